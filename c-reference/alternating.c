@@ -9,21 +9,34 @@
  * 18*17*16/3 = 816 relationships (where each relationship involves
  * 3 lines in order, these come in pairs) */
 
-/* Instance of AlternatingPredicate for the PCO */
-AlternatingPredicate PartialCyclicOrder =
-    CREATE_CYCLIC_PARTIAL_ORDER(PCO_LINES);
+/* The closure kernels, inlined into each closure defined for some n. */
+#define KERNEL static inline __attribute__((always_inline))
+
+static int entryPointerIndex(AlternatingPredicate ap, int i, int j, int k)
+{
+  return (i * ap->n + j) * ap->n + k;
+}
 
-/* Sets the value, returning false if it breaks invariants. */
+/* Sets the value, with its bits in the rows, and adds it to the worklist,
+ * returning false if it breaks invariants. */
 static bool dynamicSetRawEntry(AlternatingPredicate ap, uint_trail* entry)
 {
-  int roundedDownIx;
-  // fprintf(stderr, "%p <= %p < %p:  n:%d\n", ap->rawStorage, entry,
-  //         ap->rawStorage + ap->n * 2, ap->n);
+  int roundedDownIx, n = ap->n, triple, i, j, k;
+  uint_trail* rows = ap->rows;
   assert(entry >= ap->rawStorage);
   assert(entry < ap->rawStorage + SIGNED_TRIPLES(ap->n));
   if (!trailMaybeSetInt(entry, true)) {
     return true;
   }
+  triple = ap->triples[entry - ap->rawStorage];
+  i = triple / (n * n);
+  j = triple / n % n;
+  k = triple % n;
+  trailSetInt(rows + i * n + j, rows[i * n + j] | 1ull << k);
+  trailSetInt(rows + j * n + k, rows[j * n + k] | 1ull << i);
+  trailSetInt(rows + k * n + i, rows[k * n + i] | 1ull << j);
+  ap->worklist[ap->progress->length] = triple;
+  trailSetInt(&ap->progress->length, ap->progress->length + 1);
   roundedDownIx = ((entry - ap->rawStorage) / 2) * 2;
   return !(ap->rawStorage[roundedDownIx] && ap->rawStorage[roundedDownIx + 1]);
 }
@@ -33,15 +46,11 @@ void initializePartialCyclicOrder(void)
   initializeAlternating(PartialCyclicOrder);
 }
 
-static int entryPointerIndex(AlternatingPredicate ap, int i, int j, int k)
-{
-  return (i * ap->n + j) * ap->n + k;
-}
-
 void initializeAlternating(AlternatingPredicate ap)
 {
   int i, j, k;
   uint_trail* entry = ap->rawStorage;
+  assert(ap->n <= 64);
 
   for (i = 0; i < ap->n; i++) {
     for (j = i + 1; j < ap->n; j++) {
@@ -49,15 +58,21 @@ void initializeAlternating(AlternatingPredicate ap)
         ap->entryPointers[entryPointerIndex(ap, i, j, k)] =
             ap->entryPointers[entryPointerIndex(ap, j, k, i)] =
                 ap->entryPointers[entryPointerIndex(ap, k, i, j)] = entry;
+        ap->triples[entry - ap->rawStorage] = entryPointerIndex(ap, i, j, k);
         entry++;
         ap->entryPointers[entryPointerIndex(ap, i, k, j)] =
             ap->entryPointers[entryPointerIndex(ap, j, i, k)] =
                 ap->entryPointers[entryPointerIndex(ap, k, j, i)] = entry;
+        ap->triples[entry - ap->rawStorage] = entryPointerIndex(ap, i, k, j);
         entry++;
       }
     }
   }
   assert(entry == ap->rawStorage + SIGNED_TRIPLES(ap->n));
+  trailRegisterDynamic(ap->rawStorage,
+                       SIGNED_TRIPLES(ap->n) * sizeof(*ap->rawStorage));
+  trailRegisterDynamic(ap->rows, ap->n * ap->n * sizeof(*ap->rows));
+  trailRegisterDynamic(ap->progress, sizeof(*ap->progress));
 }
 
 uint_trail* getAlternating(AlternatingPredicate ap, int a, int b, int c)
@@ -72,39 +87,71 @@ bool dynamicAlternatingSet(AlternatingPredicate ap, int i, int j, int k)
   return dynamicSetRawEntry(ap, entry);
 }
 
-extern bool dynamicCyclicPartialOrderStep(AlternatingPredicate ap, int i, int j,
-                                          int k, int l)
+/* Sets 𝜒(i,j,l) for each l in fresh, returning false if this breaks
+ * invariants. */
+KERNEL bool setRow(AlternatingPredicate ap, const int n, int i, int j,
+                   uint64 fresh)
 {
-  if (*getAlternating(ap, i, j, k) && *getAlternating(ap, i, k, l)) {
-    // This uses trailMaybeSetInt which implements the
-    // inequality in the algorithm.
-    if (!dynamicAlternatingSet(ap, i, j, l)) {
+  for (; fresh != 0; fresh &= fresh - 1) {
+    uint_trail* entry =
+        ap->entryPointers[(i * n + j) * n + __builtin_ctzll(fresh)];
+    if (!dynamicSetRawEntry(ap, entry)) {
       return false;
     }
   }
   return true;
 }
 
-/**
- * (𝜒(a,b,x) & 𝜒(c,d,x)) | (𝜒(b,a,x) & 𝜒(d,c,x))
- */
-static bool sameOrder(AlternatingPredicate self, int a, int b, int c, int d,
-                      int x)
+/* 𝜒(i,j,k) & 𝜒(i,k,l) ⇒ 𝜒(i,j,l), where the new triple is either
+ * premise, in any of its rotations. */
+KERNEL bool cyclicPartialOrderStep(AlternatingPredicate ap, const int n, int p,
+                                   int q, int r)
 {
-  if (*getAlternating(self, a, b, x) && *getAlternating(self, c, d, x)) {
-    return true;
+  int rotation[3] = {p, q, r};
+  uint_trail* rows = ap->rows;
+  for (int turn = 0; turn < 3; turn++) {
+    int i = rotation[turn], j = rotation[(turn + 1) % 3],
+        k = rotation[(turn + 2) % 3];
+    uint64 others;
+    /* As 𝜒(i,j,k), for each l with 𝜒(i,k,l). */
+    if (!setRow(ap, n, i, j,
+                rows[i * n + k] & ~rows[i * n + j] & ~(1ull << j))) {
+      return false;
+    }
+    /* As 𝜒(i,k,l) with j,k for k,l: for each x with
+     * 𝜒(i,x,j) = 𝜒(j,i,x). */
+    others = rows[j * n + i] & ~(1ull << k);
+    for (; others != 0; others &= others - 1) {
+      int other = __builtin_ctzll(others);
+      if ((rows[i * n + other] & (1ull << k)) == 0 &&
+          !setRow(ap, n, i, other, 1ull << k)) {
+        return false;
+      }
+    }
   }
-  if (*getAlternating(self, b, a, x) && *getAlternating(self, d, c, x)) {
-    return true;
+  return true;
+}
+
+KERNEL bool cyclicPartialOrderPass(AlternatingPredicate ap, const int n)
+{
+  uint_trail* rows = ap->rows;
+  for (int i = 0; i < n; i++) {
+    for (int k = 0; k < n; k++) {
+      for (int j = 0; j < n; j++) {
+        if (j != k && (rows[i * n + j] & (1ull << k)) != 0 &&
+            !setRow(ap, n, i, j,
+                    rows[i * n + k] & ~rows[i * n + j] & ~(1ull << j))) {
+          return false;
+        }
+      }
+    }
   }
-  return false;
+  return true;
 }
 
 /*
  * We use the 3 term Grassmann-Plücker axiomatization of chirotopes,
  * adjusted for uniform oriented matroids only.
- * Checks if the chirotope conditions are met for indices a,b,c,d,x.
- * Returns true if any of the four rules indicates 𝜒(a,b,x) should be set.
  *
  * From the bible p138, with r = 3.
  * For any x₁ [a] x₂ [b] x₃ [x] y₁ [c] y₂ [d]
@@ -117,82 +164,84 @@ static bool sameOrder(AlternatingPredicate self, int a, int b, int c, int d,
  * and 𝜒(d,b,x) ⋅ 𝜒(c,a,x) ≥ 0
  * then 𝜒(a,b,x) ⋅ 𝜒(c,d,x) ≥ 0
 
- * Looking at uniform case only, ignore 0, then
- */
-static bool chirotopeCondition(AlternatingPredicate self, int a, int b, int c,
-                               int d, int x)
-{
-  /* x must be different from all other indices */
-  if (x == a || x == b || x == c || x == d) {
-    return false;
-  }
-
-  /* Match one of these four rules.
+ * Looking at uniform case only, ignore 0, then match one of these four rules.
 
 𝜒(c,d,x), 𝜒(a,c,x), 𝜒(a,d,x), 𝜒(b,d,x), 𝜒(c,b,x)  ⇒ 𝜒(a,b,x) [1]
 𝜒(c,d,x), 𝜒(a,c,x), 𝜒(b,c,x), 𝜒(b,d,x), 𝜒(d,a,x)  ⇒ 𝜒(a,b,x) [2]
 𝜒(c,d,x), 𝜒(a,d,x), 𝜒(c,a,x), 𝜒(c,b,x), 𝜒(d,b,x)  ⇒ 𝜒(a,b,x) [3]
 𝜒(c,d,x), 𝜒(b,c,x), 𝜒(c,a,x), 𝜒(d,a,x), 𝜒(d,b,x)  ⇒ 𝜒(a,b,x) [4]
-  */
 
-  /* Common condition: 𝜒(c,d,x) must be true for all rules */
-  if (!*getAlternating(self, c, d, x)) {
-    return false;
-  }
-
-  /*
-   * [1] and [2] have 𝜒(a,c,x),𝜒(b,d,x)
-   * [3] and [4] have 𝜒(c,a,x),𝜒(d,b,x)
-   */
-  if (!sameOrder(self, a, c, b, d, x)) {
-    return false;
-  }
-  /*
-   * [1] and [3] have 𝜒(a,d,x),𝜒(c,b,x)
-   * [2] and [4] have 𝜒(d,a,x),𝜒(b,c,x)
+ * Each row holds one pair over all x, so the rules are checked for every x
+ * at once; an x equal to any of a, b, c, d is never in the rows.
+ */
+KERNEL bool chirotopeRules(AlternatingPredicate self, const int n, int a,
+                           int b, int c, int d)
+{
+  uint_trail* rows = self->rows;
+  /* [1] and [2] have 𝜒(a,c,x),𝜒(b,d,x);
+   * [3] and [4] 𝜒(c,a,x),𝜒(d,b,x);
+   * [1] and [3] have 𝜒(a,d,x),𝜒(c,b,x);
+   * [2] and [4] 𝜒(d,a,x),𝜒(b,c,x).
    */
-  return sameOrder(self, a, d, c, b, x);
+  return setRow(
+      self, n, a, b,
+      rows[c * n + d] &
+          ((rows[a * n + c] & rows[b * n + d]) |
+           (rows[c * n + a] & rows[d * n + b])) &
+          ((rows[a * n + d] & rows[c * n + b]) |
+           (rows[d * n + a] & rows[b * n + c])) &
+          ~rows[a * n + b]);
 }
 
-bool dynamicChirotopeStep(AlternatingPredicate self, int a, int b, int c, int d)
+/* Every premise of the rules pairs two of a, b, c, d with x, so the new
+ * triple can only matter where a pair of its lines is two of a, b, c, d. */
+KERNEL bool chirotopeStep(AlternatingPredicate self, const int n, int p, int q,
+                          int r)
 {
-  for (int x = 0; x < self->n; x++) {
-    if (chirotopeCondition(self, a, b, c, d, x)) {
-      // printf("Checking %d %d %d\n", a, b, x);
-      if (false && (a - 6) * (b - 6) * (x - 6) == 0 &&
-          (a - 4) * (b - 4) * (x - 4) == 0 &&
-          (a - 2) * (b - 2) * (x - 2) == 0) {
-        printf(">> %d %d %d %d %d\n", a, b, c, d, x);
-        printf("sameOrder(self, a, c, b, d, x) = %d\n",
-               sameOrder(self, a, c, b, d, x));
-        printf("sameOrder(self, a, d, c, b, x) = %d\n",
-               sameOrder(self, a, d, c, b, x));
-      }
-      if (!dynamicAlternatingSet(self, a, b, x)) {
-        return false;
+  int lines[3] = {p, q, r};
+  for (int pair = 0; pair < 3; pair++) {
+    int y = lines[pair], z = lines[(pair + 1) % 3];
+    for (int slotY = 0; slotY < 4; slotY++) {
+      for (int slotZ = 0; slotZ < 4; slotZ++) {
+        int slots[4], u, v;
+        if (slotZ == slotY) {
+          continue;
+        }
+        for (u = 0; u < 4 && (u == slotY || u == slotZ); u++) {
+        }
+        for (v = u + 1; v < 4 && (v == slotY || v == slotZ); v++) {
+        }
+        slots[slotY] = y;
+        slots[slotZ] = z;
+        for (slots[u] = 0; slots[u] < n; slots[u]++) {
+          if (slots[u] == y || slots[u] == z) {
+            continue;
+          }
+          for (slots[v] = 0; slots[v] < n; slots[v]++) {
+            if (slots[v] == y || slots[v] == z || slots[v] == slots[u]) {
+              continue;
+            }
+            if (!chirotopeRules(self, n, slots[0], slots[1], slots[2],
+                                slots[3])) {
+              return false;
+            }
+          }
+        }
       }
     }
   }
   return true;
 }
 
-/* Return false if invariants are violated. */
-static bool internalDynamicAlternatingClosure(AlternatingPredicate ap)
+KERNEL bool chirotopePass(AlternatingPredicate self, const int n)
 {
-  int i, j, k, l;
-  // extended Roy-Floyd-Warshall
-  for (i = 0; i < ap->n; i++) {
-    for (k = 0; k < ap->n; k++) {
-      if (k != i) {
-        for (j = 0; j < ap->n; j++) {
-          if (j != k && j != i) {
-            for (l = 0; l < ap->n; l++) {
-              if (l != i && l != k && l != j) {
-                if (!ap->dynamicOneClosureStep(ap, i, j, k, l)) {
-                  return false;
-                }
-              }
-            }
+  for (int a = 0; a < n; a++) {
+    for (int c = 0; c < n; c++) {
+      for (int b = 0; b < n; b++) {
+        for (int d = 0; d < n; d++) {
+          if (a != b && a != c && a != d && b != c && b != d && c != d &&
+              !chirotopeRules(self, n, a, b, c, d)) {
+            return false;
           }
         }
       }
@@ -200,18 +249,48 @@ static bool internalDynamicAlternatingClosure(AlternatingPredicate ap)
   }
   return true;
 }
-/* Return false if invariants are violated. */
+
+/* Defines the closure step and pass of an axiom system for n lines; when n
+ * is a constant, they are compiled for exactly that many lines. */
+#define DEFINE_CLOSURE(storage, name, kernel, n)                          \
+  storage bool name##Step(AlternatingPredicate self, int i, int j, int k) \
+  {                                                                      \
+    return kernel##Step(self, n, i, j, k);                                \
+  }                                                                      \
+  storage bool name##Pass(AlternatingPredicate self)                      \
+  {                                                                      \
+    return kernel##Pass(self, n);                                         \
+  }
+
+DEFINE_CLOSURE(, dynamicCyclicPartialOrder, cyclicPartialOrder, self->n)
+DEFINE_CLOSURE(, dynamicChirotope, chirotope, self->n)
+DEFINE_CLOSURE(static, dynamicPcoLines, cyclicPartialOrder, PCO_LINES)
+
+/* Instance of AlternatingPredicate for the PCO */
+AlternatingPredicate PartialCyclicOrder = CREATE_ALTERNATING_PREDICATE(
+    PCO_LINES, dynamicPcoLinesStep, dynamicPcoLinesPass);
+
 bool dynamicAlternatingClosure(AlternatingPredicate ap)
 {
-  bool result = true;
-  while (result) {
-    TRAIL check = Trail;
-    result = internalDynamicAlternatingClosure(ap);
-    if (check == Trail) {
-      break;
+  int n = ap->n;
+  uint_trail closed = ap->progress->closed;
+  /* Roughly where working through the new entries one by one costs more than
+   * passes over everything. */
+  while (ap->progress->length - closed > (uint_trail)n) {
+    closed = ap->progress->length;
+    if (!ap->dynamicClosurePass(ap)) {
+      return false;
+    }
+  }
+  for (; closed < ap->progress->length; closed++) {
+    int triple = ap->worklist[closed];
+    if (!ap->dynamicClosureStep(ap, triple / (n * n), triple / n % n,
+                                triple % n)) {
+      return false;
     }
   }
-  return result;
+  trailMaybeSetInt(&ap->progress->closed, closed);
+  return true;
 }
 
 void debugAlternating(AlternatingPredicate chirotope)
@@ -236,18 +315,20 @@ void debugAlternating(AlternatingPredicate chirotope)
   }
 }
 
+/* The predicate being completed by the innermost call. */
 static AlternatingPredicate alternatingSearch;
-static int
-    DynamicAlternatingCompleteChoicePoints[SIGNED_TRIPLES((NCOLORS + 1) * 3)];
 static PredicateResult tryAlternatingComplete(int round)
 {
-  for (int i = 0; i < SIGNED_TRIPLES(alternatingSearch->n); i += 2) {
+  uint_trail* firstUnset = &alternatingSearch->progress->firstUnset;
+  for (int i = *firstUnset; i < SIGNED_TRIPLES(alternatingSearch->n); i += 2) {
     if (!(alternatingSearch->rawStorage[i] ||
           alternatingSearch->rawStorage[i + 1])) {
-      DynamicAlternatingCompleteChoicePoints[round] = i;
+      trailMaybeSetInt(firstUnset, i);
+      alternatingSearch->choicePoints[round] = i;
       return predicateChoices(2);
     }
   }
+  trailMaybeSetInt(firstUnset, SIGNED_TRIPLES(alternatingSearch->n));
   return PredicateSuccessNextPredicate;
 }
 
@@ -255,8 +336,7 @@ static PredicateResult dynamicRetryAlternatingComplete(int round, int choice)
 {
   dynamicSetRawEntry(alternatingSearch,
                      alternatingSearch->rawStorage +
-                         DynamicAlternatingCompleteChoicePoints[round] +
-                         choice);
+                         alternatingSearch->choicePoints[round] + choice);
   if (dynamicAlternatingClosure(alternatingSearch)) {
     return PredicateSuccessSamePredicate;
   } else {
@@ -270,14 +350,13 @@ static struct predicate complete = {"CompleteAlternating",
 
 static PREDICATE alternatingPredicates[] = {&complete, &SUSPENDPredicate};
 
-bool dynamicAlternatingComplete(AlternatingPredicate ap)
+bool dynamicAlternatingComplete(STACK stack, AlternatingPredicate ap)
 {
-  struct stack alternatingStack;
+  AlternatingPredicate outer = alternatingSearch;
+  bool failed;
   alternatingSearch = ap;
-  bool failed = engine(&alternatingStack, alternatingPredicates);
-  engineClear(&alternatingStack);
-  if (failed) {
-    return false;
-  }
-  return true;
+  failed = engine(stack, alternatingPredicates);
+  engineClear(stack);
+  alternatingSearch = outer;
+  return !failed;
 }
@@ -3,6 +3,7 @@
 #ifndef ALTERNATING_H
 #define ALTERNATING_H
 
+#include "engine.h"
 #include "trail.h"
 
 /**
@@ -21,29 +22,60 @@
 /* The number of signed triples for the partial cyclic order of the lines. */
 #define PCO_TRIPLES SIGNED_TRIPLES(PCO_LINES)
 
+/* Trailed, so that backtracking restores them with the entries. */
+struct alternatingProgress {
+  uint_trail closed;     /* The worklist entries already closed over */
+  uint_trail length;     /* Of the worklist */
+  uint_trail firstUnset; /* Every pair of rawStorage before this is set */
+};
+
 struct alternatingPredicate {
   int n;
-  /* Extend the predicate as in Roy-Floyd-Warshall, using the trail,
-   * and returning false on failure.
+  /* Extend the predicate as in Roy-Floyd-Warshall, using the trail and the
+   * rows, and returning false on failure: the step from the newly set
+   * 𝜒(i,j,k), the pass from everything.
    */
-  bool (*dynamicOneClosureStep)(AlternatingPredicate self, int i, int j, int k, int l);
+  bool (*dynamicClosureStep)(AlternatingPredicate self, int i, int j, int k);
+  bool (*dynamicClosurePass)(AlternatingPredicate self);
   uint_trail* rawStorage;
   uint_trail** entryPointers;
+  /* Bit k of row i*n+j is 𝜒(i,j,k). */
+  uint_trail* rows;
+  /* For each entry of rawStorage, one of its triples, as (i*n+j)*n+k. */
+  int* triples;
+  /* The triples of the entries in the order they were set. */
+  int* worklist;
+  struct alternatingProgress* progress;
+  /* The pair of entries chosen at each round of dynamicAlternatingComplete. */
+  int* choicePoints;
 };
 
 // The {0}'s initialize the arrays to zero.
-#define CREATE_ALTERNATING_PREDICATE(number, closure)        \
-  &((struct alternatingPredicate){                           \
-      .n = number,                                           \
-      .dynamicOneClosureStep = closure,                      \
-      .rawStorage = (uint_trail[SIGNED_TRIPLES(number)]){0}, \
-      .entryPointers = (uint_trail * [(number) * (number) * (number)]){0}})
-
-extern bool dynamicCyclicPartialOrderStep(AlternatingPredicate self, int i, int j, int k, int l);
-extern bool dynamicChirotopeStep(AlternatingPredicate self, int i, int j, int k, int l);
+#define CREATE_ALTERNATING_PREDICATE(number, step, pass)                 \
+  &((struct alternatingPredicate){                                       \
+      .n = number,                                                       \
+      .dynamicClosureStep = step,                                        \
+      .dynamicClosurePass = pass,                                        \
+      .rawStorage = (uint_trail[SIGNED_TRIPLES(number)]){0},             \
+      .entryPointers = (uint_trail * [(number) * (number) * (number)]){0}, \
+      .rows = (uint_trail[(number) * (number)]){0},                      \
+      .triples = (int[SIGNED_TRIPLES(number)]){0},                       \
+      .worklist = (int[SIGNED_TRIPLES(number)]){0},                      \
+      .progress = &(struct alternatingProgress){0},                      \
+      .choicePoints = (int[SIGNED_TRIPLES(number) / 2 + 1]){0}})
+
+/* These closures read n from self; PartialCyclicOrder has its own, compiled
+ * for PCO_LINES. */
+extern bool dynamicCyclicPartialOrderStep(AlternatingPredicate self, int i,
+                                          int j, int k);
+extern bool dynamicCyclicPartialOrderPass(AlternatingPredicate self);
+extern bool dynamicChirotopeStep(AlternatingPredicate self, int i, int j,
+                                 int k);
+extern bool dynamicChirotopePass(AlternatingPredicate self);
 
 #define CREATE_CYCLIC_PARTIAL_ORDER(n) \
-  CREATE_ALTERNATING_PREDICATE(n, dynamicCyclicPartialOrderStep)
+  CREATE_ALTERNATING_PREDICATE(n, dynamicCyclicPartialOrderStep, \
+                               dynamicCyclicPartialOrderPass)
 
 /*
  * Our chirotopes unusually are:
@@ -51,7 +83,8 @@ extern bool dynamicChirotopeStep(AlternatingPredicate self, int i, int j, int k,
  * - uniform: 0 is not a legal value
  **/
 
-#define CREATE_CHIROTOPE(n) CREATE_ALTERNATING_PREDICATE(n, dynamicChirotopeStep)
+#define CREATE_CHIROTOPE(n) \
+  CREATE_ALTERNATING_PREDICATE(n, dynamicChirotopeStep, dynamicChirotopePass)
 
 extern void initializePartialCyclicOrder(void);
 extern void initializeAlternating(AlternatingPredicate ap);
@@ -61,8 +94,12 @@ extern AlternatingPredicate PartialCyclicOrder;
 extern bool dynamicAlternatingSet(AlternatingPredicate ap, int i, int j, int k);
 // Returns NULL if i == j or i == k or j == k, else pointer to true or false.
 extern uint_trail* getAlternating(AlternatingPredicate ap, int i, int j, int k);
+/* Closes over the entries set since the last closure, returning false if
+ * invariants are violated. */
 extern bool dynamicAlternatingClosure(AlternatingPredicate ap);
-extern bool dynamicAlternatingComplete(AlternatingPredicate ap);
+/* Searches, with stack, for a completion of ap, returning whether there is
+ * one; the entries are left as before. */
+extern bool dynamicAlternatingComplete(STACK stack, AlternatingPredicate ap);
 extern char* alternatingToString(AlternatingPredicate ap);
 
 #endif /* ALTERNATING_H */
@@ -0,0 +1,194 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "asyncwriter.h"
+
+#include "common.h"
+#include "statistics.h"
+#include "stream.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The buffers are a ring: the search fills the one at Head, and the writer
+ * empties the one at Tail. Queued counts those filled and not yet written,
+ * including the one being written, so the search may fill the buffer at Head
+ * while Queued is less than Depth. The thread is started with the first
+ * file, so that -P workers, forked before then, have threads of their own.
+ */
+
+struct queuedWrite {
+  bool isFolder;
+  char path[1024];
+  char *buffer;
+  size_t length;
+  size_t capacity;
+};
+
+static struct queuedWrite *Queue = NULL;
+static int Depth;
+static int Head = 0;
+static int Tail = 0;
+static int Queued = 0;
+static bool Running = false;
+static bool Stopping = false;
+static pthread_t Writer;
+static pthread_mutex_t Lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t Space = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t Work = PTHREAD_COND_INITIALIZER;
+static struct graphmlFileIO Underlying;
+
+static uint64 WriterWaits = 0;
+static uint64 MaxQueued = 0;
+
+static void writeQueued(struct queuedWrite *write)
+{
+  FILE *fp;
+  if (write->isFolder) {
+    Underlying.initializeFolder(write->path);
+    return;
+  }
+  fp = Underlying.fopen(write->path, "w");
+  if (fp == NULL || fwrite(write->buffer, 1, write->length, fp) !=
+                        write->length || fclose(fp) != 0) {
+    perror(write->path);
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void *writerThread(void *unused)
+{
+  (void)unused;
+  pthread_mutex_lock(&Lock);
+  for (;;) {
+    while (Queued == 0 && !Stopping) {
+      pthread_cond_wait(&Work, &Lock);
+    }
+    if (Queued == 0) {
+      break;
+    }
+    pthread_mutex_unlock(&Lock);
+    writeQueued(Queue + Tail);
+    pthread_mutex_lock(&Lock);
+    Tail = (Tail + 1) % Depth;
+    Queued--;
+    pthread_cond_signal(&Space);
+  }
+  pthread_mutex_unlock(&Lock);
+  return NULL;
+}
+
+/* The buffer at Head, once there is space, starting the writer if need be. */
+static struct queuedWrite *nextWrite(bool isFolder, const char *path)
+{
+  struct queuedWrite *write;
+  pthread_mutex_lock(&Lock);
+  if (!Running) {
+    Stopping = false;
+    if (pthread_create(&Writer, NULL, writerThread, NULL) != 0) {
+      perror("pthread_create");
+      exit(EXIT_FAILURE);
+    }
+    Running = true;
+  }
+  if (Queued == Depth) {
+    WriterWaits++;
+    do {
+      pthread_cond_wait(&Space, &Lock);
+    } while (Queued == Depth);
+  }
+  pthread_mutex_unlock(&Lock);
+  write = Queue + Head;
+  write->isFolder = isFolder;
+  write->length = 0;
+  if (snprintf(write->path, sizeof(write->path), "%s", path) >=
+      (int)sizeof(write->path)) {
+    fprintf(stderr, "%s: path too long\n", path);
+    exit(EXIT_FAILURE);
+  }
+  return write;
+}
+
+static void enqueue(void)
+{
+  pthread_mutex_lock(&Lock);
+  Head = (Head + 1) % Depth;
+  Queued++;
+  if ((uint64)Queued > MaxQueued) {
+    MaxQueued = Queued;
+  }
+  pthread_cond_signal(&Work);
+  pthread_mutex_unlock(&Lock);
+}
+
+static int bufferWrite(void *cookie, const char *buffer, int size)
+{
+  struct queuedWrite *write = cookie;
+  if (write->length + size > write->capacity) {
+    size_t capacity = write->capacity == 0 ? 65536 : write->capacity;
+    while (write->length + size > capacity) {
+      capacity *= 2;
+    }
+    write->buffer = realloc(write->buffer, capacity);
+    if (write->buffer == NULL) {
+      perror("realloc");
+      exit(EXIT_FAILURE);
+    }
+    write->capacity = capacity;
+  }
+  memcpy(write->buffer + write->length, buffer, size);
+  write->length += size;
+  return size;
+}
+
+static int bufferClose(void *cookie)
+{
+  (void)cookie;
+  enqueue();
+  return 0;
+}
+
+static FILE *queueFopen(const char *filename, const char *mode)
+{
+  assert(strcmp(mode, "w") == 0);
+  (void)mode;
+  return streamOpen(nextWrite(false, filename), bufferWrite, bufferClose);
+}
+
+static void queueFolder(const char *folder)
+{
+  nextWrite(true, folder);
+  enqueue();
+}
+
+void asyncWriterStart(int depth)
+{
+  assert(depth > 0 && depth <= MAX_WRITER_QUEUE);
+  Queue = calloc(depth, sizeof(*Queue));
+  if (Queue == NULL) {
+    perror("calloc");
+    exit(EXIT_FAILURE);
+  }
+  Depth = depth;
+  Underlying = GraphmlFileOps;
+  GraphmlFileOps.fopen = queueFopen;
+  GraphmlFileOps.initializeFolder = queueFolder;
+  statisticIncludeInteger(&WriterWaits, "W", "writer waits", false);
+  statisticIncludeMaximum(&MaxQueued, "w", "MaxWriterQueue", true);
+}
+
+void asyncWriterFinish(void)
+{
+  if (!Running) {
+    return;
+  }
+  pthread_mutex_lock(&Lock);
+  Stopping = true;
+  pthread_cond_signal(&Work);
+  pthread_mutex_unlock(&Lock);
+  pthread_join(Writer, NULL);
+  Running = false;
+}
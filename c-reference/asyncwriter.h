@@ -0,0 +1,26 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef ASYNCWRITER_H
+#define ASYNCWRITER_H
+
+/**
+ * Writing the GraphML files in a thread of their own (-Q depth), so that the
+ * search does not wait on opening, writing and closing each, nor on making
+ * the folders. GraphmlFileOps is pointed here: each file is printed into one
+ * of depth reusable buffers, which is queued, with the folders, in order, for
+ * the writer thread, which writes them through the GraphmlFileOps of before.
+ * The search waits only when every buffer is queued: the count of such waits
+ * and the most buffers queued at once are in the statistics.
+ */
+
+/* The most buffers. */
+#define MAX_WRITER_QUEUE 4096
+
+/* Queues the GraphML in up to depth buffers. */
+extern void asyncWriterStart(int depth);
+
+/* Waits until everything queued has been written; a later file restarts the
+ * writer thread. */
+extern void asyncWriterFinish(void);
+
+#endif  // ASYNCWRITER_H
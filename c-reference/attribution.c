@@ -0,0 +1,70 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "attribution.h"
+
+#include <stdlib.h>
+
+bool FailureAttributionEnabled = false;
+
+static const char *Path;
+static uint64 Tried[NFACES][NCYCLES];
+static uint64 Failed[NFACES][NCYCLES];
+/* The last column is for failures found at a face with no cycle yet. */
+static uint64 Detected[NFACES][NCYCLES + 1];
+
+void failureAttributionStart(const char *path)
+{
+  Path = path;
+  FailureAttributionEnabled = true;
+}
+
+void failureAttributionRecord(FACE face, FAILURE failure)
+{
+  FACE failing;
+  uint64 cycleId = face->cycle - Cycles;
+  assert(cycleId < NCYCLES);
+  Tried[face->colors][cycleId]++;
+  if (failure == NULL) {
+    return;
+  }
+  Failed[face->colors][cycleId]++;
+  failing = FailureFace != NULL ? FailureFace : face;
+  Detected[failing->colors]
+          [failing->cycle != NULL ? (uint64)(failing->cycle - Cycles)
+                                  : NCYCLES]++;
+}
+
+static void writeCounts(FILE *fp, const char *kind, const uint64 *counts,
+                        uint32_t cycles)
+{
+  for (uint32_t face = 0; face < NFACES; face++) {
+    for (uint32_t cycle = 0; cycle < cycles; cycle++) {
+      uint64 count = counts[face * cycles + cycle];
+      if (count != 0) {
+        fprintf(fp, "%s,%s,%s,%llu\n", kind, colorSetToBareString(face),
+                cycle < NCYCLES ? cycleToString(Cycles + cycle) : "", count);
+      }
+    }
+  }
+}
+
+void failureAttributionWrite(void)
+{
+  FILE *fp;
+  if (!FailureAttributionEnabled) {
+    return;
+  }
+  fp = fopen(Path, "w");
+  if (fp == NULL) {
+    perror(Path);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(fp, "kind,face,cycle,count\n");
+  writeCounts(fp, "tried", &Tried[0][0], NCYCLES);
+  writeCounts(fp, "failed", &Failed[0][0], NCYCLES);
+  writeCounts(fp, "detected", &Detected[0][0], NCYCLES + 1);
+  if (fclose(fp) != 0) {
+    perror(Path);
+    exit(EXIT_FAILURE);
+  }
+}
@@ -0,0 +1,27 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef ATTRIBUTION_H
+#define ATTRIBUTION_H
+
+#include "face.h"
+
+/**
+ * Failure attribution (-A): each choice of a cycle for a face is counted,
+ * as is each that fails, and the face at which the failure was found,
+ * with the cycle it had, if any. The counts are written at the end as CSV,
+ * one row per non-zero count, with columns kind, face, cycle and count,
+ * where kind is tried, failed or detected.
+ */
+
+/* Set once attribution has started. */
+extern bool FailureAttributionEnabled;
+
+extern void failureAttributionStart(const char *path);
+
+/* Counts the choice of face->cycle, which failed unless failure is NULL. */
+extern void failureAttributionRecord(FACE face, FAILURE failure);
+
+/* Writes the counts to the path given to failureAttributionStart. */
+extern void failureAttributionWrite(void);
+
+#endif  // ATTRIBUTION_H
@@ -0,0 +1,191 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "batch.h"
+
+#include "asyncwriter.h"
+#include "main.h"
+#include "predicates.h"
+#include "statistics.h"
+
+#include <sys/wait.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+struct batchJob {
+  FACE_DEGREE degrees[NCOLORS]; /* All 0 for every sequence */
+  int skip, max, variantSkip, variantMax;
+  char text[80]; /* As in the file, to head its statistics */
+};
+
+static struct batchJob Jobs[MAX_BATCH_JOBS];
+static int NumberOfJobs = 0;
+static struct statisticTotals *Totals;
+static struct stack BatchStack;
+
+static void badJob(const char *path, int line, const char *message)
+{
+  fprintf(stderr, "%s:%d: %s\n", path, line, message);
+  exit(EXIT_FAILURE);
+}
+
+/* Parses a count, or, if unlimited is not 0, - for it. */
+static int parseCount(const char *path, int line, const char *field,
+                      int unlimited)
+{
+  char *end;
+  long value;
+  if (field == NULL) {
+    badJob(path, line, "expected degrees skip max variantSkip variantMax");
+  }
+  if (unlimited != 0 && strcmp(field, "-") == 0) {
+    return unlimited;
+  }
+  value = strtol(field, &end, 10);
+  if (end == field || *end != '\0' || value < (unlimited == 0 ? 0 : 1) ||
+      value >= INT_MAX) {
+    badJob(path, line,
+           unlimited == 0 ? "a skip must be a non-negative integer"
+                          : "a maximum must be a positive integer, or -");
+  }
+  return (int)value;
+}
+
+static void parseJob(const char *path, int line, char *text)
+{
+  struct batchJob *job = Jobs + NumberOfJobs;
+  char *degrees;
+  if (NumberOfJobs == MAX_BATCH_JOBS) {
+    badJob(path, line, "too many jobs");
+  }
+  memset(job, 0, sizeof(*job));
+  text[strcspn(text, "\r\n")] = '\0';
+  snprintf(job->text, sizeof(job->text), "%s", text);
+  degrees = strtok(text, " \t");
+  if (strcmp(degrees, "-") != 0) {
+    if (strlen(degrees) != NCOLORS) {
+      char message[64];
+      snprintf(message, sizeof(message),
+               "the degrees must be exactly %d digits, or -", NCOLORS);
+      badJob(path, line, message);
+    }
+    for (int i = 0; i < NCOLORS; i++) {
+      if (degrees[i] < '3' || degrees[i] > '6') {
+        badJob(path, line, "each digit of the degrees must be from 3 to 6");
+      }
+      job->degrees[i] = degrees[i] - '0';
+    }
+  }
+  job->skip = parseCount(path, line, strtok(NULL, " \t"), 0);
+  job->max = parseCount(path, line, strtok(NULL, " \t"), INT_MAX);
+  job->variantSkip = parseCount(path, line, strtok(NULL, " \t"), 0);
+  job->variantMax = parseCount(path, line, strtok(NULL, " \t"), INT_MAX);
+  if (strtok(NULL, " \t") != NULL) {
+    badJob(path, line, "expected degrees skip max variantSkip variantMax");
+  }
+  NumberOfJobs++;
+}
+
+static void readJobs(const char *path)
+{
+  FILE *fp = fopen(path, "r");
+  char *text = NULL;
+  size_t capacity = 0;
+  int line = 0;
+  if (fp == NULL) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  while (getline(&text, &capacity, fp) >= 0) {
+    char *start = text + strspn(text, " \t");
+    line++;
+    if (*start != '\0' && *start != '\n' && *start != '\r' && *start != '#') {
+      parseJob(path, line, start);
+    }
+  }
+  free(text);
+  fclose(fp);
+}
+
+static void runJob(const struct batchJob *job, int number, bool shared)
+{
+  bool hasDegrees = job->degrees[0] != 0;
+  if (shared) {
+    /* Lines from different jobs share stdout, keep each one whole. */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+  }
+  initializeStatisticLogging("/dev/stdout", 200, 10);
+  statisticClear();
+  memcpy(CentralFaceDegreesFlag, job->degrees, sizeof(job->degrees));
+  PerFaceDegreeSkipSolutionsFlag = hasDegrees ? job->skip : 0;
+  PerFaceDegreeMaxSolutionsFlag = hasDegrees ? job->max : INT_MAX;
+  GlobalSkipSolutionsFlag = hasDegrees ? 0 : job->skip;
+  GlobalMaxSolutionsFlag = hasDegrees ? INT_MAX : job->max;
+  IgnoreFirstVariantsPerSolution = job->variantSkip;
+  MaxVariantsPerSolutionFlag = job->variantMax;
+
+  engine(&BatchStack, NonDeterministicProgram);
+  asyncWriterFinish();
+  printf("Job %d: %s\n", number, job->text);
+  statisticPrintFull();
+  statisticAddTo(Totals);
+  fflush(NULL);
+  _exit(EXIT_SUCCESS);
+}
+
+/* Waits for a job, returning whether it succeeded. */
+static bool waitForJob(void)
+{
+  int status;
+  if (wait(&status) < 0) {
+    perror("wait");
+    exit(EXIT_FAILURE);
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+
+void batchSearch(const char *path, int parallel)
+{
+  int running = 0, failed = 0;
+  readJobs(path);
+  /* Initialize does not undo, so each job starts from the frozen point. */
+  engine(&BatchStack, (PREDICATE[]){&InitializePredicate, &FAILPredicate});
+  /* Every statistic has been registered by the initialization. */
+  Totals = statisticTotalsCreate();
+  if (parallel == 0) {
+    parallel = 1;
+  }
+  for (int i = 0; i < NumberOfJobs; i++) {
+    pid_t pid;
+    if (running == parallel) {
+      failed += !waitForJob();
+      running--;
+    }
+    fflush(NULL);
+    pid = fork();
+    if (pid < 0) {
+      perror("fork");
+      exit(EXIT_FAILURE);
+    }
+    if (pid == 0) {
+      runJob(Jobs + i, i + 1, parallel > 1);
+    }
+    running++;
+  }
+  while (running-- > 0) {
+    failed += !waitForJob();
+  }
+  statisticSetFrom(Totals);
+  statisticTotalsFree(Totals);
+  if (failed > 0) {
+    fprintf(stderr, "%d of %d jobs failed; the batch is incomplete.\n",
+            failed, NumberOfJobs);
+    exit(EXIT_FAILURE);
+  }
+  printf("All %d jobs:\n", NumberOfJobs);
+}
@@ -0,0 +1,28 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "core.h"
+
+/**
+ * Batch search: a file of jobs, one per line, each
+ *
+ *     degrees skip max variantSkip variantMax
+ *
+ * as for -d, -k, -m, -j and -n, with - for the degrees to search every
+ * sequence, and - for either maximum for no limit. Blank lines, and those
+ * starting with #, are ignored. Initialize runs once, and each job then runs
+ * in a process forked from that state, writing to the output already open,
+ * and printing its own statistics when it is done. The statistics of all the
+ * jobs are left in this process, for the program to print at the end.
+ */
+
+/* The most jobs in one file. */
+#define MAX_BATCH_JOBS 4096
+
+/* Runs the jobs in path, up to parallel of them at once, or one at a time
+ * for 0. */
+extern void batchSearch(const char *path, int parallel);
+
+#endif  // BATCH_H
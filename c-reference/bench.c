@@ -0,0 +1,430 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "common.h"
+#include "engine.h"
+#include "main.h"
+#include "predicates.h"
+#include "s6.h"
+#include "statistics.h"
+#include "stream.h"
+#include "utils.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * The benchmarks of make bench: a fixed set of workloads, each run in a
+ * process of its own, so that it starts afresh, and its peak memory is its
+ * own. The wall time, the engine steps (calls of try and retry) per second
+ * and the peak memory of each are written as JSON, and compared with a
+ * baseline written in the same way: any workload slower, or using more
+ * memory, than the baseline by more than the tolerance fails the benchmark.
+ *
+ * The corners and s6 workloads replay the search to each solution of the
+ * one sequence of face degrees, found beforehand, untimed, and then time
+ * only what follows each.
+ */
+
+#define BENCH_FACE_DEGREES "554544"
+#define BENCH_GRAPHML_SOLUTIONS 3
+/* Each solution is canonicalized this many times by the s6 workload. */
+#define BENCH_S6_REPEATS 2000
+#define MAX_LEAVES 256
+#define DEFAULT_TOLERANCE 0.3
+
+struct benchResult {
+  char name[32];
+  double seconds;
+  uint64 nodes;
+  uint64 count; /* Of solutions or variations, as a check */
+  long peakKilobytes;
+};
+
+static struct stack Stack;
+static double Seconds;
+static uint64 Nodes;
+static uint64 Count;
+static struct choicePath Leaves[MAX_LEAVES];
+static int LeafCount;
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static struct predicateResult tryCount(int round)
+{
+  (void)round;
+  Count++;
+  return PredicateFail;
+}
+
+static struct predicate CountPredicate = {"Count", tryCount, NULL};
+
+/* Keeps the choices that lead to this solution, and only these. */
+static struct predicateResult tryRecordLeaf(int round)
+{
+  CHOICE_PATH path = Leaves + LeafCount++;
+  (void)round;
+  assert(LeafCount <= MAX_LEAVES);
+  engineContinuationPath(&Stack, path);
+  for (int i = 0; i < path->length; i++) {
+    if (path->steps[i].first >= 0) {
+      path->steps[i].end = path->steps[i].first + 1;
+    }
+  }
+  return PredicateFail;
+}
+
+static struct predicate RecordLeafPredicate = {"RecordLeaf", tryRecordLeaf,
+                                               NULL};
+
+static struct predicateResult tryCanonicalize(int round)
+{
+  (void)round;
+  for (int i = 0; i < BENCH_S6_REPEATS; i++) {
+    s6RecordSolution();
+  }
+  Count++;
+  return PredicateFail;
+}
+
+static struct predicate CanonicalizePredicate = {"Canonicalize",
+                                                 tryCanonicalize, NULL};
+
+static uint64 engineSteps(PREDICATE *program)
+{
+  uint64 steps = 0;
+  for (; *program != &FAILPredicate; program++) {
+    const struct predicateProfile *profile = engineProfile(*program);
+    if (profile != NULL) {
+      steps += profile->calls + profile->retries;
+    }
+  }
+  return steps;
+}
+
+/* Runs the program, replaying path if not NULL, adding to the totals. */
+static void timed(PREDICATE *program, const struct choicePath *path)
+{
+  uint64 steps = engineSteps(program);
+  double start = now();
+  engineReplay(&Stack, program, path);
+  Seconds += now() - start;
+  Nodes += engineSteps(program) - steps;
+}
+
+static void setFaceDegrees(void)
+{
+  for (int i = 0; i < NCOLORS; i++) {
+    CentralFaceDegreesFlag[i] = BENCH_FACE_DEGREES[i] - '0';
+  }
+}
+
+/* Finds, untimed, the solutions of BENCH_FACE_DEGREES. */
+static void findLeaves(void)
+{
+  setFaceDegrees();
+  LeafCount = 0;
+  engine(&Stack, (PREDICATE[]){&InitializePredicate, &InnerFacePredicate,
+                               &VennPredicate, &RecordLeafPredicate,
+                               &FAILPredicate});
+}
+
+static void benchFull(void)
+{
+  timed((PREDICATE[]){&InitializePredicate, &InnerFacePredicate,
+                      &VennPredicate, &CountPredicate, &FAILPredicate},
+        NULL);
+}
+
+static void benchFaceDegrees(void)
+{
+  setFaceDegrees();
+  benchFull();
+}
+
+static void benchCorners(void)
+{
+  findLeaves();
+  for (int i = 0; i < LeafCount; i++) {
+    timed((PREDICATE[]){&InitializePredicate, &InnerFacePredicate,
+                        &VennPredicate, &CornersPredicate, &CountPredicate,
+                        &FAILPredicate},
+          Leaves + i);
+  }
+}
+
+static int discard(void *cookie, const char *buffer, int size)
+{
+  (void)cookie;
+  (void)buffer;
+  return size;
+}
+
+static int closeDiscarded(void *cookie)
+{
+  (void)cookie;
+  Count++;
+  return 0;
+}
+
+static FILE *nullFopen(const char *filename, const char *mode)
+{
+  (void)filename;
+  (void)mode;
+  return streamOpen(NULL, discard, closeDiscarded);
+}
+
+static void noFolder(const char *folder)
+{
+  (void)folder;
+}
+
+/* The solution files go to a temporary folder; the GraphML to nowhere. */
+static void benchGraphml(void)
+{
+  char folder[] = "/tmp/venn-bench-XXXXXX";
+  char filename[sizeof(folder) + 32];
+  if (mkdtemp(folder) == NULL) {
+    perror(folder);
+    exit(EXIT_FAILURE);
+  }
+  setFaceDegrees();
+  TargetFolderFlag = folder;
+  PerFaceDegreeMaxSolutionsFlag = BENCH_GRAPHML_SOLUTIONS;
+  GraphmlFileOps.fopen = nullFopen;
+  GraphmlFileOps.initializeFolder = noFolder;
+  timed((PREDICATE[]){&InitializePredicate, &InnerFacePredicate,
+                      &VennPredicate, &SavePredicate, &CornersPredicate,
+                      &GraphMLPredicate, &FAILPredicate},
+        NULL);
+  for (int i = 1; i <= BENCH_GRAPHML_SOLUTIONS; i++) {
+    snprintf(filename, sizeof(filename), "%s/%s-%2.2d.txt", folder,
+             BENCH_FACE_DEGREES, i);
+    unlink(filename);
+  }
+  rmdir(folder);
+}
+
+static void benchS6(void)
+{
+  findLeaves();
+  for (int i = 0; i < LeafCount; i++) {
+    timed((PREDICATE[]){&InitializePredicate, &InnerFacePredicate,
+                        &VennPredicate, &CanonicalizePredicate,
+                        &FAILPredicate},
+          Leaves + i);
+  }
+}
+
+static const struct {
+  const char *name;
+  void (*run)(void);
+} Workloads[] = {
+    {"full", benchFull},       {"degrees", benchFaceDegrees},
+    {"corners", benchCorners}, {"graphml", benchGraphml},
+    {"s6", benchS6},
+};
+
+/* Runs the workload in a child, which writes its totals to the pipe. */
+static void runWorkload(int i, struct benchResult *result)
+{
+  int fds[2];
+  int status;
+  struct rusage usage;
+  pid_t pid;
+  fflush(NULL);
+  if (pipe(fds) != 0 || (pid = fork()) < 0) {
+    perror("bench");
+    exit(EXIT_FAILURE);
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    initializeStatisticLogging(NULL, 200, 3600);
+    Workloads[i].run();
+    if (write(fds[1], &Seconds, sizeof(Seconds)) != sizeof(Seconds) ||
+        write(fds[1], &Nodes, sizeof(Nodes)) != sizeof(Nodes) ||
+        write(fds[1], &Count, sizeof(Count)) != sizeof(Count)) {
+      _exit(EXIT_FAILURE);
+    }
+    _exit(EXIT_SUCCESS);
+  }
+  close(fds[1]);
+  memset(result, 0, sizeof(*result));
+  snprintf(result->name, sizeof(result->name), "%s", Workloads[i].name);
+  if (read(fds[0], &result->seconds, sizeof(result->seconds)) !=
+          sizeof(result->seconds) ||
+      read(fds[0], &result->nodes, sizeof(result->nodes)) !=
+          sizeof(result->nodes) ||
+      read(fds[0], &result->count, sizeof(result->count)) !=
+          sizeof(result->count) ||
+      wait4(pid, &status, 0, &usage) < 0 || !WIFEXITED(status) ||
+      WEXITSTATUS(status) != EXIT_SUCCESS) {
+    fprintf(stderr, "The %s benchmark failed.\n", Workloads[i].name);
+    exit(EXIT_FAILURE);
+  }
+  close(fds[0]);
+#ifdef __APPLE__
+  result->peakKilobytes = usage.ru_maxrss / 1024;
+#else
+  result->peakKilobytes = usage.ru_maxrss;
+#endif
+}
+
+/* One workload to a line, so that readBaseline need not parse JSON. */
+static void writeResults(const char *filename, struct benchResult *results,
+                         int count)
+{
+  FILE *fp = fopen(filename, "w");
+  if (fp == NULL) {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(fp, "{\"ncolors\": %d, \"workloads\": [\n", NCOLORS);
+  for (int i = 0; i < count; i++) {
+    struct benchResult *result = results + i;
+    fprintf(fp,
+            "  {\"name\": \"%s\", \"seconds\": %.3f, \"nodes\": %llu, "
+            "\"nodesPerSecond\": %.0f, \"count\": %llu, "
+            "\"peakKilobytes\": %ld}%s\n",
+            result->name, result->seconds, (unsigned long long)result->nodes,
+            result->seconds > 0 ? result->nodes / result->seconds : 0.0,
+            (unsigned long long)result->count, result->peakKilobytes,
+            i + 1 < count ? "," : "");
+  }
+  fprintf(fp, "]}\n");
+  if (fclose(fp) != 0) {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+}
+
+static int readBaseline(const char *filename, struct benchResult *baseline,
+                        int capacity)
+{
+  char line[512];
+  int count = 0;
+  FILE *fp = fopen(filename, "r");
+  if (fp == NULL) {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+  while (count < capacity && fgets(line, sizeof(line), fp) != NULL) {
+    struct benchResult *result = baseline + count;
+    unsigned long long nodes, countField;
+    double nodesPerSecond;
+    if (sscanf(line,
+               " {\"name\": \"%31[^\"]\", \"seconds\": %lf, \"nodes\": %llu, "
+               "\"nodesPerSecond\": %lf, \"count\": %llu, "
+               "\"peakKilobytes\": %ld}",
+               result->name, &result->seconds, &nodes, &nodesPerSecond,
+               &countField, &result->peakKilobytes) == 6) {
+      result->nodes = nodes;
+      result->count = countField;
+      count++;
+    }
+  }
+  fclose(fp);
+  return count;
+}
+
+static bool exceeds(double value, double baseline, double tolerance)
+{
+  return value > baseline * (1 + tolerance);
+}
+
+/* Prints each workload against the baseline, returning false on a
+ * regression. */
+static bool compare(struct benchResult *results, int count,
+                    struct benchResult *baseline, int baselineCount,
+                    double tolerance)
+{
+  bool ok = true;
+  for (int i = 0; i < count; i++) {
+    struct benchResult *result = results + i, *base = NULL;
+    const char *verdict = "ok";
+    for (int j = 0; j < baselineCount; j++) {
+      if (strcmp(baseline[j].name, result->name) == 0) {
+        base = baseline + j;
+      }
+    }
+    if (base == NULL) {
+      printf("%-8s %8.3fs %10ld KB  (not in the baseline)\n", result->name,
+             result->seconds, result->peakKilobytes);
+      continue;
+    }
+    if (exceeds(result->seconds, base->seconds, tolerance) ||
+        exceeds(result->peakKilobytes, base->peakKilobytes, tolerance)) {
+      verdict = "REGRESSION";
+      ok = false;
+    } else if (result->count != base->count) {
+      verdict = "DIFFERENT COUNT";
+      ok = false;
+    }
+    printf("%-8s %8.3fs (%+5.1f%%) %10ld KB (%+5.1f%%) %12llu nodes %s\n",
+           result->name, result->seconds,
+           100 * (result->seconds / base->seconds - 1), result->peakKilobytes,
+           100 * ((double)result->peakKilobytes / base->peakKilobytes - 1),
+           (unsigned long long)result->nodes, verdict);
+  }
+  return ok;
+}
+
+int main(int argc, char *argv[])
+{
+  struct benchResult results[ARRAY_LEN(Workloads)];
+  struct benchResult baseline[ARRAY_LEN(Workloads)];
+  const char *output = NULL, *baselineFile = NULL;
+  double tolerance = DEFAULT_TOLERANCE;
+  int opt;
+  while ((opt = getopt(argc, argv, "o:b:t:")) != -1) {
+    switch (opt) {
+      case 'o':
+        output = optarg;
+        break;
+      case 'b':
+        baselineFile = optarg;
+        break;
+      case 't':
+        tolerance = atof(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "Usage: %s [-o results.json] [-b baseline.json] "
+                "[-t tolerance]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  for (size_t i = 0; i < ARRAY_LEN(Workloads); i++) {
+    runWorkload(i, results + i);
+  }
+  if (output != NULL) {
+    writeResults(output, results, ARRAY_LEN(Workloads));
+  }
+  if (baselineFile == NULL) {
+    for (size_t i = 0; i < ARRAY_LEN(Workloads); i++) {
+      printf("%-8s %8.3fs %10ld KB %12llu nodes %8llu found\n",
+             results[i].name, results[i].seconds, results[i].peakKilobytes,
+             (unsigned long long)results[i].nodes,
+             (unsigned long long)results[i].count);
+    }
+    return EXIT_SUCCESS;
+  }
+  return compare(results, ARRAY_LEN(Workloads), baseline,
+                 readBaseline(baselineFile, baseline, ARRAY_LEN(Workloads)),
+                 tolerance)
+             ? EXIT_SUCCESS
+             : EXIT_FAILURE;
+}
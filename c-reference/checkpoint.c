@@ -0,0 +1,242 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "checkpoint.h"
+
+#include "asyncwriter.h"
+#include "common.h"
+#include "predicates.h"
+#include "solutionindex.h"
+#include "statistics.h"
+
+#include <sys/time.h>
+
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * A checkpoint file is text:
+ *   checkpoint version
+ *   position depth inChoiceMode currentChoice
+ *   path length
+ *   first end predicateName       (one line for each step)
+ *   value name value              (for each of Values)
+ *   index entries
+ * followed by the statistics, as written by statisticWrite.
+ *
+ * Checkpoints are only taken with the Venn predicate on top of the stack:
+ * the predicates after it have side effects, such as writing files, that
+ * replaying would repeat. The position is that of the top of the stack,
+ * and tells us when a replay has got back to where the checkpoint was.
+ */
+#define CHECKPOINT_VERSION 1
+
+extern int FacePredicateRecentSolutionsFound;
+extern int FacePredicateInitialVariationCount;
+
+/* The counters that are not statistics, but that the search depends on. */
+static int *const Values[] = {
+    &PerFaceDegreeSolutionNumberIPC,    &VariationCountIPC,
+    &VariationNumberIPC,                &FacePredicateRecentSolutionsFound,
+    &FacePredicateInitialVariationCount};
+static const char *const ValueNames[] = {"solutionNumber", "variationCount",
+                                         "variationNumber", "logSolutions",
+                                         "logVariations"};
+#define NUMBER_OF_VALUES ((int)(sizeof(Values) / sizeof(Values[0])))
+
+struct position {
+  int depth;
+  int inChoiceMode;
+  int currentChoice;
+};
+
+static STACK CheckpointStack = NULL;
+static const char *CheckpointFile = NULL;
+static volatile int CheckpointRequest = 0;
+static bool Resuming = false;
+/* What we are replaying, which must not change until the replay is over. */
+static struct choicePath ResumePath;
+static struct position ResumePosition;
+static int ResumeValues[NUMBER_OF_VALUES];
+static int ResumeIndexCount = 0;
+static long ResumeStatisticsOffset = 0;
+/* What we are writing. */
+static struct choicePath SavePath;
+
+static void onAlarm(int signal)
+{
+  (void)signal;
+  CheckpointRequest = 1;
+}
+
+static void setTimer(int seconds)
+{
+  struct itimerval timer = {{seconds, 0}, {seconds, 0}};
+  setitimer(ITIMER_REAL, &timer, NULL);
+}
+
+static void malformed(const char *filename)
+{
+  fprintf(stderr, "%s: malformed checkpoint\n", filename);
+  exit(EXIT_FAILURE);
+}
+
+static struct position positionOf(STACK stack)
+{
+  return (struct position){stack->stackTop - stack->stack,
+                           stack->stackTop->inChoiceMode,
+                           stack->stackTop->currentChoice};
+}
+
+static void writeCheckpoint(STACK stack)
+{
+  char temporary[1024];
+  struct position position = positionOf(stack);
+  FILE *fp;
+  /* A resume starts after the files saved so far, so they must be written,
+   * not still queued by -Q. */
+  asyncWriterFinish();
+  snprintf(temporary, sizeof(temporary), "%s.new", CheckpointFile);
+  fp = fopen(temporary, "w");
+  if (fp == NULL) {
+    perror(temporary);
+    exit(EXIT_FAILURE);
+  }
+  engineContinuationPath(stack, &SavePath);
+  fprintf(fp, "checkpoint %d\n", CHECKPOINT_VERSION);
+  fprintf(fp, "position %d %d %d\n", position.depth, position.inChoiceMode,
+          position.currentChoice);
+  fprintf(fp, "path %d\n", SavePath.length);
+  for (int i = 0; i < SavePath.length; i++) {
+    fprintf(fp, "%d %d %s\n", SavePath.steps[i].first, SavePath.steps[i].end,
+            stack->stack[i].predicate->name);
+  }
+  for (int i = 0; i < NUMBER_OF_VALUES; i++) {
+    fprintf(fp, "value %s %d\n", ValueNames[i], *Values[i]);
+  }
+  fprintf(fp, "index %d\n", solutionIndexCount());
+  statisticWrite(fp);
+  /* Replace the old checkpoint only once the new one is complete. */
+  if (fclose(fp) != 0 || rename(temporary, CheckpointFile) != 0) {
+    perror(CheckpointFile);
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void readCheckpoint(const char *filename)
+{
+  int version;
+  char name[32];
+  FILE *fp = fopen(filename, "r");
+  if (fp == NULL) {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+  if (fscanf(fp, "checkpoint %d position %d %d %d path %d", &version,
+             &ResumePosition.depth, &ResumePosition.inChoiceMode,
+             &ResumePosition.currentChoice, &ResumePath.length) != 5 ||
+      version != CHECKPOINT_VERSION || ResumePath.length < 0 ||
+      ResumePath.length > MAX_STACK_SIZE) {
+    malformed(filename);
+  }
+  for (int i = 0; i < ResumePath.length; i++) {
+    if (fscanf(fp, "%d %d %*s", &ResumePath.steps[i].first,
+               &ResumePath.steps[i].end) != 2) {
+      malformed(filename);
+    }
+  }
+  for (int i = 0; i < NUMBER_OF_VALUES; i++) {
+    if (fscanf(fp, " value %31s %d", name, &ResumeValues[i]) != 2 ||
+        strcmp(name, ValueNames[i]) != 0) {
+      malformed(filename);
+    }
+  }
+  if (fscanf(fp, " index %d", &ResumeIndexCount) != 1) {
+    malformed(filename);
+  }
+  /* The statistics are read once the replay has registered them. */
+  ResumeStatisticsOffset = ftell(fp);
+  fclose(fp);
+}
+
+static void restoreCounters(void)
+{
+  struct statisticTotals *totals = statisticTotalsCreate();
+  FILE *fp = fopen(CheckpointFile, "r");
+  if (fp == NULL || fseek(fp, ResumeStatisticsOffset, SEEK_SET) != 0 ||
+      !statisticReadInto(fp, totals)) {
+    malformed(CheckpointFile);
+  }
+  fclose(fp);
+  statisticSetFrom(totals);
+  statisticTotalsFree(totals);
+  for (int i = 0; i < NUMBER_OF_VALUES; i++) {
+    *Values[i] = ResumeValues[i];
+  }
+}
+
+static void onCheckpointRequest(STACK stack)
+{
+  if (stack != CheckpointStack) {
+    return;
+  }
+  if (Resuming) {
+    struct position position = positionOf(stack);
+    if (memcmp(&position, &ResumePosition, sizeof(position)) == 0) {
+      restoreCounters();
+      Resuming = false;
+      CheckpointRequest = 0;
+      setTimer(CHECKPOINT_SECONDS);
+    }
+    return;
+  }
+  if (stack->stackTop->predicate != &VennPredicate) {
+    /* Try again at the next step. */
+    return;
+  }
+  writeCheckpoint(stack);
+  CheckpointRequest = 0;
+}
+
+void checkpointStart(STACK stack, const char *filename, bool resume)
+{
+  struct sigaction action;
+  CheckpointStack = stack;
+  CheckpointFile = filename;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = onAlarm;
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGALRM, &action, NULL);
+  enginePollWith(&CheckpointRequest, onCheckpointRequest);
+  if (resume) {
+    readCheckpoint(filename);
+    Resuming = true;
+    /* Look at every step until the replay is complete. */
+    CheckpointRequest = 1;
+  } else {
+    setTimer(CHECKPOINT_SECONDS);
+  }
+}
+
+const struct choicePath *checkpointPath(void)
+{
+  return Resuming ? &ResumePath : NULL;
+}
+
+int checkpointSolutionIndexCount(void)
+{
+  return Resuming ? ResumeIndexCount : 0;
+}
+
+void checkpointFinish(void)
+{
+  setTimer(0);
+  enginePollWith(NULL, NULL);
+  if (Resuming) {
+    fprintf(stderr, "%s: not a checkpoint of this search\n", CheckpointFile);
+    exit(EXIT_FAILURE);
+  }
+  unlink(CheckpointFile);
+}
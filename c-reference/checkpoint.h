@@ -0,0 +1,37 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "engine.h"
+
+/**
+ * Checkpoints for long serial runs. Every so often, between Venn choices,
+ * the choices that lead to the current point of the search are written to a
+ * checkpoint file, together with the counters. A later run resumes by
+ * replaying those choices, which, since the search is deterministic,
+ * rebuilds the DYNAMIC state without needing the trail, and then restores
+ * the counters and carries on. Solutions found between the last checkpoint
+ * and the interruption are found, and saved, again.
+ */
+
+/* Seconds between checkpoints */
+#define CHECKPOINT_SECONDS 60
+
+/**
+ * Starts checkpointing the search on stack to filename. If resuming, the
+ * checkpoint in filename is read, and the next run of stack must be with
+ * engineReplay(stack, program, checkpointPath()).
+ */
+extern void checkpointStart(STACK stack, const char *filename, bool resume);
+
+/* The choices to replay when resuming, or NULL when starting afresh */
+extern const struct choicePath *checkpointPath(void);
+
+/* The number of solution index entries to keep when resuming */
+extern int checkpointSolutionIndexCount(void);
+
+/* Stops checkpointing once the search is complete, removing the file */
+extern void checkpointFinish(void);
+
+#endif  // CHECKPOINT_H
@@ -0,0 +1,381 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 700
+
+#include "classindex.h"
+
+#include "statistics.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define INDEX_SUFFIX ".classes"
+#define INDEX_MAGIC "VENNCLS1"
+#define MAX_NAME 62
+
+struct classIndexHeader {
+  char magic[8];
+  uint32_t colors;
+  uint32_t count;
+};
+
+struct classIndexEntry {
+  uint16_t faceCycleId[NFACES];
+  uint8_t offset;
+  uint8_t reflected;
+  char name[MAX_NAME];
+};
+
+/* An entry being folded, from a pending file or from the index */
+struct foldEntry {
+  struct classIndexEntry entry;
+  bool pending;
+};
+
+struct rename {
+  char from[MAX_NAME];
+  char to[MAX_NAME];
+};
+
+static void *MappedBase = NULL;
+static size_t MappedSize = 0;
+static const struct classIndexEntry *Mapped = NULL;
+static uint32_t MappedCount = 0;
+
+/* The classes saved by this process, sorted */
+static struct classIndexEntry *Saved = NULL;
+static uint32_t SavedCount = 0, SavedCapacity = 0;
+static FILE *PendingFile = NULL;
+
+static struct rename *Renames = NULL;
+static uint32_t RenameCount = 0, RenameCapacity = 0;
+
+static uint64 KnownClassCounter = 0;
+
+static void *growArray(void *array, uint32_t *capacity, size_t size)
+{
+  *capacity = *capacity == 0 ? 64 : 2 * *capacity;
+  array = realloc(array, *capacity * size);
+  if (array == NULL) {
+    perror("realloc");
+    exit(EXIT_FAILURE);
+  }
+  return array;
+}
+
+static int compareEntries(const void *a, const void *b)
+{
+  const struct classIndexEntry *x = a, *y = b;
+  return memcmp(x->faceCycleId, y->faceCycleId, sizeof(x->faceCycleId));
+}
+
+static void entryFromSignature(struct classIndexEntry *entry,
+                               SIGNATURE classSignature)
+{
+  memset(entry, 0, sizeof(*entry));
+  for (int i = 0; i < NFACES; i++) {
+    entry->faceCycleId[i] =
+        (uint16_t)classSignature->classSignature.faceCycleId[i];
+  }
+  entry->offset = (uint8_t)classSignature->offset;
+  entry->reflected = classSignature->reflected;
+}
+
+static void indexPath(char *path, size_t size, const char *folder)
+{
+  snprintf(path, size, "%s/" INDEX_SUFFIX, folder);
+}
+
+/* Checks the header, returning the number of entries */
+static uint32_t checkHeader(const char *path, const void *data, size_t size)
+{
+  const struct classIndexHeader *header = data;
+  if (size < sizeof(*header) ||
+      memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+      header->colors != NCOLORS ||
+      size !=
+          sizeof(*header) + header->count * sizeof(struct classIndexEntry)) {
+    fprintf(stderr, "%s: not a class index for %d colors\n", path, NCOLORS);
+    exit(EXIT_FAILURE);
+  }
+  return header->count;
+}
+
+void classIndexOpen(const char *folder)
+{
+  char path[1024];
+  struct stat st;
+  int fd;
+  statisticIncludeInteger(&KnownClassCounter, "K", "known classes", false);
+  indexPath(path, sizeof(path), folder);
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return;
+    }
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  if (fstat(fd, &st) != 0) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  MappedSize = st.st_size;
+  if (MappedSize < sizeof(struct classIndexHeader)) {
+    checkHeader(path, NULL, MappedSize);
+  }
+  MappedBase = mmap(NULL, MappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (MappedBase == MAP_FAILED) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  MappedCount = checkHeader(path, MappedBase, MappedSize);
+  Mapped = (const void *)((const char *)MappedBase +
+                          sizeof(struct classIndexHeader));
+}
+
+void classIndexPending(const char *folder, const char *tag)
+{
+  char path[1024];
+  if (PendingFile != NULL) {
+    fclose(PendingFile);
+  }
+  snprintf(path, sizeof(path), "%s/.%s" INDEX_SUFFIX, folder, tag);
+  PendingFile = fopen(path, "a");
+  if (PendingFile == NULL) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+}
+
+void classIndexClose(void)
+{
+  if (PendingFile != NULL) {
+    fclose(PendingFile);
+    PendingFile = NULL;
+  }
+  if (MappedBase != NULL) {
+    munmap(MappedBase, MappedSize);
+    MappedBase = NULL;
+    Mapped = NULL;
+    MappedCount = 0;
+  }
+  free(Saved);
+  Saved = NULL;
+  SavedCount = SavedCapacity = 0;
+}
+
+bool classIndexContains(SIGNATURE classSignature)
+{
+  struct classIndexEntry key;
+  entryFromSignature(&key, classSignature);
+  if ((Mapped != NULL && bsearch(&key, Mapped, MappedCount, sizeof(key),
+                                 compareEntries) != NULL) ||
+      (Saved != NULL && bsearch(&key, Saved, SavedCount, sizeof(key),
+                                compareEntries) != NULL)) {
+    KnownClassCounter++;
+    return true;
+  }
+  return false;
+}
+
+void classIndexAdd(SIGNATURE classSignature, const char *name)
+{
+  struct classIndexEntry entry;
+  uint32_t i;
+  entryFromSignature(&entry, classSignature);
+  snprintf(entry.name, sizeof(entry.name), "%s", name);
+  if (PendingFile != NULL &&
+      (fwrite(&entry, sizeof(entry), 1, PendingFile) != 1 ||
+       fflush(PendingFile) != 0)) {
+    perror("class index");
+    exit(EXIT_FAILURE);
+  }
+  if (SavedCount == SavedCapacity) {
+    Saved = growArray(Saved, &SavedCapacity, sizeof(*Saved));
+  }
+  for (i = SavedCount; i > 0 && compareEntries(Saved + i - 1, &entry) > 0;
+       i--) {
+    Saved[i] = Saved[i - 1];
+  }
+  Saved[i] = entry;
+  SavedCount++;
+}
+
+void classIndexRename(const char *from, const char *to)
+{
+  if (RenameCount == RenameCapacity) {
+    Renames = growArray(Renames, &RenameCapacity, sizeof(*Renames));
+  }
+  memset(Renames + RenameCount, 0, sizeof(*Renames));
+  snprintf(Renames[RenameCount].from, MAX_NAME, "%s", from);
+  snprintf(Renames[RenameCount].to, MAX_NAME, "%s", to);
+  RenameCount++;
+}
+
+/* By class, with the index first, and then pending entries in the order of
+ * a serial search: by face degrees descending, then by number. */
+static int compareFoldEntries(const void *a, const void *b)
+{
+  const struct foldEntry *x = a, *y = b;
+  const char *xNumber = strrchr(x->entry.name, '-');
+  const char *yNumber = strrchr(y->entry.name, '-');
+  int result = compareEntries(&x->entry, &y->entry);
+  if (result != 0 || (result = x->pending - y->pending) != 0) {
+    return result;
+  }
+  if (xNumber == NULL || yNumber == NULL ||
+      xNumber - x->entry.name != yNumber - y->entry.name) {
+    return strcmp(x->entry.name, y->entry.name);
+  }
+  result = strncmp(y->entry.name, x->entry.name, xNumber - x->entry.name);
+  return result != 0 ? result : atoi(xNumber + 1) - atoi(yNumber + 1);
+}
+
+static int removeEntry(const char *path, const struct stat *st, int flag,
+                       struct FTW *ftw)
+{
+  (void)st;
+  (void)flag;
+  (void)ftw;
+  return remove(path);
+}
+
+/* Removes a solution, and its variations, saved in a class saved before. */
+static void removeSolution(const char *folder, const char *name)
+{
+  char path[1024];
+  struct stat st;
+  snprintf(path, sizeof(path), "%s/%s.txt", folder, name);
+  if (unlink(path) != 0 && errno != ENOENT) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  snprintf(path, sizeof(path), "%s/%s", folder, name);
+  if (stat(path, &st) == 0) {
+    nftw(path, removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+  }
+}
+
+/* Appends the entries of the file at path to entries, returning the count */
+static uint32_t readEntries(const char *path, bool isIndex,
+                            struct foldEntry **entries, uint32_t count,
+                            uint32_t *capacity)
+{
+  struct classIndexHeader header;
+  struct classIndexEntry entry;
+  FILE *fp = fopen(path, "r");
+  if (fp == NULL) {
+    if (isIndex && errno == ENOENT) {
+      return count;
+    }
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  if (isIndex && fread(&header, sizeof(header), 1, fp) != 1) {
+    fprintf(stderr, "%s: not a class index\n", path);
+    exit(EXIT_FAILURE);
+  }
+  while (fread(&entry, sizeof(entry), 1, fp) == 1) {
+    if (count == *capacity) {
+      *entries = growArray(*entries, capacity, sizeof(**entries));
+    }
+    entry.name[MAX_NAME - 1] = '\0';
+    for (uint32_t i = 0; !isIndex && i < RenameCount; i++) {
+      if (strcmp(entry.name, Renames[i].from) == 0) {
+        memcpy(entry.name, Renames[i].to, MAX_NAME);
+        break;
+      }
+    }
+    (*entries)[count].entry = entry;
+    (*entries)[count++].pending = !isIndex;
+  }
+  fclose(fp);
+  return count;
+}
+
+static void writeIndex(const char *folder, struct foldEntry *entries,
+                       uint32_t count)
+{
+  char path[1024], temporary[1024];
+  struct classIndexHeader header;
+  FILE *fp;
+  memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+  header.colors = NCOLORS;
+  header.count = count;
+  indexPath(path, sizeof(path), folder);
+  snprintf(temporary, sizeof(temporary), "%s/" INDEX_SUFFIX ".tmp", folder);
+  fp = fopen(temporary, "w");
+  if (fp == NULL || fwrite(&header, sizeof(header), 1, fp) != 1) {
+    perror(temporary);
+    exit(EXIT_FAILURE);
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if (fwrite(&entries[i].entry, sizeof(entries[i].entry), 1, fp) != 1) {
+      perror(temporary);
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (fclose(fp) != 0 || rename(temporary, path) != 0) {
+    perror(temporary);
+    exit(EXIT_FAILURE);
+  }
+}
+
+void classIndexFold(const char *folder)
+{
+  struct foldEntry *entries = NULL;
+  uint32_t count = 0, capacity = 0, kept = 0;
+  size_t suffixLength = strlen(INDEX_SUFFIX);
+  bool pending = false;
+  char path[1024];
+  struct dirent *dirEntry;
+  DIR *dir = opendir(folder);
+  if (dir == NULL) {
+    perror(folder);
+    exit(EXIT_FAILURE);
+  }
+  while ((dirEntry = readdir(dir)) != NULL) {
+    size_t length = strlen(dirEntry->d_name);
+    if (dirEntry->d_name[0] == '.' && length > suffixLength + 1 &&
+        strcmp(dirEntry->d_name + length - suffixLength, INDEX_SUFFIX) == 0) {
+      snprintf(path, sizeof(path), "%s/%s", folder, dirEntry->d_name);
+      count = readEntries(path, false, &entries, count, &capacity);
+      unlink(path);
+      pending = true;
+    }
+  }
+  closedir(dir);
+  if (pending) {
+    indexPath(path, sizeof(path), folder);
+    count = readEntries(path, true, &entries, count, &capacity);
+    qsort(entries, count, sizeof(*entries), compareFoldEntries);
+    for (uint32_t i = 0; i < count; i++) {
+      if (kept == 0 ||
+          compareEntries(&entries[kept - 1].entry, &entries[i].entry) != 0) {
+        entries[kept++] = entries[i];
+      } else if (entries[i].pending &&
+                 strcmp(entries[kept - 1].entry.name, entries[i].entry.name) !=
+                     0) {
+        /* Saved by another worker or shard, that did not know of the first */
+        removeSolution(folder, entries[i].entry.name);
+      }
+    }
+    writeIndex(folder, entries, kept);
+  }
+  free(entries);
+  free(Renames);
+  Renames = NULL;
+  RenameCount = RenameCapacity = 0;
+}
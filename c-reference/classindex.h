@@ -0,0 +1,41 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef CLASSINDEX_H
+#define CLASSINDEX_H
+
+#include "s6.h"
+
+/**
+ * An index of the classes already saved in an output folder, kept across
+ * runs with -u. The index is a binary file, .classes, of the class
+ * signatures, with the offset, reflection and name of the solution saved
+ * for each, sorted so that it can be searched where it is mapped. A run
+ * appends the classes it saves to a pending file, named with a tag, in the
+ * same format but unsorted; the pending files are folded into the index at
+ * the end of a serial or parallel run, or by the merge of shards, keeping
+ * the first solution of each class, in the order of a serial search, and
+ * removing the others, saved by workers or shards that could not know of it.
+ */
+
+/* Maps the index of folder, if it has one. */
+extern void classIndexOpen(const char *folder);
+
+/* Appends the classes saved from now on to a pending file, named with tag. */
+extern void classIndexPending(const char *folder, const char *tag);
+
+/* Closes the pending file and unmaps the index. */
+extern void classIndexClose(void);
+
+/* Whether the class is in the index, or has been saved by this process. */
+extern bool classIndexContains(SIGNATURE classSignature);
+
+/* Records that the class has been saved under name, within the folder. */
+extern void classIndexAdd(SIGNATURE classSignature, const char *name);
+
+/* Records that the solution saved as from is now named to. */
+extern void classIndexRename(const char *from, const char *to);
+
+/* Folds the pending files of folder into its index, if there are any. */
+extern void classIndexFold(const char *folder);
+
+#endif  // CLASSINDEX_H
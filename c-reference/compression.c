@@ -0,0 +1,117 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "compression.h"
+
+#include "common.h"
+#include "statistics.h"
+#include "stream.h"
+
+#include <sys/stat.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+static char Mode[4];
+static uint64 GraphmlBytes = 0;
+static uint64 CompressedBytes = 0;
+static uint64 CompressionMicroseconds = 0;
+
+/* This thread's shards of the above, since with -Q the writer compresses. */
+static _Thread_local uint64 *GraphmlBytesShard = NULL;
+static _Thread_local uint64 *CompressedBytesShard = NULL;
+static _Thread_local uint64 *MicrosecondsShard = NULL;
+
+struct gzipStream {
+  gzFile gz;
+  struct timespec opened;
+  char filename[];
+};
+
+static uint64 microsecondsSince(const struct timespec *start)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * 1000000ull +
+         (now.tv_nsec - start->tv_nsec) / 1000;
+}
+
+static int gzipWrite(void *cookie, const char *buffer, int size)
+{
+  struct gzipStream *stream = cookie;
+  int written = gzwrite(stream->gz, buffer, size);
+  if (written <= 0) {
+    return -1;
+  }
+  statisticShardAdd(GraphmlBytesShard, written);
+  return written;
+}
+
+static int gzipClose(void *cookie)
+{
+  struct gzipStream *stream = cookie;
+  struct stat st;
+  int result = gzclose(stream->gz) == Z_OK ? 0 : EOF;
+  if (result == 0 && stat(stream->filename, &st) == 0) {
+    statisticShardAdd(CompressedBytesShard, st.st_size);
+  }
+  statisticShardAdd(MicrosecondsShard, microsecondsSince(&stream->opened));
+  free(stream);
+  return result;
+}
+
+void compressionStart(int level)
+{
+  assert(level >= 1 && level <= MAX_COMPRESSION_LEVEL);
+  sprintf(Mode, "wb%d", level);
+  GraphmlFileOps.fopen = compressionFopen;
+  statisticIncludeInteger(&GraphmlBytes, "X", "GraphML bytes", false);
+  statisticIncludeInteger(&CompressedBytes, "Z", "compressed bytes", false);
+  statisticIncludeInteger(&CompressionMicroseconds, "z", "compression us",
+                          true);
+}
+
+FILE *compressionFopen(const char *filename, const char *mode)
+{
+  size_t length = strlen(filename);
+  struct gzipStream *stream = malloc(sizeof(*stream) + length + 4);
+  assert(strcmp(mode, "w") == 0);
+  (void)mode;
+  if (stream == NULL) {
+    perror("malloc");
+    exit(EXIT_FAILURE);
+  }
+  if (GraphmlBytesShard == NULL) {
+    GraphmlBytesShard = statisticShard(&GraphmlBytes);
+    CompressedBytesShard = statisticShard(&CompressedBytes);
+    MicrosecondsShard = statisticShard(&CompressionMicroseconds);
+  }
+  sprintf(stream->filename, "%s.gz", filename);
+  clock_gettime(CLOCK_MONOTONIC, &stream->opened);
+  stream->gz = gzopen(stream->filename, Mode);
+  if (stream->gz == NULL) {
+    perror(stream->filename);
+    exit(EXIT_FAILURE);
+  }
+  return streamOpen(stream, gzipWrite, gzipClose);
+}
+
+void compressionPrintSummary(FILE *fp)
+{
+  uint64 graphmlBytes = statisticValue(&GraphmlBytes);
+  uint64 compressedBytes = statisticValue(&CompressedBytes);
+  uint64 microseconds = statisticValue(&CompressionMicroseconds);
+  if (compressedBytes == 0) {
+    return;
+  }
+  fprintf(fp, "%30s %30.2f\n", "compression ratio",
+          (double)graphmlBytes / compressedBytes);
+  if (microseconds > 0) {
+    /* Bytes per microsecond are megabytes per second. */
+    fprintf(fp, "%30s %30.2f\n", "GraphML MB/s",
+            (double)graphmlBytes / microseconds);
+  }
+}
@@ -0,0 +1,27 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <stdio.h>
+
+/**
+ * Writing the GraphML files through gzip (-z level). The hook is
+ * GraphmlFileOps.fopen: each file is opened as a stream that compresses what
+ * graphml.c prints into it, and is named with a further .gz. The bytes of
+ * GraphML, the bytes written, and the time taken, are counted in the
+ * statistics, and so summed across worker and writer processes.
+ */
+
+#define MAX_COMPRESSION_LEVEL 9
+
+/* Compresses GraphML at the given level, from 1, fastest, to 9, smallest. */
+extern void compressionStart(int level);
+
+/* Opens filename.gz, for writing through gzip. */
+extern FILE *compressionFopen(const char *filename, const char *mode);
+
+/* Prints the compression ratio and throughput after the statistics. */
+extern void compressionPrintSummary(FILE *fp);
+
+#endif  // COMPRESSION_H
@@ -21,10 +21,13 @@
  * Fundamental Constants
  *--------------------------------------*/
 
-/* The curves are _colored_ from 0 to 5. */
+/* The curves are _colored_ from 0 to 5, or up to 6 with -DNCOLORS=7. */
 #ifndef NCOLORS
 #define NCOLORS 6 /* Number of colors/curves in the diagram */
 #endif
+#if NCOLORS < 2 || NCOLORS > 7
+#error "NCOLORS must be from 2 to 7"
+#endif
 
 /* Mathematical constants for combinatorial calculations */
 #define FACTORIAL0 1u
@@ -34,8 +37,14 @@
 #define FACTORIAL4 24u
 #define FACTORIAL5 120u
 #define FACTORIAL6 720u
+#define FACTORIAL7 5040u
 
 /* Binomial coefficients for combinatorial calculations */
+#define CHOOSE_7_0 1u
+#define CHOOSE_7_1 7u
+#define CHOOSE_7_2 21u
+#define CHOOSE_7_3 35u
+#define CHOOSE_7_4 35u
 #define CHOOSE_6_0 1u
 #define CHOOSE_6_1 6u
 #define CHOOSE_6_2 15u
@@ -61,7 +70,15 @@
   (CHOOSE_5_0 * FACTORIAL4 + CHOOSE_5_1 * FACTORIAL3 + CHOOSE_5_2 * FACTORIAL2)
 
 /* Configure cycle counts based on NCOLORS value */
-#if NCOLORS == 6
+#if NCOLORS == 7
+#define NCYCLES                                                    \
+  (CHOOSE_7_0 * FACTORIAL6 + CHOOSE_7_1 * FACTORIAL5 +             \
+   CHOOSE_7_2 * FACTORIAL4 + CHOOSE_7_3 * FACTORIAL3 + CHOOSE_7_4 * FACTORIAL2)
+#define NCYCLE_ENTRIES                                             \
+  (CHOOSE_7_0 * FACTORIAL6 * 7 + CHOOSE_7_1 * FACTORIAL5 * 6 +     \
+   CHOOSE_7_2 * FACTORIAL4 * 5 + CHOOSE_7_3 * FACTORIAL3 * 4 +     \
+   CHOOSE_7_4 * FACTORIAL2 * 3)
+#elif NCOLORS == 6
 #define NCYCLES                                        \
   (CHOOSE_6_0 * FACTORIAL5 + CHOOSE_6_1 * FACTORIAL4 + \
    CHOOSE_6_2 * FACTORIAL3 + CHOOSE_6_3 * FACTORIAL2)
@@ -84,6 +101,9 @@
 #define BITS_PER_WORD (sizeof(void *) * 8)
 #define CYCLESET_LENGTH ((NCYCLES - 1) / BITS_PER_WORD + 1)
 
+/* Sets of faces, in words of BITS_PER_WORD bits: two words for NCOLORS=7 */
+#define FACESET_LENGTH ((NFACES - 1) / BITS_PER_WORD + 1)
+
 /* Maximum number of vertices in the diagram */
 #define NPOINTS ((1 << (NCOLORS - 2)) * NCOLORS * (NCOLORS - 1))
 
@@ -1,7 +1,9 @@
 /* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
 
 #include "common.h"
+#include "cornerseek.h"
 #include "face.h"
+#include "geometry.h"
 #include "main.h"
 #include "predicates.h"
 #include "triangles.h"
@@ -11,31 +13,58 @@
 
 DYNAMIC EDGE SelectedCornersIPC[NCOLORS][3];
 
-static DYNAMIC EDGE PossibleCorners[NCOLORS][3][NFACES];
+/* With -j, the choices, by round, of the first variant not skipped, and how
+ * many of the rounds the search has yet to move on from them in. */
+static int SeekChoices[NCOLORS * 3];
+static int SeekRounds = 0;
 
 /**
- * Count the number of edges in a null-terminated array
+ * With -j, starts the variants of a solution at the first not skipped,
+ * numbering it as if those before it had been found. So that the last
+ * variant numbered is the same as before, it skips no further than the -n
+ * maximum, beyond which no variant is found anyway. Returns false if every
+ * variant is skipped.
  */
-static int edgeArrayLength(EDGE* edges)
+static bool seekFirstVariant(void)
 {
-  int count = 0;
-  while (edges[count] != NULL) {
-    count++;
+  int skip = IgnoreFirstVariantsPerSolution < MaxVariantsPerSolutionFlag
+                 ? IgnoreFirstVariantsPerSolution
+                 : MaxVariantsPerSolutionFlag;
+  int skipped;
+  SeekRounds = 0;
+  if (skip <= 0 || VariationNumberIPC != 1) {
+    return true;
   }
-  return count;
+  skipped = cornerSeek(skip, SeekChoices);
+  if (skipped < 0) {
+    return true;
+  }
+  VariationNumberIPC += skipped;
+  if (skipped < skip) {
+    return false;
+  }
+  SeekRounds = NCOLORS * 3;
+  return true;
 }
 
-static void dynamicPossibleCorners(EDGE* possibilitiesReturn, COLOR color,
-                                   EDGE from, EDGE to)
+/**
+ * The edges of the triangle path of color that are, or may yet be, corners:
+ * the corners chosen so far, and every possibility for those still NULL.
+ */
+static uint64 cornerBoundaries(const struct solutionGeometry* geometry,
+                               COLOR color)
 {
-  if (from == NULL) {
-    EDGE edge = vertexGetCentralEdge(color);
-    dynamicEdgePathAndLength(edge->reversed,
-                             edgeFollowBackwards(edge->reversed),
-                             possibilitiesReturn);
-  } else {
-    dynamicEdgePathAndLength(from->reversed, to, possibilitiesReturn);
+  uint64 boundaries = 0;
+  for (int i = 0; i < 3; i++) {
+    EDGE selected = SelectedCornersIPC[color][i];
+    for (int j = 0; j < geometry->possibleCornerCounts[color][i]; j++) {
+      if (selected == NULL ||
+          geometry->possibleCorners[color][i][j] == selected) {
+        boundaries |= geometry->possibleCornerBits[color][i][j];
+      }
+    }
   }
+  return boundaries;
 }
 
 /**
@@ -43,17 +72,22 @@ static void dynamicPossibleCorners(EDGE* possibilitiesReturn, COLOR color,
  *
  * For rounds 3, 6, 9, 12, 15 and 18 - we verify the previous colors corner
  * assignment, On round 18 then we simply succeed - we are now done. For rounds
- * 0 -> 17 we set up choosing between the possible corners.
+ * 0 -> 17 we set up choosing between the possible corners, first checking
+ * that the corner just chosen, with the others of its color, does not force
+ * lines to cross.
  *
  * @param round Incrementing number encoding color and corner index, from 0 to
  * 18 inclusive.
  */
 static struct predicateResult dynamicTryCorners(int round)
 {
-  EDGE cornerPairs[3][2];
+  const struct solutionGeometry* geometry = dynamicSolutionGeometry();
   int cornerIndex = round % 3;
   int colorIndex = round / 3;
 
+  if (round == 0 && !seekFirstVariant()) {
+    return PredicateFail;
+  }
   if (VariationNumberIPC > MaxVariantsPerSolutionFlag) {
     return PredicateFail;
   }
@@ -67,12 +101,14 @@ static struct predicateResult dynamicTryCorners(int round)
   if (colorIndex >= NCOLORS) {
     return PredicateSuccessNextPredicate;
   }
-  vertexAlignCorners(colorIndex, cornerPairs);
-  dynamicPossibleCorners(PossibleCorners[colorIndex][cornerIndex], colorIndex,
-                         cornerPairs[cornerIndex][0],
-                         cornerPairs[cornerIndex][1]);
+  if (cornerIndex > 0 &&
+      SelectedCornersIPC[colorIndex][cornerIndex - 1] != NULL &&
+      !dynamicTriangleLinesNotCrossedBetween(
+          colorIndex, cornerBoundaries(geometry, colorIndex))) {
+    return PredicateFail;
+  }
   return predicateChoices(
-      edgeArrayLength(PossibleCorners[colorIndex][cornerIndex]));
+      geometry->possibleCornerCounts[colorIndex][cornerIndex]);
 }
 
 /**
@@ -82,8 +118,19 @@ static struct predicateResult dynamicRetryCorners(int round, int choice)
 {
   int cornerIndex = round % 3;
   int colorIndex = round / 3;
-  TRAIL_SET_POINTER(&SelectedCornersIPC[colorIndex][cornerIndex],
-                    PossibleCorners[colorIndex][cornerIndex][choice]);
+  if (round < SeekRounds) {
+    if (choice < SeekChoices[round]) {
+      return PredicateFail;
+    }
+    if (choice > SeekChoices[round]) {
+      /* Past the first variant not skipped: the deeper rounds start over. */
+      SeekRounds = round;
+    }
+  }
+  TRAIL_SET_POINTER(
+      &SelectedCornersIPC[colorIndex][cornerIndex],
+      dynamicSolutionGeometry()->possibleCorners[colorIndex][cornerIndex]
+                                                [choice]);
   return PredicateSuccessSamePredicate;
 }
 
@@ -0,0 +1,234 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "cornerseek.h"
+
+#include "geometry.h"
+#include "vertex.h"
+
+#include <string.h>
+
+#define SEEK_WORDS (MAX_SEEK_CHOICES / 64)
+
+/* A set of choices of the three corners of one color, as bits. */
+typedef uint64 CHOICE_SET[SEEK_WORDS];
+
+/* For each color, the number of choices of its three corners. */
+static int ChoiceCounts[NCOLORS];
+/* For each color and choice, the line of the triangle through each vertex
+ * of the path, or -1 where three corners meet and no line is drawn. */
+static signed char Lines[NCOLORS][MAX_SEEK_CHOICES][NFACES];
+/* For each color and choice, how many corners are at each edge of the path. */
+static unsigned char CornerCounts[NCOLORS][MAX_SEEK_CHOICES][NFACES];
+/* For each color, each earlier color, and each choice of the first, the
+ * choices of the second that can be drawn with it. */
+static CHOICE_SET Compatible[NCOLORS][NCOLORS][MAX_SEEK_CHOICES];
+
+/* The corner, of each of the three, that a choice is made of: the first
+ * corner varies the slowest, as the search chooses it first. */
+static void choiceDigits(const struct solutionGeometry *geometry, COLOR color,
+                         int choice, int digits[3])
+{
+  for (int i = 2; i >= 0; i--) {
+    digits[i] = choice % geometry->possibleCornerCounts[color][i];
+    choice /= geometry->possibleCornerCounts[color][i];
+  }
+}
+
+/* As dynamicTriangleLinesNotCrossed, the line through each vertex. */
+static void findLines(const struct solutionGeometry *geometry, COLOR color,
+                      int choice)
+{
+  int digits[3];
+  int line = 0;
+  signed char *lines = Lines[color][choice];
+  unsigned char *corners = CornerCounts[color][choice];
+  choiceDigits(geometry, color, choice, digits);
+  memset(corners, 0, NFACES);
+  for (int i = 0; i < 3; i++) {
+    uint64 bit = geometry->possibleCornerBits[color][i][digits[i]];
+    if (bit != 0) {
+      corners[__builtin_ctzll(bit)]++;
+    }
+  }
+  for (int position = 0; position < geometry->pathLengths[color];
+       position++) {
+    if (corners[position] == 3) {
+      lines[position] = -1;
+      continue;
+    }
+    line = (line + corners[position]) % 3;
+    lines[position] = line;
+  }
+}
+
+/**
+ * As dynamicTriangleLinesNotCrossed for color, with only the vertices labelled
+ * by the lines of other, at shared, for each vertex of the path of color, its
+ * position on the path of other, or -1.
+ */
+static bool linesNotCrossed(const struct solutionGeometry *geometry,
+                            COLOR color, int choice, COLOR other,
+                            int otherChoice, const int *shared)
+{
+  uint64 linesCrossed = 0;
+  uint64 initialLinesCrossed = 0;
+  bool first = true;
+  const unsigned char *corners = CornerCounts[color][choice];
+  const signed char *otherLines = Lines[other][otherChoice];
+  for (int position = 0; position < geometry->pathLengths[color];
+       position++) {
+    int line;
+    if (corners[position] > 0) {
+      if (first) {
+        initialLinesCrossed = linesCrossed;
+        first = false;
+      }
+      linesCrossed = 0;
+      if (corners[position] == 3) {
+        continue;
+      }
+    }
+    if (shared[position] < 0 || (line = otherLines[shared[position]]) < 0) {
+      continue;
+    }
+    if (linesCrossed & (1ull << line)) {
+      return false;
+    }
+    linesCrossed |= 1ull << line;
+  }
+  return (linesCrossed & initialLinesCrossed) == 0;
+}
+
+/* The position of each vertex of the path of color on the path of other. */
+static void findShared(const struct solutionGeometry *geometry, COLOR color,
+                       COLOR other, int *shared)
+{
+  for (int position = 0; position < geometry->pathLengths[color];
+       position++) {
+    VERTEX vertex = edgeVertex(geometry->paths[color][position]);
+    shared[position] = -1;
+    for (int ix = 0; ix < geometry->pathLengths[other]; ix++) {
+      if (edgeVertex(geometry->paths[other][ix]) == vertex) {
+        shared[position] = ix;
+        break;
+      }
+    }
+  }
+}
+
+static bool buildTables(void)
+{
+  const struct solutionGeometry *geometry = dynamicSolutionGeometry();
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    ChoiceCounts[color] = 1;
+    for (int i = 0; i < 3; i++) {
+      ChoiceCounts[color] *= geometry->possibleCornerCounts[color][i];
+      if (ChoiceCounts[color] > MAX_SEEK_CHOICES) {
+        return false;
+      }
+    }
+    for (int choice = 0; choice < ChoiceCounts[color]; choice++) {
+      findLines(geometry, color, choice);
+    }
+  }
+  for (COLOR color = 1; color < NCOLORS; color++) {
+    for (COLOR other = 0; other < color; other++) {
+      int shared[NFACES];
+      findShared(geometry, color, other, shared);
+      for (int choice = 0; choice < ChoiceCounts[color]; choice++) {
+        uint64 *compatible = Compatible[color][other][choice];
+        memset(compatible, 0, sizeof(CHOICE_SET));
+        for (int otherChoice = 0; otherChoice < ChoiceCounts[other];
+             otherChoice++) {
+          if (linesNotCrossed(geometry, color, choice, other, otherChoice,
+                              shared)) {
+            compatible[otherChoice / 64] |= 1ull << (otherChoice % 64);
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+/* Restricts the choices of the later colors to those compatible with the
+ * choice for color. */
+static void restrictChoices(COLOR color, int choice,
+                            CHOICE_SET candidates[NCOLORS],
+                            CHOICE_SET restricted[NCOLORS])
+{
+  for (COLOR later = color + 1; later < NCOLORS; later++) {
+    for (int w = 0; w < SEEK_WORDS; w++) {
+      restricted[later][w] = 0;
+    }
+    for (int laterChoice = 0; laterChoice < ChoiceCounts[later];
+         laterChoice++) {
+      uint64 bit = 1ull << (laterChoice % 64);
+      if ((candidates[later][laterChoice / 64] & bit) &&
+          (Compatible[later][color][laterChoice][choice / 64] &
+           (1ull << (choice % 64)))) {
+        restricted[later][laterChoice / 64] |= bit;
+      }
+    }
+  }
+}
+
+/* The number of variants with the candidate choices for color and later. */
+static uint64 countVariants(COLOR color, CHOICE_SET candidates[NCOLORS])
+{
+  uint64 count = 0;
+  if (color == NCOLORS - 1) {
+    for (int w = 0; w < SEEK_WORDS; w++) {
+      count += __builtin_popcountll(candidates[color][w]);
+    }
+    return count;
+  }
+  for (int choice = 0; choice < ChoiceCounts[color]; choice++) {
+    CHOICE_SET restricted[NCOLORS];
+    if (candidates[color][choice / 64] & (1ull << (choice % 64))) {
+      restrictChoices(color, choice, candidates, restricted);
+      count += countVariants(color + 1, restricted);
+    }
+  }
+  return count;
+}
+
+int cornerSeek(int skip, int choices[NCOLORS * 3])
+{
+  const struct solutionGeometry *geometry = dynamicSolutionGeometry();
+  CHOICE_SET candidates[NCOLORS];
+  uint64 remaining = skip;
+  if (!buildTables()) {
+    return -1;
+  }
+  memset(candidates, 0, sizeof(candidates));
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    for (int choice = 0; choice < ChoiceCounts[color]; choice++) {
+      candidates[color][choice / 64] |= 1ull << (choice % 64);
+    }
+  }
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    int choice;
+    for (choice = 0; choice < ChoiceCounts[color]; choice++) {
+      CHOICE_SET restricted[NCOLORS];
+      uint64 count;
+      if (!(candidates[color][choice / 64] & (1ull << (choice % 64)))) {
+        continue;
+      }
+      restrictChoices(color, choice, candidates, restricted);
+      count = color == NCOLORS - 1 ? 1 : countVariants(color + 1, restricted);
+      if (remaining < count) {
+        memcpy(candidates, restricted, sizeof(candidates));
+        break;
+      }
+      remaining -= count;
+    }
+    if (choice == ChoiceCounts[color]) {
+      /* Only the first color can run out: later, the count was enough. */
+      assert(color == 0);
+      return skip - (int)remaining;
+    }
+    choiceDigits(geometry, color, choice, choices + 3 * color);
+  }
+  return skip;
+}
@@ -0,0 +1,31 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef CORNERSEEK_H
+#define CORNERSEEK_H
+
+#include "core.h"
+
+/**
+ * Seeking to a variant of the current solution without visiting those
+ * before it. The line crossing checks of dynamicTriangleLinesNotCrossed
+ * compare the lines of one color only with the lines of each earlier color
+ * in turn, so whether a choice of corners for all the colors can be drawn is
+ * whether each pair of colors can be, and that is tabulated once, for every
+ * choice of the three corners of one color against every choice for the
+ * other. Counting the variants under a partial choice is then counting the
+ * cliques in these tables, without walking any triangles.
+ */
+
+/* The most choices of the three corners of one color that are tabulated. */
+#define MAX_SEEK_CHOICES 256
+
+/**
+ * Skips up to skip variants, in the order that Corners finds them, setting
+ * choices, by round of Corners, to those of the next one. Returns how many
+ * were skipped, fewer than skip if there are no more, when choices is not
+ * set; or -1, if some color has more than MAX_SEEK_CHOICES choices, leaving
+ * Corners to find the variants one by one.
+ */
+extern int cornerSeek(int skip, int choices[NCOLORS * 3]);
+
+#endif  // CORNERSEEK_H
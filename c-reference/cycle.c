@@ -21,6 +21,14 @@ static void addCycle(int length, COLOR* colors)
     cycle->curves[ix] = color;
     cycle->colors |= 1u << color;
   }
+  cycle->restrictedPairs = 0;
+  for (uint32_t i = 0; i < NCOLORS; i++) {
+    for (uint32_t j = i + 1; j < NCOLORS; j++) {
+      if (!cycleContainsAthenB(cycle, i, j)) {
+        cycle->restrictedPairs |= 1ull << (i * NCOLORS + j);
+      }
+    }
+  }
 }
 static bool isCycleValid(int length, COLOR max, COLOR* cycle)
 {
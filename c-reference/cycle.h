@@ -34,6 +34,11 @@ struct facialCycle {
 
   /* The actual sequence of colors in the cycle */
   COLOR curves[NCOLORS];
+
+  /* Bit i * NCOLORS + j, for i < j, is set unless the cycle has i followed by
+   * j. When set, a face with this cycle shares no vertex with the face across
+   * both i and j, which must therefore omit i and j from its cycle. */
+  uint64 restrictedPairs;
 };
 
 /* Global variables */
@@ -2,18 +2,38 @@
 
 #include "cycleset.h"
 
+#include "memoimage.h"
+#include "memotables.h"
 #include "trail.h"
 
 #include <string.h>
 
+/*
+ * The whole set operations have vector versions, chosen at build time, e.g.
+ * with -march=native, using AVX2 or NEON. They work on as many words at a
+ * time as fit in a register, and finish off the remainder one at a time.
+ * AVX2 has no popcount of its own, but processors with AVX2 have a scalar
+ * one, so cycleSetSize needs no AVX2 version.
+ */
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CYCLESET_AVX2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define CYCLESET_NEON
+#endif
+
 CYCLESET_DECLARE CycleSetPairs[NCOLORS][NCOLORS];
 CYCLESET_DECLARE CycleSetTriples[NCOLORS][NCOLORS][NCOLORS];
 CYCLESET_DECLARE CycleSetOmittingOneColor[NCOLORS];
 CYCLESET_DECLARE CycleSetOmittingColorPair[NCOLORS][NCOLORS];
+CYCLESET_DECLARE CycleSetByLength[NCOLORS + 1];
 
 static int NextSetOfCycleSets = 0;
 static CYCLESET CycleSetSets[NCYCLE_ENTRIES * 2];
 
+_Static_assert(CYCLESET_LENGTH <= 64, "cycleSetCountNotIn sets a bit per word");
+
 #define FINAL_ENTRIES_IN_UNIVERSAL_CYCLE_SET \
   ((1ul << (NCYCLES % BITS_PER_WORD)) - 1ul)
 
@@ -97,6 +117,14 @@ static void initializeOmittingCycleSets(void)
   initializeOmittingColorPairs();
 }
 
+static void initializeByLength(void)
+{
+  uint32_t cycleId;
+  for (cycleId = 0; cycleId < NCYCLES; cycleId++) {
+    cycleSetAdd(cycleId, CycleSetByLength[Cycles[cycleId].length]);
+  }
+}
+
 CYCLE cycleSetFirst(CYCLESET cycleSet)
 {
   return cycleSetNext(cycleSet, NULL);
@@ -141,21 +169,76 @@ CYCLE cycleSetNext(CYCLESET cycleSet, CYCLE cycle)
   return NULL;
 }
 
+CYCLE cycleSetNth(CYCLESET cycleSet, uint32_t n)
+{
+  for (uint64 i = 0; i < CYCLESET_LENGTH; i++) {
+    uint64 word = cycleSet[i];
+    uint32_t count = __builtin_popcountll(word);
+    if (n < count) {
+      // Drop the lowest n set bits
+      while (n-- > 0) {
+        word &= word - 1;
+      }
+      return &Cycles[i * BITS_PER_WORD + __builtin_ctzll(word)];
+    }
+    n -= count;
+  }
+  return NULL;
+}
+
 uint32_t cycleSetSize(CYCLESET cycleSet)
 {
-  uint32_t size = 0;
-  for (uint32_t i = 0; i < CYCLESET_LENGTH; i++) {
+  uint32_t size = 0, i = 0;
+#if defined(CYCLESET_NEON)
+  for (; i + 2 <= CYCLESET_LENGTH; i += 2) {
+    uint8x16_t v = vreinterpretq_u8_u64(vld1q_u64((const uint64_t *)cycleSet + i));
+    size += vaddlvq_u8(vcntq_u8(v));
+  }
+#endif
+  for (; i < CYCLESET_LENGTH; i++) {
     size += __builtin_popcountll(cycleSet[i]);
   }
   return size;
 }
 
-void dynamicCycleSetRemoveCycle(CYCLESET cycleSet, uint32_t cycleId)
+uint32_t cycleSetCountNotIn(CYCLESET cycleSet, CYCLESET mask, uint64 *words)
 {
-  assert(cycleId < NCYCLES);
-  trailSetInt(
-      &cycleSet[cycleId / BITS_PER_WORD],
-      cycleSet[cycleId / BITS_PER_WORD] & ~(1ul << (cycleId % BITS_PER_WORD)));
+  uint32_t count = 0, i = 0;
+  uint64 changed = 0;
+#if defined(CYCLESET_AVX2)
+  /* Most restrictions change nothing, or few words, so only the changed
+     words are counted, using the processor's popcount. */
+  for (; i + 4 <= CYCLESET_LENGTH; i += 4) {
+    __m256i notIn = _mm256_andnot_si256(
+        _mm256_loadu_si256((const __m256i *)(mask + i)),
+        _mm256_loadu_si256((const __m256i *)(cycleSet + i)));
+    __m256i zero = _mm256_cmpeq_epi64(notIn, _mm256_setzero_si256());
+    changed |=
+        (uint64)(~(uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(zero)) & 0xf)
+        << i;
+  }
+  for (uint64 rest = changed; rest != 0; rest &= rest - 1) {
+    uint32_t j = __builtin_ctzll(rest);
+    count += __builtin_popcountll(cycleSet[j] & ~mask[j]);
+  }
+#elif defined(CYCLESET_NEON)
+  for (; i + 2 <= CYCLESET_LENGTH; i += 2) {
+    uint64x2_t notIn = vbicq_u64(vld1q_u64((const uint64_t *)cycleSet + i),
+                                 vld1q_u64((const uint64_t *)mask + i));
+    uint64x2_t nonZero = vtstq_u64(notIn, notIn);
+    changed |= (uint64)((vgetq_lane_u64(nonZero, 0) & 1) |
+                        (vgetq_lane_u64(nonZero, 1) & 2))
+               << i;
+    count += vaddlvq_u8(vcntq_u8(vreinterpretq_u8_u64(notIn)));
+  }
+#endif
+  for (; i < CYCLESET_LENGTH; i++) {
+    uint64 notIn = cycleSet[i] & ~mask[i];
+    changed |= (uint64)(notIn != 0) << i;
+    count += __builtin_popcountll(notIn);
+  }
+  *words = changed;
+  return count;
 }
 
 void initializeCycleSetUniversal(CYCLESET cycleSet)
@@ -210,15 +293,75 @@ static void initializeOppositeDirection(void)
   assert(NextSetOfCycleSets == 2 * NCYCLE_ENTRIES);
 }
 
+static void loadMemo(const struct memoTables *tables)
+{
+  for (uint32_t i = 0; i < NCYCLES; i++) {
+    Cycles[i].length = tables->cycleLength[i];
+    Cycles[i].colors = tables->cycleColors[i];
+    memcpy(Cycles[i].curves, tables->cycleCurves[i], sizeof(Cycles[i].curves));
+    Cycles[i].restrictedPairs = tables->cycleRestrictedPairs[i];
+  }
+  memcpy(CycleSetPairs, tables->cycleSetPairs, sizeof(CycleSetPairs));
+  memcpy(CycleSetTriples, tables->cycleSetTriples, sizeof(CycleSetTriples));
+  memcpy(CycleSetOmittingOneColor, tables->cycleSetOmittingOneColor,
+         sizeof(CycleSetOmittingOneColor));
+  memcpy(CycleSetOmittingColorPair, tables->cycleSetOmittingColorPair,
+         sizeof(CycleSetOmittingColorPair));
+  memcpy(CycleSetByLength, tables->cycleSetByLength, sizeof(CycleSetByLength));
+}
+
+void cycleSetsSaveMemo(struct memoTables *tables)
+{
+  for (uint32_t i = 0; i < NCYCLES; i++) {
+    tables->cycleLength[i] = Cycles[i].length;
+    tables->cycleColors[i] = Cycles[i].colors;
+    memcpy(tables->cycleCurves[i], Cycles[i].curves, sizeof(Cycles[i].curves));
+    tables->cycleRestrictedPairs[i] = Cycles[i].restrictedPairs;
+  }
+  memcpy(tables->cycleSetPairs, CycleSetPairs, sizeof(CycleSetPairs));
+  memcpy(tables->cycleSetTriples, CycleSetTriples, sizeof(CycleSetTriples));
+  memcpy(tables->cycleSetOmittingOneColor, CycleSetOmittingOneColor,
+         sizeof(CycleSetOmittingOneColor));
+  memcpy(tables->cycleSetOmittingColorPair, CycleSetOmittingColorPair,
+         sizeof(CycleSetOmittingColorPair));
+  memcpy(tables->cycleSetByLength, CycleSetByLength, sizeof(CycleSetByLength));
+}
+
+void cycleSetsIncludeInImage(void)
+{
+  memoImageInclude(Cycles, sizeof(Cycles));
+  memoImageInclude(CycleSetPairs, sizeof(CycleSetPairs));
+  memoImageInclude(CycleSetTriples, sizeof(CycleSetTriples));
+  memoImageInclude(CycleSetOmittingOneColor, sizeof(CycleSetOmittingOneColor));
+  memoImageInclude(CycleSetOmittingColorPair,
+                   sizeof(CycleSetOmittingColorPair));
+  memoImageInclude(CycleSetByLength, sizeof(CycleSetByLength));
+  memoImageInclude(CycleSetSets, sizeof(CycleSetSets));
+  memoImageInclude(&NextSetOfCycleSets, sizeof(NextSetOfCycleSets));
+  for (uint32_t i = 0; i < NCYCLES; i++) {
+    memoImageIncludePointer(&Cycles[i].sameDirection);
+    memoImageIncludePointer(&Cycles[i].oppositeDirection);
+  }
+  for (uint32_t i = 0; i < NCYCLE_ENTRIES * 2; i++) {
+    memoImageIncludePointer(CycleSetSets + i);
+  }
+}
+
 void initializeCycleSets(void)
 {
   if (Cycles[0].length == 0) {
-    // Initialize cycles first if they haven't been initialized
-    initializeCycles();
-    memoizeCyclePairs();
-    memoizeCycleTriples();
+    if (memoTables() != NULL) {
+      loadMemo(memoTables());
+    } else {
+      // Initialize cycles first if they haven't been initialized
+      initializeCycles();
+      memoizeCyclePairs();
+      memoizeCycleTriples();
+      initializeOmittingCycleSets();
+      initializeByLength();
+    }
+    /* Pointers into the cycle sets above. */
     initializeSameDirection();
     initializeOppositeDirection();
-    initializeOmittingCycleSets();
   }
 }
@@ -22,6 +22,8 @@ extern CYCLESET_DECLARE CycleSetTriples[NCOLORS][NCOLORS][NCOLORS];
 extern CYCLESET_DECLARE CycleSetOmittingOneColor[NCOLORS];
 /* Cycles that don't contain a specific color pair in sequence */
 extern CYCLESET_DECLARE CycleSetOmittingColorPair[NCOLORS][NCOLORS];
+/* Cycles of each length */
+extern CYCLESET_DECLARE CycleSetByLength[NCOLORS + 1];
 
 /* Basic cycleset operations */
 /* Add a cycle to a cycleset */
@@ -36,12 +38,15 @@ extern bool cycleSetMember(CYCLE_ID cycleId, CYCLESET cycleSet);
 extern CYCLE cycleSetFirst(CYCLESET cycleSet);
 /* Get next cycle in a cycleset after the specified cycle */
 extern CYCLE cycleSetNext(CYCLESET cycleSet, CYCLE cycle);
+/* Get the n-th cycle (counting from 0) in a cycleset, or NULL */
+extern CYCLE cycleSetNth(CYCLESET cycleSet, uint32_t n);
 /* Count the number of cycles in a cycleset */
 extern uint32_t cycleSetSize(CYCLESET cycleSet);
-
-/* Trail-based operations - support backtracking */
-/* Remove a cycle with backtracking support */
-extern void dynamicCycleSetRemoveCycle(CYCLESET cycleSet, uint32_t cycleId);
+/* Count the cycles in cycleSet that are not in mask, setting bit i of *words
+ * when word i of cycleSet has any: these are the words restricting changes.
+ * There are at most 64 words, 37 for NCOLORS=7. */
+extern uint32_t cycleSetCountNotIn(CYCLESET cycleSet, CYCLESET mask,
+                                   uint64 *words);
 
 /* Initialization functions */
 /* Set a cycleset to contain all possible cycles */
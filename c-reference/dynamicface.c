@@ -2,6 +2,7 @@
 
 #include "face.h"
 #include "failure.h"
+#include "nogood.h"
 #include "s6.h"
 #include "statistics.h"
 #include "utils.h"
@@ -9,18 +10,40 @@
 
 uint64 CycleForcedCounter = 0;
 uint64 CycleSetReducedCounter = 0;
+struct statisticHistogram CycleChoiceHistogram;
+FACE FailureFace = NULL;
 
-static void setupColors(VERTEX vertex, COLOR colors[2])
+/*
+ * The worklist of faces whose cycle is known but whose choice has not yet been
+ * propagated, with the wave of propagation that forced each. A face's cycle is
+ * set as it is added, so it is added at most once, and any further
+ * restrictions on it are just checked against that cycle.
+ */
+static FACE pendingFaces[NFACES];
+static int pendingDepths[NFACES];
+static int pendingHead = 0, pendingTail = 0;
+
+static void dynamicAddPendingFace(FACE face, int depth)
 {
-  colors[0] = vertex->primary;
-  colors[1] = vertex->secondary;
+  assert(pendingTail < NFACES);
+  pendingFaces[pendingTail] = face;
+  pendingDepths[pendingTail++] = depth;
 }
 
-static void validateIncomingEdges(VERTEX vertex)
+static FAILURE dynamicPropagatePendingFaces(void)
 {
-  for (int incomingEdgeSlot = 0; incomingEdgeSlot < 4; incomingEdgeSlot++) {
-    assert(vertex->incomingEdges[incomingEdgeSlot]->to != NULL);
+  FAILURE failure = NULL;
+  while (failure == NULL && pendingHead < pendingTail) {
+    NogoodPropagationReasons = pendingFaces[pendingHead]->reasons;
+    failure = dynamicFaceChoice(pendingFaces[pendingHead],
+                                pendingDepths[pendingHead]);
+    if (failure != NULL && FailureFace == NULL) {
+      FailureFace = pendingFaces[pendingHead];
+    }
+    pendingHead++;
   }
+  pendingHead = pendingTail = 0;
+  return failure;
 }
 
 void dynamicRecomputeCountOfChoices(FACE face)
@@ -28,91 +51,35 @@ void dynamicRecomputeCountOfChoices(FACE face)
   trailSetInt(&face->cycleSetSize, cycleSetSize(face->possibleCycles));
 }
 
-static void dynamicRestrictCycles(FACE face, CYCLESET cycleSet)
+void dynamicFaceHasCycle(FACE face)
 {
-  uint32_t i;
-  uint_trail toBeCleared;
-  uint_trail newCycleSetSize = face->cycleSetSize;
-
-  for (i = 0; i < CYCLESET_LENGTH; i++) {
-    toBeCleared = face->possibleCycles[i] & ~cycleSet[i];
-    if (toBeCleared == 0) {
-      continue;
-    }
-    trailSetInt(&face->possibleCycles[i],
-                face->possibleCycles[i] & cycleSet[i]);
-    newCycleSetSize -= __builtin_popcountll(toBeCleared);
-  }
-  if (newCycleSetSize < face->cycleSetSize) {
-    CycleSetReducedCounter++;
-    trailSetInt(&face->cycleSetSize, newCycleSetSize);
-  }
+  uint64 id = face - Faces;
+  trailSetInt(&FacesWithoutCycleState[id / BITS_PER_WORD],
+              FacesWithoutCycleState[id / BITS_PER_WORD] &
+                  ~(1ull << (id % BITS_PER_WORD)));
 }
 
-static void dynamicCountEdge(EDGE edge)
+bool dynamicRestrictCycles(FACE face, CYCLESET cycleSet)
 {
-  uint_trail* edgeCountPtr =
-      &EdgeColorCountState[IS_CLOCKWISE_EDGE(edge)][edge->color];
-  trailSetInt(edgeCountPtr, (*edgeCountPtr) + 1);
-}
+  uint64 words;
+  uint32_t cleared =
+      cycleSetCountNotIn(face->possibleCycles, cycleSet, &words);
 
-static FAILURE dynamicHandleExistingEdge(FACE face, COLOR aColor, COLOR bColor,
-                                         int depth)
-{
-  if (face->edges[aColor].to != NULL) {
-    assert(face->edges[aColor].to != &face->edges[aColor].possiblyTo[aColor]);
-    if (face->edges[aColor].to != &face->edges[aColor].possiblyTo[bColor]) {
-      return failureVertexConflict(depth);
-    }
-    assert(face->edges[aColor].to == &face->edges[aColor].possiblyTo[bColor]);
-    return NULL;
+  if (cleared == 0) {
+    return false;
   }
-  return NULL;
-}
-
-/*
- * Processes an incoming edge at a vertex intersection of two curves.
- *
- * The incomingEdgeSlot parameter encodes both the edge and its relationship to
- * colors:
- * - Slots 0,1 correspond to the primary color (colors[0])
- * - Slots 2,3 correspond to the secondary color (colors[1])
- *
- * The bit operation (incomingEdgeSlot & 2) >> 1 extracts the color index:
- * - For slots 0,1: (0 & 2) >> 1 = 0 → colors[0] (primary)
- * - For slots 2,3: (2 & 2) >> 1 = 1 → colors[1] (secondary)
- *
- * The edge's destination is always set to the other color's possiblyTo entry
- * to establish the correct connections between faces.
- */
-static FAILURE dynamicProcessIncomingEdge(EDGE edge, COLOR colors[2],
-                                          int incomingEdgeSlot, int depth)
-{
-  // Determine which color this edge corresponds to based on the slot
-  int colorIndex =
-      (incomingEdgeSlot & 2) >> 1;       // 0 for slots 0,1; 1 for slots 2,3
-  int otherColorIndex = 1 - colorIndex;  // The other color index (0 or 1)
-
-  // Verify edge's color matches the appropriate slot's color
-  assert(edge->color == colors[colorIndex]);
-  assert(edge->color != colors[otherColorIndex]);
-
-  if (edge->to != NULL) {
-    // If the edge already has a destination, ensure it's consistent
-    if (edge->to != &edge->possiblyTo[colors[colorIndex]]) {
-      return failureVertexConflict(depth);
-    }
-    assert(edge->to == &edge->possiblyTo[colors[otherColorIndex]]);
-  } else {
-    // Set the edge's destination to connect to the other color
-    TRAIL_SET_POINTER(&edge->to, &edge->possiblyTo[colors[otherColorIndex]]);
+  /* Only the changed words go on the trail. */
+  for (; words != 0; words &= words - 1) {
+    uint32_t i = __builtin_ctzll(words);
+    trailSetInt(&face->possibleCycles[i],
+                face->possibleCycles[i] & cycleSet[i]);
   }
-
-  assert(edge->to != &edge->possiblyTo[edge->color]);
-  return NULL;
+  CycleSetReducedCounter++;
+  trailSetInt(&face->cycleSetSize, face->cycleSetSize - cleared);
+  return true;
 }
 
-static FAILURE dynamicCheckLengthOfCycleOfFaces(FACE face)
+FAILURE dynamicFaceCheckRingOfFaces(FACE face, int depth, bool allowOpen)
 {
   uint32_t i = 0,
            expected = FaceSumOfFaceDegree[__builtin_popcount(face->colors)];
@@ -124,28 +91,23 @@ static FAILURE dynamicCheckLengthOfCycleOfFaces(FACE face)
     assert(i <= expected);
     if (f == face) {
       if (i != expected) {
-        return failureDisconnectedFaces(0);
+        return failureDisconnectedFaces(depth);
       }
       return NULL;
     }
   } while (f != NULL);
-  assert(0);
+  assert(allowOpen);
+  (void)allowOpen;
+  return NULL;
 }
 
 bool dynamicFaceSetCycleLength(uint32_t faceColors, FACE_DEGREE length)
 {
   FACE face = Faces + (faceColors & (NFACES - 1));
-  CYCLE cycle;
-  uint32_t cycleId;
   if (length == 0) {
     return true;
   }
-  for (cycleId = 0, cycle = Cycles; cycleId < NCYCLES; cycleId++, cycle++) {
-    if (cycle->length != length) {
-      dynamicCycleSetRemoveCycle(face->possibleCycles, cycleId);
-    }
-  }
-  dynamicRecomputeCountOfChoices(face);
+  dynamicRestrictCycles(face, CycleSetByLength[length]);
   return face->cycleSetSize != 0;
 }
 
@@ -154,24 +116,37 @@ FAILURE dynamicFaceRestrictAndPropagateCycles(FACE face, CYCLESET onlyCycleSet,
 {
   if (face->cycleSetSize == 1 || face->cycle != NULL) {
     if (!cycleSetMember(face->cycle - Cycles, onlyCycleSet)) {
+      NogoodFailureReasons = face->reasons | NogoodPropagationReasons;
+      FailureFace = face;
       return failureConflictingConstraints(depth);
     }
     return NULL;
   }
 
-  dynamicRestrictCycles(face, onlyCycleSet);
+  if (dynamicRestrictCycles(face, onlyCycleSet)) {
+    trailMaybeSetInt(&face->reasons, face->reasons | NogoodPropagationReasons);
+  }
 
   if (face->cycleSetSize == 0) {
+    NogoodFailureReasons = face->reasons;
+    FailureFace = face;
     return failureNoMatchingCycles(depth);
   }
   if (face->cycleSetSize == 1) {
     TRAIL_SET_POINTER(&face->cycle, cycleSetFirst(face->possibleCycles));
+    dynamicFaceHasCycle(face);
     CycleForcedCounter++;
-    return dynamicFaceChoice(face, depth + 1);
+    dynamicAddPendingFace(face, depth + 1);
   }
   return NULL;
 }
 
+FAILURE dynamicFacePropagateChoiceAndForced(FACE face)
+{
+  dynamicAddPendingFace(face, 0);
+  return dynamicPropagatePendingFaces();
+}
+
 void dynamicFaceSetupCentral(FACE_DEGREE* faceDegrees)
 {
   uint64 i;
@@ -181,47 +156,71 @@ void dynamicFaceSetupCentral(FACE_DEGREE* faceDegrees)
   }
   // The cycle (a b c d e f) is the last one.
   centralFace->cycle = &Cycles[NCYCLES - 1];
+  dynamicFaceHasCycle(centralFace);
   dynamicFaceBacktrackableChoice(centralFace);
 }
 
-FAILURE dynamicFaceIncludeVertex(FACE face, COLOR aColor, COLOR bColor,
-                                 int depth)
+/*
+ * Includes the vertex at the end of the edge of aColor of face, where it
+ * meets bColor, unless the edge already ends at a vertex, which must be that
+ * one. The four edges into the vertex then run on to the other color: those
+ * in slots 0 and 1, of the primary color, to the secondary; those in slots 2
+ * and 3 to the primary. The edge of aColor is one of them, so a vertex is
+ * never included twice, and if another already has an end it is elsewhere.
+ */
+static inline FAILURE dynamicFaceIncludeVertex(FACE face, COLOR aColor,
+                                               COLOR bColor, int depth)
 {
   FAILURE failure;
+  EDGE edge = &face->edges[aColor];
   VERTEX vertex;
-  EDGE edge;
-  COLOR colors[2];
+  uint_trail to[2];
 
-  failure = dynamicHandleExistingEdge(face, aColor, bColor, depth);
-  if (failure != NULL || face->edges[aColor].to != NULL) {
-    return failure;
+  if (edge->to != 0) {
+    assert(edge->to != 1 + aColor);
+    return edge->to == 1 + bColor ? NULL : failureVertexConflict(depth);
+  }
+  vertex = curveLinkVertex(&edge->possiblyTo[bColor]);
+  CHECK_FAILURE(dynamicEdgeCountVertex(vertex, depth));
+  to[0] = 1 + vertex->secondary;
+  to[1] = 1 + vertex->primary;
+  for (int slot = 0; slot < 4; slot++) {
+    EDGE incoming = vertex->incomingEdges[slot];
+    if (incoming->to != 0) {
+      return failureVertexConflict(depth);
+    }
+    trailSetInt(&incoming->to, to[slot >> 1]);
   }
+  return NULL;
+}
 
-  vertex = face->edges[aColor].possiblyTo[bColor].vertex;
-  CHECK_FAILURE(
-      dynamicEdgeCheckCrossingLimit(vertex->primary, vertex->secondary, depth));
-  setupColors(vertex, colors);
+FAILURE dynamicFaceIncludeVertices(FACE face, CYCLE cycle, int depth)
+{
+  FAILURE failure;
+  uint32_t last = cycle->length - 1;
 
-  for (int incomingEdgeSlot = 0; incomingEdgeSlot < 4; incomingEdgeSlot++) {
-    edge = vertex->incomingEdges[incomingEdgeSlot];
-    CHECK_FAILURE(
-        dynamicProcessIncomingEdge(edge, colors, incomingEdgeSlot, depth));
-    dynamicCountEdge(edge);
+  for (uint32_t i = 0; i < last; i++) {
+    CHECK_FAILURE(dynamicFaceIncludeVertex(face, cycle->curves[i],
+                                           cycle->curves[i + 1], depth));
   }
-  validateIncomingEdges(vertex);
-  return NULL;
+  return dynamicFaceIncludeVertex(face, cycle->curves[last], cycle->curves[0],
+                                  depth);
 }
 
 bool dynamicColorRemoveFromSearch(COLOR color)
 {
   FACE f;
   uint32_t i;
+  /* These restrictions follow from the edges, which have no reasons. */
+  NogoodPropagationReasons = NOGOOD_UNKNOWN;
   for (i = 0, f = Faces; i < NFACES; i++, f++) {
     if (f->cycle == NULL) {
       /* Discard failure, we will report a different one. */
-      if (f->edges[color].to == NULL &&
-          dynamicFaceRestrictAndPropagateCycles(
-              f, CycleSetOmittingOneColor[color], 0) != NULL) {
+      if (f->edges[color].to == 0 &&
+          (dynamicFaceRestrictAndPropagateCycles(
+               f, CycleSetOmittingOneColor[color], 0) != NULL ||
+           dynamicPropagatePendingFaces() != NULL)) {
+        NogoodFailureReasons = NOGOOD_UNKNOWN;
         return false;
       }
     }
@@ -247,7 +246,7 @@ FAILURE dynamicFaceFinalCorrectnessChecks(void)
 #endif
   for (colors = 1; colors < (NFACES - 1); colors |= face->previous->colors) {
     face = Faces + colors;
-    CHECK_FAILURE(dynamicCheckLengthOfCycleOfFaces(face));
+    CHECK_FAILURE(dynamicFaceCheckRingOfFaces(face, 0, false));
   }
   return NULL;
 }
@@ -255,7 +254,7 @@ FAILURE dynamicFaceFinalCorrectnessChecks(void)
 FAILURE dynamicFacePropagateChoice(FACE face, EDGE edge, int depth)
 {
   FAILURE failure;
-  VERTEX vertex = edge->to->vertex;
+  VERTEX vertex = edgeVertex(edge);
   COLOR aColor = edge->color;
   COLOR bColor =
       edge->color == vertex->primary ? vertex->secondary : vertex->primary;
@@ -4,6 +4,7 @@
 #define DYNAMICFACE_H
 
 #include "failure.h"
+#include "statistics.h"
 #include "trail.h"
 #include "vertex.h"
 
@@ -33,15 +34,14 @@ extern bool dynamicFaceSetCycleLength(uint32_t faceColors, FACE_DEGREE length);
 
 /* Cycle and vertex manipulation */
 /**
- * Includes a vertex in a face, connecting specified colors.
+ * Includes the vertices of a face with a cycle, between each pair of
+ * consecutive colors, counting each new one on its curves.
  * @param face Face to modify
- * @param aColor First color to connect
- * @param bColor Second color to connect
+ * @param cycle The cycle of the face
  * @param depth Current search depth
  * @return Failure object if operation fails, NULL otherwise
  */
-extern FAILURE dynamicFaceIncludeVertex(FACE face, COLOR aColor, COLOR bColor,
-                                        int depth);
+extern FAILURE dynamicFaceIncludeVertices(FACE face, CYCLE cycle, int depth);
 
 /**
  * Removes a color from further consideration in search.
@@ -51,16 +51,26 @@ extern FAILURE dynamicFaceIncludeVertex(FACE face, COLOR aColor, COLOR bColor,
 extern bool dynamicColorRemoveFromSearch(COLOR color);
 
 /**
- * Propagates cycle constraints from a face through the diagram.
- * @param face Starting face for propagation
+ * Restricts the cycles of a face. If this leaves only one, the face is added
+ * to the worklist, to be propagated by dynamicFacePropagateChoiceAndForced.
+ * @param face Face to restrict
  * @param onlyCycleSet Restricted set of cycles to consider
- * @param depth Current search depth
+ * @param depth Current propagation wave
  * @return Failure object if propagation fails, NULL otherwise
  */
 extern FAILURE dynamicFaceRestrictAndPropagateCycles(FACE face,
                                                      CYCLESET onlyCycleSet,
                                                      int depth);
 
+/**
+ * Propagates the cycle chosen for a face, and then, breadth first, the cycle
+ * of every face this forces. Each forced face is one wave further than the
+ * face that forced it; the waves are the depths in the failure statistics.
+ * @param face Face whose cycle has been chosen
+ * @return Failure object if propagation fails, NULL otherwise
+ */
+extern FAILURE dynamicFacePropagateChoiceAndForced(FACE face);
+
 /**
  * Propagates edge choice constraints to connected faces.
  * @param face Source face for propagation
@@ -71,6 +81,18 @@ extern FAILURE dynamicFaceRestrictAndPropagateCycles(FACE face,
 extern FAILURE dynamicFacePropagateChoice(FACE face, EDGE edge, int depth);
 
 /* Validation and finalization */
+/**
+ * Checks the ring of faces with the same number of colors as face, following
+ * next from face. Fails if the ring has closed without all of those faces.
+ * @param face Face in the ring, neither the inner nor the outer face
+ * @param depth Current search depth
+ * @param allowOpen Whether the ring need not have closed yet, as when the
+ *                  next of face has just been set
+ * @return Failure object if the ring is too short, NULL otherwise
+ */
+extern FAILURE dynamicFaceCheckRingOfFaces(FACE face, int depth,
+                                           bool allowOpen);
+
 /**
  * Updates the count of available choices for a face.
  * @param face Face to update
@@ -94,4 +116,16 @@ extern uint64 CycleForcedCounter;
  */
 extern uint64 CycleSetReducedCounter;
 
+/**
+ * The sizes of the cycle sets of the faces chosen during search.
+ */
+extern struct statisticHistogram CycleChoiceHistogram;
+
+/**
+ * The face at which the latest failure was found, or NULL for the face
+ * being chosen: the face left with no cycle, or with one conflicting with
+ * a restriction, or else the face whose cycle was being propagated.
+ */
+extern FACE FailureFace;
+
 #endif /* DYNAMICFACE_H */
@@ -3,22 +3,46 @@
 #include "edge.h"
 
 #include "trail.h"
+#include "vertex.h"
 
-uint64 EdgeColorCountState[2][NCOLORS];
 COLORSET ColorCompletedState;
 
 /* If we have convex polygons A and B both with N sides, then they can cross
    each other in at most 2*N different points. For half A crosses outside B. */
 #define MAX_ONE_WAY_CURVE_CROSSINGS MAX_CORNERS
-static uint64 EdgeCrossingCounts[NCOLORS][NCOLORS];
+
+/* For each color, in one word, so that counting a vertex takes one entry on
+   the trail for each of its two curves: the number of vertices on the curve
+   in the low EDGE_COUNT_BITS, and then, in EDGE_CROSSING_BITS for each other
+   color, how often the curve has crossed it as the primary color. Kept under
+   32 bits, the old values take narrow entries. */
+#define EDGE_COUNT_BITS 8
+#define EDGE_CROSSING_BITS 3
+#define EDGE_COUNT_MASK ((1u << EDGE_COUNT_BITS) - 1)
+#define EDGE_CROSSING_SHIFT(color) \
+  (EDGE_COUNT_BITS + EDGE_CROSSING_BITS * (color))
+_Static_assert(EDGE_CROSSING_SHIFT(NCOLORS) <= 32,
+               "The vertex counts of a color fit in 32 bits");
+_Static_assert(MAX_ONE_WAY_CURVE_CROSSINGS < 1u << EDGE_CROSSING_BITS,
+               "A crossing count fits in EDGE_CROSSING_BITS");
+_Static_assert(2 * MAX_ONE_WAY_CURVE_CROSSINGS * (NCOLORS - 1) <=
+                   EDGE_COUNT_MASK,
+               "The vertices of a curve fit in EDGE_COUNT_BITS");
+static uint64 EdgeVertexCounts[NCOLORS];
 static uint64 EdgeCurvesComplete[NCOLORS];
 
+void initializeEdgeState(void)
+{
+  trailRegisterDynamic(EdgeVertexCounts, sizeof(EdgeVertexCounts));
+  trailRegisterDynamic(EdgeCurvesComplete, sizeof(EdgeCurvesComplete));
+}
+
 static EDGE edgeFollowForwards(EDGE edge)
 {
-  if (edge->to == NULL) {
+  if (edge->to == 0) {
     return NULL;
   }
-  return edge->to->next;
+  return curveLinkNext(edgeTo(edge));
 }
 
 static uint_trail curveLength(EDGE edge)
@@ -35,13 +59,13 @@ static uint_trail curveLength(EDGE edge)
 static FAILURE dynamicCheckForDisconnectedCurve(EDGE edge, int depth)
 {
   uint_trail length;
-  if (edge->reversed->to != NULL) {
+  if (edge->reversed->to != 0) {
     // We have a colored cycle in the FISC.
     length = curveLength(edge);
-    if (length < EdgeColorCountState[IS_CLOCKWISE_EDGE(edge)][edge->color]) {
+    if (length < (EdgeVertexCounts[edge->color] & EDGE_COUNT_MASK)) {
       return failureDisconnectedCurve(depth);
     }
-    assert(length == EdgeColorCountState[IS_CLOCKWISE_EDGE(edge)][edge->color]);
+    assert(length == (EdgeVertexCounts[edge->color] & EDGE_COUNT_MASK));
     if (ColorCompletedState & 1u << edge->color) {
       return NULL;
     }
@@ -63,13 +87,17 @@ static EDGE findStartOfCurve(EDGE edge)
   return edge;
 }
 
-FAILURE dynamicEdgeCheckCrossingLimit(COLOR a, COLOR b, int depth)
+FAILURE dynamicEdgeCountVertex(VERTEX vertex, int depth)
 {
-  uint_trail* crossing = &EdgeCrossingCounts[a][b];
-  if (*crossing + 1 > MAX_ONE_WAY_CURVE_CROSSINGS) {
+  uint_trail* primary = &EdgeVertexCounts[vertex->primary];
+  uint_trail* secondary = &EdgeVertexCounts[vertex->secondary];
+  uint32_t shift = EDGE_CROSSING_SHIFT(vertex->secondary);
+  if ((*primary >> shift & ((1u << EDGE_CROSSING_BITS) - 1)) ==
+      MAX_ONE_WAY_CURVE_CROSSINGS) {
     return failureCrossingLimit(depth);
   }
-  trailSetInt(crossing, *crossing + 1);
+  trailSetInt(primary, *primary + (1ull << shift) + 1);
+  trailSetInt(secondary, *secondary + 1);
   return NULL;
 }
 
@@ -25,16 +25,25 @@ typedef struct Vertex* VERTEX;
 /**
  * Connection between an edge and a vertex.
  * Used to describe how edges connect to vertices in the diagram.
+ *
+ * The edge and the vertex are held as numbers, rather than pointers, to keep
+ * the edges, and so the faces, small; see curveLinkNext and curveLinkVertex
+ * in vertex.h. This also leaves the curve links the same at any address.
  */
 struct curveLink {
   /* This CURVELINK is at the end of one edge only.
      To find that edge, if the to field here is not NULL, then:
      it is: next->reversed->to->next->reversed
   */
-  EDGE next;     /* Next edge in the sequence */
-  VERTEX vertex; /* Associated vertex */
+  MEMO uint16_t next;   /* EDGE_NUMBER of the next edge, or 0 */
+  MEMO uint16_t vertex; /* One more than the number of the vertex, or 0 */
 };
 
+/* The number of an edge, from its face and its color, never 0. */
+#define EDGE_NUMBER(edge) ((edge)->colors << 3 | ((edge)->color + 1))
+_Static_assert(NCOLORS < 8, "EDGE_NUMBER has three bits for the color");
+_Static_assert(NFACES << 3 <= UINT16_MAX, "EDGE_NUMBER is 16 bits");
+
 /**
  * Core edge structure representing a segment of a curve.
  * Each edge represents part of the boundary of a face in the diagram.
@@ -51,25 +60,18 @@ struct edge {
   MEMO EDGE reversed;
 
   /*
-   * to starts off as NULL, and is set to the jth member of possiblyTo
-   * where (color, j) is in the facial cycle of inner, equivalently
-   * (j, color) is in the facial cycle of outer.
+   * to starts off as 0, for none, and is set to 1 + j, for the jth member of
+   * possiblyTo, where (color, j) is in the facial cycle of inner,
+   * equivalently (j, color) is in the facial cycle of outer. Being small,
+   * it takes a short entry on the trail; see edgeTo in vertex.h.
    */
-  DYNAMIC CURVELINK to;
+  DYNAMIC uint_trail to;
 
   /* This vertex at the end of this edge may cross one of the other colors.
    * We have all 5 pre-initialized in this array, with the color-th entry
    * being all NULL.
    */
   MEMO struct curveLink possiblyTo[NCOLORS];
-
-  /* Both this edge and its reverse point to the same uint_trail value,
-   * which is initialized as UNSET_LINE_ID (2^64 - 1; all 1s; -1; ~0).
-   * When we know which line it is on, we set this.
-   * lineId is one of 3*color, 3*color+1, 3*color+2.
-   * For edges on the central face lineId is 3*color.
-   */
-  uint_trail* lineId;
 };
 
 /*--------------------------------------
@@ -77,16 +79,14 @@ struct edge {
  *--------------------------------------*/
 
 /**
- * Tracks the count of edges for each color in the diagram.
- * First dimension: 0=edges with no vertex, 1=edges with vertex
- * Second dimension: color index
+ * Bit set tracking which colors have all their edges completed.
  */
-extern uint64 EdgeColorCountState[2][NCOLORS];
+extern COLORSET ColorCompletedState;
 
 /**
- * Bit set tracking which colors have all their edges completed.
+ * Registers the edge counters with the trail, see trailRegisterDynamic.
  */
-extern COLORSET ColorCompletedState;
+extern void initializeEdgeState(void);
 
 /*--------------------------------------
  * Edge Navigation Functions
@@ -134,13 +134,13 @@ extern int dynamicEdgePathAndLength(EDGE from, EDGE to, EDGE* pathReturn);
 extern int edgePathLengthOnly(EDGE from, EDGE to);
 
 /**
- * Checks if curve crossing limits are exceeded.
- * @param a First color
- * @param b Second color
+ * Counts a vertex newly in the diagram on both of its curves, and as a
+ * crossing of its primary curve over its secondary one.
+ * @param vertex The vertex
  * @param depth Current search depth
- * @return Failure object if limits exceeded, NULL otherwise
+ * @return Failure object if the crossing limit is exceeded, NULL otherwise
  */
-extern FAILURE dynamicEdgeCheckCrossingLimit(COLOR a, COLOR b, int depth);
+extern FAILURE dynamicEdgeCountVertex(VERTEX vertex, int depth);
 
 /**
  * Determines if an edge is oriented clockwise around its face.
@@ -1,33 +1,94 @@
 /* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
 
+#define _DEFAULT_SOURCE
+
 #include "engine.h"
 
 #include "face.h"
 #include "main.h"
 #include "statistics.h"
+#include "trace.h"
 #include "trail.h"
 #include "visible_for_testing.h"
 
+#include <sys/mman.h>
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 /**
  * The engine implements a WAM-like execution model for search.
  * See docs/DESIGN.md "Non-deterministic Engine, Backtracking, Memory and the
  * Trail" for detailed documentation.
  */
 
-/* We use 16384 which is about twice what we need. */
-#define TRAIL_SIZE 16384
+/*
+ * The trail is reserved, not allocated: pages are only backed by memory once
+ * used, so this is far more than we need at little cost. A guard page after
+ * the end turns an overflow into a fault, which is reported, rather than
+ * needing a check on each write.
+ */
+#define TRAIL_CAPACITY (1ul << 30)
 #define MAX_STACK_SIZE 1000
 
+/*
+ * The trail is a stream of 32-bit words, read backwards when rewinding. The
+ * last word of each entry says how to decode it:
+ *   - even: a narrow entry, for an old value that fits in 32 bits; the old
+ *     value is in the word before, and the offset of the location, in
+ *     64-bit words, into the dynamic region is in the top 31 bits;
+ *   - ending in binary 01: a wide entry, the old value in the two words
+ *     before, and the offset in the top 30 bits;
+ *   - TRAIL_ABSOLUTE: a location outside the dynamic region, with the
+ *     pointer and old value in the four words before.
+ * The trailed locations are nearly all inside Faces and the other static
+ * arrays. Counters and cleared pointers take narrow entries; cycle set words
+ * usually take wide ones.
+ */
 struct trail {
-  void* ptr;
-  uint_trail value;
+  uint32_t word;
 };
 
-static struct trail TrailArray[TRAIL_SIZE];
-TRAIL Trail = TrailArray;
-static TRAIL frozenTrail = NULL;
+#define TRAIL_ABSOLUTE 3u
+#define MAX_DYNAMIC_WORDS (1ul << 30)
+
+static TRAIL TrailArray = NULL;
+TRAIL Trail = NULL;
+TRAIL TrailEnd = NULL;
+/* The context of the innermost running engine, or of none. */
+static struct engineContext TopLevel;
+static struct engineContext* Context = &TopLevel;
 static uint64 MaxTrailSize = 0;
+static struct statisticHistogram ChoiceTrailDepth;
+/* The smallest span covering every registered region. */
+static uintptr_t DynamicStart = 0;
+static uintptr_t DynamicEnd = 0;
+/* The registered regions themselves, for the checks of TRAIL_CHECK. */
+#define MAX_DYNAMIC_REGIONS 32
+static struct {
+  char* start;
+  uint64 size;
+} DynamicRegions[MAX_DYNAMIC_REGIONS];
+static int DynamicRegionCount = 0;
 int EngineCounter = 0;
+static volatile int* PollRequest = NULL;
+static void (*PollHandler)(STACK stack) = NULL;
+/* The outermost running engine, and the leaves it has reached. */
+static STACK SearchStack = NULL;
+static double LeafWeights = 0.0;
+static double WeightedEstimates = 0.0;
+
+/* Enough for every predicate of the search, and of its nested engines. */
+#define MAX_PROFILES 32
+static struct predicateProfile Profiles[MAX_PROFILES];
+static int ProfileCount = 0;
 
 const struct predicateResult PredicateFail = {PREDICATE_FAIL, 0};
 const struct predicateResult PredicateSuccessNextPredicate = {
@@ -46,8 +107,16 @@ struct predicateResult predicateChoices(int numberOfChoices)
   return (struct predicateResult){PREDICATE_CHOICES, numberOfChoices};
 }
 
-static void trace(STACK stack, const char* message)
+#ifndef NO_TRACE
+static void trace(STACK stack, enum traceKind kind)
 {
+  static const char* const messages[] = TRACE_KIND_NAMES;
+  const char* message = messages[kind];
+  if (TraceRing != NULL) {
+    traceRecord(stack->stackTop->counter, stack->stackTop - stack->stack,
+                stack->stackTop->profile - Profiles, kind,
+                stack->stackTop->round, stack->stackTop->currentChoice);
+  }
   if (!TracingFlag) return;
   fprintf(stderr, "%d:%ld:", stack->stackTop->counter,
           stack->stackTop - stack->stack);
@@ -59,6 +128,86 @@ static void trace(STACK stack, const char* message)
             stack->stackTop->predicate->name);
   }
 }
+#else
+#define trace(stack, kind) ((void)0)
+#endif
+
+/*
+ * The ports of each predicate are timed by sampling, to keep the cost of the
+ * timer reads out of the times. The first PROFILE_SAMPLE_PERIOD tries, and
+ * retries, of each predicate are each timed, so that those called only a few
+ * times are timed exactly. After that, one in every PROFILE_SAMPLE_PERIOD is
+ * timed, and stands for the whole period.
+ */
+#define PROFILE_SAMPLE_PERIOD 64
+
+/* The ports the next port, after so many, stands for, or 0 to not time it. */
+static inline uint64 profileWeight(uint64 ports)
+{
+  if (ports < PROFILE_SAMPLE_PERIOD) {
+    return 1;
+  }
+  return ports % PROFILE_SAMPLE_PERIOD == 0 ? PROFILE_SAMPLE_PERIOD : 0;
+}
+
+static uint64 profileTicks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec now;
+  timespec_get(&now, TIME_UTC);
+  return (uint64)now.tv_sec * 1000000000 + (uint64)now.tv_nsec;
+#endif
+}
+
+static struct predicateProfile* findProfile(PREDICATE predicate)
+{
+  for (int i = 0; i < ProfileCount; i++) {
+    if (Profiles[i].predicate == predicate) {
+      return Profiles + i;
+    }
+  }
+  return NULL;
+}
+
+static struct predicateProfile* profileOf(PREDICATE predicate)
+{
+  struct predicateProfile* profile = findProfile(predicate);
+  if (profile != NULL) {
+    return profile;
+  }
+  assert(ProfileCount < MAX_PROFILES);
+  Profiles[ProfileCount].predicate = predicate;
+  return Profiles + ProfileCount++;
+}
+
+/* Adds the counts since before, if counting, to the profile. */
+static void profileCounters(struct predicateProfile* profile,
+                            const uint64 before[PERF_COUNTERS])
+{
+  uint64 after[PERF_COUNTERS];
+  perfCountersRead(after);
+  for (int i = 0; i < PERF_COUNTERS; i++) {
+    profile->counters[i] += after[i] - before[i];
+  }
+}
+
+static void profileResult(struct predicateProfile* profile,
+                          PredicateResultCode code)
+{
+  switch (code) {
+    case PREDICATE_FAIL:
+      profile->failures++;
+      break;
+    case PREDICATE_SUCCESS_NEXT_PREDICATE:
+    case PREDICATE_SUCCESS_SAME_PREDICATE:
+      profile->successes++;
+      break;
+    default:
+      break;
+  }
+}
 
 /**
  * Initializes a new stack entry after success. .
@@ -72,11 +221,82 @@ static void pushStackEntry(struct stackEntry* entry, PredicateResultCode code)
                           ? entry[-1].predicates + 1
                           : entry[-1].predicates;
   entry->predicate = *entry->predicates;
+  /* Rounds of the same predicate are common, and save a look up. */
+  entry->profile = entry->predicate == entry[-1].predicate
+                       ? entry[-1].profile
+                       : profileOf(entry->predicate);
   entry->round =
       code == PREDICATE_SUCCESS_NEXT_PREDICATE ? 0 : entry[-1].round + 1;
   entry->currentChoice = -1;
   entry->trail = Trail;
   entry->counter = EngineCounter++;
+  entry->weight = entry[-1].weight;
+  entry->nodes = entry[-1].inChoiceMode ? entry[-1].nodes + entry[-1].weight
+                                        : entry[-1].nodes;
+}
+
+/* A leaf a random probe would reach 1/weight of the time. */
+static void countLeaf(STACK stack, double weight, double nodes)
+{
+  if (stack == SearchStack) {
+    LeafWeights += 1.0 / weight;
+    WeightedEstimates += nodes / weight;
+  }
+}
+
+/**
+ * Restricts a new choice point to the choices of the replayed path.
+ */
+static void replayChoices(STACK stack)
+{
+  int depth = stack->stackTop - stack->stack;
+  const struct choiceRange* step;
+  if (stack->replay == NULL || depth >= stack->replayLength) {
+    return;
+  }
+  step = &stack->replay->steps[depth];
+  assert(step->first >= 0);
+  assert(step->end <= stack->stackTop->numberOfChoices);
+  stack->stackTop->currentChoice = step->first;
+  stack->stackTop->numberOfChoices = step->end;
+}
+
+/**
+ * Once a replayed choice point moves on from its first choice, the deeper
+ * steps of the path no longer apply.
+ */
+static void replayMoveOn(STACK stack)
+{
+  int depth = stack->stackTop - stack->stack;
+  if (stack->replay != NULL && depth < stack->replayLength &&
+      stack->stackTop->currentChoice !=
+          stack->replay->steps[depth].first) {
+    stack->replayLength = depth + 1;
+  }
+}
+
+/**
+ * For a probe, tries each choice, and keeps one of those that do not fail at
+ * once, drawn at random, as the only one. Counting only those in the weight
+ * keeps the estimate unbiased, with far less variance than drawing from all
+ * of the choices, since most of them fail at once.
+ */
+static void probeChoice(STACK stack)
+{
+  struct stackEntry* entry = stack->stackTop;
+  int viable = 0, chosen = 0;
+  for (int choice = 0; choice < entry->numberOfChoices; choice++) {
+    PredicateResult result = entry->predicate->retry(entry->round, choice);
+    trailRewindTo(entry->trail);
+    /* Reservoir sampling: each viable choice is kept with chance 1/viable. */
+    if (result.code != PREDICATE_FAIL &&
+        engineRandom(stack->probe) % ++viable == 0) {
+      chosen = choice;
+    }
+  }
+  entry->weight *= viable;
+  entry->currentChoice = chosen;
+  entry->numberOfChoices = viable == 0 ? 0 : chosen + 1;
 }
 
 /**
@@ -85,8 +305,25 @@ static void pushStackEntry(struct stackEntry* entry, PredicateResultCode code)
  */
 static bool callPort(STACK stack)
 {
-  PredicateResult result =
-      stack->stackTop->predicate->try(stack->stackTop->round);
+  struct predicateProfile* profile = stack->stackTop->profile;
+  uint64 counts[PERF_COUNTERS];
+  uint64 weight = profileWeight(profile->calls), start = 0;
+  PredicateResult result;
+  if (PerfCountersEnabled) {
+    perfCountersRead(counts);
+  }
+  if (weight != 0) {
+    start = profileTicks();
+  }
+  result = stack->stackTop->predicate->try(stack->stackTop->round);
+  if (weight != 0) {
+    profile->tryTicks += (profileTicks() - start) * weight;
+  }
+  if (PerfCountersEnabled) {
+    profileCounters(profile, counts);
+  }
+  profile->calls++;
+  profileResult(profile, result.code);
 
   switch (result.code) {
     case PREDICATE_SUCCESS_NEXT_PREDICATE:
@@ -97,11 +334,22 @@ static bool callPort(STACK stack)
 
     case PREDICATE_FAIL: /* 0 choices */
     case PREDICATE_CHOICES:
+      if (result.numberOfChoices > 1) {
+        statisticHistogramAdd(&ChoiceTrailDepth, Trail - TrailArray);
+      }
       // Start trying choice
       stack->stackTop->inChoiceMode = true;
       stack->stackTop->currentChoice = 0;
       stack->stackTop->numberOfChoices = result.numberOfChoices;
       stack->stackTop->trail = Trail;
+      if (result.numberOfChoices == 0) {
+        countLeaf(stack, stack->stackTop->weight, stack->stackTop->nodes);
+      } else if (stack->probe != NULL) {
+        probeChoice(stack);
+      } else {
+        stack->stackTop->weight *= result.numberOfChoices;
+      }
+      replayChoices(stack);
       break;
     case PREDICATE_SUSPEND:
       return false;
@@ -114,11 +362,32 @@ static bool callPort(STACK stack)
  */
 static void retryPort(STACK stack)
 {
-  PredicateResult result = stack->stackTop->predicate->retry(
+  struct predicateProfile* profile = stack->stackTop->profile;
+  uint64 counts[PERF_COUNTERS];
+  uint64 weight = profileWeight(profile->retries), start = 0;
+  PredicateResult result;
+  replayMoveOn(stack);
+  if (PerfCountersEnabled) {
+    perfCountersRead(counts);
+  }
+  if (weight != 0) {
+    start = profileTicks();
+  }
+  result = stack->stackTop->predicate->retry(
       stack->stackTop->round, stack->stackTop->currentChoice++);
+  if (weight != 0) {
+    profile->retryTicks += (profileTicks() - start) * weight;
+  }
+  if (PerfCountersEnabled) {
+    profileCounters(profile, counts);
+  }
+  profile->retries++;
+  profileResult(profile, result.code);
 
   switch (result.code) {
     case PREDICATE_FAIL:
+      countLeaf(stack, stack->stackTop->weight,
+                stack->stackTop->nodes + stack->stackTop->weight);
       trailRewindTo(stack->stackTop->trail);
       break;
 
@@ -141,10 +410,13 @@ static void retryPort(STACK stack)
 static bool engineLoop(STACK stack)
 {
   while (true) {
-    freeAll();
+    freeTo(stack->context.arena);
     trailRewindTo(stack->stackTop->trail);
+    if (PollRequest != NULL && *PollRequest != 0) {
+      PollHandler(stack);
+    }
     if (!stack->stackTop->inChoiceMode) {
-      trace(stack, "call");
+      trace(stack, TRACE_CALL);
       if (!callPort(stack)) {
         return false;
       }
@@ -152,7 +424,7 @@ static bool engineLoop(STACK stack)
       if (stack->stackTop->currentChoice >= stack->stackTop->numberOfChoices) {
         /* backtrack */
         do {
-          trace(stack, "fail");
+          trace(stack, TRACE_FAIL);
           if (stack->stackTop == stack->stack) {
             return true;  // All done
           }
@@ -160,30 +432,184 @@ static bool engineLoop(STACK stack)
         } while (!stack->stackTop->inChoiceMode);
         continue;
       }
-      trace(stack, "retry");
+      trace(stack, TRACE_RETRY);
       retryPort(stack);
     }
   }
 }
 
+static void onTrailOverflow(int number, siginfo_t* info, void* context)
+{
+  static const char message[] = "Trail overflow: increase TRAIL_CAPACITY\n";
+  uintptr_t address = (uintptr_t)info->si_addr;
+  (void)context;
+  if (address >= (uintptr_t)TrailEnd &&
+      address < (uintptr_t)TrailEnd + (uintptr_t)sysconf(_SC_PAGESIZE)) {
+    write(STDERR_FILENO, message, sizeof(message) - 1);
+    traceWrite();
+    _exit(EXIT_FAILURE);
+  }
+  /* Not ours: fault again, as if there were no handler. */
+  signal(number, SIG_DFL);
+}
+
+/*
+ * Reserves the trail before main, so that it is there for every use,
+ * including the tests that do not initialize the rest of the program.
+ */
+__attribute__((constructor)) static void reserveTrail(void)
+{
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  size_t size = TRAIL_CAPACITY * sizeof(struct trail);
+  struct sigaction action;
+  void* reserved = mmap(NULL, size + page, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (reserved == MAP_FAILED ||
+      mprotect((char*)reserved + size, page, PROT_NONE) != 0) {
+    perror("trail");
+    exit(EXIT_FAILURE);
+  }
+  Trail = TrailArray = reserved;
+  TrailEnd = TrailArray + TRAIL_CAPACITY;
+  memset(&action, 0, sizeof(action));
+  action.sa_sigaction = onTrailOverflow;
+  action.sa_flags = SA_SIGINFO;
+  sigaction(SIGSEGV, &action, NULL);
+}
+
+/* Runs the engine loop with stack as the current context. */
+static bool runEngine(STACK stack)
+{
+  struct engineContext* outer = Context;
+  bool outermost = SearchStack == NULL;
+  bool result;
+  if (outermost) {
+    SearchStack = stack;
+  }
+  Context = &stack->context;
+  result = engineLoop(stack);
+  Context = outer;
+  if (outermost) {
+    SearchStack = NULL;
+  }
+  return result;
+}
+
 void initializeTrail()
 {
-  statisticIncludeInteger(&MaxTrailSize, "$", "MaxTrail", true);
+  statisticIncludeMaximum(&MaxTrailSize, "$", "MaxTrail", true);
+  statisticIncludeHistogram(&ChoiceTrailDepth, "$", "trail at choice", true);
+}
+
+uint64 trailCapacity(void)
+{
+  return TRAIL_CAPACITY;
+}
+
+void trailRegisterDynamic(void* start, uint64 size)
+{
+  uintptr_t from = (uintptr_t)start, to = from + size;
+  for (int i = 0; i < DynamicRegionCount; i++) {
+    if (DynamicRegions[i].start == start && DynamicRegions[i].size == size) {
+      return;
+    }
+  }
+  if (DynamicRegionCount == MAX_DYNAMIC_REGIONS) {
+    fprintf(stderr, "Too many dynamic regions: increase MAX_DYNAMIC_REGIONS\n");
+    exit(EXIT_FAILURE);
+  }
+  DynamicRegions[DynamicRegionCount].start = start;
+  DynamicRegions[DynamicRegionCount].size = size;
+  DynamicRegionCount++;
+  if (DynamicStart != DynamicEnd) {
+    from = from < DynamicStart ? from : DynamicStart;
+    to = to > DynamicEnd ? to : DynamicEnd;
+  }
+  /* Changing the region would misread entries already on the trail. */
+  if (Trail != TrailArray || (to - from) / sizeof(uint_trail) >
+                                 MAX_DYNAMIC_WORDS) {
+    return;
+  }
+  DynamicStart = from;
+  DynamicEnd = to;
+}
+
+#ifdef TRAIL_CHECK
+static bool inDynamicRegion(void* ptr)
+{
+  for (int i = 0; i < DynamicRegionCount; i++) {
+    if ((char*)ptr >= DynamicRegions[i].start &&
+        (char*)ptr + sizeof(uint_trail) <=
+            DynamicRegions[i].start + DynamicRegions[i].size) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif
+
+static void trailPush(void* ptr, uint_trail value)
+{
+  uintptr_t offset = (uintptr_t)ptr - DynamicStart;
+#ifdef TRAIL_CHECK
+  assert(inDynamicRegion(ptr));
+#endif
+  if (offset < DynamicEnd - DynamicStart && offset % sizeof(uint_trail) == 0) {
+    offset /= sizeof(uint_trail);
+    if (value <= UINT32_MAX) {
+      Trail[0].word = (uint32_t)value;
+      Trail[1].word = (uint32_t)(offset << 1);
+      Trail += 2;
+    } else {
+      Trail[0].word = (uint32_t)value;
+      Trail[1].word = (uint32_t)(value >> 32);
+      Trail[2].word = (uint32_t)(offset << 2 | 1);
+      Trail += 3;
+    }
+  } else {
+    Trail[0].word = (uint32_t)(uintptr_t)ptr;
+    Trail[1].word = (uint32_t)((uint64)(uintptr_t)ptr >> 32);
+    Trail[2].word = (uint32_t)value;
+    Trail[3].word = (uint32_t)(value >> 32);
+    Trail[4].word = TRAIL_ABSOLUTE;
+    Trail += 5;
+  }
+}
+
+static uint_trail trailWideValue(TRAIL entry)
+{
+  return entry[0].word | (uint_trail)entry[1].word << 32;
+}
+
+/* Pops the last entry off the trail, restoring the old value. */
+static void trailPop(void)
+{
+  uint32_t tag = (--Trail)->word;
+  uint_trail* ptr;
+  if ((tag & 1) == 0) {
+    Trail--;
+    ptr = (uint_trail*)DynamicStart + (tag >> 1);
+    *ptr = Trail->word;
+  } else if (tag != TRAIL_ABSOLUTE) {
+    Trail -= 2;
+    ptr = (uint_trail*)DynamicStart + (tag >> 2);
+    *ptr = trailWideValue(Trail);
+  } else {
+    Trail -= 4;
+    ptr = (uint_trail*)(uintptr_t)trailWideValue(Trail);
+    *ptr = trailWideValue(Trail + 2);
+  }
 }
 
 void trailSetPointer(void** ptr, void* value)
 {
-  Trail->ptr = ptr;
-  Trail->value = (uint_trail)*ptr;
-  Trail++;
+  trailPush(ptr, (uint_trail)*ptr);
   *ptr = value;
 }
 
 void trailSetInt(uint_trail* ptr, uint_trail value)
 {
-  Trail->ptr = ptr;
-  Trail->value = *ptr;
-  Trail++;
+  trailPush(ptr, *ptr);
   *ptr = value;
 }
 
@@ -197,12 +623,12 @@ bool trailMaybeSetInt(uint_trail* ptr, uint_trail value)
 }
 
 /**
- * Freezes the trail at its current point. Backtracking won't go beyond this
- * point.
+ * Freezes the trail at its current point. Backtracking in the current engine
+ * won't go beyond this point.
  */
 void trailFreeze()
 {
-  frozenTrail = Trail;
+  Context->floor = Trail;
 }
 
 /**
@@ -215,13 +641,12 @@ bool trailRewindTo(TRAIL backtrackPoint)
     MaxTrailSize = trailSize;
   }
   bool result = false;
-  if (backtrackPoint < frozenTrail) {
-    backtrackPoint = frozenTrail;
+  if (backtrackPoint < Context->floor) {
+    backtrackPoint = Context->floor;
   }
   while (Trail > backtrackPoint) {
     result = true;
-    Trail--;
-    *(uint_trail*)Trail->ptr = Trail->value;
+    trailPop();
   }
   return result;
 }
@@ -231,17 +656,34 @@ bool trailRewindTo(TRAIL backtrackPoint)
  * See docs/DESIGN.md for detailed explanation of the execution model.
  */
 bool engine(STACK stack, PREDICATE* predicates)
+{
+  return engineReplay(stack, predicates, NULL);
+}
+
+static bool startEngine(STACK stack, PREDICATE* predicates,
+                        const struct choicePath* path, uint64* probe)
 {
   bool result;
+  stack->probe = probe;
+  stack->replay = path;
+  stack->replayLength = path == NULL ? 0 : path->length;
   stack->stackTop = stack->stack;
   stack->stackTop->inChoiceMode = false;
   stack->stackTop->predicate = *predicates;
   stack->stackTop->predicates = predicates;
+  stack->stackTop->profile = profileOf(*predicates);
   stack->stackTop->currentChoice = -1;
   stack->stackTop->round = 0;
   stack->stackTop->trail = Trail;
   stack->stackTop->counter = EngineCounter++;
-  result = engineLoop(stack);
+  stack->stackTop->weight = 1.0;
+  stack->stackTop->nodes = 1.0;
+  if (SearchStack == NULL) {
+    LeafWeights = WeightedEstimates = 0.0;
+  }
+  stack->context.floor = Trail;
+  stack->context.arena = tempMark();
+  result = runEngine(stack);
 
   if (!result) {
     if (TracingFlag) {
@@ -254,6 +696,30 @@ bool engine(STACK stack, PREDICATE* predicates)
   return result;
 }
 
+bool engineReplay(STACK stack, PREDICATE* predicates,
+                  const struct choicePath* path)
+{
+  return startEngine(stack, predicates, path, NULL);
+}
+
+bool engineProbe(STACK stack, PREDICATE* predicates, uint64* random)
+{
+  return startEngine(stack, predicates, NULL, random);
+}
+
+uint64 engineRandom(uint64* state)
+{
+  uint64 z = (*state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+double engineWeight(void)
+{
+  return SearchStack == NULL ? 1.0 : SearchStack->stackTop->weight;
+}
+
 /**
  * Continue from the suspension point, with a new set of predicates.
  * When the new predicates complete, we backtrack through
@@ -266,14 +732,18 @@ void engineResume(STACK stack, PREDICATE* predicates)
   pushStackEntry(++stack->stackTop, PREDICATE_SUCCESS_NEXT_PREDICATE);
   stack->stackTop->predicate = *predicates;
   stack->stackTop->predicates = predicates;
-  successfulRun = engineLoop(stack);
+  stack->stackTop->profile = profileOf(*predicates);
+  successfulRun = runEngine(stack);
   // Suspending twice is not supported.
   assert(successfulRun);
 }
 
 void engineClear(STACK stack)
 {
+  struct engineContext* outer = Context;
+  Context = &stack->context;
   trailRewindTo(stack->stackTop->trail);
+  Context = outer;
 }
 /**
  * Helper macro for defining simple predicates with no retry behavior.
@@ -297,3 +767,142 @@ SIMPLE_PREDICATE(FAIL)
  * caller. Used for testing.
  */
 SIMPLE_PREDICATE(SUSPEND)
+
+bool engineSplit(STACK stack, PREDICATE predicate, CHOICE_PATH path)
+{
+  struct stackEntry* entry;
+  int depth, remaining, split;
+  for (entry = stack->stack; entry <= stack->stackTop; entry++) {
+    if (entry->inChoiceMode && entry->predicate == predicate &&
+        entry->currentChoice < entry->numberOfChoices) {
+      break;
+    }
+  }
+  if (entry > stack->stackTop) {
+    return false;
+  }
+  depth = entry - stack->stack;
+  for (int i = 0; i < depth; i++) {
+    struct stackEntry* ancestor = stack->stack + i;
+    if (ancestor->inChoiceMode) {
+      /* The choice being explored is the one before currentChoice. */
+      path->steps[i].first = ancestor->currentChoice - 1;
+      path->steps[i].end = ancestor->currentChoice;
+    } else {
+      path->steps[i].first = path->steps[i].end = -1;
+    }
+  }
+  remaining = entry->numberOfChoices - entry->currentChoice;
+  split = entry->currentChoice + remaining / 2;
+  path->steps[depth].first = split;
+  path->steps[depth].end = entry->numberOfChoices;
+  path->length = depth + 1;
+  entry->numberOfChoices = split;
+  return true;
+}
+
+void engineContinuationPath(STACK stack, CHOICE_PATH path)
+{
+  int depth = stack->stackTop - stack->stack;
+  for (int i = 0; i < depth; i++) {
+    struct stackEntry* ancestor = stack->stack + i;
+    if (ancestor->inChoiceMode) {
+      /* Redo the choice being explored, and then the rest. */
+      path->steps[i].first = ancestor->currentChoice - 1;
+      path->steps[i].end = ancestor->numberOfChoices;
+    } else {
+      path->steps[i].first = path->steps[i].end = -1;
+    }
+  }
+  path->length = depth;
+  if (stack->stackTop->inChoiceMode) {
+    /* Between choices: the earlier ones are done. */
+    path->steps[depth].first = stack->stackTop->currentChoice;
+    path->steps[depth].end = stack->stackTop->numberOfChoices;
+    path->length = depth + 1;
+  }
+}
+
+void enginePollWith(volatile int* request, void (*handler)(STACK stack))
+{
+  PollRequest = request;
+  PollHandler = handler;
+}
+
+STACK engineSearchStack(void)
+{
+  return SearchStack;
+}
+
+double engineEstimatedNodes(void)
+{
+  return LeafWeights > 0.0 ? WeightedEstimates / LeafWeights : 0.0;
+}
+
+double engineProgress(void)
+{
+  double result = 0.0;
+  if (SearchStack == NULL) {
+    return 1.0;
+  }
+  for (struct stackEntry* entry = SearchStack->stack;
+       entry <= SearchStack->stackTop; entry++) {
+    if (entry->inChoiceMode && entry->numberOfChoices > 0) {
+      /* Below the top, the choice before currentChoice is being explored. */
+      int done = entry < SearchStack->stackTop ? entry->currentChoice - 1
+                                               : entry->currentChoice;
+      result += done / entry->weight;
+    }
+  }
+  return result;
+}
+
+const struct predicateProfile* engineProfile(PREDICATE predicate)
+{
+  return findProfile(predicate);
+}
+
+const char* enginePredicateName(int id)
+{
+  return id < ProfileCount ? Profiles[id].predicate->name : NULL;
+}
+
+void enginePrintProfile(FILE* fp)
+{
+  uint64 total = 0;
+  for (int i = 0; i < ProfileCount; i++) {
+    total += Profiles[i].tryTicks + Profiles[i].retryTicks;
+  }
+  if (total == 0) {
+    return;
+  }
+  fprintf(fp, "%16s %12s %12s %12s %12s %8s %8s\n", "Predicate", "Calls",
+          "Retries", "Successes", "Failures", "Try%", "Retry%");
+  for (int i = 0; i < ProfileCount; i++) {
+    struct predicateProfile* profile = Profiles + i;
+    fprintf(fp, "%16s %12llu %12llu %12llu %12llu %8.2f %8.2f\n",
+            profile->predicate->name, profile->calls, profile->retries,
+            profile->successes, profile->failures,
+            100.0 * profile->tryTicks / total,
+            100.0 * profile->retryTicks / total);
+  }
+}
+
+void enginePrintCounters(FILE* fp)
+{
+  if (!PerfCountersEnabled) {
+    return;
+  }
+  fprintf(fp, "%16s %14s %14s %6s %12s %12s\n", "Predicate", "Cycles",
+          "Instructions", "IPC", "CacheMisses", "BranchMisses");
+  for (int i = 0; i < ProfileCount; i++) {
+    const uint64* counters = Profiles[i].counters;
+    fprintf(fp, "%16s %14llu %14llu %6.2f %12llu %12llu\n",
+            Profiles[i].predicate->name, counters[PERF_CYCLES],
+            counters[PERF_INSTRUCTIONS],
+            counters[PERF_CYCLES] == 0 ? 0.0
+                                       : (double)counters[PERF_INSTRUCTIONS] /
+                                             counters[PERF_CYCLES],
+            counters[PERF_CACHE_MISSES], counters[PERF_BRANCH_MISSES]);
+  }
+}
@@ -3,6 +3,7 @@
 #ifndef ENGINE_H
 #define ENGINE_H
 
+#include "perfcounters.h"
 #include "trail.h"
 
 /**
@@ -73,6 +74,23 @@ typedef struct predicate {
                            int choice); /* Function for trying alternatives */
 }* PREDICATE;
 
+/**
+ * What the engine has seen of one predicate. The times are in ticks of the
+ * processor's time stamp counter, or in nanoseconds where there is none, and
+ * include any nested engine run from the predicate. Beyond the first few
+ * ports of each kind, they are estimated from a sample of the ports.
+ */
+struct predicateProfile {
+  PREDICATE predicate;
+  uint64 calls;      /* Calls of try */
+  uint64 retries;    /* Calls of retry */
+  uint64 successes;  /* Either returning success */
+  uint64 failures;   /* Either returning failure */
+  uint64 tryTicks;   /* Time in try */
+  uint64 retryTicks; /* Time in retry */
+  uint64 counters[PERF_COUNTERS]; /* In try and retry, with -H */
+};
+
 struct stackEntry {
   bool inChoiceMode;             /* Whether we're exploring alternatives */
   struct predicate* predicate;   /* Current predicate being executed */
@@ -82,12 +100,48 @@ struct stackEntry {
   TRAIL trail;                   /* Backtracking trail */
   int counter;                   /* Counter for tracing */
   int numberOfChoices;           /* Total alternatives in this predicate */
+  struct predicateProfile* profile; /* Counters for the predicate */
+  double weight; /* Product of the numbers of choices on the way here */
+  double nodes;  /* Knuth's estimate of the tree from the path here */
 };
 
 #define MAX_STACK_SIZE 1000
 
+/**
+ * A choice path names a subtree of the search by the choices made at each
+ * depth of the stack on the way to it. Replaying a path reproduces the
+ * ancestors of the subtree, and then explores just that subtree. A step may
+ * be a range of choices: the deeper steps apply only to its first choice,
+ * and the rest of the range is then explored in full.
+ */
+struct choiceRange {
+  int first; /* First choice to explore, or -1 where there is no choice */
+  int end;   /* One more than the last choice to explore */
+};
+
+typedef struct choicePath {
+  int length; /* Number of stack depths covered */
+  struct choiceRange steps[MAX_STACK_SIZE];
+}* CHOICE_PATH;
+
+/**
+ * What a run of the engine owns, so that a predicate can run another engine
+ * without disturbing its own. The trail itself is shared: a nested engine
+ * starts with its floor at the end of the outer engine's trail, and never
+ * rewinds past it. Likewise, each step frees only the temporaries allocated
+ * since the run began.
+ */
+struct engineContext {
+  TRAIL floor;           /* Backtracking stops here, see trailFreeze */
+  struct tempMark arena; /* Temporaries from before the run */
+};
+
 typedef struct stack {
   struct stackEntry* stackTop;
+  struct engineContext context;
+  const struct choicePath* replay; /* Choices to take, or NULL */
+  int replayLength;                /* Depths at which replay still applies */
+  uint64* probe; /* Random state choosing the only choice taken, or NULL */
   struct stackEntry stack[MAX_STACK_SIZE + 1];
 }* STACK;
 /* Predefined predicates for ending search sequences */
@@ -112,6 +166,99 @@ extern void engineResume(STACK stack, PREDICATE* predicates);
 
 extern void engineClear(STACK stack);
 
+/**
+ * Like engine, but the choice points at the depths covered by path explore
+ * only the choices it gives. The predicates must make the same choice
+ * points as when the path was recorded.
+ */
+extern bool engineReplay(STACK stack, PREDICATE* predicates,
+                         const struct choicePath* path);
+
+/**
+ * Like engine, but a random probe: at each choice point every choice is
+ * retried once, and one of those that do not fail, drawn with engineRandom
+ * from *random, is the only one explored, so that there is one path from the
+ * root to a leaf. engineWeight is then the inverse of the chance of reaching
+ * the current point, as in Knuth's estimate of the size of a search tree,
+ * with one step of look-ahead. A retry must depend only on its choice, not on
+ * which choice was retried before.
+ */
+extern bool engineProbe(STACK stack, PREDICATE* predicates, uint64* random);
+
+/* The next of a sequence of pseudo-random numbers, splitmix64. */
+extern uint64 engineRandom(uint64* state);
+
+/* The product of the numbers of choices at each choice point above the top
+ * of the outermost engine; for a probe, of those that did not fail. */
+extern double engineWeight(void);
+
+/**
+ * Gives away half of the untried choices of the shallowest choice point of
+ * the given predicate. On success, path is set to the given away subtree,
+ * which this stack will no longer explore, and true is returned.
+ */
+extern bool engineSplit(STACK stack, PREDICATE predicate, CHOICE_PATH path);
+
+/**
+ * Sets path to the choices that replay the stack to its current point, after
+ * which the search carries on from there, as if it had never stopped.
+ * Replaying calls try again for every entry on the stack, including the top
+ * one. For use from a poll handler.
+ */
+extern void engineContinuationPath(STACK stack, CHOICE_PATH path);
+
+/**
+ * Between steps, whenever *request is non-zero, the engine calls handler,
+ * which may, for example, use engineSplit on the stack. This is cheap
+ * enough to leave on: the request is typically set by another process.
+ * Nested engines share the same handler.
+ */
+extern void enginePollWith(volatile int* request, void (*handler)(STACK stack));
+
+/**
+ * The stack of the outermost running engine, or NULL. A sampler may read it
+ * from a signal handler, at some cost in accuracy at the top of the stack.
+ */
+extern STACK engineSearchStack(void);
+
+/**
+ * An estimate of the number of nodes in the tree of the outermost running
+ * engine, from the leaves it has reached so far. Each leaf gives Knuth's
+ * estimate for the path to it. These are averaged weighted by the chance
+ * of a random probe reaching that leaf, which corrects for depth first
+ * search reaching the leaves below few choices first. Once the tree is
+ * done, the estimate is exact. Returns 0 before any leaf.
+ */
+extern double engineEstimatedNodes(void);
+
+/**
+ * How much of the tree of the outermost running engine is done, from 0 to
+ * 1, from the current choice out of the number of choices at each level of
+ * its stack. Returns 1 once it is done.
+ */
+extern double engineProgress(void);
+
+/**
+ * The profile of predicate, or NULL if the engine has not yet run it.
+ */
+extern const struct predicateProfile* engineProfile(PREDICATE predicate);
+
+/**
+ * The name of the predicate with the given profile index, or NULL past the
+ * last. Traces identify predicates in this way.
+ */
+extern const char* enginePredicateName(int id);
+
+/**
+ * Prints a table of the profile of every predicate the engine has run.
+ */
+extern void enginePrintProfile(FILE* fp);
+
+/**
+ * Prints a table of the hardware counts of every predicate, if counted.
+ */
+extern void enginePrintCounters(FILE* fp);
+
 /*--------------------------------------
  * Predicate Definition Macros
  *--------------------------------------*/
@@ -0,0 +1,152 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "estimate.h"
+
+#include "predicates.h"
+#include "statistics.h"
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* What one probe reached, each as its weight, or 0. */
+struct probeResult {
+  double solutions;
+  double variants;
+};
+
+/* Shared with the workers, which each fill in the results of their probes,
+ * so that the totals are summed in the same order however many there are. */
+static struct probeResult* Results = NULL;
+static struct probeResult* CurrentResult;
+static struct statisticTotals* Totals;
+static struct stack ProbeStack;
+
+static struct predicateResult tryProbeSolution(int round)
+{
+  (void)round;
+  CurrentResult->solutions = engineWeight();
+  return PredicateSuccessNextPredicate;
+}
+
+static struct predicateResult tryProbeVariant(int round)
+{
+  (void)round;
+  CurrentResult->variants = engineWeight();
+  return PredicateFail;
+}
+
+static struct predicate ProbeSolutionPredicate = {"ProbeSolution",
+                                                  tryProbeSolution, NULL};
+static struct predicate ProbeVariantPredicate = {"ProbeVariant",
+                                                 tryProbeVariant, NULL};
+
+/* NonDeterministicProgram without its output. */
+static PREDICATE ProbeProgram[] = {
+    &InitializePredicate,    &InnerFacePredicate, &VennPredicate,
+    &ProbeSolutionPredicate, &CornersPredicate,   &ProbeVariantPredicate,
+    &FAILPredicate};
+
+/* Runs every workers-th probe, starting with first. */
+static void runProbes(int first, int probes, int workers, uint64 seed)
+{
+  for (int i = first; i < probes; i += workers) {
+    uint64 number = (uint64)i;
+    uint64 random = seed ^ engineRandom(&number);
+    CurrentResult = Results + i;
+    engineProbe(&ProbeStack, ProbeProgram, &random);
+  }
+}
+
+static void waitForWorkers(int workers)
+{
+  bool failed = false;
+  for (int i = 0; i < workers; i++) {
+    int status;
+    if (wait(&status) < 0) {
+      perror("wait");
+      exit(EXIT_FAILURE);
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+      failed = true;
+    }
+  }
+  if (failed) {
+    fprintf(stderr, "A worker process failed; the estimate is incomplete.\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void printEstimate(const char* name, double sum, double sumOfSquares,
+                          int reached, int probes)
+{
+  double mean = sum / probes;
+  double variance =
+      probes > 1 ? (sumOfSquares - probes * mean * mean) / (probes - 1) : 0.0;
+  double halfWidth = 1.96 * sqrt(fmax(variance, 0.0) / probes);
+  printf("%s: %.4g +- %.2g (95%%), %.4g to %.4g; reached by %d probes\n", name,
+         mean, halfWidth, fmax(mean - halfWidth, 0.0), mean + halfWidth,
+         reached);
+}
+
+void estimateSearch(int probes, uint64 seed, int workers)
+{
+  size_t size = probes * sizeof(*Results);
+  double solutions = 0.0, solutionSquares = 0.0;
+  double variants = 0.0, variantSquares = 0.0;
+  int solutionsReached = 0, variantsReached = 0;
+  assert(probes > 0 && probes <= MAX_ESTIMATE_PROBES);
+  Results = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (Results == MAP_FAILED) {
+    perror("mmap");
+    exit(EXIT_FAILURE);
+  }
+  if (workers == 0) {
+    runProbes(0, probes, 1, seed);
+  } else {
+    engine(&ProbeStack, (PREDICATE[]){&InitializePredicate, &FAILPredicate});
+    /* Every statistic has been registered by the initialization. */
+    Totals = statisticTotalsCreate();
+    fflush(NULL);
+    for (int i = 0; i < workers; i++) {
+      pid_t pid = fork();
+      if (pid < 0) {
+        perror("fork");
+        exit(EXIT_FAILURE);
+      }
+      if (pid == 0) {
+        /* Lines from different workers share stdout, keep each one whole. */
+        setvbuf(stdout, NULL, _IOLBF, 0);
+        statisticClear();
+        runProbes(i, probes, workers, seed);
+        statisticAddTo(Totals);
+        fflush(stdout);
+        _exit(EXIT_SUCCESS);
+      }
+    }
+    waitForWorkers(workers);
+    statisticSetFrom(Totals);
+    statisticTotalsFree(Totals);
+  }
+  for (int i = 0; i < probes; i++) {
+    solutions += Results[i].solutions;
+    solutionSquares += Results[i].solutions * Results[i].solutions;
+    solutionsReached += Results[i].solutions > 0.0;
+    variants += Results[i].variants;
+    variantSquares += Results[i].variants * Results[i].variants;
+    variantsReached += Results[i].variants > 0.0;
+  }
+  munmap(Results, size);
+  printf("Probes: %d, seed %llu\n", probes, (unsigned long long)seed);
+  printEstimate("Solutions", solutions, solutionSquares, solutionsReached,
+                probes);
+  printEstimate("Variations", variants, variantSquares, variantsReached,
+                probes);
+}
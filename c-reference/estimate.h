@@ -0,0 +1,29 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef ESTIMATE_H
+#define ESTIMATE_H
+
+#include "core.h"
+
+/**
+ * Estimates the numbers of solutions, and of their variations, for searches
+ * too large to run in full. Each probe runs the search from the root down
+ * one randomly chosen path, see engineProbe, and a solution, or variation,
+ * reached with weight W counts as W of them. The mean over the probes is an
+ * unbiased estimate of each number, reported with a 95% confidence interval
+ * from the normal approximation, which is only as good as the probes are
+ * many: most reach neither, and a few reach one with a large weight.
+ *
+ * Each probe draws its choices from a state derived from the seed and its
+ * number, so runs with the same arguments report the same estimates, with
+ * or without workers, as long as the search order is repeatable.
+ */
+
+/* The most probes in one run. */
+#define MAX_ESTIMATE_PROBES (1 << 24)
+
+/* Runs the probes, in that many worker processes, or in this one for 0,
+ * leaving the combined statistics of the search in this process. */
+extern void estimateSearch(int probes, uint64 seed, int workers);
+
+#endif  // ESTIMATE_H
@@ -3,12 +3,17 @@
 #include "face.h"
 
 #include "failure.h"
+#include "memoimage.h"
+#include "memotables.h"
 #include "s6.h"
 #include "statistics.h"
+#include "trail.h"
 #include "utils.h"
 
 struct face Faces[NFACES];
+struct faceNeighbours FaceNeighboursByCycleId[NFACES][NCYCLES];
 uint64 FaceSumOfFaceDegree[NCOLORS + 1];
+uint64 FacesWithoutCycleState[FACESET_LENGTH];
 
 static void initializeLengthOfCycleOfFaces(void)
 {
@@ -121,15 +126,56 @@ static void applyMonotonicity(void)
       } else {
         assert(previousFaceColors);
         assert(nextFaceColors);
-        face->nextByCycleId[cycleId] = Faces + nextFaceColors;
-        face->previousByCycleId[cycleId] = Faces + previousFaceColors;
+        FaceNeighboursByCycleId[faceColors][cycleId].next =
+            (uint8_t)nextFaceColors;
+        FaceNeighboursByCycleId[faceColors][cycleId].previous =
+            (uint8_t)previousFaceColors;
       }
     }
     dynamicRecomputeCountOfChoices(face);
   }
+}
 
-  dynamicFaceSetCycleLength(0, NCOLORS);
-  dynamicFaceSetCycleLength(~0, NCOLORS);
+static void loadMemo(const struct memoTables* tables)
+{
+  memcpy(FaceNeighboursByCycleId, tables->faceNeighbours,
+         sizeof(FaceNeighboursByCycleId));
+  for (COLORSET faceColors = 1; faceColors < NFACES - 1; faceColors++) {
+    FACE face = Faces + faceColors;
+    memcpy(face->possibleCycles, tables->possibleCycles[faceColors],
+           sizeof(face->possibleCycles));
+    dynamicRecomputeCountOfChoices(face);
+  }
+}
+
+void facesSaveMemo(struct memoTables* tables)
+{
+  memcpy(tables->faceNeighbours, FaceNeighboursByCycleId,
+         sizeof(FaceNeighboursByCycleId));
+  for (COLORSET faceColors = 0; faceColors < NFACES; faceColors++) {
+    memcpy(tables->possibleCycles[faceColors], Faces[faceColors].possibleCycles,
+           sizeof(Faces[faceColors].possibleCycles));
+  }
+  /* As they were before the restrictions on the outer and inner faces. */
+  initializeCycleSetUniversal(tables->possibleCycles[0]);
+  initializeCycleSetUniversal(tables->possibleCycles[NFACES - 1]);
+}
+
+void facesIncludeInImage(void)
+{
+  memoImageInclude(Faces, sizeof(Faces));
+  memoImageInclude(FaceNeighboursByCycleId, sizeof(FaceNeighboursByCycleId));
+  memoImageInclude(FaceSumOfFaceDegree, sizeof(FaceSumOfFaceDegree));
+  for (FACE face = Faces; face < Faces + NFACES; face++) {
+    memoImageIncludePointer(&face->cycle);
+    memoImageIncludePointer(&face->previous);
+    memoImageIncludePointer(&face->next);
+    for (COLOR color = 0; color < NCOLORS; color++) {
+      EDGE edge = face->edges + color;
+      memoImageIncludePointer(face->adjacentFaces + color);
+      memoImageIncludePointer(&edge->reversed);
+    }
+  }
 }
 
 static void initializePossiblyTo(void)
@@ -146,7 +192,8 @@ static void initializePossiblyTo(void)
           continue;
         }
         edge->possiblyTo[othercolor].vertex =
-            initializeVertexIncomingEdge(face->colors, edge, othercolor);
+            1 + vertexNumber(
+                    initializeVertexIncomingEdge(face->colors, edge, othercolor));
       }
     }
   }
@@ -200,14 +247,26 @@ void initializeFacesAndEdges(void)
   uint32_t facecolors, color;
   FACE face, adjacent;
   EDGE edge;
+  trailRegisterDynamic(Faces, sizeof(Faces));
+  trailRegisterDynamic(FacesWithoutCycleState, sizeof(FacesWithoutCycleState));
+  for (uint32_t i = 0; i < FACESET_LENGTH; i++) {
+    uint32_t faces = NFACES - i * BITS_PER_WORD;
+    FacesWithoutCycleState[i] = faces >= BITS_PER_WORD ? ~0ull
+                                                       : (1ull << faces) - 1;
+  }
+  initializeEdgeState();
+  /* Outside the test below, which a loaded image, see memoimage.h, skips. */
+  statisticIncludeInteger(&CycleForcedCounter, "+", "forced", false);
+  statisticIncludeInteger(&CycleSetReducedCounter, "-", "reduced", true);
+  statisticIncludeHistogram(&CycleChoiceHistogram, "?", "cycles at choice",
+                            true);
   if (Faces[1].colors == 0) {
-    statisticIncludeInteger(&CycleForcedCounter, "+", "forced", false);
-    statisticIncludeInteger(&CycleSetReducedCounter, "-", "reduced", true);
     initializeLengthOfCycleOfFaces();
     for (facecolors = 0, face = Faces; facecolors < NFACES;
          facecolors++, face++) {
       face->colors = facecolors;
       initializeCycleSetUniversal(face->possibleCycles);
+      face->cycleSetSize = NCYCLES;
 
       for (color = 0; color < NCOLORS; color++) {
         uint32_t colorbit = (1 << color);
@@ -219,7 +278,13 @@ void initializeFacesAndEdges(void)
         edge->reversed = &adjacent->edges[color];
       }
     }
-    applyMonotonicity();
+    if (memoTables() != NULL) {
+      loadMemo(memoTables());
+    } else {
+      applyMonotonicity();
+    }
+    dynamicFaceSetCycleLength(0, NCOLORS);
+    dynamicFaceSetCycleLength(~0, NCOLORS);
     initializePossiblyTo();
   }
 }
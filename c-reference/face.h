@@ -15,9 +15,15 @@ extern struct face Faces[NFACES];
  */
 extern uint64 FaceSumOfFaceDegree[NCOLORS + 1];
 
+/* Bit i % 64 of word i / 64 is set if Faces[i] may still have no cycle: every
+ * face without a cycle is included, so searchChooseNextFace need look at no
+ * others. */
+extern uint64 FacesWithoutCycleState[FACESET_LENGTH];
+
 /* Dynamic search functions - used in the solving algorithm */
 extern FAILURE dynamicFaceBacktrackableChoice(FACE face);
 extern FAILURE dynamicFaceChoice(FACE face, int depth);
+extern void dynamicFaceHasCycle(FACE face);
 
 /* Core face operations */
 extern void initializeFacesAndEdges(void);
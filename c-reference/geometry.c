@@ -0,0 +1,73 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "geometry.h"
+
+#include "common.h"
+#include "trail.h"
+#include "vertex.h"
+
+static struct solutionGeometry Geometry;
+/* Whether Geometry is that of the current solution: set on the trail, so
+ * that backtracking to another solution forgets it. */
+static DYNAMIC uint_trail GeometryFound = 0;
+
+static int possibleCorners(EDGE *possibilitiesReturn, COLOR color, EDGE from,
+                           EDGE to)
+{
+  if (from == NULL) {
+    EDGE edge = vertexGetCentralEdge(color);
+    return edgePathLength(edge->reversed, edgeFollowBackwards(edge->reversed),
+                          possibilitiesReturn);
+  }
+  return edgePathLength(from->reversed, to, possibilitiesReturn);
+}
+
+static uint64 pathBit(COLOR color, EDGE corner)
+{
+  for (int ix = 0; ix < Geometry.pathLengths[color]; ix++) {
+    if (Geometry.paths[color][ix]->reversed == corner) {
+      /* Corners does its bookkeeping in one word per curve. */
+      assert(ix < (int)BITS_PER_WORD);
+      return 1ull << ix;
+    }
+  }
+  return 0;
+}
+
+static void findGeometry(COLOR color)
+{
+  EDGE cornerPairs[3][2];
+  EDGE edge = vertexGetCentralEdge(color);
+  Geometry.pathLengths[color] =
+      edgePathLength(edge, edgeFollowBackwards(edge), Geometry.paths[color]);
+  vertexAlignCorners(color, cornerPairs);
+  for (int i = 0; i < 3; i++) {
+    EDGE *possibilities = Geometry.possibleCorners[color][i];
+    int count = possibleCorners(possibilities, color, cornerPairs[i][0],
+                                cornerPairs[i][1]);
+    Geometry.possibleCornerCounts[color][i] = count;
+    for (int j = 0; j < count; j++) {
+      Geometry.possibleCornerBits[color][i][j] =
+          pathBit(color, possibilities[j]);
+    }
+  }
+}
+
+void initializeGeometry(void)
+{
+  /* Geometry is not trailed, but GeometryFound is, so a snapshot needs it. */
+  trailRegisterDynamic(&Geometry, sizeof(Geometry));
+  trailRegisterDynamic(&GeometryFound, sizeof(GeometryFound));
+  trailRegisterDynamic(SelectedCornersIPC, sizeof(SelectedCornersIPC));
+}
+
+const struct solutionGeometry *dynamicSolutionGeometry(void)
+{
+  if (!GeometryFound) {
+    for (COLOR color = 0; color < NCOLORS; color++) {
+      findGeometry(color);
+    }
+    trailSetInt(&GeometryFound, 1);
+  }
+  return &Geometry;
+}
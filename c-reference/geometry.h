@@ -0,0 +1,32 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include "edge.h"
+
+/**
+ * The geometry of a complete solution: the curves, and where the corners of
+ * each triangle may be. None of this depends on the corners chosen, so it is
+ * found once, when the solution is saved, for Corners, the line crossing
+ * checks and GraphML to share across all the variations. It is kept until
+ * the search backtracks from the solution.
+ */
+struct solutionGeometry {
+  /* The NULL-terminated path around the central face of each color. */
+  EDGE paths[NCOLORS][NFACES];
+  int pathLengths[NCOLORS];
+  /* The NULL-terminated possibilities for each corner of each color. */
+  EDGE possibleCorners[NCOLORS][3][NFACES];
+  int possibleCornerCounts[NCOLORS][3];
+  /* For each possibility, the bit of its index in the path of its color. */
+  uint64 possibleCornerBits[NCOLORS][3][NFACES];
+};
+
+/* Registers the geometry, and the corners chosen, as dynamic state. */
+extern void initializeGeometry(void);
+
+/* The geometry of the current, complete, solution, found if need be. */
+extern const struct solutionGeometry *dynamicSolutionGeometry(void);
+
+#endif  // GEOMETRY_H
@@ -1,12 +1,17 @@
 /* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
 
 #include "common.h"
+#include "jsonsink.h"
 #include "main.h"
 #include "predicates.h"
 #include "triangles.h"
 #include "utils.h"
+#include "variantdedup.h"
+#include "variantfile.h"
 
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #define DEBUG 0
 
@@ -19,192 +24,284 @@ int LevelsIPC = 0;
 struct graphmlFileIO GraphmlFileOps = {fopen, initializeFolder};
 
 /* GraphML namespace and schema definitions */
-static const char *GRAPHML_NS = "http://graphml.graphdrawing.org/xmlns";
-static const char *GRAPHML_SCHEMA =
-    "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd";
+#define GRAPHML_NS "http://graphml.graphdrawing.org/xmlns"
+#define GRAPHML_SCHEMA "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd"
+
+/* The beginning of a GraphML document, including XML declaration,
+ * namespaces, and attribute definitions. */
+static const char GRAPHML_BEGIN[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<graphml xmlns=\"" GRAPHML_NS "\"\n"
+    "         xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n"
+    "         xsi:schemaLocation=\"" GRAPHML_NS " " GRAPHML_SCHEMA "\">\n"
+    "  <key id=\"colors\" for=\"node\" attr.name=\"colors\" "
+    "attr.type=\"string\"/>\n"
+    "  <key id=\"primary\" for=\"node\" attr.name=\"primary\" "
+    "attr.type=\"string\"/>\n"
+    "  <key id=\"secondary\" for=\"node\" attr.name=\"secondary\" "
+    "attr.type=\"string\"/>\n"
+    "  <key id=\"color\" for=\"edge\" attr.name=\"color\" "
+    "attr.type=\"string\"/>\n"
+    "  <key id=\"line\" for=\"edge\" attr.name=\"line\" "
+    "attr.type=\"string\"/>\n"
+    "  <graph id=\"venn_diagram\" edgedefault=\"undirected\">\n";
+
+static const char GRAPHML_END[] = "  </graph>\n</graphml>\n";
 
 /* Structure to hold data for GraphML output */
 typedef struct {
-  FILE *fp;
   int cornerIds[3];
   int cornerIx;
   COLOR color;
 } GraphMLData;
 
 /**
- * Generates a vertex ID for GraphML output.
- * Uses the format "p_<colorset>_<primary>_<secondary>"
+ * The text of a variation is the same few pieces over and over: the ids and
+ * nodes of the vertices, which are fixed once initializePoints has run, and
+ * of the corners, and the data of each line. These are rendered once, the
+ * first time they are needed, and copied into Output, which is written to
+ * the file of the variation in one go.
  */
-static char *graphmlVertexId(VERTEX vertex)
+struct fragment {
+  int length;
+  char text[192];
+};
+
+static struct fragment VertexIds[NPOINTS];
+static struct fragment VertexNodes[NPOINTS];
+static struct fragment CornerIds[NCOLORS][3];
+static struct fragment ColorSetNames[NFACES];
+/* The data of a corner node after its colors. */
+static struct fragment CornerNodeEnds[NCOLORS];
+/* The data of an edge after its target. */
+static struct fragment EdgeEnds[NCOLORS][3];
+static bool FragmentsRendered = false;
+
+static char *Output = NULL;
+static size_t OutputLength = 0;
+static size_t OutputCapacity = 0;
+
+static void emit(const char *text, size_t length)
 {
-  char *buffer = getBuffer();
-  sprintf(buffer, "p_%s", vertexToString(vertex));
-  return usingBuffer(buffer);
+  if (OutputLength + length > OutputCapacity) {
+    OutputCapacity = OutputCapacity == 0 ? 65536 : 2 * OutputCapacity;
+    Output = realloc(Output, OutputCapacity);
+    if (Output == NULL) {
+      perror("realloc");
+      exit(EXIT_FAILURE);
+    }
+  }
+  memcpy(Output + OutputLength, text, length);
+  OutputLength += length;
 }
 
-/**
- * Generates a corner ID for GraphML output.
- * Uses the format "<color>_<counter>"
- */
-static char *cornerId(COLOR color, int counter)
+#define EMIT_LITERAL(text) emit(text, sizeof(text) - 1)
+
+static void emitFragment(const struct fragment *fragment)
 {
-  char *buffer = getBuffer();
-  assert(counter < 3);
-  sprintf(buffer, "%c_%d", colorToChar(color), counter);
-  return usingBuffer(buffer);
+  emit(fragment->text, fragment->length);
+}
+
+static void render(struct fragment *fragment, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void render(struct fragment *fragment, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  fragment->length =
+      vsnprintf(fragment->text, sizeof(fragment->text), format, args);
+  va_end(args);
+  assert(fragment->length < (int)sizeof(fragment->text));
+}
+
+static void renderFragments(void)
+{
+  for (COLORSET colors = 0; colors < NFACES; colors++) {
+    render(&ColorSetNames[colors], "%s", colorSetToBareString(colors));
+  }
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    int c = colorToChar(color);
+    render(&CornerNodeEnds[color],
+           "</data>\n"
+           "      <data key=\"primary\">%c</data>\n"
+           "      <data key=\"secondary\">%c</data>\n"
+           "    </node>\n",
+           c, c);
+    for (int i = 0; i < 3; i++) {
+      render(&CornerIds[color][i], "%c_%d", c, i);
+      render(&EdgeEnds[color][i],
+             "\">\n"
+             "      <data key=\"color\">%c</data>\n"
+             "      <data key=\"line\">%c%d</data>\n"
+             "    </edge>\n",
+             c, c, i);
+    }
+  }
+  FragmentsRendered = true;
 }
 
 /**
- * Writes the beginning of a GraphML document, including XML declaration,
- * namespaces, and attribute definitions.
+ * The vertex ID for GraphML output.
+ * Uses the format "p_<colorset>_<primary>_<secondary>"
  */
-static void graphmlBegin(FILE *fp)
+static const struct fragment *graphmlVertexId(VERTEX vertex)
 {
-  fprintf(fp, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
-  fprintf(fp, "<graphml xmlns=\"%s\"\n", GRAPHML_NS);
-  fprintf(fp,
-          "         xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n");
-  fprintf(fp, "         xsi:schemaLocation=\"%s %s\">\n", GRAPHML_NS,
-          GRAPHML_SCHEMA);
-
-  /* Define custom attributes */
-  fprintf(fp,
-          "  <key id=\"colors\" for=\"node\" attr.name=\"colors\" "
-          "attr.type=\"string\"/>\n");
-  fprintf(fp,
-          "  <key id=\"primary\" for=\"node\" attr.name=\"primary\" "
-          "attr.type=\"string\"/>\n");
-  fprintf(fp,
-          "  <key id=\"secondary\" for=\"node\" attr.name=\"secondary\" "
-          "attr.type=\"string\"/>\n");
-  fprintf(fp,
-          "  <key id=\"color\" for=\"edge\" attr.name=\"color\" "
-          "attr.type=\"string\"/>\n");
-  fprintf(fp,
-          "  <key id=\"line\" for=\"edge\" attr.name=\"line\" "
-          "attr.type=\"string\"/>\n");
-
-  fprintf(fp, "  <graph id=\"venn_diagram\" edgedefault=\"undirected\">\n");
+  struct fragment *id = &VertexIds[vertexNumber(vertex)];
+  if (id->length == 0) {
+    render(id, "p_%s", vertexToString(vertex));
+    render(&VertexNodes[vertexNumber(vertex)],
+           "    <node id=\"%s\">\n"
+           "      <data key=\"colors\">%s</data>\n"
+           "      <data key=\"primary\">%c</data>\n"
+           "      <data key=\"secondary\">%c</data>\n"
+           "    </node>\n",
+           id->text, vertexToColorSetString(vertex), 'a' + vertex->primary,
+           'a' + vertex->secondary);
+  }
+  return id;
 }
 
 /**
- * Writes the end of a GraphML document.
+ * The corner ID for GraphML output.
+ * Uses the format "<color>_<counter>"
  */
-static void graphmlEnd(FILE *fp)
+static const struct fragment *cornerId(COLOR color, int counter)
 {
-  fprintf(fp, "  </graph>\n");
-  fprintf(fp, "</graphml>\n");
+  assert(counter < 3);
+  return &CornerIds[color][counter];
 }
 
 /**
  * Adds a vertex to the GraphML output.
  */
-static void graphmlAddVertex(FILE *fp, VERTEX vertex)
+static void graphmlAddVertex(VERTEX vertex)
 {
-  char *id = graphmlVertexId(vertex);
-  fprintf(fp, "    <node id=\"%s\">\n", id);
-  fprintf(fp, "      <data key=\"colors\">%s</data>\n",
-          vertexToColorSetString(vertex));
-  fprintf(fp, "      <data key=\"primary\">%c</data>\n", 'a' + vertex->primary);
-  fprintf(fp, "      <data key=\"secondary\">%c</data>\n",
-          'a' + vertex->secondary);
-  fprintf(fp, "    </node>\n");
+  if (BinaryVariationsFlag) {
+    variantFileVertex(vertex);
+    return;
+  }
+  graphmlVertexId(vertex);
+  emitFragment(&VertexNodes[vertexNumber(vertex)]);
 }
 
 /**
  * Adds a corner node to the GraphML output.
  */
-static void graphmlAddCorner(FILE *fp, EDGE edge, COLOR color, int counter)
+static void graphmlAddCorner(EDGE edge, COLOR color, int counter)
 {
   COLORSET colors = edge->colors | (1ll << color);
-  char *id = cornerId(color, counter);
-  fprintf(fp, "    <node id=\"%s\">\n", id);
-  fprintf(fp, "      <data key=\"colors\">%s</data>\n",
-          colorSetToBareString(colors));
-  fprintf(fp, "      <data key=\"primary\">%c</data>\n", colorToChar(color));
-  fprintf(fp, "      <data key=\"secondary\">%c</data>\n", colorToChar(color));
-  fprintf(fp, "    </node>\n");
+  if (BinaryVariationsFlag) {
+    variantFileCorner(edge, color, counter);
+    return;
+  }
+  EMIT_LITERAL("    <node id=\"");
+  emitFragment(cornerId(color, counter));
+  EMIT_LITERAL("\">\n      <data key=\"colors\">");
+  emitFragment(&ColorSetNames[colors]);
+  emitFragment(&CornerNodeEnds[color]);
 }
 
 /**
  * Adds a vertex to the GraphML output if it's a primary vertex for the given
  * color.
  */
-static void addVertexIfPrimary(FILE *fp, VERTEX vertex, COLOR color)
+static void addVertexIfPrimary(VERTEX vertex, COLOR color)
 {
   if (vertex->primary == color) {
-    graphmlAddVertex(fp, vertex);
+    graphmlAddVertex(vertex);
   }
 }
 
 /**
  * Adds corner nodes to the GraphML output.
  */
-static void addCornerNodes(FILE *fp, EDGE (*corners)[3], COLOR color,
-                           int *cornerIds)
+static void addCornerNodes(EDGE (*corners)[3], COLOR color, int *cornerIds)
 {
   for (int i = 0; i < 3; i++) {
-    graphmlAddCorner(fp, (*corners)[i], color, cornerIds[i]);
+    graphmlAddCorner((*corners)[i], color, cornerIds[i]);
   }
 }
 
+static struct variantEndpoint vertexEndpoint(VERTEX vertex)
+{
+  return (struct variantEndpoint){.vertex = vertex, .corner = -1};
+}
+
+static struct variantEndpoint cornerEndpoint(int corner)
+{
+  return (struct variantEndpoint){.vertex = NULL, .corner = corner};
+}
+
+static const struct fragment *endpointId(COLOR color,
+                                         struct variantEndpoint end)
+{
+  return end.vertex == NULL ? cornerId(color, end.corner)
+                            : graphmlVertexId(end.vertex);
+}
+
 /**
  * Adds an edge to the GraphML output.
  */
-static void addEdge(FILE *fp, COLOR color, int line, char *source, char *target)
+static void addEdge(COLOR color, int line, struct variantEndpoint source,
+                    struct variantEndpoint target)
 {
-  fprintf(fp, "    <edge source=\"%s\" target=\"%s\">\n", source, target);
-  fprintf(fp, "      <data key=\"color\">%c</data>\n", colorToChar(color));
-  fprintf(fp, "      <data key=\"line\">%c%d</data>\n", colorToChar(color),
-          line);
-  fprintf(fp, "    </edge>\n");
+  if (BinaryVariationsFlag) {
+    variantFileEdge(color, line, source, target);
+    return;
+  }
+  EMIT_LITERAL("    <edge source=\"");
+  emitFragment(endpointId(color, source));
+  EMIT_LITERAL("\" target=\"");
+  emitFragment(endpointId(color, target));
+  emitFragment(&EdgeEnds[color][line]);
 }
 
 /**
  * Adds a regular edge to the GraphML output.
  */
-static void graphmlAddEdge(FILE *fp, EDGE edge, int line)
+static void graphmlAddEdge(EDGE edge, int line)
 {
   /* Use the primary edge for consistent ID generation */
   if (!IS_CLOCKWISE_EDGE(edge)) {
     edge = edge->reversed;
   }
-  char *source = graphmlVertexId(edge->reversed->to->vertex);
-  char *target = graphmlVertexId(edge->to->vertex);
-  addEdge(fp, edge->color, line, source, target);
+  struct variantEndpoint source = vertexEndpoint(edgeVertex(edge->reversed));
+  struct variantEndpoint target = vertexEndpoint(edgeVertex(edge));
+  addEdge(edge->color, line, source, target);
 }
 
 /**
  * Adds an edge from a vertex to a corner in the GraphML output.
  */
-static void addEdgeToCorner(FILE *fp, EDGE edge, int corner, int line)
+static void addEdgeToCorner(EDGE edge, int corner, int line)
 {
-  char *source = graphmlVertexId(edge->reversed->to->vertex);
-  char *target = cornerId(edge->color, corner);
+  struct variantEndpoint source = vertexEndpoint(edgeVertex(edge->reversed));
+  struct variantEndpoint target = cornerEndpoint(corner);
   assert(line != corner);
-  addEdge(fp, edge->color, line, source, target);
+  addEdge(edge->color, line, source, target);
 }
 
 /**
  * Adds an edge between two corners in the GraphML output.
  */
-static void addEdgeBetweenCorners(FILE *fp, COLOR color, int low, int high)
+static void addEdgeBetweenCorners(COLOR color, int low, int high)
 {
-  char *source = cornerId(color, low);
-  char *target = cornerId(color, high);
+  struct variantEndpoint source = cornerEndpoint(low);
+  struct variantEndpoint target = cornerEndpoint(high);
   int line = 3 - high - low;
-  addEdge(fp, color, line, source, target);
+  addEdge(color, line, source, target);
 }
 
 /**
  * Adds an edge from a corner to a vertex in the GraphML output.
  */
-static void addEdgeFromCorner(FILE *fp, int corner, EDGE edge, int line)
+static void addEdgeFromCorner(int corner, EDGE edge, int line)
 {
-  char *source = cornerId(edge->color, corner);
-  char *target = graphmlVertexId(edge->to->vertex);
+  struct variantEndpoint source = cornerEndpoint(corner);
+  struct variantEndpoint target = vertexEndpoint(edgeVertex(edge));
   assert(line != corner);
-  addEdge(fp, edge->color, line, source, target);
+  addEdge(edge->color, line, source, target);
 }
 
 /**
@@ -213,8 +310,8 @@ static void addEdgeFromCorner(FILE *fp, int corner, EDGE edge, int line)
 static void processRegularEdgeGraphML(void *data, EDGE current, int line)
 {
   GraphMLData *gml = (GraphMLData *)data;
-  graphmlAddEdge(gml->fp, current, line);
-  addVertexIfPrimary(gml->fp, current->to->vertex, gml->color);
+  graphmlAddEdge(current, line);
+  addVertexIfPrimary(edgeVertex(current), gml->color);
 }
 
 /**
@@ -224,11 +321,11 @@ static void processSingleCornerGraphML(void *data, EDGE current, int line)
 {
   GraphMLData *gml = (GraphMLData *)data;
   gml->cornerIds[gml->cornerIx] = line == 0 ? 2 : line == 1 ? 0 : 1;
-  addEdgeToCorner(gml->fp, current, gml->cornerIds[gml->cornerIx], line);
+  addEdgeToCorner(current, gml->cornerIds[gml->cornerIx], line);
   line = (line + 1) % 3;
-  addEdgeFromCorner(gml->fp, gml->cornerIds[gml->cornerIx], current, line);
+  addEdgeFromCorner(gml->cornerIds[gml->cornerIx], current, line);
   gml->cornerIx++;
-  addVertexIfPrimary(gml->fp, current->to->vertex, gml->color);
+  addVertexIfPrimary(edgeVertex(current), gml->color);
 }
 
 /**
@@ -241,14 +338,14 @@ static void processAdjacentCornersGraphML(void *data, EDGE current, int line)
   assert(line < 2);
   gml->cornerIds[gml->cornerIx + 1] = line;
   gml->cornerIds[gml->cornerIx] = line == 0 ? 2 : 0;
-  addEdgeToCorner(gml->fp, current, gml->cornerIds[gml->cornerIx], line);
+  addEdgeToCorner(current, gml->cornerIds[gml->cornerIx], line);
   line = (line + 1) % 3;
-  addEdgeBetweenCorners(gml->fp, gml->color, gml->cornerIds[gml->cornerIx],
+  addEdgeBetweenCorners(gml->color, gml->cornerIds[gml->cornerIx],
                         gml->cornerIds[gml->cornerIx + 1]);
   line = (line + 1) % 3;
-  addEdgeFromCorner(gml->fp, gml->cornerIds[gml->cornerIx + 1], current, line);
+  addEdgeFromCorner(gml->cornerIds[gml->cornerIx + 1], current, line);
   gml->cornerIx += 2;
-  addVertexIfPrimary(gml->fp, current->to->vertex, gml->color);
+  addVertexIfPrimary(edgeVertex(current), gml->color);
 }
 
 /**
@@ -262,11 +359,11 @@ static void processAllCornersGraphML(void *data, EDGE current, int line)
   gml->cornerIds[gml->cornerIx++] = 0;
   gml->cornerIds[gml->cornerIx++] = 1;
   gml->cornerIds[gml->cornerIx++] = 2;
-  addEdgeToCorner(gml->fp, current, 0, 1);
-  addEdgeBetweenCorners(gml->fp, gml->color, 0, 1);
-  addEdgeBetweenCorners(gml->fp, gml->color, 1, 2);
-  addEdgeFromCorner(gml->fp, 2, current, 1);
-  addVertexIfPrimary(gml->fp, current->to->vertex, gml->color);
+  addEdgeToCorner(current, 0, 1);
+  addEdgeBetweenCorners(gml->color, 0, 1);
+  addEdgeBetweenCorners(gml->color, 1, 2);
+  addEdgeFromCorner(2, current, 1);
+  addVertexIfPrimary(edgeVertex(current), gml->color);
 }
 
 /**
@@ -293,10 +390,10 @@ static char *subFilename(void)
 /**
  * Saves a triangle to the GraphML output.
  */
-static void saveTriangle(FILE *fp, COLOR color, EDGE (*corners)[3])
+static void saveTriangle(COLOR color, EDGE (*corners)[3])
 {
   GraphMLData gml = {
-      .fp = fp, .cornerIds = {-1, -1, -1}, .cornerIx = 0, .color = color};
+      .cornerIds = {-1, -1, -1}, .cornerIx = 0, .color = color};
 
   TriangleTraversalCallbacks callbacks = {
       .processRegularEdge = processRegularEdgeGraphML,
@@ -311,7 +408,7 @@ static void saveTriangle(FILE *fp, COLOR color, EDGE (*corners)[3])
   assert(gml.cornerIx == 3);
 
   /* Add the corner nodes to the graph */
-  addCornerNodes(fp, corners, color, gml.cornerIds);
+  addCornerNodes(corners, color, gml.cornerIds);
 }
 
 /**
@@ -320,20 +417,51 @@ static void saveTriangle(FILE *fp, COLOR color, EDGE (*corners)[3])
 static void saveVariation(EDGE (*corners)[3])
 {
   COLOR a;
-  char *filename = subFilename();
-  FILE *fp;
+  char *filename =
+      CountVariationsFlag || BinaryVariationsFlag || DeltaVariationsFlag ||
+              JsonSinkFlag != NULL
+          ? NULL
+          : subFilename();
+  FILE *fp = NULL;
   VariationNumberIPC++;
   if (VariationNumberIPC - 1 <= IgnoreFirstVariantsPerSolution) {
     return;
   }
+  if (UniqueVariantsFlag && variantDedupSeen(corners)) {
+    return;
+  }
   GlobalVariantCountIPC++;
-  fp = GraphmlFileOps.fopen(filename, "w");
-  graphmlBegin(fp);
+  if (CountVariationsFlag) {
+    return;
+  }
+  if (JsonSinkFlag != NULL) {
+    jsonSinkVariant(VariationNumberIPC - 1, corners);
+    return;
+  }
+  if (DeltaVariationsFlag) {
+    variantDeltaWrite(VariationNumberIPC - 1, corners);
+    return;
+  }
+  if (BinaryVariationsFlag) {
+    variantFileBegin(VariationNumberIPC - 1);
+  } else {
+    if (!FragmentsRendered) {
+      renderFragments();
+    }
+    OutputLength = 0;
+    EMIT_LITERAL(GRAPHML_BEGIN);
+  }
   for (a = 0; a < NCOLORS; a++, corners++) {
-    saveTriangle(fp, a, corners);
+    saveTriangle(a, corners);
+  }
+  if (BinaryVariationsFlag) {
+    variantFileEnd();
+  } else {
+    EMIT_LITERAL(GRAPHML_END);
+    fp = GraphmlFileOps.fopen(filename, "w");
+    fwrite(Output, 1, OutputLength, fp);
+    fclose(fp);
   }
-  graphmlEnd(fp);
-  fclose(fp);
 }
 
 /**
@@ -1,7 +1,10 @@
 /* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
 #include "common.h"
 #include "face.h"
+#include "geometry.h"
 #include "main.h"
+#include "memoimage.h"
+#include "nogood.h"
 #include "predicates.h"
 #include "s6.h"
 #include "statistics.h"
@@ -13,6 +16,10 @@
 
 void initialize(void)
 {
+  /* The image is of the state the first time through; the initializers
+   * below then find what it holds already done. */
+  bool image = MemoImageFlag != NULL && Faces[1].colors == 0;
+  bool loaded = image && memoImageLoad(MemoImageFlag);
   /* Architecture-specific assertions */
   assert((sizeof(uint64) == sizeof(void *)));
   assert(sizeof(uint64) == 8);
@@ -20,10 +27,15 @@ void initialize(void)
   initializeCycleSets();
   initializeFacesAndEdges();
   initializePoints();
+  initializeGeometry();
   initializeTrail();
   initializeMemory();
+  initializeNogoods();
   initializeS6();
   trailFreeze();
+  if (image && !loaded) {
+    memoImageSave(MemoImageFlag);
+  }
 }
 
 static bool forwardInitialize(void)
@@ -7,9 +7,10 @@
 /**
  * In a simple Venn diagram of convex curves, the faces inside k curves
  * have total face degree being 2 * nCk + nC(k-1), where nCk is the binomial
- * coefficient "n choose k". For n = 6 and k = 5, this equals 2 * 6 + 15 = 27.
+ * coefficient "n choose k". For n = 6 and k = 5, this equals 2 * 6 + 15 = 27,
+ * and for n = 7 and k = 6, 2 * 7 + 21 = 35.
  */
-#define TOTAL_5FACE_DEGREE 27
+#define TOTAL_5FACE_DEGREE (2 * NCOLORS + NCOLORS * (NCOLORS - 1) / 2)
 
 extern FACE_DEGREE CurrentFaceDegrees[NCOLORS];
 FACE_DEGREE CurrentFaceDegrees[NCOLORS];
@@ -23,41 +24,51 @@ static int sumFaceDegree(int round)
   return sum;
 }
 
+/* The degrees to try at each position, from NCOLORS down to 3, or just the
+ * one the -d flag requires. */
+static FACE_DEGREE CandidateDegrees[NCOLORS][NCOLORS - 2];
+static int CandidateCount[NCOLORS];
+
+static void initializeCandidateDegrees(void)
+{
+  for (int i = 0; i < NCOLORS; i++) {
+    CandidateCount[i] = 0;
+    for (FACE_DEGREE degree = NCOLORS; degree >= 3; degree--) {
+      if (CentralFaceDegreesFlag[i] == 0 ||
+          CentralFaceDegreesFlag[i] == degree) {
+        CandidateDegrees[i][CandidateCount[i]++] = degree;
+      }
+    }
+  }
+}
+
 static struct predicateResult dynamicTry5FaceDegree(int round)
 {
+  if (round == 0) {
+    initializeCandidateDegrees();
+  }
   if (round == NCOLORS) {
     if (sumFaceDegree(round) != TOTAL_5FACE_DEGREE) {
       return PredicateFail;
     }
-    if (s6SymmetryType6(CurrentFaceDegrees) == NON_CANONICAL) {
-      return PredicateFail;
-    }
+    assert(s6SymmetryType6(CurrentFaceDegrees) != NON_CANONICAL);
     dynamicFaceSetupCentral(CurrentFaceDegrees);
     return PredicateSuccessNextPredicate;
   }
-  return predicateChoices(NCOLORS - 2);
+  return predicateChoices(CandidateCount[round]);
 }
 
 static struct predicateResult retry5FaceDegree(int round, int choice)
 {
-  // Try each possible face degree >= 3 for the current position
-  int degree = NCOLORS - choice;  // Start with NCOLORS and go down to 3
-  if (degree < 3) {
-    return PredicateFail;
-  }
-
-  if (CentralFaceDegreesFlag[round] > 0 &&
-      (FACE_DEGREE)degree != CentralFaceDegreesFlag[round]) {
-    return PredicateFail;  // Skip if there's a specific degree required for
-                           // this position
-  }
-  // Try this degree
-  CurrentFaceDegrees[round] = degree;
+  CurrentFaceDegrees[round] = CandidateDegrees[round][choice];
 
   if (sumFaceDegree(round + 1) + 3 * (NCOLORS - round - 1) >
       TOTAL_5FACE_DEGREE) {
     return PredicateFail;  // Exceeded target sum
   }
+  if (s6PrefixNonCanonical6(CurrentFaceDegrees, round + 1)) {
+    return PredicateFail;
+  }
 
   return PredicateSuccessSamePredicate;
 }
@@ -0,0 +1,120 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "jsonsink.h"
+
+#include "color.h"
+#include "common.h"
+#include "face.h"
+#include "geometry.h"
+#include "s6.h"
+#include "vertex.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static FILE *Sink = NULL;
+static const char *Path;
+static char SolutionName[64];
+
+static void writeFailed(void)
+{
+  perror(Path);
+  exit(EXIT_FAILURE);
+}
+
+/* Ends the record, flushing it, so that the reader has it at once. */
+static void endRecord(void)
+{
+  if (fputs("}\n", Sink) == EOF || fflush(Sink) != 0) {
+    writeFailed();
+  }
+}
+
+void jsonSinkOpen(const char *path)
+{
+  assert(Sink == NULL);
+  Path = path;
+  if (strcmp(path, "-") == 0) {
+    int fd;
+    Path = "stdout";
+    fflush(stdout);
+    fd = dup(STDOUT_FILENO);
+    if (fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+      writeFailed();
+    }
+    Sink = fdopen(fd, "w");
+  } else {
+    Sink = fopen(path, "w");
+  }
+  if (Sink == NULL) {
+    writeFailed();
+  }
+}
+
+void jsonSinkSolution(int expectedVariations)
+{
+  const struct solutionGeometry *geometry = dynamicSolutionGeometry();
+  const char *separator = "";
+  snprintf(SolutionName, sizeof(SolutionName), "%s-%2.2d",
+           CurrentSolution.faceDegrees, PerFaceDegreeSolutionNumberIPC);
+  fprintf(Sink,
+          "{\"type\":\"solution\",\"name\":\"%s\",\"faceDegrees\":\"%s\","
+          "\"signature\":\"%s\",",
+          SolutionName, CurrentSolution.faceDegrees,
+          s6SignatureToString(&CurrentSolution.signature));
+  fprintf(Sink, "\"classSignature\":\"%s\",\"faces\":{",
+          s6SignatureToString(&CurrentSolution.classSignature));
+  for (COLORSET colors = 0; colors < NFACES; colors++) {
+    char *cycle = cycleToString(Faces[colors].cycle);
+    cycle[strlen(cycle) - 1] = '\0';
+    fprintf(Sink, "%s\"%s\":\"%s\"", separator, colorSetToBareString(colors),
+            cycle + 1);
+    separator = ",";
+  }
+  fputs("},\"paths\":[", Sink);
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    fputs(color == 0 ? "[" : ",[", Sink);
+    for (int ix = 0; ix < geometry->pathLengths[color]; ix++) {
+      fprintf(Sink, "%s\"%s\"", ix == 0 ? "" : ",",
+              vertexToString(edgeVertex(geometry->paths[color][ix])));
+    }
+    fputc(']', Sink);
+  }
+  fprintf(Sink, "],\"variations\":%d", expectedVariations);
+  endRecord();
+}
+
+void jsonSinkVariant(int variationNumber, EDGE (*corners)[3])
+{
+  const struct solutionGeometry *geometry = dynamicSolutionGeometry();
+  fprintf(Sink, "{\"type\":\"variant\",\"solution\":\"%s\",\"number\":%d,"
+          "\"corners\":[", SolutionName, variationNumber);
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    fputs(color == 0 ? "[" : ",[", Sink);
+    for (int i = 0; i < 3; i++) {
+      int ix = 0;
+      while (geometry->paths[color][ix]->reversed != corners[color][i]) {
+        ix++;
+        assert(ix < geometry->pathLengths[color]);
+      }
+      fprintf(Sink, "%s%d", i == 0 ? "" : ",", ix);
+    }
+    fputc(']', Sink);
+  }
+  fputc(']', Sink);
+  endRecord();
+}
+
+void jsonSinkClose(void)
+{
+  if (Sink == NULL) {
+    return;
+  }
+  if (fclose(Sink) != 0) {
+    writeFailed();
+  }
+  Sink = NULL;
+}
@@ -0,0 +1,32 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef JSONSINK_H
+#define JSONSINK_H
+
+#include "edge.h"
+
+/**
+ * Streaming the solutions and their variations, as JSON Lines, to stdout or
+ * a named pipe (-J path), instead of writing files, so that another program
+ * can read them while the search goes on. Each line is one record, flushed
+ * as written. A solution record has its name, as would be used for its .txt
+ * file, its face degrees, signature and class signature, the cycle of each
+ * face, keyed by its colors, the path of each curve, as the vertices along
+ * it, and the number of variations expected. Each variation record that
+ * follows has the name of its solution, its number, and, for each curve, the
+ * positions in its path of its three corners.
+ */
+
+/* Opens path, or, for "-", stdout, which is then pointed at stderr, so that
+ * only the records go to the original stdout. */
+extern void jsonSinkOpen(const char *path);
+
+/* Writes the record of the current solution. */
+extern void jsonSinkSolution(int expectedVariations);
+
+/* Writes the record of a variation of the current solution. */
+extern void jsonSinkVariant(int variationNumber, EDGE (*corners)[3]);
+
+extern void jsonSinkClose(void);
+
+#endif  // JSONSINK_H
@@ -4,14 +4,18 @@
 #include "main.h"
 #include "predicates.h"
 #include "statistics.h"
+#include "variantpool.h"
 
 extern FACE_DEGREE CurrentFaceDegrees[NCOLORS];
 static clock_t TotalWastedTime = 0;
 static clock_t TotalUsefulTime = 0;
 static int WastedSearchCount = 0;
 static int UsefulSearchCount = 0;
-static int FacePredicateRecentSolutionsFound = 0;
-static int FacePredicateInitialVariationCount = 0;
+/* Not static, so that checkpoints can restore them. */
+extern int FacePredicateRecentSolutionsFound;
+extern int FacePredicateInitialVariationCount;
+int FacePredicateRecentSolutionsFound = 0;
+int FacePredicateInitialVariationCount = 0;
 static clock_t FacePredicateStart = 0;
 
 static bool forwardLog(void)
@@ -40,9 +44,15 @@ static void backwardLog(void)
     for (int i = 0; i < NCOLORS; i++) {
       printf("%llu ", CurrentFaceDegrees[i]);
     }
-    printf(" gives %llu/%d new solutions\n",
-           GlobalSolutionsFoundIPC - FacePredicateRecentSolutionsFound,
-           VariationCountIPC - FacePredicateInitialVariationCount);
+    if (variantPoolIsOpen()) {
+      /* The writers count the variations, reported at the end. */
+      printf(" gives %llu new solutions\n",
+             GlobalSolutionsFoundIPC - FacePredicateRecentSolutionsFound);
+    } else {
+      printf(" gives %llu/%d new solutions\n",
+             GlobalSolutionsFoundIPC - FacePredicateRecentSolutionsFound,
+             VariationCountIPC - FacePredicateInitialVariationCount);
+    }
     statisticPrintOneLine(0, false);
   } else {
     WastedSearchCount += 1;
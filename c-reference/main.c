@@ -2,10 +2,31 @@
 
 #include "main.h"
 
+#include "asyncwriter.h"
+#include "attribution.h"
+#include "batch.h"
+#include "checkpoint.h"
+#include "classindex.h"
+#include "compression.h"
 #include "engine.h"
+#include "estimate.h"
+#include "jsonsink.h"
 #include "nondeterminism.h"
+#include "order.h"
+#include "parallel.h"
+#include "perfcounters.h"
+#include "s6.h"
+#include "sampler.h"
+#include "server.h"
+#include "shard.h"
+#include "solutionindex.h"
+#include "solutionpath.h"
 #include "statistics.h"
+#include "trace.h"
 #include "utils.h"
+#include "variantarchive.h"
+#include "variantdedup.h"
+#include "variantpool.h"
 
 #include <getopt.h>
 #include <limits.h>
@@ -20,8 +41,39 @@ int GlobalSkipSolutionsFlag = 0;
 int PerFaceDegreeSkipSolutionsFlag = 0;
 int IgnoreFirstVariantsPerSolution = 0;
 FACE_DEGREE CentralFaceDegreesFlag[NCOLORS] = {0};
+int SymmetryDepthFlag = DEFAULT_SYMMETRY_DEPTH;
 bool VerboseModeFlag = false;
 bool TracingFlag = false;
+int ParallelWorkersFlag = 0;
+int ShardIndexFlag = 0;
+int ShardCountFlag = 0;
+int ShardDepthFlag = DEFAULT_SHARD_DEPTH;
+bool MergeShardsFlag = false;
+char *CheckpointFileFlag = NULL;
+bool ResumeFlag = false;
+char *TraceFileFlag = NULL;
+bool BenchmarkOrdersFlag = false;
+bool UniqueClassesFlag = false;
+bool UniqueVariantsFlag = false;
+bool CountVariationsFlag = false;
+int VariantWritersFlag = 0;
+bool BinaryVariationsFlag = false;
+bool ArchiveVariationsFlag = false;
+bool DeltaVariationsFlag = false;
+int CompressionLevelFlag = 0;
+int WriterQueueFlag = 0;
+char *JsonSinkFlag = NULL;
+bool HardwareCountersFlag = false;
+char *StatisticsExportFlag = NULL;
+char *FailureAttributionFlag = NULL;
+char *SamplingProfileFlag = NULL;
+char *MemoImageFlag = NULL;
+char *ServeFlag = NULL;
+char *BatchFileFlag = NULL;
+char *ReplaySolutionFlag = NULL;
+bool SolutionPathsFlag = false;
+int EstimateProbesFlag = 0;
+uint64 EstimateSeedFlag = 1;
 
 static void setFaceDegrees(const char *programName, const char *faceDegrees)
 {
@@ -48,7 +100,7 @@ static int parsePositiveArgument(const char *programName, const char *arg,
   sprintf(errorMessage, "-%c must be a %s integer.", flag,
           allowZero ? "non-negative" : "positive");
   int value = strtol(arg, &endptr, 10);
-  if (value <= 0) {
+  if (value < 0) {
     disaster(programName, errorMessage);
   }
   if (endptr == arg) {
@@ -63,6 +115,100 @@ static int parsePositiveArgument(const char *programName, const char *arg,
   return value;
 }
 
+/* Parses i/N or i/N:depth for -S. */
+static void setShard(const char *programName, const char *arg)
+{
+  char *endptr;
+  const char *errorMessage =
+      "-S must be shard/shards or shard/shards:depth, with 0 <= shard < "
+      "shards.";
+  ShardIndexFlag = strtol(arg, &endptr, 10);
+  if (endptr == arg || *endptr != '/') {
+    disaster(programName, errorMessage);
+  }
+  arg = endptr + 1;
+  ShardCountFlag = strtol(arg, &endptr, 10);
+  if (endptr == arg || (*endptr != '\0' && *endptr != ':')) {
+    disaster(programName, errorMessage);
+  }
+  if (*endptr == ':') {
+    ShardDepthFlag = parsePositiveArgument(programName, endptr + 1, 'S', false);
+  }
+  if (ShardIndexFlag < 0 || ShardCountFlag <= ShardIndexFlag ||
+      ShardCountFlag > MAX_SHARDS || ShardDepthFlag > NFACES) {
+    disaster(programName, errorMessage);
+  }
+}
+
+/* Parses probes or probes:seed for -e. */
+static void setEstimate(const char *programName, const char *arg)
+{
+  char *endptr;
+  char errorMessage[100];
+  sprintf(errorMessage,
+          "-e must be probes or probes:seed, with 0 < probes <= %d.",
+          MAX_ESTIMATE_PROBES);
+  EstimateProbesFlag = strtol(arg, &endptr, 10);
+  if (endptr == arg || (*endptr != '\0' && *endptr != ':') ||
+      EstimateProbesFlag <= 0 || EstimateProbesFlag > MAX_ESTIMATE_PROBES) {
+    disaster(programName, errorMessage);
+  }
+  if (*endptr == ':') {
+    arg = endptr + 1;
+    EstimateSeedFlag = strtoull(arg, &endptr, 10);
+    if (endptr == arg || *endptr != '\0') {
+      disaster(programName, errorMessage);
+    }
+  }
+}
+
+/* Checks that -r names a solution as its files are, degrees-number. */
+static void setReplaySolution(const char *programName, char *arg)
+{
+  char *endptr;
+  for (int i = 0; i < NCOLORS; i++) {
+    if (arg[i] < '3' || arg[i] > '0' + NCOLORS) {
+      disaster(programName,
+               "-r must name a solution, as its files are, such as 554544-06.");
+    }
+  }
+  if (arg[NCOLORS] != '-' || strtol(arg + NCOLORS + 1, &endptr, 10) <= 0 ||
+      *endptr != '\0') {
+    disaster(programName,
+             "-r must name a solution, as its files are, such as 554544-06.");
+  }
+  ReplaySolutionFlag = arg;
+}
+
+/* Selects the -O strategy, or all of them for the benchmark. */
+static void setOrder(const char *programName, const char *name)
+{
+  if (strcmp(name, "all") == 0) {
+    BenchmarkOrdersFlag = true;
+  } else if (!orderSelect(name)) {
+    disaster(programName, "-O must be mrv, constraining, wdeg or all.");
+  }
+}
+
+/* Selects the -F format of the variations. */
+static void setFormat(const char *programName, const char *name)
+{
+  BinaryVariationsFlag = strcmp(name, "bin") == 0;
+  ArchiveVariationsFlag = strcmp(name, "archive") == 0;
+  DeltaVariationsFlag = strcmp(name, "delta") == 0;
+  if (!BinaryVariationsFlag && !ArchiveVariationsFlag && !DeltaVariationsFlag &&
+      strcmp(name, "graphml") != 0) {
+    disaster(programName, "-F must be graphml, bin, archive or delta.");
+  }
+}
+
+static void benchmarkSearch(void)
+{
+  struct stack stack;
+  engine(&stack, NonDeterministicProgram);
+  asyncWriterFinish();
+}
+
 static void initializeOutputFolder()
 {
   initializeFolder(TargetFolderFlag);
@@ -76,9 +222,13 @@ int realMain0(int argc, char *argv[])
   int localMaxSolutions = INT_MAX;
   int localSkipSolutions = 0;
   char *programName = argv[0];
+  bool serveOptionsOnly = true;
   struct stack mainStack;
 
-  while ((opt = getopt(argc, argv, "f:d:m:n:k:j:vt")) != -1) {
+  while ((opt = getopt(argc, argv,
+                       "f:d:m:n:k:j:vtT:P:S:Mc:R:O:y:uCW:F:z:Q:J:HE:A:G:I:s:b:"
+                       "e:r:ix")) != -1) {
+    serveOptionsOnly &= opt == 's' || opt == 'I' || opt == 'v';
     switch (opt) {
       case 'f':
         TargetFolderFlag = optarg;
@@ -109,6 +259,89 @@ int realMain0(int argc, char *argv[])
       case 't':
         TracingFlag = true;
         break;
+      case 'T':
+        TraceFileFlag = optarg;
+        break;
+      case 'P':
+        ParallelWorkersFlag =
+            parsePositiveArgument(programName, optarg, 'P', false);
+        break;
+      case 'S':
+        setShard(programName, optarg);
+        break;
+      case 'M':
+        MergeShardsFlag = true;
+        break;
+      case 'R':
+        ResumeFlag = true;
+        /* fall through */
+      case 'c':
+        CheckpointFileFlag = optarg;
+        break;
+      case 'O':
+        setOrder(programName, optarg);
+        break;
+      case 'u':
+        UniqueClassesFlag = true;
+        break;
+      case 'i':
+        UniqueVariantsFlag = true;
+        break;
+      case 'C':
+        CountVariationsFlag = true;
+        break;
+      case 'W':
+        VariantWritersFlag =
+            parsePositiveArgument(programName, optarg, 'W', false);
+        break;
+      case 'F':
+        setFormat(programName, optarg);
+        break;
+      case 'z':
+        CompressionLevelFlag =
+            parsePositiveArgument(programName, optarg, 'z', false);
+        break;
+      case 'Q':
+        WriterQueueFlag =
+            parsePositiveArgument(programName, optarg, 'Q', false);
+        break;
+      case 'J':
+        JsonSinkFlag = optarg;
+        break;
+      case 'H':
+        HardwareCountersFlag = true;
+        break;
+      case 'E':
+        StatisticsExportFlag = optarg;
+        break;
+      case 'A':
+        FailureAttributionFlag = optarg;
+        break;
+      case 'G':
+        SamplingProfileFlag = optarg;
+        break;
+      case 'I':
+        MemoImageFlag = optarg;
+        break;
+      case 's':
+        ServeFlag = optarg;
+        break;
+      case 'b':
+        BatchFileFlag = optarg;
+        break;
+      case 'e':
+        setEstimate(programName, optarg);
+        break;
+      case 'r':
+        setReplaySolution(programName, optarg);
+        break;
+      case 'x':
+        SolutionPathsFlag = true;
+        break;
+      case 'y':
+        SymmetryDepthFlag =
+            parsePositiveArgument(programName, optarg, 'y', true);
+        break;
       default:
         disaster(programName, "Invalid option");
     }
@@ -116,9 +349,153 @@ int realMain0(int argc, char *argv[])
   if (optind != argc) {
     disaster(programName, "Invalid option");
   }
-  if (TargetFolderFlag == NULL) {
+  if (ServeFlag != NULL) {
+    if (!serveOptionsOnly) {
+      disaster(programName, "-s can only be used with -I and -v");
+    }
+    serve(ServeFlag);
+    return 0;
+  }
+  if (EstimateProbesFlag > 0) {
+    if (TargetFolderFlag != NULL || CountVariationsFlag ||
+        JsonSinkFlag != NULL || ShardCountFlag > 0 || MergeShardsFlag ||
+        CheckpointFileFlag != NULL || UniqueClassesFlag ||
+        BinaryVariationsFlag || ArchiveVariationsFlag || DeltaVariationsFlag ||
+        VariantWritersFlag > 0 || BatchFileFlag != NULL ||
+        localMaxSolutions != INT_MAX || localSkipSolutions != 0 ||
+        MaxVariantsPerSolutionFlag != INT_MAX ||
+        IgnoreFirstVariantsPerSolution != 0) {
+      disaster(programName,
+               "-e cannot be used with -f, -F, -C, -J, -S, -M, -c, -R, -u, "
+               "-W, -b, -m, -k, -n or -j");
+    }
+  } else if (CountVariationsFlag) {
+    if (TargetFolderFlag != NULL || ParallelWorkersFlag > 0 ||
+        ShardCountFlag > 0 || MergeShardsFlag || CheckpointFileFlag != NULL ||
+        UniqueClassesFlag || BinaryVariationsFlag || ArchiveVariationsFlag ||
+        DeltaVariationsFlag || JsonSinkFlag != NULL) {
+      disaster(programName,
+               "-C cannot be used with -f, -F, -J, -P, -S, -M, -c, -R or -u");
+    }
+  } else if (JsonSinkFlag != NULL) {
+    if (TargetFolderFlag != NULL || ParallelWorkersFlag > 0 ||
+        ShardCountFlag > 0 || MergeShardsFlag || CheckpointFileFlag != NULL ||
+        UniqueClassesFlag || BinaryVariationsFlag || ArchiveVariationsFlag ||
+        DeltaVariationsFlag || VariantWritersFlag > 0) {
+      disaster(programName,
+               "-J cannot be used with -f, -F, -P, -S, -M, -c, -R, -u or -W");
+    }
+  } else if (TargetFolderFlag == NULL) {
     disaster(programName, "Output folder not specified");
   }
+  if (BatchFileFlag != NULL &&
+      (hasFaceDegrees || localMaxSolutions != INT_MAX ||
+       localSkipSolutions != 0 || MaxVariantsPerSolutionFlag != INT_MAX ||
+       IgnoreFirstVariantsPerSolution != 0 || ShardCountFlag > 0 ||
+       MergeShardsFlag || CheckpointFileFlag != NULL || UniqueClassesFlag ||
+       VariantWritersFlag > 0 || TraceFileFlag != NULL ||
+       HardwareCountersFlag || StatisticsExportFlag != NULL ||
+       FailureAttributionFlag != NULL || SamplingProfileFlag != NULL ||
+       BenchmarkOrdersFlag)) {
+    disaster(programName,
+             "-b cannot be used with -d, -m, -k, -n, -j, -S, -M, -c, -R, -u, "
+             "-W, -T, -H, -E, -A, -G or -O all");
+  }
+  if (ReplaySolutionFlag != NULL) {
+    if (TargetFolderFlag == NULL || hasFaceDegrees ||
+        localMaxSolutions != INT_MAX || localSkipSolutions != 0 ||
+        ParallelWorkersFlag > 0 || ShardCountFlag > 0 || MergeShardsFlag ||
+        CheckpointFileFlag != NULL || UniqueClassesFlag ||
+        BatchFileFlag != NULL || VariantWritersFlag > 0 ||
+        BenchmarkOrdersFlag) {
+      disaster(programName,
+               "-r needs -f, and cannot be used with -d, -m, -k, -P, -S, -M, "
+               "-c, -R, -u, -b, -W or -O all");
+    }
+  }
+  if (SolutionPathsFlag &&
+      (TargetFolderFlag == NULL || ParallelWorkersFlag > 0 ||
+       ShardCountFlag > 0 || MergeShardsFlag || BatchFileFlag != NULL ||
+       ReplaySolutionFlag != NULL || BenchmarkOrdersFlag)) {
+    disaster(programName,
+             "-x needs -f, and cannot be used with -P, -S, -M, -b, -r or "
+             "-O all");
+  }
+  if (UniqueVariantsFlag && (CountVariationsFlag || VariantWritersFlag > 0 ||
+                             EstimateProbesFlag > 0)) {
+    disaster(programName, "-i cannot be used with -C, -W or -e");
+  }
+  if (ShardCountFlag > 0 &&
+      (localMaxSolutions != INT_MAX || localSkipSolutions != 0)) {
+    disaster(programName, "-m and -k cannot be used with -S");
+  }
+  if (ParallelWorkersFlag > 0 && !hasFaceDegrees &&
+      (localMaxSolutions != INT_MAX || localSkipSolutions != 0)) {
+    disaster(programName, "-m and -k need -d when used with -P");
+  }
+  if (CheckpointFileFlag != NULL &&
+      (ParallelWorkersFlag > 0 || MergeShardsFlag)) {
+    disaster(programName, "-c and -R cannot be used with -P or -M");
+  }
+  if (TraceFileFlag != NULL && ParallelWorkersFlag > 0) {
+    disaster(programName, "-T cannot be used with -P");
+  }
+  if (HardwareCountersFlag && ParallelWorkersFlag > 0) {
+    disaster(programName, "-H cannot be used with -P");
+  }
+  if (StatisticsExportFlag != NULL && ParallelWorkersFlag > 0) {
+    disaster(programName, "-E cannot be used with -P");
+  }
+  if (FailureAttributionFlag != NULL && ParallelWorkersFlag > 0) {
+    disaster(programName, "-A cannot be used with -P");
+  }
+  if (SamplingProfileFlag != NULL && ParallelWorkersFlag > 0) {
+    disaster(programName, "-G cannot be used with -P");
+  }
+  if ((BenchmarkOrdersFlag || !orderIsRepeatable()) &&
+      (ParallelWorkersFlag > 0 || ShardCountFlag > 0 || MergeShardsFlag ||
+       CheckpointFileFlag != NULL)) {
+    disaster(programName,
+             "-O all and -O wdeg cannot be used with -P, -S, -M, -c or -R");
+  }
+  if (VariantWritersFlag > 0 &&
+      (ParallelWorkersFlag > 0 || MergeShardsFlag || CountVariationsFlag ||
+       CheckpointFileFlag != NULL || TraceFileFlag != NULL ||
+       BenchmarkOrdersFlag)) {
+    disaster(programName,
+             "-W cannot be used with -P, -M, -C, -c, -R, -T or -O all");
+  }
+  if (VariantWritersFlag > MAX_VARIANT_WRITERS) {
+    char errorMessage[100];
+    sprintf(errorMessage, "-W must be at most %d.", MAX_VARIANT_WRITERS);
+    disaster(programName, errorMessage);
+  }
+  if (CompressionLevelFlag > 0 &&
+      (CountVariationsFlag || JsonSinkFlag != NULL || BinaryVariationsFlag ||
+       ArchiveVariationsFlag || DeltaVariationsFlag)) {
+    disaster(programName, "-z can only be used with -F graphml");
+  }
+  if (CompressionLevelFlag > MAX_COMPRESSION_LEVEL) {
+    char errorMessage[100];
+    sprintf(errorMessage, "-z must be at most %d.", MAX_COMPRESSION_LEVEL);
+    disaster(programName, errorMessage);
+  }
+  if (WriterQueueFlag > 0 &&
+      (CountVariationsFlag || JsonSinkFlag != NULL || BinaryVariationsFlag ||
+       ArchiveVariationsFlag || DeltaVariationsFlag ||
+       VariantWritersFlag > 0)) {
+    disaster(programName, "-Q can only be used with -F graphml, not with -W");
+  }
+  if (WriterQueueFlag > MAX_WRITER_QUEUE) {
+    char errorMessage[100];
+    sprintf(errorMessage, "-Q must be at most %d.", MAX_WRITER_QUEUE);
+    disaster(programName, errorMessage);
+  }
+  if (ParallelWorkersFlag > MAX_PARALLEL_WORKERS) {
+    char errorMessage[100];
+    sprintf(errorMessage, "-P must be at most %d.", MAX_PARALLEL_WORKERS);
+    disaster(programName, errorMessage);
+  }
   // Set the appropriate static variables based on whether -d was specified
   if (hasFaceDegrees) {
     PerFaceDegreeMaxSolutionsFlag = localMaxSolutions;
@@ -128,11 +505,97 @@ int realMain0(int argc, char *argv[])
     GlobalSkipSolutionsFlag = localSkipSolutions;
   }
 
-  initializeOutputFolder();
+  if (JsonSinkFlag != NULL) {
+    jsonSinkOpen(JsonSinkFlag);
+  } else if (!CountVariationsFlag && EstimateProbesFlag == 0) {
+    initializeOutputFolder();
+  }
+  if (TraceFileFlag != NULL) {
+    traceStart(TraceFileFlag);
+  }
+  if (CompressionLevelFlag > 0) {
+    compressionStart(CompressionLevelFlag);
+  }
+  if (ArchiveVariationsFlag) {
+    variantArchiveStart();
+  }
+  if (WriterQueueFlag > 0) {
+    asyncWriterStart(WriterQueueFlag);
+  }
   initializeStatisticLogging("/dev/stdout", 200, 10);
+  if (HardwareCountersFlag) {
+    perfCountersStart();
+  }
+  if (StatisticsExportFlag != NULL) {
+    statisticExportTo(StatisticsExportFlag);
+  }
+  if (FailureAttributionFlag != NULL) {
+    failureAttributionStart(FailureAttributionFlag);
+  }
+  if (SamplingProfileFlag != NULL) {
+    samplerStart(SamplingProfileFlag);
+  }
+  if (UniqueClassesFlag && !MergeShardsFlag) {
+    classIndexOpen(TargetFolderFlag);
+  }
+  if (UniqueVariantsFlag) {
+    variantDedupStart();
+  }
 
-  engine(&mainStack, NonDeterministicProgram);
+  if (MergeShardsFlag) {
+    shardMerge(TargetFolderFlag);
+  } else if (BenchmarkOrdersFlag) {
+    orderBenchmark(benchmarkSearch);
+    return 0;
+  } else if (EstimateProbesFlag > 0) {
+    estimateSearch(EstimateProbesFlag, EstimateSeedFlag, ParallelWorkersFlag);
+  } else if (BatchFileFlag != NULL) {
+    batchSearch(BatchFileFlag, ParallelWorkersFlag);
+  } else if (ReplaySolutionFlag != NULL) {
+    solutionPathReplay(TargetFolderFlag, ReplaySolutionFlag);
+    asyncWriterFinish();
+  } else if (ParallelWorkersFlag > 0) {
+    parallelSearch(ParallelWorkersFlag);
+    classIndexClose();
+  } else {
+    char tag[32] = "serial";
+    if (CheckpointFileFlag != NULL) {
+      checkpointStart(&mainStack, CheckpointFileFlag, ResumeFlag);
+    }
+    if (ShardCountFlag > 0) {
+      shardTag(tag, sizeof(tag));
+      solutionIndexOpen(TargetFolderFlag, tag, checkpointSolutionIndexCount());
+    }
+    if (UniqueClassesFlag) {
+      classIndexPending(TargetFolderFlag, tag);
+    }
+    if (VariantWritersFlag > 0) {
+      variantPoolStart(VariantWritersFlag);
+    }
+    engineReplay(&mainStack, NonDeterministicProgram, checkpointPath());
+    variantPoolFinish();
+    asyncWriterFinish();
+    solutionIndexClose();
+    classIndexClose();
+    if (CheckpointFileFlag != NULL) {
+      checkpointFinish();
+    }
+  }
+  if (ShardCountFlag > 0 && !MergeShardsFlag) {
+    shardSaveStatistics(TargetFolderFlag);
+  } else if (ParallelWorkersFlag > 0 && BatchFileFlag == NULL &&
+             EstimateProbesFlag == 0) {
+    solutionIndexRenumber(TargetFolderFlag);
+  }
+  if ((ShardCountFlag == 0 || MergeShardsFlag) && !CountVariationsFlag &&
+      JsonSinkFlag == NULL && EstimateProbesFlag == 0) {
+    classIndexFold(TargetFolderFlag);
+  }
 
   statisticPrintFull();
+  compressionPrintSummary(stdout);
+  failureAttributionWrite();
+  samplerWrite();
+  jsonSinkClose();
   return 0;
 }
@@ -13,10 +13,43 @@
 extern char* TargetFolderFlag; /* Output folder for results (-f) */
 extern bool VerboseModeFlag;   /* Verbose output mode (-v) */
 extern bool TracingFlag;       /* Tracing output mode (-t) */
+extern char* TraceFileFlag;    /* Binary trace file (-T) */
+
+/* Execution control flags */
+extern int ParallelWorkersFlag;  /* Number of worker processes (-P) */
+extern int ShardIndexFlag;       /* This shard, from 0 (-S i/N) */
+extern int ShardCountFlag;       /* Number of shards, or 0 (-S i/N) */
+extern int ShardDepthFlag;       /* Venn choices hashed (-S i/N:depth) */
+extern bool MergeShardsFlag;     /* Merge the shards in the folder (-M) */
+extern char* CheckpointFileFlag; /* Checkpoint file (-c or -R) */
+extern bool ResumeFlag;          /* Resume from the checkpoint (-R) */
+extern bool BenchmarkOrdersFlag; /* Compare the search orders (-O all) */
+extern bool UniqueClassesFlag;   /* Skip classes already saved (-u) */
+extern bool UniqueVariantsFlag;  /* Skip isomorphic variants (-i) */
+extern bool CountVariationsFlag; /* Count variations, writing nothing (-C) */
+extern int VariantWritersFlag;   /* Number of variant writer processes (-W) */
+extern bool BinaryVariationsFlag; /* Write variations.bin, not GraphML (-F) */
+extern bool ArchiveVariationsFlag; /* Write GraphML to variations.arc (-F) */
+extern bool DeltaVariationsFlag;   /* Write corners to variations.dlt (-F) */
+extern int CompressionLevelFlag;  /* gzip level of the GraphML, or 0 (-z) */
+extern int WriterQueueFlag;       /* GraphML buffers for a writer thread (-Q) */
+extern char* JsonSinkFlag;        /* Stream JSON Lines here, not files (-J) */
+extern bool HardwareCountersFlag; /* Hardware counts per predicate (-H) */
+extern char* StatisticsExportFlag; /* Export the statistics here (-E) */
+extern char* FailureAttributionFlag; /* Failures by face and cycle (-A) */
+extern char* SamplingProfileFlag; /* Folded stacks of the search (-G) */
+extern char* MemoImageFlag;       /* The state after Initialize (-I) */
+extern char* ServeFlag;           /* Serve search jobs from here (-s) */
+extern char* BatchFileFlag;       /* The jobs of a batch search (-b) */
+extern char* ReplaySolutionFlag;  /* The solution to find again (-r) */
+extern bool SolutionPathsFlag;    /* Index the paths to the solutions (-x) */
+extern int EstimateProbesFlag;     /* Random probes to estimate with (-e) */
+extern uint64 EstimateSeedFlag;   /* Their seed (-e probes:seed) */
 
 /* Search constraint flags */
 extern FACE_DEGREE
     CentralFaceDegreesFlag[NCOLORS]; /* Central face degrees (-d) */
+extern int SymmetryDepthFlag; /* Venn rounds checked for symmetry (-y) */
 
 /* Solution limiting flags */
 extern int MaxVariantsPerSolutionFlag; /* Max variants per solution (-n) */
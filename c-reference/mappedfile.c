@@ -0,0 +1,92 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "mappedfile.h"
+
+#include <sys/mman.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void mappedFailed(struct mappedFile *file)
+{
+  perror(file->filename);
+  exit(EXIT_FAILURE);
+}
+
+void mappedOpen(struct mappedFile *file, const char *filename)
+{
+  file->filename = filename;
+  file->fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (file->fd < 0) {
+    mappedFailed(file);
+  }
+  file->segment = NULL;
+  file->start = 0;
+  file->length = 0;
+}
+
+/* Maps the segment starting at the end of the last, making room for it. */
+static void nextSegment(struct mappedFile *file)
+{
+  if (file->segment != NULL) {
+    if (munmap(file->segment, MAPPED_SEGMENT_BYTES) != 0) {
+      mappedFailed(file);
+    }
+    file->start += MAPPED_SEGMENT_BYTES;
+  }
+#ifdef __APPLE__
+  if (ftruncate(file->fd, file->start + MAPPED_SEGMENT_BYTES) != 0) {
+    mappedFailed(file);
+  }
+#else
+  errno = posix_fallocate(file->fd, file->start, MAPPED_SEGMENT_BYTES);
+  if (errno != 0) {
+    mappedFailed(file);
+  }
+#endif
+  file->segment = mmap(NULL, MAPPED_SEGMENT_BYTES, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, file->fd, file->start);
+  if (file->segment == MAP_FAILED) {
+    file->segment = NULL;
+    mappedFailed(file);
+  }
+}
+
+void mappedWrite(struct mappedFile *file, const void *data, size_t size)
+{
+  const char *bytes = data;
+  while (size > 0) {
+    uint64_t used = file->length - file->start;
+    size_t room;
+    if (file->segment == NULL || used == MAPPED_SEGMENT_BYTES) {
+      nextSegment(file);
+      used = file->length - file->start;
+    }
+    room = MAPPED_SEGMENT_BYTES - used;
+    if (room > size) {
+      room = size;
+    }
+    memcpy(file->segment + used, bytes, room);
+    file->length += room;
+    bytes += room;
+    size -= room;
+  }
+}
+
+void mappedClose(struct mappedFile *file)
+{
+  if (file->segment != NULL &&
+      munmap(file->segment, MAPPED_SEGMENT_BYTES) != 0) {
+    mappedFailed(file);
+  }
+  if (ftruncate(file->fd, file->length) != 0 || close(file->fd) != 0) {
+    mappedFailed(file);
+  }
+  file->segment = NULL;
+}
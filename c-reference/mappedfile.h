@@ -0,0 +1,34 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * An output file written in place, through memory mapped segments, rather
+ * than through stdio. Each segment is preallocated, mapped, and filled by
+ * copying; when it is full the next is mapped in its place. Closing unmaps
+ * the last, and cuts the file to what was written.
+ */
+
+/* The bytes preallocated and mapped at a time; a multiple of any page size. */
+#define MAPPED_SEGMENT_BYTES (1 << 20)
+
+struct mappedFile {
+  const char *filename; /* For errors */
+  int fd;
+  char *segment;    /* The mapping, or NULL before the first write */
+  uint64_t start;   /* The offset in the file of the segment */
+  uint64_t length;  /* Written so far */
+};
+
+extern void mappedOpen(struct mappedFile *file, const char *filename);
+
+extern void mappedWrite(struct mappedFile *file, const void *data,
+                        size_t size);
+
+extern void mappedClose(struct mappedFile *file);
+
+#endif  // MAPPEDFILE_H
@@ -0,0 +1,252 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "memoimage.h"
+
+#include "mappedfile.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* The file is the header, and then each region in turn, as they are in
+ * memory, except that each pointer is 0 for NULL, or, in the top 16 bits, one
+ * more than the region it points into, and the offset there below. */
+#define MEMO_IMAGE_MAGIC "vennmemo"
+#define MEMO_IMAGE_VERSION 1
+#define OFFSET_BITS 48
+#define OFFSET_MASK ((1ull << OFFSET_BITS) - 1)
+
+/* Enough for the regions of every module */
+#define MAX_REGIONS 32
+
+struct imageHeader {
+  char magic[8];
+  uint64 version;
+  uint64 ncolors;
+  uint64 regionCount;
+  uint64 pointerCount;
+  uint64 layout; /* A hash of the sizes of the regions and of the slots */
+  uint64 size;   /* Of the regions */
+};
+
+struct region {
+  char *start;
+  size_t size;
+  size_t imageOffset;
+};
+
+struct pointerSlot {
+  int region;
+  size_t offset;
+};
+
+static struct region Regions[MAX_REGIONS];
+static int RegionCount = 0;
+static struct pointerSlot *Slots = NULL;
+static uint64 SlotCount = 0;
+static uint64 SlotCapacity = 0;
+static uint64 ImageSize = 0;
+static uint64 Layout;
+static bool Described = false;
+
+/* The region holding address, counting one past its end, or -1. */
+static int regionOf(uintptr_t address, bool pastEnd)
+{
+  for (int i = 0; i < RegionCount; i++) {
+    uintptr_t start = (uintptr_t)Regions[i].start;
+    if (address >= start && (address < start + Regions[i].size ||
+                             (pastEnd && address == start + Regions[i].size))) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void memoImageInclude(void *start, size_t size)
+{
+  assert(!Described && RegionCount < MAX_REGIONS);
+  Regions[RegionCount].start = start;
+  Regions[RegionCount].size = size;
+  Regions[RegionCount].imageOffset = ImageSize;
+  RegionCount++;
+  ImageSize += size;
+}
+
+void memoImageIncludePointer(void *slot)
+{
+  int region = regionOf((uintptr_t)slot, false);
+  assert(!Described && region >= 0);
+  assert((uintptr_t)slot % sizeof(void *) == 0);
+  if (SlotCount == SlotCapacity) {
+    SlotCapacity = SlotCapacity == 0 ? 4096 : 2 * SlotCapacity;
+    Slots = realloc(Slots, SlotCapacity * sizeof(*Slots));
+    if (Slots == NULL) {
+      perror("realloc");
+      exit(EXIT_FAILURE);
+    }
+  }
+  Slots[SlotCount].region = region;
+  Slots[SlotCount].offset = (char *)slot - Regions[region].start;
+  SlotCount++;
+}
+
+/* FNV-1a */
+static uint64 hashIn(uint64 hash, uint64 value)
+{
+  for (int i = 0; i < 8; i++) {
+    hash = (hash ^ ((value >> (8 * i)) & 0xff)) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+static void describe(void)
+{
+  if (Described) {
+    return;
+  }
+  cycleSetsIncludeInImage();
+  facesIncludeInImage();
+  verticesIncludeInImage();
+  s6IncludeInImage();
+  Described = true;
+  Layout = hashIn(0xcbf29ce484222325ull, NCOLORS);
+  for (int i = 0; i < RegionCount; i++) {
+    Layout = hashIn(Layout, Regions[i].size);
+  }
+  for (uint64 i = 0; i < SlotCount; i++) {
+    Layout = hashIn(Layout, Slots[i].region);
+    Layout = hashIn(Layout, Slots[i].offset);
+  }
+}
+
+static uint64 *slotInImage(char *image, struct pointerSlot *slot)
+{
+  return (uint64 *)(image + Regions[slot->region].imageOffset + slot->offset);
+}
+
+void memoImageSave(const char *path)
+{
+  char temporary[1024];
+  struct mappedFile file;
+  struct imageHeader header = {MEMO_IMAGE_MAGIC, MEMO_IMAGE_VERSION, NCOLORS,
+                               0, 0, 0, 0};
+  char *image;
+  describe();
+  image = malloc(ImageSize);
+  if (image == NULL) {
+    perror("malloc");
+    exit(EXIT_FAILURE);
+  }
+  for (int i = 0; i < RegionCount; i++) {
+    memcpy(image + Regions[i].imageOffset, Regions[i].start, Regions[i].size);
+  }
+  for (uint64 i = 0; i < SlotCount; i++) {
+    uint64 *encoded = slotInImage(image, Slots + i);
+    int region;
+    if (*encoded == 0) {
+      continue;
+    }
+    region = regionOf(*encoded, true);
+    if (region < 0) {
+      fprintf(stderr, "%s: a pointer is outside the regions of the image\n",
+              path);
+      exit(EXIT_FAILURE);
+    }
+    *encoded = (uint64)(region + 1) << OFFSET_BITS |
+               (*encoded - (uintptr_t)Regions[region].start);
+  }
+  header.regionCount = RegionCount;
+  header.pointerCount = SlotCount;
+  header.layout = Layout;
+  header.size = ImageSize;
+  snprintf(temporary, sizeof(temporary), "%s.new", path);
+  mappedOpen(&file, temporary);
+  mappedWrite(&file, &header, sizeof(header));
+  mappedWrite(&file, image, ImageSize);
+  mappedClose(&file);
+  free(image);
+  /* A worker of another run may be loading the old one. */
+  if (rename(temporary, path) != 0) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Whether every pointer in the image is NULL, or in a region. */
+static bool pointersValid(char *image)
+{
+  for (uint64 i = 0; i < SlotCount; i++) {
+    uint64 encoded = *slotInImage(image, Slots + i);
+    uint64 region = (encoded >> OFFSET_BITS) - 1;
+    if (encoded != 0 && (region >= (uint64)RegionCount ||
+                         (encoded & OFFSET_MASK) > Regions[region].size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool memoImageLoad(const char *path)
+{
+  struct stat status;
+  const struct imageHeader *header;
+  char *mapped, *image;
+  int fd;
+  describe();
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return false;
+    }
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  if (fstat(fd, &status) != 0) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  if ((uint64)status.st_size != sizeof(*header) + ImageSize) {
+    close(fd);
+    fprintf(stderr, "%s: from another build, replacing it\n", path);
+    return false;
+  }
+  /* Private, so that relocating the pointers does not change the file. */
+  mapped = mmap(NULL, status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  header = (const struct imageHeader *)mapped;
+  image = mapped + sizeof(*header);
+  if (memcmp(header->magic, MEMO_IMAGE_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != MEMO_IMAGE_VERSION || header->ncolors != NCOLORS ||
+      header->regionCount != (uint64)RegionCount ||
+      header->pointerCount != SlotCount || header->layout != Layout ||
+      header->size != ImageSize || !pointersValid(image)) {
+    munmap(mapped, status.st_size);
+    fprintf(stderr, "%s: from another build, replacing it\n", path);
+    return false;
+  }
+  for (uint64 i = 0; i < SlotCount; i++) {
+    uint64 *encoded = slotInImage(image, Slots + i);
+    if (*encoded != 0) {
+      uint64 region = (*encoded >> OFFSET_BITS) - 1;
+      *encoded = (uintptr_t)Regions[region].start + (*encoded & OFFSET_MASK);
+    }
+  }
+  for (int i = 0; i < RegionCount; i++) {
+    memcpy(Regions[i].start, image + Regions[i].imageOffset, Regions[i].size);
+  }
+  munmap(mapped, status.st_size);
+  return true;
+}
@@ -0,0 +1,48 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef MEMOIMAGE_H
+#define MEMOIMAGE_H
+
+#include "core.h"
+
+#include <stddef.h>
+
+/**
+ * An image of the MEMO state after Initialize: the cycles, faces, edges and
+ * vertices, with the pointers between them, and the permutation tables. It is
+ * the same on every run of the same build, so the -I flag saves it once and
+ * later runs load it instead of computing it.
+ *
+ * The state is made of static arrays, which do not move relative to each
+ * other, but, with address space randomization, do move from run to run. So
+ * each module describes its regions, and the pointer slots in them, and the
+ * image holds each pointer as the region it points to and the offset there.
+ * Loading maps the file, copies the regions into place, and then relocates
+ * the pointers. Initialize then finds the work done, and only does what
+ * every run does, such as registering the statistics and the trail regions.
+ *
+ * An image from a build with a different layout of the state is rejected;
+ * one from a build which computes the same layout differently is not, so
+ * remove the image after changing the initialization.
+ */
+
+/* Describe the regions of the image, and the pointer slots within them. A
+ * pointer slot must point into a region, one past the end of one, or be
+ * NULL. */
+extern void memoImageInclude(void *start, size_t size);
+extern void memoImageIncludePointer(void *slot);
+
+/* Each module's description of its part of the image */
+extern void cycleSetsIncludeInImage(void);
+extern void facesIncludeInImage(void);
+extern void verticesIncludeInImage(void);
+extern void s6IncludeInImage(void);
+
+/* Loads the image in path, returning false, with the state untouched, if
+ * there is none, or it is from another build. */
+extern bool memoImageLoad(const char *path);
+
+/* Saves the image, once Initialize is complete. */
+extern void memoImageSave(const char *path);
+
+#endif  // MEMOIMAGE_H
@@ -6,14 +6,23 @@
 
 #include <stdlib.h>
 
-// Each allocation is wrapped in a header that links to the next allocation
-typedef struct AllocationHeader {
-  struct AllocationHeader *next;
-  void *data;
-} AllocationHeader;
+/*
+ * Temporary memory is bump allocated from a list of large chunks. freeAll
+ * just goes back to the start of the first chunk; the chunks are kept for
+ * reuse, so after warming up we never call malloc.
+ */
+typedef struct Chunk {
+  struct Chunk *next;
+  size_t size;
+  max_align_t data[];
+} Chunk;
 
-// Global pointer to the start of the allocation chain
-static AllocationHeader *chain = NULL;
+#define CHUNK_SIZE (1 << 20)
+#define ALIGNMENT sizeof(max_align_t)
+
+static Chunk *firstChunk = NULL;
+static Chunk *currentChunk = NULL;
+static size_t used = 0;
 #define BUFFER_SIZE 256
 
 static uint64 MaxBufferSize = 0;
@@ -22,38 +31,68 @@ static uint64 MaxMemory = 0;
 
 void initializeMemory()
 {
-  statisticIncludeInteger(&MaxBufferSize, "B", "MaxBuffer", true);
-  statisticIncludeInteger(&CurrentMemory, "C", "CurrentMemory", true);
-  statisticIncludeInteger(&MaxMemory, "M", "MaxMemory", true);
+  statisticIncludeMaximum(&MaxBufferSize, "B", "MaxBuffer", true);
+  statisticIncludeMaximum(&CurrentMemory, "C", "CurrentMemory", true);
+  statisticIncludeMaximum(&MaxMemory, "M", "MaxMemory", true);
 }
 
 void freeAll(void)
 {
-  while (chain) {
-    AllocationHeader *next = chain->next;
-    free(chain);
-    chain = next;
-  }
+  currentChunk = firstChunk;
+  used = 0;
   CurrentMemory = 0;
 }
 
-void *tempMalloc(size_t size)
+struct tempMark tempMark(void)
 {
-  // Allocate header + requested size
-  AllocationHeader *header = malloc(sizeof(AllocationHeader) + size);
-  if (!header) return NULL;
+  return (struct tempMark){currentChunk, used, CurrentMemory};
+}
 
-  // Set up the header
-  header->next = chain;
-  header->data = (void *)(header + 1);  // Vertex to the data area
+void freeTo(struct tempMark mark)
+{
+  /* With no chunk, the next allocation reuses the first one. */
+  currentChunk = mark.chunk;
+  used = mark.used;
+  CurrentMemory = mark.memory;
+}
 
-  // Update chain
-  chain = header;
-  CurrentMemory += size + sizeof(AllocationHeader);
+/* Moves on to a chunk with at least size bytes free, reusing the next one if
+   it is big enough. */
+static bool nextChunk(size_t size)
+{
+  Chunk *chunk = currentChunk == NULL ? firstChunk : currentChunk->next;
+  if (chunk == NULL || chunk->size < size) {
+    size_t chunkSize = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+    Chunk *fresh = malloc(sizeof(Chunk) + chunkSize);
+    if (!fresh) return false;
+    fresh->size = chunkSize;
+    fresh->next = chunk;
+    if (currentChunk == NULL) {
+      firstChunk = fresh;
+    } else {
+      currentChunk->next = fresh;
+    }
+    chunk = fresh;
+  }
+  currentChunk = chunk;
+  used = 0;
+  return true;
+}
+
+void *tempMalloc(size_t size)
+{
+  void *result;
+  size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  if (currentChunk == NULL || currentChunk->size - used < size) {
+    if (!nextChunk(size)) return NULL;
+  }
+  result = (char *)currentChunk->data + used;
+  used += size;
+  CurrentMemory += size;
   if (CurrentMemory > MaxMemory) {
     MaxMemory = CurrentMemory;
   }
-  return header->data;
+  return result;
 }
 
 char *getBuffer()
@@ -11,10 +11,20 @@
  * Provides a simple arena allocator that can be bulk-freed.
  */
 
+/* A point in the arena, so that an allocation and what follows it can be
+   freed without freeing what came before. */
+struct tempMark {
+  struct Chunk *chunk;
+  size_t used;
+  size_t memory;
+};
+
 /* Memory allocation functions */
 extern void initializeMemory(void);   /* Initialize memory system */
 extern void *tempMalloc(size_t size); /* Allocate temporary memory */
 extern void freeAll(void);            /* Free all temporary allocations */
+extern struct tempMark tempMark(void);     /* The current point */
+extern void freeTo(struct tempMark mark); /* Free all allocations since mark */
 
 /* String buffer functions */
 extern char *getBuffer(void);           /* Get a temporary string buffer */
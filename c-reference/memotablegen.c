@@ -0,0 +1,98 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "memotables.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Writes the C source of MemoTables to stdout, computing it with the same
+ * code as a run would without it. The build compiles this once for each
+ * NCOLORS, as objsN/memotablegen, to write objsN/memodata.c.
+ */
+
+static struct memoTables Tables;
+
+/* So that each struct faceNeighbours prints as its two members. */
+_Static_assert(sizeof(struct faceNeighbours) == 2, "unpadded faceNeighbours");
+
+static unsigned long long valueAt(const unsigned char *data, size_t size)
+{
+  switch (size) {
+    case 1:
+      return *(const uint8_t *)data;
+    case 2:
+      return *(const uint16_t *)data;
+    case 4:
+      return *(const uint32_t *)data;
+    default:
+      return *(const uint64_t *)data;
+  }
+}
+
+/* The array at data, with the given dimensions, as a nested initializer. */
+static void printArray(const unsigned char *data, size_t size,
+                       const int *dimensions, int depth)
+{
+  size_t stride = size;
+  for (int i = 1; i < depth; i++) {
+    stride *= dimensions[i];
+  }
+  putchar('{');
+  for (int i = 0; i < dimensions[0]; i++) {
+    if (i > 0) {
+      putchar(',');
+      if (depth == 1 && i % 16 == 0) {
+        putchar('\n');
+      }
+    }
+    if (depth == 1) {
+      printf("%llu%s", valueAt(data + i * stride, size), size == 8 ? "ull" : "");
+    } else {
+      printArray(data + i * stride, size, dimensions + 1, depth - 1);
+    }
+  }
+  putchar('}');
+}
+
+/* element indexes the member down to one of its values. */
+#define PRINT_MEMBER(name, element, ...)                                 \
+  do {                                                                   \
+    const int dimensions[] = {__VA_ARGS__};                              \
+    printf("  ." #name " =\n    ");                                      \
+    printArray((const unsigned char *)&Tables.name,                      \
+               sizeof(Tables.name element), dimensions,                  \
+               (int)(sizeof(dimensions) / sizeof(dimensions[0])));       \
+    printf(",\n");                                                       \
+  } while (0)
+
+int main(void)
+{
+  memoTablesCompute(&Tables);
+  printf("/* Generated by memotablegen for NCOLORS=%d; do not edit. */\n\n",
+         NCOLORS);
+  printf("#include \"memotables.h\"\n\n");
+  printf("const struct memoTables MemoTables = {\n");
+  PRINT_MEMBER(cycleLength, [0], NCYCLES);
+  PRINT_MEMBER(cycleColors, [0], NCYCLES);
+  PRINT_MEMBER(cycleCurves, [0][0], NCYCLES, NCOLORS);
+  PRINT_MEMBER(cycleRestrictedPairs, [0], NCYCLES);
+  PRINT_MEMBER(cycleSetPairs, [0][0][0], NCOLORS, NCOLORS, CYCLESET_LENGTH);
+  PRINT_MEMBER(cycleSetTriples, [0][0][0][0], NCOLORS, NCOLORS, NCOLORS,
+               CYCLESET_LENGTH);
+  PRINT_MEMBER(cycleSetOmittingOneColor, [0][0], NCOLORS, CYCLESET_LENGTH);
+  PRINT_MEMBER(cycleSetOmittingColorPair, [0][0][0], NCOLORS, NCOLORS,
+               CYCLESET_LENGTH);
+  PRINT_MEMBER(cycleSetByLength, [0][0], NCOLORS + 1, CYCLESET_LENGTH);
+  PRINT_MEMBER(possibleCycles, [0][0], NFACES, CYCLESET_LENGTH);
+  PRINT_MEMBER(faceNeighbours, [0][0].previous, NFACES, NCYCLES, 2);
+  PRINT_MEMBER(permutedFace, [0][0], NPERMUTATIONS, NFACES);
+  PRINT_MEMBER(permutedCycle, [0][0], NPERMUTATIONS, NCYCLES);
+  PRINT_MEMBER(reversedCycle, [0], NCYCLES);
+  printf("};\n");
+  if (fflush(stdout) != 0) {
+    perror("memotablegen");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,25 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "memotables.h"
+
+#include "cycleset.h"
+#include "face.h"
+
+static bool Computing = false;
+
+const struct memoTables *memoTables(void)
+{
+  return Computing ? NULL : &MemoTables;
+}
+
+void memoTablesCompute(struct memoTables *tables)
+{
+  Computing = true;
+  initializeCycleSets();
+  initializeFacesAndEdges();
+  initializeS6();
+  Computing = false;
+  cycleSetsSaveMemo(tables);
+  facesSaveMemo(tables);
+  s6SaveMemo(tables);
+}
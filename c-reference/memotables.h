@@ -0,0 +1,56 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef MEMOTABLES_H
+#define MEMOTABLES_H
+
+#include "core.h"
+#include "color.h"
+#include "s6.h"
+#include "vertex.h"
+
+/**
+ * The MEMO data that takes most of the start up: the cycles and their cycle
+ * sets, the cycles each face may have, with their neighbours, and the
+ * permutation tables of s6.c. It is the same for each NCOLORS, so the build
+ * runs memotablegen, which computes it with the code below, and writes it
+ * as the initializer of MemoTables, in objsN/memodata.c. The initializers
+ * then copy from MemoTables, and fix up the pointers, such as those of each
+ * cycle to its cycle sets, which are left as they were. Where memodata.o is
+ * not linked in, as in memotablegen itself, or for NCOLORS=7, whose
+ * permutation tables alone are 24MB, MemoTables is NULL, and the data is
+ * computed as before.
+ */
+
+struct memoTables {
+  uint32_t cycleLength[NCYCLES];
+  COLORSET cycleColors[NCYCLES];
+  COLOR cycleCurves[NCYCLES][NCOLORS];
+  uint64 cycleRestrictedPairs[NCYCLES];
+  uint64 cycleSetPairs[NCOLORS][NCOLORS][CYCLESET_LENGTH];
+  uint64 cycleSetTriples[NCOLORS][NCOLORS][NCOLORS][CYCLESET_LENGTH];
+  uint64 cycleSetOmittingOneColor[NCOLORS][CYCLESET_LENGTH];
+  uint64 cycleSetOmittingColorPair[NCOLORS][NCOLORS][CYCLESET_LENGTH];
+  uint64 cycleSetByLength[NCOLORS + 1][CYCLESET_LENGTH];
+  /* Before the outer and inner faces are restricted to NCOLORS cycles. */
+  uint64 possibleCycles[NFACES][CYCLESET_LENGTH];
+  struct faceNeighbours faceNeighbours[NFACES][NCYCLES];
+  uint8_t permutedFace[NPERMUTATIONS][NFACES];
+  uint16_t permutedCycle[NPERMUTATIONS][NCYCLES];
+  uint16_t reversedCycle[NCYCLES];
+};
+
+extern const struct memoTables MemoTables __attribute__((weak));
+
+/* MemoTables, unless it is not linked in, or is being computed. */
+extern const struct memoTables *memoTables(void);
+
+/* Computes the tables, from which the MEMO data must not yet be initialized,
+ * leaving it initialized. */
+extern void memoTablesCompute(struct memoTables *tables);
+
+/* Each copies its part of the initialized MEMO data into tables. */
+extern void cycleSetsSaveMemo(struct memoTables *tables);
+extern void facesSaveMemo(struct memoTables *tables);
+extern void s6SaveMemo(struct memoTables *tables);
+
+#endif  // MEMOTABLES_H
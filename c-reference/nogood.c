@@ -0,0 +1,89 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "nogood.h"
+
+#include "statistics.h"
+
+/* The nogoods kept under each (face, cycle) choice */
+#define NOGOOD_WAYS 2
+
+struct nogood {
+  uint32_t generation; /* Empty unless this is Generation */
+  uint8_t size;        /* Of the other choices, below */
+  uint8_t faces[NOGOOD_MAX_SIZE - 1];
+  uint16_t cycles[NOGOOD_MAX_SIZE - 1];
+};
+
+uint64 NogoodPropagationReasons = 0;
+uint64 NogoodFailureReasons = NOGOOD_UNKNOWN;
+
+static struct nogood Nogoods[NFACES][NCYCLES][NOGOOD_WAYS];
+static uint32_t Generation = 1;
+static uint64 NogoodHitCounter = 0;
+static uint64 NogoodMissCounter = 0;
+static uint64 NogoodLearnedCounter = 0;
+
+void initializeNogoods(void)
+{
+  statisticIncludeInteger(&NogoodLearnedCounter, "L", "nogoods", true);
+  statisticIncludeInteger(&NogoodHitCounter, "H", "nogood hits", true);
+  statisticIncludeInteger(&NogoodMissCounter, "h", "nogood misses", true);
+}
+
+void nogoodClear(void)
+{
+  Generation++;
+}
+
+static bool nogoodHolds(const struct nogood* nogood)
+{
+  for (uint32_t i = 0; i < nogood->size; i++) {
+    if (Faces[nogood->faces[i]].cycle != Cycles + nogood->cycles[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool nogoodExcludes(FACE face, CYCLE cycle)
+{
+  struct nogood* nogood = Nogoods[face - Faces][cycle - Cycles];
+  for (int way = 0; way < NOGOOD_WAYS; way++, nogood++) {
+    if (nogood->generation == Generation && nogoodHolds(nogood)) {
+      NogoodHitCounter++;
+      return true;
+    }
+  }
+  NogoodMissCounter++;
+  return false;
+}
+
+void nogoodLearn(FACE* facesInOrder, int round)
+{
+  FACE face = facesInOrder[round];
+  uint64 latest = NOGOOD_REASON(round);
+  uint64 others = NogoodFailureReasons & ~latest;
+  struct nogood *slot, *ways;
+  /* Only rounds up to this one can have contributed, unless unknown. */
+  if (latest == NOGOOD_UNKNOWN || (NogoodFailureReasons & latest) == 0 ||
+      (others & ~(latest - 1)) != 0 ||
+      __builtin_popcountll(others) > NOGOOD_MAX_SIZE - 1) {
+    return;
+  }
+  ways = Nogoods[face - Faces][face->cycle - Cycles];
+  slot = ways + NogoodLearnedCounter % NOGOOD_WAYS;
+  for (int way = 0; way < NOGOOD_WAYS; way++) {
+    if (ways[way].generation != Generation) {
+      slot = ways + way;
+      break;
+    }
+  }
+  slot->generation = Generation;
+  slot->size = 0;
+  for (; others != 0; others &= others - 1) {
+    FACE other = facesInOrder[__builtin_ctzll(others)];
+    slot->faces[slot->size] = (uint8_t)(other - Faces);
+    slot->cycles[slot->size++] = (uint16_t)(other->cycle - Cycles);
+  }
+  NogoodLearnedCounter++;
+}
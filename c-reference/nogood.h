@@ -0,0 +1,50 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef NOGOOD_H
+#define NOGOOD_H
+
+#include "face.h"
+
+/**
+ * Learned nogoods for the Venn search: small sets of (face, cycle) choices
+ * that cannot all hold, given the central face set up in round 0.
+ *
+ * Each face carries, in face->reasons, the rounds of the Venn choices that
+ * have restricted its cycles, directly or through forced faces. When a choice
+ * fails because some face has no cycle left, or has one that it is not
+ * allowed, the reasons of that face and of the face propagating to it give
+ * the choices that together caused the failure. If there are few enough of
+ * them, they are remembered, under the latest, and checked before that
+ * choice is made again. Other failures, about edges and vertices, are not
+ * learned from, since the reasons do not cover them.
+ */
+
+/* The most choices in a nogood */
+#define NOGOOD_MAX_SIZE 4
+
+/* The reasons for a failure that cannot be learned from */
+#define NOGOOD_UNKNOWN (~0ull)
+
+/* The reasons of the Venn choice of a round. There are bits for the first 64
+ * rounds only; the later ones, which only NCOLORS=7 reaches, are unknown. */
+#define NOGOOD_REASON(round) \
+  ((round) < 64 ? 1ull << (round) : NOGOOD_UNKNOWN)
+
+/* The reasons for the propagation under way, and for the latest failure. */
+extern uint64 NogoodPropagationReasons;
+extern uint64 NogoodFailureReasons;
+
+/* Registers the nogood statistics. */
+extern void initializeNogoods(void);
+
+/* Forgets all the nogoods, as round 0 changes what they depend on. */
+extern void nogoodClear(void);
+
+/* Whether a learned nogood rules out choosing cycle for face now. */
+extern bool nogoodExcludes(FACE face, CYCLE cycle);
+
+/* Learns from the failure of choosing the cycle of facesInOrder[round],
+ * using NogoodFailureReasons. */
+extern void nogoodLearn(FACE* facesInOrder, int round);
+
+#endif  // NOGOOD_H
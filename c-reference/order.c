@@ -0,0 +1,227 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "order.h"
+
+#include "common.h"
+#include "main.h"
+#include "utils.h"
+#include "visible_for_testing.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* The wdeg weights are halved after this many failures, so that recent
+ * failures count for more. Must be a power of two. */
+#define WDEG_DECAY_INTERVAL (1u << 12)
+
+static uint64 FaceWeights[NFACES];
+static uint32_t CycleFailures[NFACES][NCYCLES];
+static uint64 FailureCount = 0;
+
+/* The cycle IDs from most to least constraining, see mostConstrainingFirst */
+static CYCLE_ID CyclesByConstraint[NCYCLES];
+static bool CyclesByConstraintReady = false;
+
+static double StartSeconds;
+static double FirstSolutionSeconds;
+static uint64 FirstSolutionGuesses = 0;
+
+FACE searchChooseNextFace(void)
+{
+  FACE face = NULL;
+  int64_t min = NCYCLES + 1;
+  /* In increasing order, so that ties go to the lowest face as before. */
+  for (uint32_t word = 0; word < FACESET_LENGTH; word++) {
+    for (uint64 faces = FacesWithoutCycleState[word]; faces != 0;
+         faces &= faces - 1) {
+      int i = word * BITS_PER_WORD + __builtin_ctzll(faces);
+      if ((int64_t)Faces[i].cycleSetSize < min && Faces[i].cycle == NULL) {
+        min = (int64_t)Faces[i].cycleSetSize;
+        face = Faces + i;
+      }
+    }
+  }
+  return face;
+}
+
+/* The fewest cycles, with ties going to the face whose choices have failed
+ * most recently. Dividing the cycles by the weight, as dom/wdeg does, takes
+ * faces with many cycles far too early in this search. */
+static FACE chooseWeightedFace(void)
+{
+  FACE face = NULL;
+  uint64 min = NCYCLES + 1, maxWeight = 0;
+  for (uint32_t word = 0; word < FACESET_LENGTH; word++) {
+    for (uint64 faces = FacesWithoutCycleState[word]; faces != 0;
+         faces &= faces - 1) {
+      int i = word * BITS_PER_WORD + __builtin_ctzll(faces);
+      if (Faces[i].cycle != NULL) {
+        continue;
+      }
+      if (Faces[i].cycleSetSize < min ||
+          (Faces[i].cycleSetSize == min && FaceWeights[i] > maxWeight)) {
+        min = Faces[i].cycleSetSize;
+        maxWeight = FaceWeights[i];
+        face = Faces + i;
+      }
+    }
+  }
+  return face;
+}
+
+/* The faces whose cycles a choice of this cycle restricts directly: two for
+ * each edge, one for each missing color, and one for each restricted pair. */
+static uint32_t constraintsOf(CYCLE cycle)
+{
+  return 2 * cycle->length + (NCOLORS - cycle->length) +
+         __builtin_popcountll(cycle->restrictedPairs);
+}
+
+static void initializeCyclesByConstraint(void)
+{
+  CYCLE_ID i, j;
+  for (i = 0; i < NCYCLES; i++) {
+    uint32_t constraints = constraintsOf(Cycles + i);
+    for (j = i; j > 0 && constraintsOf(Cycles + CyclesByConstraint[j - 1]) <
+                             constraints;
+         j--) {
+      CyclesByConstraint[j] = CyclesByConstraint[j - 1];
+    }
+    CyclesByConstraint[j] = i;
+  }
+  CyclesByConstraintReady = true;
+}
+
+static void mostConstrainingFirst(FACE face, CYCLE* cycles)
+{
+  CYCLE_ID i;
+  if (!CyclesByConstraintReady) {
+    initializeCyclesByConstraint();
+  }
+  for (i = 0; i < NCYCLES; i++) {
+    if (cycleSetMember(CyclesByConstraint[i], face->possibleCycles)) {
+      *cycles++ = Cycles + CyclesByConstraint[i];
+    }
+  }
+}
+
+static void fewestFailuresFirst(FACE face, CYCLE* cycles)
+{
+  uint32_t* failures = CycleFailures[face - Faces];
+  uint32_t count = 0, j;
+  CYCLE cycle;
+  for (cycle = cycleSetFirst(face->possibleCycles); cycle != NULL;
+       cycle = cycleSetNext(face->possibleCycles, cycle), count++) {
+    uint32_t mine = failures[cycle - Cycles];
+    for (j = count; j > 0 && failures[cycles[j - 1] - Cycles] > mine; j--) {
+      cycles[j] = cycles[j - 1];
+    }
+    cycles[j] = cycle;
+  }
+}
+
+static void countFailure(FACE face, CYCLE cycle)
+{
+  FaceWeights[face - Faces]++;
+  CycleFailures[face - Faces][cycle - Cycles]++;
+  if ((++FailureCount & (WDEG_DECAY_INTERVAL - 1)) == 0) {
+    for (uint32_t i = 0; i < NFACES; i++) {
+      FaceWeights[i] /= 2;
+      for (uint32_t j = 0; j < NCYCLES; j++) {
+        CycleFailures[i][j] /= 2;
+      }
+    }
+  }
+}
+
+static const struct orderStrategy Strategies[] = {
+    {"mrv", searchChooseNextFace, NULL, NULL},
+    {"constraining", searchChooseNextFace, mostConstrainingFirst, NULL},
+    {"wdeg", chooseWeightedFace, fewestFailuresFirst, countFailure},
+};
+
+const struct orderStrategy* OrderStrategy = Strategies;
+
+bool orderSelect(const char* name)
+{
+  for (size_t i = 0; i < ARRAY_LEN(Strategies); i++) {
+    if (strcmp(name, Strategies[i].name) == 0) {
+      OrderStrategy = Strategies + i;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool orderIsRepeatable(void)
+{
+  return OrderStrategy->failed == NULL;
+}
+
+static double seconds(void)
+{
+  struct timespec now;
+  timespec_get(&now, TIME_UTC);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+void orderSolutionFound(void)
+{
+  if (FirstSolutionGuesses == 0) {
+    FirstSolutionGuesses = CycleGuessCounterIPC;
+    FirstSolutionSeconds = seconds() - StartSeconds;
+  }
+}
+
+static void runBenchmark(const struct orderStrategy* strategy,
+                         const char* folder, void (*search)(void))
+{
+  static char subfolder[PATH_MAX];
+  snprintf(subfolder, sizeof(subfolder), "%s/%s", folder, strategy->name);
+  TargetFolderFlag = subfolder;
+  initializeFolder(subfolder);
+  OrderStrategy = strategy;
+  StartSeconds = seconds();
+  search();
+  printf("%-12s %12llu guesses %8llu solutions; first after %llu guesses, "
+         "%.2fs; all in %.2fs\n",
+         strategy->name, (unsigned long long)CycleGuessCounterIPC,
+         (unsigned long long)GlobalSolutionsFoundIPC,
+         (unsigned long long)FirstSolutionGuesses, FirstSolutionSeconds,
+         seconds() - StartSeconds);
+  fflush(stdout);
+  _exit(EXIT_SUCCESS);
+}
+
+void orderBenchmark(void (*search)(void))
+{
+  const char* folder = TargetFolderFlag;
+  for (size_t i = 0; i < ARRAY_LEN(Strategies); i++) {
+    int status;
+    pid_t pid;
+    fflush(NULL);
+    pid = fork();
+    if (pid < 0) {
+      perror("fork");
+      exit(EXIT_FAILURE);
+    }
+    if (pid == 0) {
+      runBenchmark(Strategies + i, folder, search);
+    }
+    if (waitpid(pid, &status, 0) < 0) {
+      perror("waitpid");
+      exit(EXIT_FAILURE);
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+      fprintf(stderr, "The %s benchmark failed.\n", Strategies[i].name);
+      exit(EXIT_FAILURE);
+    }
+  }
+}
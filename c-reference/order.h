@@ -0,0 +1,46 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef ORDER_H
+#define ORDER_H
+
+#include "face.h"
+
+/**
+ * Orderings for the Venn search: which face to choose next, and in which
+ * order to try its cycles. The default, mrv, chooses the face with fewest
+ * cycles left, and tries them in order of cycle ID. Serial search finds the
+ * solutions in an order that depends on the strategy, but the same solutions.
+ */
+struct orderStrategy {
+  const char* name;
+  /* The next face to choose, or NULL when every face has a cycle. */
+  FACE (*chooseFace)(void);
+  /* Sets cycles to those of the face in the order to try them, or is NULL
+   * for the order of cycle ID. */
+  void (*orderCycles)(FACE face, CYCLE* cycles);
+  /* Told when choosing the cycle for the face fails, or NULL. A strategy that
+   * learns from failures does not give the same order when a choice path is
+   * replayed, so cannot be used with -P, -S, -c or -R. */
+  void (*failed)(FACE face, CYCLE cycle);
+};
+
+extern const struct orderStrategy* OrderStrategy;
+
+/* Selects the named strategy, returning false if there is none. */
+extern bool orderSelect(const char* name);
+
+/* Whether the selected strategy orders the same way on replay. */
+extern bool orderIsRepeatable(void);
+
+/* Called by the Venn predicate for each solution found. */
+extern void orderSolutionFound(void);
+
+/**
+ * Runs search once with each strategy, in a child process, writing the
+ * solutions to a subfolder of TargetFolderFlag named after the strategy. A
+ * line per strategy reports the guesses made, and the guesses and time taken
+ * to the first solution, which is what matters with -m 1.
+ */
+extern void orderBenchmark(void (*search)(void));
+
+#endif  // ORDER_H
@@ -0,0 +1,291 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "parallel.h"
+
+#include "asyncwriter.h"
+#include "classindex.h"
+#include "face.h"
+#include "main.h"
+#include "predicates.h"
+#include "shard.h"
+#include "solutionindex.h"
+#include "statistics.h"
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include <limits.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * The parent process runs Initialize and the InnerFace predicate, collecting
+ * every canonical face degree sequence in the order of the serial search.
+ * It then forks the workers, so that all the MEMO data is shared
+ * copy-on-write, and each worker has its own engine, trail and DYNAMIC
+ * state. Each worker replaces InnerFace with a predicate that claims
+ * whichever sequences are still unclaimed.
+ *
+ * Because some sequences have far more work than others, a worker with
+ * nothing left to claim steals work: it asks a busy worker, which, between
+ * engine steps, gives away half the untried choices of its shallowest Venn
+ * choice point as a choice path. The thief replays that path, rebuilding
+ * the DYNAMIC state of the subtree, and searches it.
+ *
+ * Solutions are then found out of serial order, so they are saved under
+ * provisional names, for main to renumber to the serial names at the end.
+ * Options that count solutions across sequences (-m and -k without -d)
+ * cannot be honored and are rejected by main. With -d, -m and -k count the
+ * solutions of each sequence, so no work is stolen: each sequence is
+ * searched by the one worker that claims it, in serial order.
+ */
+
+extern FACE_DEGREE CurrentFaceDegrees[NCOLORS];
+
+enum { OFFER_PENDING, OFFER_READY, OFFER_NONE };
+
+/* Value of stealRequest while a worker has no work to give. */
+#define NOT_BUSY (-1)
+
+struct workerState {
+  int stealRequest; /* 1 + index of the worker asking for work, or 0 */
+  int offer;        /* The answer to this worker's own request */
+  int offeredSequence;
+  struct choicePath offeredPath;
+};
+
+struct sharedState {
+  int numberOfSequences;
+  int busyWorkers;
+  FACE_DEGREE sequences[MAX_FACE_DEGREE_SEQUENCES][NCOLORS];
+  int claimed[MAX_FACE_DEGREE_SEQUENCES];
+  struct workerState workers[MAX_PARALLEL_WORKERS];
+};
+
+static struct sharedState* Shared = NULL;
+static struct statisticTotals* Totals;
+static int NumberOfWorkers;
+static int ThisWorker;
+static struct stack WorkerStack;
+/* The sequence of the path being replayed, already claimed. */
+static int ReplayedSequence = -1;
+static int CurrentSequence;
+/* Whether idle workers steal; not when -m or -k count within a sequence. */
+static bool Stealing;
+
+static struct predicateResult tryCollectFaceDegrees(int round)
+{
+  (void)round;
+  assert(Shared->numberOfSequences < MAX_FACE_DEGREE_SEQUENCES);
+  memcpy(Shared->sequences[Shared->numberOfSequences++], CurrentFaceDegrees,
+         sizeof(CurrentFaceDegrees));
+  return PredicateFail;
+}
+
+static struct predicateResult tryClaimFaceDegrees(int round)
+{
+  (void)round;
+  return predicateChoices(Shared->numberOfSequences);
+}
+
+static struct predicateResult retryClaimFaceDegrees(int round, int choice)
+{
+  (void)round;
+  if (choice != ReplayedSequence &&
+      __atomic_exchange_n(&Shared->claimed[choice], 1, __ATOMIC_RELAXED)) {
+    return PredicateFail;
+  }
+  CurrentSequence = choice;
+  memcpy(CurrentFaceDegrees, Shared->sequences[choice],
+         sizeof(CurrentFaceDegrees));
+  dynamicFaceSetupCentral(CurrentFaceDegrees);
+  return PredicateSuccessNextPredicate;
+}
+
+static struct predicate CollectFaceDegreesPredicate = {
+    "CollectFaceDegrees", tryCollectFaceDegrees, NULL};
+
+static struct predicate ClaimFaceDegreesPredicate = {
+    "ClaimFaceDegrees", tryClaimFaceDegrees, retryClaimFaceDegrees};
+
+/* NonDeterministicProgram with InnerFace replaced. */
+static PREDICATE WorkerProgram[] = {
+    &InitializePredicate, &ClaimFaceDegreesPredicate, &LogPredicate,
+    &VennPredicate,       &SavePredicate,             &CornersPredicate,
+    &GraphMLPredicate,    &FAILPredicate};
+
+/**
+ * Called by the engine when another worker has asked this one for work.
+ */
+static void handleStealRequest(STACK stack)
+{
+  struct workerState* me = &Shared->workers[ThisWorker];
+  struct workerState* thief;
+  int request = __atomic_load_n(&me->stealRequest, __ATOMIC_ACQUIRE);
+  if (stack != &WorkerStack || request <= 0) {
+    return;  // Wait until we are back from any nested engine.
+  }
+  thief = &Shared->workers[request - 1];
+  if (engineSplit(stack, &VennPredicate, &thief->offeredPath)) {
+    for (int i = 0; i < thief->offeredPath.length; i++) {
+      if (stack->stack[i].predicate == &LogPredicate) {
+        /* The thief logs its share of the solutions when it is done. */
+        thief->offeredPath.steps[i].end = 2;
+      }
+    }
+    thief->offeredSequence = CurrentSequence;
+    __atomic_fetch_add(&Shared->busyWorkers, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&thief->offer, OFFER_READY, __ATOMIC_RELEASE);
+  } else {
+    __atomic_store_n(&thief->offer, OFFER_NONE, __ATOMIC_RELEASE);
+  }
+  __atomic_store_n(&me->stealRequest, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * Stops accepting steal requests, declining any that is already pending.
+ */
+static void becomeIdle(void)
+{
+  int request = __atomic_exchange_n(&Shared->workers[ThisWorker].stealRequest,
+                                    NOT_BUSY, __ATOMIC_ACQ_REL);
+  if (request > 0) {
+    __atomic_store_n(&Shared->workers[request - 1].offer, OFFER_NONE,
+                     __ATOMIC_RELEASE);
+  }
+  __atomic_fetch_sub(&Shared->busyWorkers, 1, __ATOMIC_RELEASE);
+}
+
+static void waitBriefly(void)
+{
+  struct timespec delay = {0, 1000000};
+  nanosleep(&delay, NULL);
+}
+
+/**
+ * Returns false when every worker is idle, so there is no work left.
+ */
+static bool stealWork(void)
+{
+  struct workerState* me = &Shared->workers[ThisWorker];
+  while (__atomic_load_n(&Shared->busyWorkers, __ATOMIC_ACQUIRE) > 0) {
+    for (int i = 1; i < NumberOfWorkers; i++) {
+      int victim = (ThisWorker + i) % NumberOfWorkers;
+      int expected = 0;
+      __atomic_store_n(&me->offer, OFFER_PENDING, __ATOMIC_RELAXED);
+      if (!__atomic_compare_exchange_n(
+              &Shared->workers[victim].stealRequest, &expected,
+              ThisWorker + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        continue;
+      }
+      while (__atomic_load_n(&me->offer, __ATOMIC_ACQUIRE) == OFFER_PENDING) {
+        sched_yield();
+      }
+      if (__atomic_load_n(&me->offer, __ATOMIC_ACQUIRE) == OFFER_READY) {
+        __atomic_store_n(&me->stealRequest, 0, __ATOMIC_RELEASE);
+        return true;
+      }
+    }
+    waitBriefly();
+  }
+  return false;
+}
+
+static void runWorker(int worker)
+{
+  char tag[64] = "";
+  ThisWorker = worker;
+  /* Lines from different workers share stdout, keep each one whole. */
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  /* Only count this worker's share of the search. */
+  statisticClear();
+  if (ShardCountFlag > 0) {
+    shardTag(tag, sizeof(tag));
+  }
+  snprintf(tag + strlen(tag), sizeof(tag) - strlen(tag), "w%d", worker);
+  solutionIndexOpen(TargetFolderFlag, tag, 0);
+  if (UniqueClassesFlag) {
+    classIndexPending(TargetFolderFlag, tag);
+  }
+  if (Stealing) {
+    enginePollWith(&Shared->workers[worker].stealRequest, handleStealRequest);
+  }
+
+  engine(&WorkerStack, WorkerProgram);
+  if (Stealing) {
+    becomeIdle();
+    while (stealWork()) {
+      struct workerState* me = &Shared->workers[worker];
+      ReplayedSequence = me->offeredSequence;
+      engineReplay(&WorkerStack, WorkerProgram, &me->offeredPath);
+      becomeIdle();
+    }
+  }
+
+  asyncWriterFinish();
+  solutionIndexClose();
+  classIndexClose();
+  statisticAddTo(Totals);
+  fflush(stdout);
+  _exit(EXIT_SUCCESS);
+}
+
+static void waitForWorkers(int workers)
+{
+  bool failed = false;
+  for (int i = 0; i < workers; i++) {
+    int status;
+    if (wait(&status) < 0) {
+      perror("wait");
+      exit(EXIT_FAILURE);
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+      failed = true;
+    }
+  }
+  if (failed) {
+    fprintf(stderr, "A worker process failed; the search is incomplete.\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+void parallelSearch(int workers)
+{
+  struct stack parentStack;
+  assert(workers <= MAX_PARALLEL_WORKERS);
+  Shared = mmap(NULL, sizeof(*Shared), PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (Shared == MAP_FAILED) {
+    perror("mmap");
+    exit(EXIT_FAILURE);
+  }
+  engine(&parentStack,
+         (PREDICATE[]){&InitializePredicate, &InnerFacePredicate,
+                       &CollectFaceDegreesPredicate});
+  /* Every statistic has been registered by the initialization. */
+  Totals = statisticTotalsCreate();
+
+  NumberOfWorkers = workers;
+  Stealing = PerFaceDegreeMaxSolutionsFlag == INT_MAX &&
+             PerFaceDegreeSkipSolutionsFlag == 0;
+  Shared->busyWorkers = workers;
+  fflush(NULL);
+  for (int i = 0; i < workers; i++) {
+    pid_t pid = fork();
+    if (pid < 0) {
+      perror("fork");
+      exit(EXIT_FAILURE);
+    }
+    if (pid == 0) {
+      runWorker(i);
+    }
+  }
+  waitForWorkers(workers);
+  statisticSetFrom(Totals);
+  statisticTotalsFree(Totals);
+  munmap(Shared, sizeof(*Shared));
+}
@@ -0,0 +1,28 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "core.h"
+
+/**
+ * Parallel search: the canonical face degree sequences chosen by InnerFace
+ * are enumerated up front and claimed, one at a time, by worker processes
+ * which each run the remainder of the non-deterministic program. Idle
+ * workers steal subtrees of the Venn search from busy ones.
+ */
+
+/* The most worker processes. */
+#define MAX_PARALLEL_WORKERS 256
+
+/* The most canonical inner face degree sequences that can be shared out. */
+#define MAX_FACE_DEGREE_SEQUENCES 4096
+
+/**
+ * Runs the full search using the given number of worker processes, and
+ * leaves the combined statistics of all the workers in this process. The
+ * solutions are left with provisional names, see solutionindex.h.
+ */
+extern void parallelSearch(int workers);
+
+#endif  // PARALLEL_H
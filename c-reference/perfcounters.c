@@ -0,0 +1,82 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "perfcounters.h"
+
+#include <stdio.h>
+#include <string.h>
+
+bool PerfCountersEnabled = false;
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+
+#include <errno.h>
+#include <unistd.h>
+
+/* The first is the leader of the group, so all are read at once. */
+static int Leader = -1;
+
+static int openCounter(uint64_t config, int group)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+bool perfCountersStart(void)
+{
+  static const uint64_t configs[PERF_COUNTERS] = {
+      [PERF_CYCLES] = PERF_COUNT_HW_CPU_CYCLES,
+      [PERF_INSTRUCTIONS] = PERF_COUNT_HW_INSTRUCTIONS,
+      [PERF_CACHE_MISSES] = PERF_COUNT_HW_CACHE_MISSES,
+      [PERF_BRANCH_MISSES] = PERF_COUNT_HW_BRANCH_MISSES,
+  };
+  int fds[PERF_COUNTERS];
+  for (int i = 0; i < PERF_COUNTERS; i++) {
+    fds[i] = openCounter(configs[i], i == 0 ? -1 : fds[0]);
+    if (fds[i] < 0) {
+      fprintf(stderr, "Hardware counters unavailable: %s\n", strerror(errno));
+      while (i-- > 0) {
+        close(fds[i]);
+      }
+      return false;
+    }
+  }
+  Leader = fds[0];
+  PerfCountersEnabled = true;
+  return true;
+}
+
+/* A failed read repeats the last, so that nothing is counted for it. */
+void perfCountersRead(uint64 counts[PERF_COUNTERS])
+{
+  static uint64_t values[PERF_COUNTERS + 1];
+  uint64_t latest[PERF_COUNTERS + 1];
+  if (read(Leader, latest, sizeof(latest)) == (ssize_t)sizeof(latest)) {
+    memcpy(values, latest, sizeof(values));
+  }
+  for (int i = 0; i < PERF_COUNTERS; i++) {
+    counts[i] = values[i + 1];
+  }
+}
+#else
+bool perfCountersStart(void)
+{
+  fprintf(stderr, "Hardware counters unavailable: not Linux\n");
+  return false;
+}
+
+void perfCountersRead(uint64 counts[PERF_COUNTERS])
+{
+  memset(counts, 0, PERF_COUNTERS * sizeof(counts[0]));
+}
+#endif
@@ -0,0 +1,33 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include "core.h"
+
+/**
+ * Hardware performance counters (-H): the cycles, instructions, cache misses
+ * and branch misses of this process, read by the engine before and after
+ * each try and retry, and added to the profile of the predicate. They are
+ * opened with perf_event_open, so only on Linux; where they cannot be, as in
+ * many containers, the search goes on without them.
+ */
+
+enum perfCounter {
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_CACHE_MISSES,
+  PERF_BRANCH_MISSES,
+  PERF_COUNTERS
+};
+
+/* Set once the counters are open. */
+extern bool PerfCountersEnabled;
+
+/* Opens the counters, or explains on stderr why not, returning false. */
+extern bool perfCountersStart(void);
+
+/* The counts so far. */
+extern void perfCountersRead(uint64 counts[PERF_COUNTERS]);
+
+#endif  // PERFCOUNTERS_H
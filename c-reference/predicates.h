@@ -17,6 +17,9 @@ extern struct predicate InitializePredicate;
 extern struct predicate InnerFacePredicate;  /* Select face degrees */
 extern struct predicate VennPredicate;       /* Assign cycles to faces */
 
+/* The choices of VennPredicate leading to the current solution */
+extern int vennChoicePath(int choices[NFACES]);
+
 /* Output phases - save and display results */
 extern struct predicate LogPredicate;        /* Log progress */
 extern struct predicate SavePredicate;       /* Save solutions */
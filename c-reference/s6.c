@@ -2,8 +2,11 @@
 
 #include "s6.h"
 
+#include "cycleset.h"
 #include "face.h"
 #include "main.h"
+#include "memoimage.h"
+#include "memotables.h"
 #include "predicates.h"
 #include "statistics.h"
 #include "utils.h"
@@ -19,10 +22,53 @@
 /* Canonical face ordering and its inverse mapping */
 static COLORSET SequenceOrder[NFACES];
 static COLORSET InverseSequenceOrder[NFACES];
+/* The face at each position of the canonical order, under each permutation */
+static COLORSET PermutedSequenceOrder[2 * NCOLORS][NFACES];
+
+static uint64 NonCanonicalPrunedCounter = 0;
+
+struct solutionRecord CurrentSolution;
+
+/* NCOLORS to the power NCOLORS, more than any cycleCode */
+#if NCOLORS == 7
+#define NCYCLE_CODES 823543
+#elif NCOLORS == 6
+#define NCYCLE_CODES 46656
+#elif NCOLORS == 5
+#define NCYCLE_CODES 3125
+#elif NCOLORS == 4
+#define NCYCLE_CODES 256
+#elif NCOLORS == 3
+#define NCYCLE_CODES 27
+#else
+#define NCYCLE_CODES 4
+#endif
+
+/* The image of each face and of each cycle under each permutation, in
+ * lexicographic order, and the reverse of each cycle. */
+static uint8_t PermutedFace[NPERMUTATIONS][NFACES];
+static uint16_t PermutedCycle[NPERMUTATIONS][NCYCLES];
+static uint16_t ReversedCycle[NCYCLES];
+static bool PermutationTablesReady = false;
 
 /* Dihedral group D_n generators (rotations and reflections) */
 static int dihedralGroup[2 * NCOLORS][NCOLORS] = {
-#if NCOLORS == 6
+#if NCOLORS == 7
+    {0, 1, 2, 3, 4, 5, 6},
+    {1, 2, 3, 4, 5, 6, 0},
+    {2, 3, 4, 5, 6, 0, 1},
+    {3, 4, 5, 6, 0, 1, 2},
+    {4, 5, 6, 0, 1, 2, 3},
+    {5, 6, 0, 1, 2, 3, 4},
+    {6, 0, 1, 2, 3, 4, 5},
+    {6, 5, 4, 3, 2, 1, 0},
+    {5, 4, 3, 2, 1, 0, 6},
+    {4, 3, 2, 1, 0, 6, 5},
+    {3, 2, 1, 0, 6, 5, 4},
+    {2, 1, 0, 6, 5, 4, 3},
+    {1, 0, 6, 5, 4, 3, 2},
+    {0, 6, 5, 4, 3, 2, 1}
+#elif NCOLORS == 6
     {0, 1, 2, 3, 4, 5},
     {1, 2, 3, 4, 5, 0},
     {2, 3, 4, 5, 0, 1},
@@ -45,30 +91,12 @@ static int dihedralGroup[2 * NCOLORS][NCOLORS] = {
 #endif
 };
 
-/* Comparison function for signatures, used for sorting */
-static int s6SignatureCompare(const void *a, const void *b)
-{
-  return memcmp(a, b, sizeof(((CYCLE_ID_SEQUENCE)NULL)[0]));
-}
-
-/* Comparison function for cycle ID sequences, used for sorting */
-static int compareCycleIdSequence(const void *a, const void *b)
-{
-  return -s6SignatureCompare(*(SIGNATURE *)a, *(SIGNATURE *)b);
-}
-
 /* Comparison function for face degree sequences, used for sorting */
 static int compareFaceDegree(const void *a, const void *b)
 {
   return -memcmp(a, b, sizeof(FACE_DEGREE) * NFACES);
 }
 
-/* Applies a permutation to a color value */
-static COLOR colorPermute(COLOR color, PERMUTATION permutation)
-{
-  return (*permutation)[color];
-}
-
 /* Applies a permutation to a color set */
 static COLORSET colorSetPermute(COLORSET colorSet, PERMUTATION permutation)
 {
@@ -87,16 +115,12 @@ static bool faceDegreesEqual(FACE_DEGREE_SEQUENCE faceDegrees,
   return memcmp(faceDegrees, other, sizeof(faceDegrees[0])) == 0;
 }
 
-static void verifyS6Initialization(uint64 done, uint64 ix)
+static void verifyS6Initialization(const bool *done, uint64 ix)
 {
   uint64 i;
-#if NCOLORS == 6
-  assert(done == ~0llu);
-#else
-  assert(done == (1llu << (uint64)NFACES) - 1l);
-#endif
   assert(ix == NFACES);
   for (i = 0; i < NFACES; i++) {
+    assert(done[i]);
     assert(InverseSequenceOrder[SequenceOrder[i]] == i);
     assert(SequenceOrder[InverseSequenceOrder[i]] == i);
   }
@@ -113,16 +137,62 @@ PERMUTATION s6Automorphism(CYCLE_ID cycleId)
   return result;
 }
 
-CYCLE_ID s6PermuteCycleId(CYCLE_ID originalCycleId, PERMUTATION permutation)
+/* The position of the permutation in lexicographic order */
+static uint32_t permutationIndex(const int *permutation)
+{
+  uint32_t index = 0;
+  for (int i = 0; i < NCOLORS; i++) {
+    uint32_t smaller = 0;
+    for (int j = i + 1; j < NCOLORS; j++) {
+      if (permutation[j] < permutation[i]) {
+        smaller++;
+      }
+    }
+    index = index * (NCOLORS - i) + smaller;
+  }
+  return index;
+}
+
+static void permutationFromIndex(uint32_t index, int *permutation)
+{
+  bool used[NCOLORS] = {false};
+  uint32_t factorial = NPERMUTATIONS;
+  for (int i = 0; i < NCOLORS; i++) {
+    uint32_t smaller;
+    int color;
+    factorial /= NCOLORS - i;
+    smaller = index / factorial;
+    index %= factorial;
+    for (color = 0; used[color] || smaller > 0; color++) {
+      if (!used[color]) {
+        smaller--;
+      }
+    }
+    used[color] = true;
+    permutation[i] = color;
+  }
+}
+
+/* A number for the colors of a cycle starting with its smallest color, which
+ * since the others are larger is different for each cycle. */
+static uint32_t cycleCode(const COLOR *curves, uint32_t length)
+{
+  uint32_t code = 0;
+  for (uint32_t i = length; i > 0; i--) {
+    code = code * NCOLORS + curves[i - 1];
+  }
+  return code;
+}
+
+static uint32_t permutedCycleCode(CYCLE cycle, const int *permutation)
 {
   COLOR permuted[NCOLORS * 2];
-  CYCLE cycle = &Cycles[originalCycleId];
   COLOR min = NCOLORS;
   int minIndex = -1;
 
   // First apply the permutation to all colors in the cycle
   for (uint32_t i = 0; i < cycle->length; i++) {
-    COLOR color = colorPermute(cycle->curves[i], permutation);
+    COLOR color = permutation[cycle->curves[i]];
     permuted[i] = color;
     permuted[cycle->length + i] = color;  // Duplicate for cyclic search
   }
@@ -134,7 +204,75 @@ CYCLE_ID s6PermuteCycleId(CYCLE_ID originalCycleId, PERMUTATION permutation)
       minIndex = i;
     }
   }
-  return getCycleId(permuted + minIndex, cycle->length);
+  return cycleCode(permuted + minIndex, cycle->length);
+}
+
+/* Fills the permutation tables, once the cycles have been initialized. */
+static void initializePermutationTables(void)
+{
+  static uint16_t CycleIdByCode[NCYCLE_CODES];
+  int permutation[NCOLORS];
+  COLOR reversal[NCOLORS];
+  CYCLE_ID cycleId;
+  if (PermutationTablesReady) {
+    return;
+  }
+  if (memoTables() != NULL) {
+    memcpy(PermutedFace, memoTables()->permutedFace, sizeof(PermutedFace));
+    memcpy(PermutedCycle, memoTables()->permutedCycle, sizeof(PermutedCycle));
+    memcpy(ReversedCycle, memoTables()->reversedCycle, sizeof(ReversedCycle));
+    PermutationTablesReady = true;
+    return;
+  }
+  for (cycleId = 0; cycleId < NCYCLES; cycleId++) {
+    CYCLE cycle = Cycles + cycleId;
+    uint32_t code = cycleCode(cycle->curves, cycle->length);
+    assert(code < ARRAY_LEN(CycleIdByCode));
+    CycleIdByCode[code] = (uint16_t)cycleId;
+  }
+  for (uint32_t i = 0; i < NPERMUTATIONS; i++) {
+    permutationFromIndex(i, permutation);
+    assert(permutationIndex(permutation) == i);
+    for (COLORSET colors = 0; colors < NFACES; colors++) {
+      PermutedFace[i][colors] = (uint8_t)colorSetPermute(
+          colors, (PERMUTATION)permutation);
+    }
+    for (cycleId = 0; cycleId < NCYCLES; cycleId++) {
+      PermutedCycle[i][cycleId] =
+          CycleIdByCode[permutedCycleCode(Cycles + cycleId, permutation)];
+    }
+  }
+  /* Reversing a cycle is not a permutation of the colors, so do it apart. */
+  for (cycleId = 0; cycleId < NCYCLES; cycleId++) {
+    CYCLE cycle = Cycles + cycleId;
+    reversal[0] = cycle->curves[0];
+    for (uint32_t i = 1; i < cycle->length; i++) {
+      reversal[i] = cycle->curves[cycle->length - i];
+    }
+    ReversedCycle[cycleId] =
+        CycleIdByCode[cycleCode(reversal, cycle->length)];
+  }
+  PermutationTablesReady = true;
+}
+
+void s6SaveMemo(struct memoTables *tables)
+{
+  memcpy(tables->permutedFace, PermutedFace, sizeof(PermutedFace));
+  memcpy(tables->permutedCycle, PermutedCycle, sizeof(PermutedCycle));
+  memcpy(tables->reversedCycle, ReversedCycle, sizeof(ReversedCycle));
+}
+
+void s6IncludeInImage(void)
+{
+  memoImageInclude(PermutedFace, sizeof(PermutedFace));
+  memoImageInclude(PermutedCycle, sizeof(PermutedCycle));
+  memoImageInclude(ReversedCycle, sizeof(ReversedCycle));
+  memoImageInclude(&PermutationTablesReady, sizeof(PermutationTablesReady));
+}
+
+CYCLE_ID s6PermuteCycleId(CYCLE_ID originalCycleId, PERMUTATION permutation)
+{
+  return PermutedCycle[permutationIndex(*permutation)][originalCycleId];
 }
 
 static FACE_DEGREE_SEQUENCE getFaceDegreesInCanonicalOrder()
@@ -206,76 +344,18 @@ static SYMMETRY_TYPE getPartialSequenceCanonicity(int n,
   return getFullSequenceCanonicity(sizes);
 }
 
-/* Creates mirror image by reversing cycle orientations */
-static SIGNATURE s6SignatureReflected(SIGNATURE sequence)
-{
-  SIGNATURE result = NEW(SIGNATURE);
-  for (int i = 0; i < NFACES; i++) {
-    result->classSignature.faceCycleId[i] =
-        cycleIdReverseDirection(sequence->classSignature.faceCycleId[i]);
-  }
-  result->offset = sequence->offset;
-  result->reflected = !sequence->reflected;
-  return result;
-}
-
-static SIGNATURE s6SignaturePermuted(SIGNATURE sequence,
-                                     PERMUTATION permutation)
-{
-  SIGNATURE result = NEW(SIGNATURE);
-  for (COLORSET i = 0; i < NFACES; i++) {
-    result->classSignature.faceCycleId[colorSetPermute(i, permutation)] =
-        s6PermuteCycleId(sequence->classSignature.faceCycleId[i], permutation);
-  }
-  result->offset = colorSetPermute(sequence->offset, permutation);
-  result->reflected = sequence->reflected;
-  return result;
-}
-
-/* Shifts reference frame to make 'center' the new central face */
-static SIGNATURE s6SignatureRecentered(SIGNATURE sequence, COLORSET center)
-{
-  SIGNATURE result = NEW(SIGNATURE);
-  for (int i = 0; i < NFACES; i++) {
-    result->classSignature.faceCycleId[i] =
-        sequence->classSignature.faceCycleId[i ^ center];
-  }
-  result->offset = center ^ sequence->offset;
-  result->reflected = sequence->reflected;
-  return result;
-}
-
-/* Finds maximum signature under all cyclic color permutations */
-static SIGNATURE maxSpunSignature(SIGNATURE onCurrentFace)
-{
-  int counter;
-  PERMUTATION abcNCycle = &dihedralGroup[1];
-  SIGNATURE best = onCurrentFace;
-  PERMUTATION permutation =
-      s6Automorphism(onCurrentFace->classSignature.faceCycleId[0]);
-  SIGNATURE permuted = s6SignaturePermuted(onCurrentFace, permutation);
-  for (counter = 0; counter < NFACES; counter++) {
-    assert(permuted->classSignature.faceCycleId[0] == NCYCLES - 1);
-    if (s6SignatureCompare(permuted, best) > 0) {
-      best = permuted;
-    }
-    permuted = s6SignaturePermuted(permuted, abcNCycle);
-  }
-  return best;
-}
-
 /* Priority order: single-color faces, then faces with colors 0 and NCOLORS-1,
  * then consecutive colors */
 #define ADD_TO_SEQUENCE_ORDER(colors)               \
   do {                                              \
     SequenceOrder[ix++] = (NFACES - 1) & ~(colors); \
-    done |= 1llu << (colors);                       \
+    done[colors] = true;                            \
   } while (0)
 
 void initializeS6(void)
 {
   uint64 ix = 0, i;
-  uint64 done = 0;
+  bool done[NFACES] = {false};
 
   for (i = 0; i < NCOLORS; i++) {
     ADD_TO_SEQUENCE_ORDER(1llu << i);
@@ -285,7 +365,7 @@ void initializeS6(void)
     ADD_TO_SEQUENCE_ORDER((2llu | 1llu) << i);
   }
   for (i = 0; i < NFACES; i++) {
-    if ((done & (1llu << i)) != 0) {
+    if (done[i]) {
       continue;
     }
     ADD_TO_SEQUENCE_ORDER(i);
@@ -293,7 +373,17 @@ void initializeS6(void)
   for (i = 0; i < NFACES; i++) {
     InverseSequenceOrder[SequenceOrder[i]] = i;
   }
+  for (int j = 0; j < 2 * NCOLORS; j++) {
+    for (i = 0; i < NFACES; i++) {
+      PermutedSequenceOrder[j][i] =
+          colorSetPermute(SequenceOrder[i], &dihedralGroup[j]);
+    }
+  }
   verifyS6Initialization(done, ix);
+  initializeCycleSets();
+  initializePermutationTables();
+  statisticIncludeInteger(&NonCanonicalPrunedCounter, "Y",
+                          "non-canonical prunes", true);
 }
 
 SIGNATURE s6SignatureFromFaces(void)
@@ -307,32 +397,95 @@ SIGNATURE s6SignatureFromFaces(void)
   return result;
 }
 
+/* One reading of the diagram: with center as the central face, perhaps
+ * reflected, and with the colors permuted to put the cycle of that face in
+ * order, then rotated. */
+struct reading {
+  COLORSET center;
+  bool reflected;
+  uint32_t permutation; /* Indexes of the permutation and its inverse */
+  uint32_t inverse;
+};
+
+static void readingInitialize(struct reading *reading, COLORSET center,
+                              bool reflected, int rotation)
+{
+  CYCLE_ID cycleId = Faces[center].cycle - Cycles;
+  CYCLE cycle;
+  int permutation[NCOLORS], inverse[NCOLORS];
+  if (reflected) {
+    cycleId = ReversedCycle[cycleId];
+  }
+  cycle = Cycles + cycleId;
+  reading->center = center;
+  reading->reflected = reflected;
+  for (int i = 0; i < NCOLORS; i++) {
+    int color = (i + rotation) % NCOLORS;
+    permutation[cycle->curves[i]] = color;
+    inverse[color] = cycle->curves[i];
+  }
+  reading->permutation = permutationIndex(permutation);
+  reading->inverse = permutationIndex(inverse);
+}
+
+/* The cycle ID of the face with these colors, in this reading */
+static CYCLE_ID readingCycleId(const struct reading *reading, COLORSET colors)
+{
+  FACE face =
+      Faces + (PermutedFace[reading->inverse][colors] ^ reading->center);
+  CYCLE_ID cycleId = face->cycle - Cycles;
+  if (reading->reflected) {
+    cycleId = ReversedCycle[cycleId];
+  }
+  return PermutedCycle[reading->permutation][cycleId];
+}
+
+/* Whether the reading is larger than the best so far, comparing as memcmp
+ * does on the whole sequence, but stopping at the first difference. */
+static bool readingIsLarger(const struct reading *reading,
+                            CYCLE_ID_SEQUENCE best)
+{
+  for (COLORSET i = 0; i < NFACES; i++) {
+    CYCLE_ID cycleId = readingCycleId(reading, i);
+    int comparison = memcmp(&cycleId, &best->faceCycleId[i], sizeof(cycleId));
+    if (comparison != 0) {
+      return comparison > 0;
+    }
+  }
+  return false;
+}
+
 /* Computes diagram's canonical representation across all symmetries and face
- * centrings */
+ * centrings. Each reading is only built in full if it is the largest yet. */
 SIGNATURE s6MaxSignature(void)
 {
-  int resultsIndex = 0;
-  SIGNATURE fromFaces = s6SignatureFromFaces();
-  COLORSET center = 0;
-  SIGNATURE recentered;
-  SIGNATURE results[NFACES * 2];
-
-  // Try each face as a potential center
-  for (center = 0; center < NFACES; center++) {
-    if (Faces[center].cycle->length == NCOLORS) {
-      // Recenter the signature around this face
-      recentered = s6SignatureRecentered(fromFaces, center);
-
-      // Compute signatures for both orientations
-      results[resultsIndex++] = maxSpunSignature(recentered);
-      results[resultsIndex++] =
-          maxSpunSignature(s6SignatureReflected(recentered));
+  SIGNATURE result = NEW(SIGNATURE);
+  struct reading reading, best;
+  bool found = false;
+
+  for (COLORSET center = 0; center < NFACES; center++) {
+    if (Faces[center].cycle->length != NCOLORS) {
+      continue;
+    }
+    for (int reflected = 0; reflected < 2; reflected++) {
+      for (int rotation = 0; rotation < NCOLORS; rotation++) {
+        readingInitialize(&reading, center, reflected, rotation);
+        if (found && !readingIsLarger(&reading, &result->classSignature)) {
+          continue;
+        }
+        best = reading;
+        found = true;
+        for (COLORSET i = 0; i < NFACES; i++) {
+          result->classSignature.faceCycleId[i] = readingCycleId(&best, i);
+        }
+      }
     }
   }
-
-  // Find the lexicographically maximum signature
-  qsort(results, resultsIndex, sizeof(results[0]), compareCycleIdSequence);
-  return results[0];
+  assert(found);
+  assert(result->classSignature.faceCycleId[0] == NCYCLES - 1);
+  result->offset = PermutedFace[best.permutation][best.center ^ (NFACES - 1)];
+  result->reflected = best.reflected;
+  return result;
 }
 
 SYMMETRY_TYPE s6FacesSymmetryType(void)
@@ -340,16 +493,136 @@ SYMMETRY_TYPE s6FacesSymmetryType(void)
   return getFullSequenceCanonicity(getFaceDegreesInCanonicalOrder());
 }
 
+int s6Automorphisms(struct automorphism automorphisms[S6_MAX_AUTOMORPHISMS])
+{
+  struct reading identity, reading;
+  int count = 0;
+  readingInitialize(&identity, NFACES - 1, false, 0);
+  assert(identity.permutation == 0);
+  for (COLORSET center = NFACES; center-- > 0;) {
+    if (Faces[center].cycle->length != NCOLORS) {
+      continue;
+    }
+    for (int reflected = 0; reflected < 2; reflected++) {
+      for (int rotation = 0; rotation < NCOLORS; rotation++) {
+        COLORSET i;
+        readingInitialize(&reading, center, reflected, rotation);
+        for (i = 0; i < NFACES; i++) {
+          if (readingCycleId(&reading, i) != readingCycleId(&identity, i)) {
+            break;
+          }
+        }
+        if (i < NFACES) {
+          continue;
+        }
+        /* The face read as i is the complement of i in the identity, and
+         * the inverse of i, offset by center, in this reading. */
+        assert(count < S6_MAX_AUTOMORPHISMS);
+        permutationFromIndex(reading.inverse,
+                             automorphisms[count].permutation);
+        automorphisms[count++].offset = center ^ (NFACES - 1);
+      }
+    }
+  }
+  assert(count > 0);
+  return count;
+}
+
+/* The shortest and longest cycle each face may still have, as 4 bits each,
+ * or 0 if not yet needed by this check. */
+static uint8_t LengthBounds[NFACES];
+
+static bool cycleSetDisjoint(CYCLESET cycleSet, CYCLESET other)
+{
+  for (uint32_t i = 0; i < CYCLESET_LENGTH; i++) {
+    if ((cycleSet[i] & other[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint32_t lengthBounds(COLORSET colors)
+{
+  FACE face = Faces + colors;
+  uint32_t min, max, length;
+  if (LengthBounds[colors] != 0) {
+    return LengthBounds[colors];
+  }
+  if (face->cycle != NULL) {
+    min = max = face->cycle->length;
+  } else {
+    for (length = 3; length < NCOLORS; length++) {
+      if (!cycleSetDisjoint(face->possibleCycles, CycleSetByLength[length])) {
+        break;
+      }
+    }
+    min = length;
+    for (length = NCOLORS; length > min; length--) {
+      if (!cycleSetDisjoint(face->possibleCycles, CycleSetByLength[length])) {
+        break;
+      }
+    }
+    max = length;
+  }
+  return LengthBounds[colors] = (uint8_t)(min | max << 4);
+}
+
+/* Whether the permutation gives a larger face degree sequence, whatever the
+ * faces still without a cycle turn out to be. */
+static bool permutationIsLarger(const COLORSET *permuted)
+{
+  for (int i = 0; i < NFACES; i++) {
+    uint32_t original = lengthBounds(SequenceOrder[i]);
+    uint32_t image = lengthBounds(permuted[i]);
+    if ((image & 0xf) > (original >> 4)) {
+      return true;
+    }
+    /* Unless both lengths are known and equal, the next face cannot matter. */
+    if (image != original || (image & 0xf) != (image >> 4)) {
+      return false;
+    }
+  }
+  return false;
+}
+
+bool s6PartialFacesNonCanonical(void)
+{
+  memset(LengthBounds, 0, sizeof(LengthBounds));
+  /* The identity, permutation 0, never is. */
+  for (int j = 1; j < 2 * NCOLORS; j++) {
+    if (permutationIsLarger(PermutedSequenceOrder[j])) {
+      NonCanonicalPrunedCounter++;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool s6PrefixNonCanonical6(const FACE_DEGREE *faceDegrees, int length)
+{
+  /* Permutation j takes the face around the central face omitting color k
+   * to the one omitting dihedralGroup[j][k], so the face degree at position
+   * k becomes that at dihedralGroup[j][k]. */
+  for (int j = 1; j < 2 * NCOLORS; j++) {
+    for (int k = 0; k < length && dihedralGroup[j][k] < length; k++) {
+      FACE_DEGREE image = faceDegrees[dihedralGroup[j][k]];
+      if (image != faceDegrees[k]) {
+        if (image > faceDegrees[k]) {
+          return true;
+        }
+        break;
+      }
+    }
+  }
+  return false;
+}
+
 SYMMETRY_TYPE s6SymmetryType6(FACE_DEGREE *args)
 {
-  struct faceDegreeSequence argsAsSequence = {
-#if NCOLORS <= 2
-      {args[0]}
-#else
-      {args[0], args[1], args[2], args[3], args[4], args[5]}
-#endif
-  };
-  return getPartialSequenceCanonicity(6, &argsAsSequence);
+  struct faceDegreeSequence argsAsSequence;
+  memcpy(argsAsSequence.faceDegrees, args, sizeof(*args) * NCOLORS);
+  return getPartialSequenceCanonicity(NCOLORS, &argsAsSequence);
 }
 
 char *s6FaceDegreeSignature(void)
@@ -363,6 +636,13 @@ char *s6FaceDegreeSignature(void)
   return Result;
 }
 
+void s6RecordSolution(void)
+{
+  strcpy(CurrentSolution.faceDegrees, s6FaceDegreeSignature());
+  CurrentSolution.signature = *s6SignatureFromFaces();
+  CurrentSolution.classSignature = *s6MaxSignature();
+}
+
 char *s6SignatureToString(SIGNATURE signature)
 {
   char *result = getBuffer();
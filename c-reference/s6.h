@@ -13,6 +13,25 @@
  * It provides canonical representations for comparing diagrams.
  */
 
+/* The number of color permutations, NCOLORS! */
+#if NCOLORS == 7
+#define NPERMUTATIONS FACTORIAL7
+#elif NCOLORS == 6
+#define NPERMUTATIONS FACTORIAL6
+#elif NCOLORS == 5
+#define NPERMUTATIONS FACTORIAL5
+#elif NCOLORS == 4
+#define NPERMUTATIONS FACTORIAL4
+#elif NCOLORS == 3
+#define NPERMUTATIONS FACTORIAL3
+#else
+#define NPERMUTATIONS FACTORIAL2
+#endif
+
+/* The default number of Venn choices after which partial face degree
+ * sequences are checked for canonicity; the later ones prune little. */
+#define DEFAULT_SYMMETRY_DEPTH 32
+
 /*--------------------------------------
  * Type Definitions and Structures
  *--------------------------------------*/
@@ -65,6 +84,31 @@ typedef struct signature {
   bool reflected;                        /* Whether diagram is reflected */
 } *SIGNATURE;
 
+/**
+ * A map of the diagram onto itself: color c goes to permutation[c], and the
+ * face with colors f to the face with the permuted colors exclusive-or
+ * offset, which is not 0 when the central face goes elsewhere.
+ */
+struct automorphism {
+  int permutation[NCOLORS];
+  COLORSET offset;
+};
+
+/* Each automorphism takes the central face to a face with NCOLORS edges,
+ * and one of those to another in at most 2 * NCOLORS ways. */
+#define S6_MAX_AUTOMORPHISMS (2 * NCOLORS * NFACES)
+
+/**
+ * What the outputs need to know of the current solution, computed once when
+ * the Venn predicate finds it. The class signature, with its offset and
+ * reflection, identifies the diagram whichever way and order it was found.
+ */
+struct solutionRecord {
+  char faceDegrees[NCOLORS + 1];   /* As s6FaceDegreeSignature */
+  struct signature signature;      /* As s6SignatureFromFaces */
+  struct signature classSignature; /* As s6MaxSignature */
+};
+
 /**
  * Callback type for iterating over face degree permutations.
  *
@@ -83,6 +127,9 @@ typedef void (*UseFaceDegrees)(void *data, FACE_DEGREE *faceDegrees);
  */
 extern void initializeS6(void);
 
+/* The current solution, as recorded by s6RecordSolution */
+extern struct solutionRecord CurrentSolution;
+
 /* Signature generation and comparison */
 /**
  * Get the canonical signature from the current face configuration.
@@ -94,6 +141,11 @@ extern SIGNATURE s6SignatureFromFaces(void);
  */
 extern SIGNATURE s6MaxSignature(void);
 
+/**
+ * Record the current solution in CurrentSolution.
+ */
+extern void s6RecordSolution(void);
+
 /**
  * Convert a signature to its string representation.
  */
@@ -110,6 +162,26 @@ extern char *s6FaceDegreeSignature(void);
  */
 extern SYMMETRY_TYPE s6FacesSymmetryType(void);
 
+/**
+ * The maps of the current diagram onto itself, on the sphere, perhaps
+ * reflecting it, and perhaps swapping its central face with another, such
+ * as the outer face. The identity is first. Returns how many there are.
+ */
+extern int s6Automorphisms(
+    struct automorphism automorphisms[S6_MAX_AUTOMORPHISMS]);
+
+/**
+ * Whether the faces with a cycle so far already make the diagram
+ * NON_CANONICAL, however the other faces are completed.
+ */
+extern bool s6PartialFacesNonCanonical(void);
+
+/**
+ * Whether the first length face degrees around the central face already make
+ * the diagram NON_CANONICAL, whatever the others are.
+ */
+extern bool s6PrefixNonCanonical6(const FACE_DEGREE *faceDegrees, int length);
+
 /**
  * Analyze symmetry of a given face degree sequence.
  */
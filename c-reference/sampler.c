@@ -0,0 +1,175 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "sampler.h"
+
+#include "engine.h"
+
+#include <sys/mman.h>
+#include <sys/time.h>
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Node 0 is the root, above the bottom of the stack. Each other node is a
+ * position, a child of the position of the entry below it; they are found
+ * by hashing the parent with the position into Slots, which is twice the
+ * size of Nodes, and probed linearly. Both are reserved, like the trail,
+ * and only backed by memory once used.
+ */
+struct samplerNode {
+  PREDICATE predicate;
+  uint32_t parent;
+  int32_t round;
+  int32_t choice; /* -1 if not at a choice */
+  uint32_t samples;
+};
+
+#define SAMPLER_SLOTS (2 * (uint64)SAMPLER_NODES)
+
+static const char *Path = NULL;
+static struct samplerNode *Nodes;
+static uint32_t *Slots; /* Index into Nodes, or 0 if empty */
+static uint32_t NodeCount = 1;
+static uint64 Samples = 0;
+static uint64 Dropped = 0;
+/* Set while a handler runs: the signal may come to any thread. */
+static int Busy = 0;
+
+static void *reserve(size_t size)
+{
+  void *reserved = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (reserved == MAP_FAILED) {
+    perror("sampler");
+    exit(EXIT_FAILURE);
+  }
+  return reserved;
+}
+
+static uint64 hashPosition(uint32_t parent, PREDICATE predicate, int round,
+                           int choice)
+{
+  uint64 hash = (uint64)(uintptr_t)predicate;
+  hash = hash * 0x9e3779b97f4a7c15ull ^ parent;
+  hash = hash * 0x9e3779b97f4a7c15ull ^ (uint32_t)round;
+  hash = hash * 0x9e3779b97f4a7c15ull ^ (uint32_t)choice;
+  return hash ^ (hash >> 29);
+}
+
+/* The child of parent at the position, added if need be, or 0 if full. */
+static uint32_t childOf(uint32_t parent, PREDICATE predicate, int round,
+                        int choice)
+{
+  uint64 slot = hashPosition(parent, predicate, round, choice) % SAMPLER_SLOTS;
+  for (;; slot = (slot + 1) % SAMPLER_SLOTS) {
+    struct samplerNode *node;
+    if (Slots[slot] == 0) {
+      if (NodeCount == SAMPLER_NODES) {
+        return 0;
+      }
+      node = Nodes + NodeCount;
+      node->predicate = predicate;
+      node->parent = parent;
+      node->round = round;
+      node->choice = choice;
+      Slots[slot] = NodeCount;
+      return NodeCount++;
+    }
+    node = Nodes + Slots[slot];
+    if (node->parent == parent && node->predicate == predicate &&
+        node->round == round && node->choice == choice) {
+      return Slots[slot];
+    }
+  }
+}
+
+static void onSample(int number)
+{
+  STACK stack = engineSearchStack();
+  uint32_t node = 0;
+  (void)number;
+  if (stack == NULL || __atomic_exchange_n(&Busy, 1, __ATOMIC_ACQUIRE)) {
+    return;
+  }
+  for (struct stackEntry *entry = stack->stack; entry <= stack->stackTop;
+       entry++) {
+    /* The choice being explored is the one before currentChoice. */
+    node = childOf(node, entry->predicate, entry->round,
+                   entry->inChoiceMode ? entry->currentChoice - 1 : -1);
+    if (node == 0) {
+      break;
+    }
+  }
+  if (node == 0) {
+    Dropped++;
+  } else {
+    Nodes[node].samples++;
+    Samples++;
+  }
+  __atomic_store_n(&Busy, 0, __ATOMIC_RELEASE);
+}
+
+void samplerStart(const char *path)
+{
+  struct sigaction action;
+  struct itimerval timer = {{0, SAMPLER_INTERVAL_USEC},
+                            {0, SAMPLER_INTERVAL_USEC}};
+  Path = path;
+  Nodes = reserve(SAMPLER_NODES * sizeof(*Nodes));
+  Slots = reserve(SAMPLER_SLOTS * sizeof(*Slots));
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = onSample;
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGPROF, &action, NULL);
+  if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+    perror("sampler");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void writeFrames(FILE *fp, uint32_t node)
+{
+  const struct samplerNode *position = Nodes + node;
+  if (position->parent != 0) {
+    writeFrames(fp, position->parent);
+    putc(';', fp);
+  }
+  fprintf(fp, "%s r%d", position->predicate->name, position->round);
+  if (position->choice >= 0) {
+    fprintf(fp, " c%d", position->choice);
+  }
+}
+
+void samplerWrite(void)
+{
+  struct itimerval stop = {{0, 0}, {0, 0}};
+  FILE *fp;
+  if (Path == NULL) {
+    return;
+  }
+  setitimer(ITIMER_PROF, &stop, NULL);
+  signal(SIGPROF, SIG_IGN);
+  fp = fopen(Path, "w");
+  if (fp == NULL) {
+    perror(Path);
+    exit(EXIT_FAILURE);
+  }
+  for (uint32_t node = 1; node < NodeCount; node++) {
+    if (Nodes[node].samples > 0) {
+      writeFrames(fp, node);
+      fprintf(fp, " %u\n", Nodes[node].samples);
+    }
+  }
+  if (fclose(fp) != 0) {
+    perror(Path);
+    exit(EXIT_FAILURE);
+  }
+  if (Dropped > 0) {
+    fprintf(stderr, "%s: %llu of %llu samples dropped, beyond %u positions\n",
+            Path, Dropped, Samples + Dropped, SAMPLER_NODES);
+  }
+}
@@ -0,0 +1,28 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+/**
+ * The sampling profiler (-G): on each SIGPROF, every SAMPLER_INTERVAL_USEC
+ * of CPU time, or each tick of the kernel if that is longer, the position of
+ * the outermost engine is recorded, as the predicate, round and choice, if
+ * any, of each entry of its stack. The samples are kept as a tree of
+ * positions, each counting the samples that ended there, so that the handler
+ * needs no allocation. They are written at the end as folded stacks, one
+ * line per position with samples, such as
+ *   Initialize r0 c0;InnerFaces r0 c0;...;Log r0 c0;Venn r0 c2;Venn r1 c0 12
+ * which flamegraph.pl, or any tool reading that format, draws as the effort
+ * spent under each choice of the search.
+ */
+
+#define SAMPLER_INTERVAL_USEC 1000
+/* Positions beyond this many are counted as dropped; must be < 2^32. */
+#define SAMPLER_NODES (1u << 22)
+
+extern void samplerStart(const char *path);
+
+/* Stops sampling, and writes the samples to the path given to samplerStart. */
+extern void samplerWrite(void);
+
+#endif  // SAMPLER_H
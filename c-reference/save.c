@@ -1,12 +1,21 @@
 /* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
 
+#include "classindex.h"
 #include "common.h"
 #include "face.h"
+#include "geometry.h"
+#include "jsonsink.h"
 #include "main.h"
 #include "predicates.h"
 #include "s6.h"
+#include "solutionindex.h"
+#include "solutionpath.h"
 #include "statistics.h"
 #include "utils.h"
+#include "variantarchive.h"
+#include "variantdedup.h"
+#include "variantfile.h"
+#include "variantpool.h"
 #include "visible_for_testing.h"
 
 #include <stdio.h>
@@ -19,25 +28,21 @@ static char* currentFilename;
 static FILE* currentFile;
 static int currentNumberOfVariations;
 static char currentVariationMultiplication[128];
+/* Whether a writer process has the variants of the current solution. */
+static bool currentWithWriter;
 
 /* Count variations and build multiplication string for display */
 int searchCountVariations(void)
 {
-  EDGE corners[3][2];
+  const struct solutionGeometry* geometry = dynamicSolutionGeometry();
   int numberOfVariations = 1;
   int pLength;
   char* currentPos = currentVariationMultiplication;
   currentPos[0] = '\0';
 
   for (COLOR a = 0; a < NCOLORS; a++) {
-    vertexAlignCorners(a, corners);
     for (int i = 0; i < 3; i++) {
-      if (corners[i][0] == NULL) {
-        EDGE edge = vertexGetCentralEdge(a);
-        pLength = edgePathLengthOnly(edge, edgeFollowBackwards(edge));
-      } else {
-        pLength = edgePathLengthOnly(corners[i][0]->reversed, corners[i][1]);
-      }
+      pLength = geometry->possibleCornerCounts[a][i];
       numberOfVariations *= pLength;
       if (pLength > 1) {
         currentPos += sprintf(currentPos, "*%d", pLength);
@@ -82,56 +87,158 @@ static void solutionPrint(FILE* fp)
 
 static bool gateSave(void)
 {
+  /* Every solution found, saved or not, so that any can be found again. */
+  if (SolutionPathsFlag) {
+    solutionPathRecord(TargetFolderFlag);
+  }
   if ((int64_t)GlobalSolutionsFoundIPC <= GlobalSkipSolutionsFlag) {
     return false;
   }
   if ((int64_t)GlobalSolutionsFoundIPC > GlobalMaxSolutionsFlag) {
     return false;
   }
-  if (PerFaceDegreeSolutionNumberIPC <= PerFaceDegreeSkipSolutionsFlag ||
-      PerFaceDegreeSolutionNumberIPC > PerFaceDegreeMaxSolutionsFlag) {
+  if (PerFaceDegreeSolutionNumberIPC <= PerFaceDegreeSkipSolutionsFlag) {
+    /* Still numbered, as with -u below. */
+    if (solutionIndexIsOpen()) {
+      solutionIndexRecord(SOLUTION_INDEX_UNSAVED);
+    }
+    return false;
+  }
+  if (PerFaceDegreeSolutionNumberIPC > PerFaceDegreeMaxSolutionsFlag) {
+    return false;
+  }
+  if (UniqueClassesFlag && classIndexContains(&CurrentSolution.classSignature)) {
+    /* Still numbered, so that the others keep their serial names. */
+    if (solutionIndexIsOpen()) {
+      solutionIndexRecord(SOLUTION_INDEX_UNSAVED);
+    }
     return false;
   }
-  char* buffer = getBuffer();
-  sprintf(buffer, "%s/%s", TargetFolderFlag, s6FaceDegreeSignature());
   return true;
 }
 
+/* Prints a row of the table in RESULTS.md: the face degrees, the solution
+ * number, the variations, the corner choices and their product. */
+static void printVariationCount(void)
+{
+  const char* choices = currentVariationMultiplication;
+  printf("%s | %2.2d | %d | ", CurrentSolution.faceDegrees,
+         PerFaceDegreeSolutionNumberIPC, VariationNumberIPC - 1);
+  for (const char* p = choices; *p != '\0'; p++) {
+    if (*p != '*') {
+      putchar(*p);
+    } else if (p != choices) {
+      fputs("×", stdout);
+    }
+  }
+  printf(" | %d\n", currentNumberOfVariations);
+}
+
 static bool beforeVariantsSave(void)
 {
-  char* buffer = getBuffer();
-  sprintf(buffer, "%s/%s", TargetFolderFlag, s6FaceDegreeSignature());
+  char* buffer;
+  if (CountVariationsFlag) {
+    VariationNumberIPC = 1;
+    currentNumberOfVariations = searchCountVariations();
+    return true;
+  }
+  if (JsonSinkFlag != NULL) {
+    VariationNumberIPC = 1;
+    if (UniqueVariantsFlag) {
+      variantDedupSolution();
+    }
+    jsonSinkSolution(searchCountVariations());
+    return true;
+  }
+  buffer = getBuffer();
+  sprintf(buffer, "%s/%s", TargetFolderFlag, CurrentSolution.faceDegrees);
   currentFilename = usingBuffer(buffer);
 
-  snprintf(CurrentPrefixIPC, sizeof(CurrentPrefixIPC), "%s-%2.2d.txt",
-           currentFilename, PerFaceDegreeSolutionNumberIPC);
+  if (solutionIndexIsOpen()) {
+    solutionIndexPrefix(CurrentPrefixIPC, sizeof(CurrentPrefixIPC) - 4,
+                        currentFilename);
+    strcat(CurrentPrefixIPC, ".txt");
+  } else {
+    snprintf(CurrentPrefixIPC, sizeof(CurrentPrefixIPC), "%s-%2.2d.txt",
+             currentFilename, PerFaceDegreeSolutionNumberIPC);
+  }
   currentFile = fopen(CurrentPrefixIPC, "w");
   if (currentFile == NULL) {
     perror(CurrentPrefixIPC);
     exit(EXIT_FAILURE);
   }
   VariationNumberIPC = 1;
+  if (UniqueVariantsFlag) {
+    variantDedupSolution();
+  }
   solutionPrint(currentFile);
   CurrentPrefixIPC[strlen(CurrentPrefixIPC) - 4] = '\0';
+  if (solutionIndexIsOpen()) {
+    solutionIndexRecord(CurrentPrefixIPC);
+  }
+  if (UniqueClassesFlag) {
+    const char* name = strrchr(CurrentPrefixIPC, '/');
+    classIndexAdd(&CurrentSolution.classSignature,
+                  name == NULL ? CurrentPrefixIPC : name + 1);
+  }
   GraphmlFileOps.initializeFolder(CurrentPrefixIPC);
   currentNumberOfVariations = searchCountVariations();
   LevelsIPC = numberOfLevels(currentNumberOfVariations);
   fprintf(currentFile, "\nSolution signature %s\nClass signature %s\n",
-          s6SignatureToString(s6SignatureFromFaces()),
-          s6SignatureToString(s6MaxSignature()));
+          s6SignatureToString(&CurrentSolution.signature),
+          s6SignatureToString(&CurrentSolution.classSignature));
   fflush(currentFile);
 
+  if (variantPoolIsOpen() && !variantPoolDispatch()) {
+    fclose(currentFile);
+    currentWithWriter = true;
+    return false;
+  }
+  if (BinaryVariationsFlag) {
+    variantFileOpen(CurrentPrefixIPC, LevelsIPC);
+  } else if (ArchiveVariationsFlag) {
+    variantArchiveOpen(CurrentPrefixIPC);
+  } else if (DeltaVariationsFlag) {
+    variantDeltaOpen(CurrentPrefixIPC, LevelsIPC);
+  }
   return true;
 }
 
 static void afterVariantsSave(void)
 {
+  if (CountVariationsFlag) {
+    printVariationCount();
+    VariationCountIPC += VariationNumberIPC - 1;
+    return;
+  }
+  if (JsonSinkFlag != NULL) {
+    VariationCountIPC += VariationNumberIPC - 1;
+    return;
+  }
+  if (currentWithWriter) {
+    currentWithWriter = false;
+    return;
+  }
   fprintf(currentFile, "Number of variations: %d/%d = 1%s\n",
 
           VariationNumberIPC - 1, currentNumberOfVariations,
           currentVariationMultiplication);
+  if (UniqueVariantsFlag) {
+    fprintf(currentFile, "Isomorphic duplicates skipped: %d\n",
+            variantDedupDuplicates());
+  }
   VariationCountIPC += VariationNumberIPC - 1;
   fclose(currentFile);
+  if (BinaryVariationsFlag) {
+    variantFileClose();
+  } else if (ArchiveVariationsFlag) {
+    variantArchiveClose();
+  } else if (DeltaVariationsFlag) {
+    variantDeltaClose();
+  }
+  if (variantPoolIsWriter()) {
+    variantPoolWriterExit(VariationNumberIPC - 1);
+  }
 }
 
 FORWARD_BACKWARD_PREDICATE(Save, gateSave, beforeVariantsSave,
@@ -0,0 +1,149 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "server.h"
+
+#include "main.h"
+#include "predicates.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* The most arguments in one job. */
+#define MAX_JOB_ARGUMENTS 64
+
+static struct stack ServerStack;
+
+static double seconds(void)
+{
+  struct timespec now;
+  timespec_get(&now, TIME_UTC);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/* Runs the job, a line of arguments, in a child with its output to output,
+ * and then reports how it went there. */
+static void runJob(int number, char *line, int output)
+{
+  char *argv[MAX_JOB_ARGUMENTS + 2] = {"venn"};
+  int argc = 1, status;
+  double start = seconds();
+  pid_t pid;
+  for (char *arg = strtok(line, " \t\r\n"); arg != NULL;
+       arg = strtok(NULL, " \t\r\n")) {
+    if (argc > MAX_JOB_ARGUMENTS) {
+      dprintf(output, "job %d: more than %d arguments\n", number,
+              MAX_JOB_ARGUMENTS);
+      return;
+    }
+    argv[argc++] = arg;
+  }
+  fflush(NULL);
+  pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    exit(EXIT_FAILURE);
+  }
+  if (pid == 0) {
+    signal(SIGPIPE, SIG_DFL);
+    if (output != STDOUT_FILENO) {
+      dup2(output, STDOUT_FILENO);
+      dup2(output, STDERR_FILENO);
+    }
+    ServeFlag = NULL;
+    optind = 1;
+    exit(realMain0(argc, argv));
+  }
+  if (waitpid(pid, &status, 0) < 0) {
+    perror("waitpid");
+    exit(EXIT_FAILURE);
+  }
+  if (WIFEXITED(status)) {
+    dprintf(output, "job %d exit %d %.3fs\n", number, WEXITSTATUS(status),
+            seconds() - start);
+  } else {
+    dprintf(output, "job %d signal %d %.3fs\n", number, WTERMSIG(status),
+            seconds() - start);
+  }
+}
+
+/* Runs each job read from input, numbering them on from *count. */
+static void runJobs(FILE *input, int output, int *count)
+{
+  char *line = NULL;
+  size_t capacity = 0;
+  /* Unbuffered, so that a child exiting, which may set the offset of the
+   * input to where its copy of the stream is, cannot lose or repeat jobs. */
+  setvbuf(input, NULL, _IONBF, 0);
+  while (getline(&line, &capacity, input) >= 0) {
+    if (line[strspn(line, " \t\r\n")] != '\0') {
+      runJob(++*count, line, output);
+    }
+  }
+  free(line);
+}
+
+static int listenOn(const char *path)
+{
+  struct sockaddr_un address;
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    perror("socket");
+    exit(EXIT_FAILURE);
+  }
+  if (strlen(path) >= sizeof(address.sun_path)) {
+    fprintf(stderr, "%s: too long for a socket path\n", path);
+    exit(EXIT_FAILURE);
+  }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, path);
+  unlink(path);
+  if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+      listen(fd, 8) != 0) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  return fd;
+}
+
+void serve(const char *address)
+{
+  int count = 0, listening;
+  /* Initialize does not undo, so this leaves the trail at its frozen point,
+   * from which every job starts. */
+  engine(&ServerStack,
+         (PREDICATE[]){&InitializePredicate, &FAILPredicate});
+  /* A client that goes away loses its output, not the server. */
+  signal(SIGPIPE, SIG_IGN);
+  if (strcmp(address, "-") == 0) {
+    runJobs(stdin, STDOUT_FILENO, &count);
+    return;
+  }
+  listening = listenOn(address);
+  while (true) {
+    FILE *input;
+    int connection = accept(listening, NULL, NULL);
+    if (connection < 0) {
+      perror("accept");
+      exit(EXIT_FAILURE);
+    }
+    input = fdopen(connection, "r");
+    if (input == NULL) {
+      perror("fdopen");
+      exit(EXIT_FAILURE);
+    }
+    runJobs(input, connection, &count);
+    fclose(input);
+  }
+}
@@ -0,0 +1,24 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "core.h"
+
+/**
+ * Service mode: initializes once, and then runs search jobs one after
+ * another, each a line of the usual arguments, such as "-f out -d 554544".
+ * Each job runs in a process forked from the initialized state, with the
+ * trail at its frozen point, so that it searches from the root with the
+ * tables already in place, and leaves nothing, not even its counters,
+ * behind for the next. The output of a job, ending with its statistics, is
+ * followed by a line "job N exit S T.TTTs", or "job N signal S T.TTTs".
+ *
+ * With address "-" the jobs are read from stdin, and the output written to
+ * stdout. Otherwise address is the path of a Unix socket, which is listened
+ * on, taking one connection at a time, with the jobs read from it, and the
+ * output, including that to stderr, written back to it.
+ */
+extern void serve(const char *address);
+
+#endif  // SERVER_H
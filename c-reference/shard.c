@@ -0,0 +1,132 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "shard.h"
+
+#include "main.h"
+#include "predicates.h"
+#include "solutionindex.h"
+#include "statistics.h"
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define STATISTICS_SUFFIX ".statistics"
+
+extern FACE_DEGREE CurrentFaceDegrees[NCOLORS];
+
+/* FNV-1a, which gives the same answer on every machine. */
+#define FNV_OFFSET 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+static uint64 hashInt(uint64 hash, uint64 value)
+{
+  for (int i = 0; i < 8; i++) {
+    hash ^= (value >> (8 * i)) & 0xff;
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+bool shardOwnsChoicePath(int length, const int *choices)
+{
+  uint64 hash = FNV_OFFSET;
+  for (int i = 0; i < NCOLORS; i++) {
+    hash = hashInt(hash, CurrentFaceDegrees[i]);
+  }
+  for (int i = 0; i < length; i++) {
+    hash = hashInt(hash, choices[i]);
+  }
+  return hash % ShardCountFlag == (uint64)ShardIndexFlag;
+}
+
+void shardTag(char *tag, size_t size)
+{
+  snprintf(tag, size, "s%dof%d", ShardIndexFlag, ShardCountFlag);
+}
+
+void shardSaveStatistics(const char *folder)
+{
+  char tag[32], filename[1024];
+  FILE *fp;
+  shardTag(tag, sizeof(tag));
+  snprintf(filename, sizeof(filename), "%s/.%s" STATISTICS_SUFFIX, folder,
+           tag);
+  fp = fopen(filename, "w");
+  if (fp == NULL) {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+  statisticWrite(fp);
+  fclose(fp);
+}
+
+static void readShardStatistics(const char *folder, const char *name,
+                                struct statisticTotals *totals,
+                                bool *seen, int *count)
+{
+  char path[1024];
+  int index, total;
+  FILE *fp;
+  snprintf(path, sizeof(path), "%s/%s", folder, name);
+  if (sscanf(name, ".s%dof%d", &index, &total) != 2 || index < 0 ||
+      index >= total || total > MAX_SHARDS ||
+      (*count != 0 && *count != total)) {
+    fprintf(stderr, "%s: not one of the shards being merged\n", path);
+    exit(EXIT_FAILURE);
+  }
+  *count = total;
+  seen[index] = true;
+  fp = fopen(path, "r");
+  if (fp == NULL) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  if (!statisticReadInto(fp, totals)) {
+    fprintf(stderr, "%s: malformed statistics\n", path);
+    exit(EXIT_FAILURE);
+  }
+  fclose(fp);
+  unlink(path);
+}
+
+void shardMerge(const char *folder)
+{
+  struct statisticTotals *totals;
+  static bool seen[MAX_SHARDS];
+  struct stack mergeStack;
+  struct dirent *entry;
+  size_t suffixLength = strlen(STATISTICS_SUFFIX);
+  int count = 0;
+  DIR *dir;
+
+  /* Registers the counters to be merged. */
+  engine(&mergeStack, (PREDICATE[]){&InitializePredicate, &FAILPredicate});
+  totals = statisticTotalsCreate();
+
+  dir = opendir(folder);
+  if (dir == NULL) {
+    perror(folder);
+    exit(EXIT_FAILURE);
+  }
+  while ((entry = readdir(dir)) != NULL) {
+    size_t length = strlen(entry->d_name);
+    if (entry->d_name[0] == '.' && length > suffixLength &&
+        strcmp(entry->d_name + length - suffixLength, STATISTICS_SUFFIX) ==
+            0) {
+      readShardStatistics(folder, entry->d_name, totals, seen, &count);
+    }
+  }
+  closedir(dir);
+  for (int i = 0; i < count; i++) {
+    if (!seen[i]) {
+      fprintf(stderr, "Warning: shard %d of %d is missing from %s\n", i,
+              count, folder);
+    }
+  }
+  statisticSetFrom(totals);
+  statisticTotalsFree(totals);
+  solutionIndexRenumber(folder);
+}
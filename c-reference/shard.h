@@ -0,0 +1,36 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "core.h"
+
+/**
+ * Deterministic partitioning of the search among independent runs, for
+ * clusters with no shared memory. Each Venn subtree at a fixed depth
+ * belongs to the shard given by a hash of the choices leading to it, so
+ * every run agrees on the partition without communicating. Each shard saves
+ * its solutions under provisional names (see solutionindex.h) and its
+ * statistics in its output folder. Once the shards' folders have been
+ * copied together, a merge combines the statistics and renumbers the
+ * solutions to the names a serial search would give.
+ */
+
+/* The default number of Venn choices that are hashed */
+#define DEFAULT_SHARD_DEPTH 4
+/* The most shards */
+#define MAX_SHARDS 100000
+
+/* Whether the subtree reached by these Venn choices is in this shard */
+extern bool shardOwnsChoicePath(int length, const int *choices);
+
+/* A tag for provisional names, unique to this shard */
+extern void shardTag(char *tag, size_t size);
+
+/* Writes this shard's statistics into folder */
+extern void shardSaveStatistics(const char *folder);
+
+/* Combines the shards' statistics and solution names in folder */
+extern void shardMerge(const char *folder);
+
+#endif  // SHARD_H
@@ -0,0 +1,247 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 700
+
+#include "solutionindex.h"
+
+#include "classindex.h"
+#include "predicates.h"
+#include "s6.h"
+
+#include <sys/stat.h>
+
+#include <dirent.h>
+#include <ftw.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * Each line of an index file is:
+ *   faceDegrees signature provisionalName choice,choice,...
+ * where faceDegrees are those chosen by InnerFace, and the signature and
+ * provisional name are as used in the file names.
+ */
+#define INDEX_SUFFIX ".index"
+#define MAX_NAME 64
+
+extern FACE_DEGREE CurrentFaceDegrees[NCOLORS];
+
+struct indexEntry {
+  char faceDegrees[16];
+  char signature[16];
+  char name[MAX_NAME];
+  int length;
+  int choices[NFACES];
+};
+
+static FILE *IndexFile = NULL;
+static char IndexTag[MAX_NAME];
+static int ProvisionalCount = 0;
+
+void solutionIndexOpen(const char *folder, const char *tag, int keep)
+{
+  char filename[1024], line[2048];
+  snprintf(IndexTag, sizeof(IndexTag), "%s", tag);
+  snprintf(filename, sizeof(filename), "%s/.%s" INDEX_SUFFIX, folder, tag);
+  IndexFile = fopen(filename, keep > 0 ? "r+" : "w");
+  if (IndexFile == NULL) {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+  for (ProvisionalCount = 0; ProvisionalCount < keep; ProvisionalCount++) {
+    if (fgets(line, sizeof(line), IndexFile) == NULL) {
+      fprintf(stderr, "%s: fewer than %d entries\n", filename, keep);
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (keep > 0) {
+    /* The later entries are for solutions that will be found again. */
+    long end = ftell(IndexFile);
+    if (ftruncate(fileno(IndexFile), end) != 0 ||
+        fseek(IndexFile, end, SEEK_SET) != 0) {
+      perror(filename);
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+void solutionIndexClose(void)
+{
+  if (IndexFile != NULL) {
+    fclose(IndexFile);
+    IndexFile = NULL;
+  }
+}
+
+bool solutionIndexIsOpen(void)
+{
+  return IndexFile != NULL;
+}
+
+void solutionIndexPrefix(char *prefix, size_t size,
+                         const char *folderAndSignature)
+{
+  snprintf(prefix, size, "%s-%s-%d", folderAndSignature, IndexTag,
+           ++ProvisionalCount);
+}
+
+void solutionIndexRecord(const char *prefix)
+{
+  int choices[NFACES];
+  int length = vennChoicePath(choices);
+  const char *name = strrchr(prefix, '/');
+  name = name == NULL ? prefix : name + 1;
+  if (strcmp(name, SOLUTION_INDEX_UNSAVED) == 0) {
+    /* Keeps one entry per provisional number, for resuming. */
+    ++ProvisionalCount;
+  }
+  for (int i = 0; i < NCOLORS; i++) {
+    fputc('0' + (int)CurrentFaceDegrees[i], IndexFile);
+  }
+  fprintf(IndexFile, " %s %s ", CurrentSolution.faceDegrees, name);
+  for (int i = 0; i < length; i++) {
+    fprintf(IndexFile, i == 0 ? "%d" : ",%d", choices[i]);
+  }
+  fprintf(IndexFile, "\n");
+  fflush(IndexFile);
+}
+
+int solutionIndexCount(void)
+{
+  return ProvisionalCount;
+}
+
+static bool parseEntry(char *line, struct indexEntry *entry)
+{
+  char choices[1024];
+  char *p;
+  if (sscanf(line, "%15s %15s %63s %1023s", entry->faceDegrees,
+             entry->signature, entry->name, choices) != 4) {
+    return false;
+  }
+  entry->length = 0;
+  for (p = choices; *p != '\0' && entry->length < NFACES; p++) {
+    entry->choices[entry->length++] = strtol(p, &p, 10);
+    if (*p != ',') {
+      break;
+    }
+  }
+  return true;
+}
+
+static int compareEntries(const void *a, const void *b)
+{
+  const struct indexEntry *x = a, *y = b;
+  int result = strcmp(x->faceDegrees, y->faceDegrees);
+  for (int i = 0; result == 0; i++) {
+    if (i == x->length || i == y->length) {
+      return x->length - y->length;
+    }
+    result = x->choices[i] - y->choices[i];
+  }
+  return result;
+}
+
+static int removeEntry(const char *path, const struct stat *st, int flag,
+                       struct FTW *ftw)
+{
+  (void)st;
+  (void)flag;
+  (void)ftw;
+  return remove(path);
+}
+
+static void renameSolution(const char *folder, const char *from,
+                           const char *to)
+{
+  char fromPath[1024], toPath[1024];
+  struct stat st;
+  snprintf(fromPath, sizeof(fromPath), "%s/%s.txt", folder, from);
+  snprintf(toPath, sizeof(toPath), "%s/%s.txt", folder, to);
+  if (rename(fromPath, toPath) != 0) {
+    perror(fromPath);
+    exit(EXIT_FAILURE);
+  }
+  snprintf(fromPath, sizeof(fromPath), "%s/%s", folder, from);
+  snprintf(toPath, sizeof(toPath), "%s/%s", folder, to);
+  if (stat(fromPath, &st) != 0) {
+    return;
+  }
+  // Replace the variations of any earlier run.
+  if (stat(toPath, &st) == 0) {
+    nftw(toPath, removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+  }
+  if (rename(fromPath, toPath) != 0) {
+    perror(fromPath);
+    exit(EXIT_FAILURE);
+  }
+}
+
+static int readIndexFile(const char *path, struct indexEntry **entries,
+                         int count, int *capacity)
+{
+  char line[2048];
+  FILE *fp = fopen(path, "r");
+  if (fp == NULL) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    if (count == *capacity) {
+      *capacity = *capacity == 0 ? 256 : 2 * *capacity;
+      *entries = realloc(*entries, *capacity * sizeof(**entries));
+      if (*entries == NULL) {
+        perror("realloc");
+        exit(EXIT_FAILURE);
+      }
+    }
+    if (parseEntry(line, *entries + count)) {
+      count++;
+    } else {
+      fprintf(stderr, "%s: malformed line: %s", path, line);
+    }
+  }
+  fclose(fp);
+  return count;
+}
+
+void solutionIndexRenumber(const char *folder)
+{
+  struct indexEntry *entries = NULL;
+  int count = 0, capacity = 0;
+  size_t suffixLength = strlen(INDEX_SUFFIX);
+  char path[1024];
+  struct dirent *dirEntry;
+  DIR *dir = opendir(folder);
+  if (dir == NULL) {
+    perror(folder);
+    exit(EXIT_FAILURE);
+  }
+  while ((dirEntry = readdir(dir)) != NULL) {
+    size_t length = strlen(dirEntry->d_name);
+    if (dirEntry->d_name[0] == '.' && length > suffixLength &&
+        strcmp(dirEntry->d_name + length - suffixLength, INDEX_SUFFIX) == 0) {
+      snprintf(path, sizeof(path), "%s/%s", folder, dirEntry->d_name);
+      count = readIndexFile(path, &entries, count, &capacity);
+      unlink(path);
+    }
+  }
+  closedir(dir);
+
+  qsort(entries, count, sizeof(*entries), compareEntries);
+  for (int i = 0, number = 0; i < count; i++) {
+    char finalName[MAX_NAME];
+    if (i == 0 ||
+        strcmp(entries[i].faceDegrees, entries[i - 1].faceDegrees) != 0) {
+      number = 0;
+    }
+    snprintf(finalName, sizeof(finalName), "%s-%2.2d", entries[i].signature,
+             ++number);
+    if (strcmp(entries[i].name, SOLUTION_INDEX_UNSAVED) != 0) {
+      renameSolution(folder, entries[i].name, finalName);
+      classIndexRename(entries[i].name, finalName);
+    }
+  }
+  free(entries);
+}
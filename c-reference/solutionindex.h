@@ -0,0 +1,39 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef SOLUTIONINDEX_H
+#define SOLUTIONINDEX_H
+
+#include "core.h"
+
+/**
+ * Solutions found out of serial order, by parallel workers or by shards,
+ * are saved under provisional names and listed in an index file, together
+ * with the face degrees and Venn choices that led to them. Sorting the
+ * entries by those choices recovers the order of a serial search, so that
+ * renumbering gives the same file names as a serial search.
+ */
+
+/* Save solutions under provisional names including tag, indexed in folder.
+   The first keep entries of an existing index are kept, when resuming. */
+extern void solutionIndexOpen(const char *folder, const char *tag, int keep);
+extern void solutionIndexClose(void);
+extern bool solutionIndexIsOpen(void);
+
+/* Writes "folderAndSignature-tag-n" into prefix, n being new each call */
+extern void solutionIndexPrefix(char *prefix, size_t size,
+                                const char *folderAndSignature);
+
+/* The prefix recording a solution that is counted but not saved, as its class
+   has been saved already */
+#define SOLUTION_INDEX_UNSAVED "-"
+
+/* Records that the current solution is saved with the given prefix */
+extern void solutionIndexRecord(const char *prefix);
+
+/* The number of entries in the index */
+extern int solutionIndexCount(void);
+
+/* Renames every indexed solution in folder to its serial name */
+extern void solutionIndexRenumber(const char *folder);
+
+#endif  // SOLUTIONINDEX_H
@@ -0,0 +1,154 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "solutionpath.h"
+
+#include "main.h"
+#include "predicates.h"
+#include "s6.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern int PerFaceDegreeSolutionNumberIPC;
+
+/* Each choice takes at most 4 characters, "999," or "-1,". */
+#define MAX_LINE (256 + 4 * MAX_STACK_SIZE)
+
+/* What is being replayed. */
+static struct choicePath ReplayPath;
+static int ReplayNumber;
+static char ReplaySignature[SOLUTION_SIGNATURE_SIZE];
+static bool ReplayReached;
+static struct stack ReplayStack;
+
+static void pathsFilename(char *filename, size_t size, const char *folder,
+                          const char *faceDegrees)
+{
+  snprintf(filename, size, "%s/%s" SOLUTION_PATH_SUFFIX, folder, faceDegrees);
+}
+
+void solutionPathRecord(const char *folder)
+{
+  STACK stack = engineSearchStack();
+  struct choicePath path;
+  char filename[1024];
+  FILE *fp;
+  pathsFilename(filename, sizeof(filename), folder,
+                CurrentSolution.faceDegrees);
+  /* A new index for each run, from its first solution of these degrees. */
+  fp = fopen(filename, PerFaceDegreeSolutionNumberIPC == 1 ? "w" : "a");
+  if (fp == NULL) {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+  engineContinuationPath(stack, &path);
+  fprintf(fp, "%d %s ", PerFaceDegreeSolutionNumberIPC,
+          s6SignatureToString(&CurrentSolution.signature));
+  for (int i = 0; i < path.length; i++) {
+    int choice = path.steps[i].first;
+    if (choice >= 0 && stack->stack[i].predicate == &InnerFacePredicate) {
+      /* With -d there is one choice of each degree. */
+      choice = 0;
+    }
+    fprintf(fp, i == 0 ? "%d" : ",%d", choice);
+  }
+  fprintf(fp, "\n");
+  fclose(fp);
+}
+
+/* Reads the last entry for the solution, as one run of a search may find a
+ * solution twice, when it resumes from a checkpoint. */
+bool solutionPathRead(const char *folder, const char *name, CHOICE_PATH path,
+                      char signature[SOLUTION_SIGNATURE_SIZE])
+{
+  char filename[1024], faceDegrees[NCOLORS + 1];
+  char *line = malloc(MAX_LINE);
+  bool found = false;
+  int wanted = atoi(name + NCOLORS + 1);
+  FILE *fp;
+  snprintf(faceDegrees, sizeof(faceDegrees), "%s", name);
+  pathsFilename(filename, sizeof(filename), folder, faceDegrees);
+  if (line == NULL) {
+    perror("malloc");
+    exit(EXIT_FAILURE);
+  }
+  fp = fopen(filename, "r");
+  if (fp == NULL) {
+    free(line);
+    return false;
+  }
+  while (fgets(line, MAX_LINE, fp) != NULL) {
+    int number, offset;
+    char read[SOLUTION_SIGNATURE_SIZE];
+    char *p;
+    if (sscanf(line, "%d %255s %n", &number, read, &offset) != 2) {
+      fprintf(stderr, "%s: malformed line\n", filename);
+      exit(EXIT_FAILURE);
+    }
+    if (number != wanted) {
+      continue;
+    }
+    found = true;
+    strcpy(signature, read);
+    path->length = 0;
+    for (p = line + offset; path->length < MAX_STACK_SIZE; p++) {
+      int choice = strtol(p, &p, 10);
+      path->steps[path->length].first = choice;
+      path->steps[path->length++].end = choice + 1;
+      if (*p != ',') {
+        break;
+      }
+    }
+  }
+  free(line);
+  fclose(fp);
+  return found;
+}
+
+/* Between Venn and Save: gives the solution its number, once it is sure
+ * that the path has led to it. */
+static struct predicateResult tryReplayCheck(int round)
+{
+  (void)round;
+  if (strcmp(s6SignatureToString(&CurrentSolution.signature),
+             ReplaySignature) != 0) {
+    return PredicateFail;
+  }
+  ReplayReached = true;
+  PerFaceDegreeSolutionNumberIPC = ReplayNumber;
+  return PredicateSuccessNextPredicate;
+}
+
+static struct predicate ReplayCheckPredicate = {"ReplayCheck",
+                                                tryReplayCheck, NULL};
+
+/* NonDeterministicProgram, checking the solution before saving it. */
+static PREDICATE ReplayProgram[] = {
+    &InitializePredicate,  &InnerFacePredicate, &LogPredicate,
+    &VennPredicate,        &ReplayCheckPredicate, &SavePredicate,
+    &CornersPredicate,     &GraphMLPredicate,   &FAILPredicate};
+
+void solutionPathReplay(const char *folder, const char *name)
+{
+  if (!solutionPathRead(folder, name, &ReplayPath, ReplaySignature)) {
+    fprintf(stderr,
+            "%s: not in the .paths index of %s; only a serial search with -x "
+            "writes one\n",
+            name, folder);
+    exit(EXIT_FAILURE);
+  }
+  ReplayNumber = atoi(name + NCOLORS + 1);
+  for (int i = 0; i < NCOLORS; i++) {
+    CentralFaceDegreesFlag[i] = name[i] - '0';
+  }
+  ReplayReached = false;
+  engineReplay(&ReplayStack, ReplayProgram, &ReplayPath);
+  if (!ReplayReached) {
+    fprintf(stderr,
+            "%s: the path does not lead to the solution; replay with the -O "
+            "and -y of the search that found it\n",
+            name);
+    exit(EXIT_FAILURE);
+  }
+}
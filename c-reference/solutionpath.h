@@ -0,0 +1,44 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef SOLUTIONPATH_H
+#define SOLUTIONPATH_H
+
+#include "engine.h"
+
+/**
+ * An index of the choices that lead to each solution of a serial search, with
+ * -x, so that one solution can be found again without the search before it.
+ * The workers of -P, the shards of -S and the jobs of -b find solutions out
+ * of serial order, and write none. Each line of the index of a sequence of
+ * face degrees, in the output folder, is:
+ *   number signature choice,choice,...
+ * with the choice taken at each depth of the engine stack, or -1 where there
+ * is none. The face degree choices are recorded as if the sequence had been
+ * given with -d, as it is on replay. The Venn choices depend on the order of
+ * the search, so a path must be replayed with the -O and -y of the run that
+ * found it; the signature tells whether it has been.
+ */
+
+#define SOLUTION_PATH_SUFFIX ".paths"
+/* Room for a signature as s6SignatureToString writes it. */
+#define SOLUTION_SIGNATURE_SIZE 256
+
+/* Records the path to the current solution in folder. */
+extern void solutionPathRecord(const char *folder);
+
+/**
+ * Reads the choices to the solution called name, such as 554544-06, and its
+ * signature, from the index in folder, with false if there is no index of its
+ * degrees, or the solution is not in it.
+ */
+extern bool solutionPathRead(const char *folder, const char *name,
+                             CHOICE_PATH path,
+                             char signature[SOLUTION_SIGNATURE_SIZE]);
+
+/**
+ * Finds the solution called name again, as indexed in folder, and saves it,
+ * and its variants, there, as the search that found it did.
+ */
+extern void solutionPathReplay(const char *folder, const char *name);
+
+#endif  // SOLUTIONPATH_H
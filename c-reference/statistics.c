@@ -1,14 +1,38 @@
 /* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
 
+#define _DEFAULT_SOURCE
+
 #include "statistics.h"
 
+#include "engine.h"
 #include "face.h"
 #include "main.h"
 
+#include <sys/mman.h>
+
+#include <ctype.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+/**
+ * The registry grows as statistics are registered. Counters of other
+ * threads, such as the -Q writer's, are shards hung off their statistic, so
+ * that nothing is shared between the threads as they count, and they are
+ * added in, or for maxima combined, whenever the statistics are reported.
+ */
 
-static Statistic Statistics[MAX_STATISTICS];
-static Failure* Failures[MAX_STATISTICS];
+static Statistic* Statistics = NULL;
+static int NumberOfStatistics = 0;
+static Failure** Failures = NULL;
+static int NumberOfFailures = 0;
+static struct statisticHistogram** Histograms = NULL;
+static int NumberOfHistograms = 0;
+static pthread_mutex_t RegistryLock = PTHREAD_MUTEX_INITIALIZER;
+static const char* ExportPath = NULL;
+/* The progress when first logged, from which the rate is measured. */
+static double FirstProgress = -1.0;
+static time_t FirstProgressTime;
 static time_t StartTime;
 static time_t LastLogTime;
 static int CheckFrequency = 1;
@@ -90,7 +114,7 @@ static void printFailureCounts(bool oneLine)
   if (!VerboseModeFlag) {
     return;  // Skip failures in non-verbose mode
   }
-  for (int i = 0; i < MAX_STATISTICS; i++) {
+  for (int i = 0; i < NumberOfFailures; i++) {
     if (Failures[i]->count[0] == 0) {
       break;
     }
@@ -105,24 +129,95 @@ static void printFailureCounts(bool oneLine)
   }
 }
 
-static void printStatisticsCounters(bool oneLine)
+static uint64 valueOf(int i)
 {
-  for (int i = 0; i < MAX_STATISTICS; i++) {
-    if (Statistics[i].countPtr == NULL) {
-      break;
+  uint64 value = *Statistics[i].countPtr;
+  for (struct statisticShard* shard =
+           __atomic_load_n(&Statistics[i].shards, __ATOMIC_ACQUIRE);
+       shard != NULL; shard = shard->next) {
+    uint64 count = __atomic_load_n(&shard->count, __ATOMIC_RELAXED);
+    if (!Statistics[i].maximum) {
+      value += count;
+    } else if (count > value) {
+      value = count;
     }
+  }
+  return value;
+}
+
+static void printStatisticsCounters(bool oneLine)
+{
+  for (int i = 0; i < NumberOfStatistics; i++) {
     if (!Statistics[i].verboseOnly || VerboseModeFlag) {
       if (oneLine) {
-        fprintf(LogFile, "%s %llu ", Statistics[i].shortName,
-                *Statistics[i].countPtr);
+        fprintf(LogFile, "%s %llu ", Statistics[i].shortName, valueOf(i));
       } else {
-        fprintf(LogFile, "%30s %30llu\n", Statistics[i].name,
-                *Statistics[i].countPtr);
+        fprintf(LogFile, "%30s %30llu\n", Statistics[i].name, valueOf(i));
       }
     }
   }
 }
 
+static int findHighestNonZeroBucket(struct statisticHistogram* histogram)
+{
+  int b;
+  for (b = HISTOGRAM_BUCKETS - 1; b > 0; b--) {
+    if (histogram->buckets[b]) {
+      break;
+    }
+  }
+  return b;
+}
+
+/* Bucket b > 0 holds the values from 2^(b-1) up to 2^b - 1. */
+static void printHistograms(void)
+{
+  for (int i = 0; i < NumberOfHistograms; i++) {
+    struct statisticHistogram* histogram = Histograms[i];
+    char buf[4096];
+    char* bufptr = buf;
+    char separator = '[';
+    uint64 count = 0;
+    if (histogram->verboseOnly && !VerboseModeFlag) {
+      continue;
+    }
+    for (int b = 0; b <= findHighestNonZeroBucket(histogram); b++) {
+      bufptr += sprintf(bufptr, "%c%llu", separator, histogram->buckets[b]);
+      separator = ' ';
+      count += histogram->buckets[b];
+    }
+    sprintf(bufptr, "]");
+    fprintf(LogFile, "%30s %30s\n", histogram->name, buf);
+    if (count > 0) {
+      snprintf(buf, sizeof(buf), "%s mean", histogram->name);
+      fprintf(LogFile, "%30s %30.2f\n", buf, (double)histogram->sum / count);
+    }
+  }
+}
+
+/**
+ * The estimated size of the search tree, the fraction of it done, and the
+ * time left at the rate since first logged, which allows for a resumed
+ * search having started part way through.
+ */
+static void printProgress(time_t now)
+{
+  double progress = engineProgress();
+  fprintf(LogFile, "est %.3g done %.2f%% ", engineEstimatedNodes(),
+          100.0 * progress);
+  if (FirstProgress < 0.0) {
+    FirstProgress = progress;
+    FirstProgressTime = now;
+  } else if (progress > FirstProgress && now > FirstProgressTime) {
+    char eta[20];
+    formatElapsedTimeHMS((time_t)(difftime(now, FirstProgressTime) *
+                                  (1.0 - progress) /
+                                  (progress - FirstProgress)),
+                         eta, sizeof(eta));
+    fprintf(LogFile, "eta %s ", eta);
+  }
+}
+
 static void updateLoggingState(time_t now)
 {
   LastLogTime = now;
@@ -143,36 +238,443 @@ void initializeStatisticLogging(char* filename, int frequency, int seconds)
   initializeFailures();
 }
 
-void statisticIncludeInteger(uint64* counter, char* shortName, char* name,
-                             bool verboseOnly)
+/* Returns array, of count entries of size bytes, with room for one more. */
+static void* grow(void* array, int count, size_t size)
 {
-  for (int i = 0; i < MAX_STATISTICS; i++) {
-    if (Statistics[i].countPtr == counter) {
-      return;
+  if (count == 0 || (count >= 8 && (count & (count - 1)) == 0)) {
+    array = realloc(array, (count == 0 ? 8 : 2 * count) * size);
+    if (array == NULL) {
+      perror("realloc");
+      exit(EXIT_FAILURE);
     }
-    if (Statistics[i].countPtr == NULL) {
-      Statistics[i].countPtr = counter;
-      Statistics[i].shortName = shortName;
-      Statistics[i].name = name;
-      Statistics[i].verboseOnly = verboseOnly;
+  }
+  return array;
+}
+
+static void includeStatistic(uint64* counter, char* shortName, char* name,
+                             bool verboseOnly, bool maximum)
+{
+  for (int i = 0; i < NumberOfStatistics; i++) {
+    if (Statistics[i].countPtr == counter) {
       return;
     }
   }
-  assert(false);
+  pthread_mutex_lock(&RegistryLock);
+  Statistics = grow(Statistics, NumberOfStatistics, sizeof(*Statistics));
+  Statistics[NumberOfStatistics] = (Statistic){name, shortName, counter,
+                                               verboseOnly, maximum, NULL};
+  NumberOfStatistics++;
+  pthread_mutex_unlock(&RegistryLock);
+}
+
+void statisticIncludeInteger(uint64* counter, char* shortName, char* name,
+                             bool verboseOnly)
+{
+  includeStatistic(counter, shortName, name, verboseOnly, false);
+}
+
+void statisticIncludeMaximum(uint64* counter, char* shortName, char* name,
+                             bool verboseOnly)
+{
+  includeStatistic(counter, shortName, name, verboseOnly, true);
 }
 
 void statisticIncludeFailure(Failure* failure)
 {
-  for (int i = 0; i < MAX_STATISTICS; i++) {
+  for (int i = 0; i < NumberOfFailures; i++) {
     if (Failures[i] == failure) {
       return;
     }
-    if (Failures[i] == 0) {
-      Failures[i] = failure;
+  }
+  Failures = grow(Failures, NumberOfFailures, sizeof(*Failures));
+  Failures[NumberOfFailures++] = failure;
+}
+
+void statisticIncludeHistogram(struct statisticHistogram* histogram,
+                               char* shortName, char* name, bool verboseOnly)
+{
+  for (int i = 0; i < NumberOfHistograms; i++) {
+    if (Histograms[i] == histogram) {
       return;
     }
   }
-  assert(false);
+  histogram->shortName = shortName;
+  histogram->name = name;
+  histogram->verboseOnly = verboseOnly;
+  Histograms = grow(Histograms, NumberOfHistograms, sizeof(*Histograms));
+  Histograms[NumberOfHistograms++] = histogram;
+}
+
+uint64* statisticShard(uint64* counter)
+{
+  struct statisticShard* shard = calloc(1, sizeof(*shard));
+  int i;
+  if (shard == NULL) {
+    perror("calloc");
+    exit(EXIT_FAILURE);
+  }
+  pthread_mutex_lock(&RegistryLock);
+  for (i = 0; i < NumberOfStatistics; i++) {
+    if (Statistics[i].countPtr == counter) {
+      break;
+    }
+  }
+  assert(i < NumberOfStatistics);
+  shard->next = Statistics[i].shards;
+  __atomic_store_n(&Statistics[i].shards, shard, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&RegistryLock);
+  return &shard->count;
+}
+
+uint64 statisticValue(uint64* counter)
+{
+  for (int i = 0; i < NumberOfStatistics; i++) {
+    if (Statistics[i].countPtr == counter) {
+      return valueOf(i);
+    }
+  }
+  return *counter;
+}
+
+static void clearShards(int i)
+{
+  for (struct statisticShard* shard = Statistics[i].shards; shard != NULL;
+       shard = shard->next) {
+    __atomic_store_n(&shard->count, 0, __ATOMIC_RELAXED);
+  }
+}
+
+/**
+ * The totals hold the counters, then NFACES counts for each failure, then
+ * the buckets and the sum of each histogram. They are shared, so that
+ * forked processes may add to them.
+ */
+static size_t totalsSize(int statistics, int failures, int histograms)
+{
+  return sizeof(struct statisticTotals) +
+         (statistics + failures * NFACES +
+          histograms * (HISTOGRAM_BUCKETS + 1)) *
+             sizeof(uint64);
+}
+
+static uint64* failureTotals(struct statisticTotals* totals, int i)
+{
+  return totals->values + totals->statistics + i * NFACES;
+}
+
+static uint64* histogramTotals(struct statisticTotals* totals, int i)
+{
+  return totals->values + totals->statistics + totals->failures * NFACES +
+         i * (HISTOGRAM_BUCKETS + 1);
+}
+
+struct statisticTotals* statisticTotalsCreate(void)
+{
+  struct statisticTotals* totals =
+      mmap(NULL,
+           totalsSize(NumberOfStatistics, NumberOfFailures,
+                      NumberOfHistograms),
+           PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (totals == MAP_FAILED) {
+    perror("mmap");
+    exit(EXIT_FAILURE);
+  }
+  totals->statistics = NumberOfStatistics;
+  totals->failures = NumberOfFailures;
+  totals->histograms = NumberOfHistograms;
+  return totals;
+}
+
+void statisticTotalsFree(struct statisticTotals* totals)
+{
+  munmap(totals,
+         totalsSize(totals->statistics, totals->failures, totals->histograms));
+}
+
+/**
+ * Zeroes every registered counter, e.g. in a newly forked worker process.
+ */
+void statisticClear(void)
+{
+  for (int i = 0; i < NumberOfStatistics; i++) {
+    *Statistics[i].countPtr = 0;
+    clearShards(i);
+  }
+  for (int i = 0; i < NumberOfFailures; i++) {
+    memset(Failures[i]->count, 0, sizeof(Failures[i]->count));
+  }
+  for (int i = 0; i < NumberOfHistograms; i++) {
+    memset(Histograms[i]->buckets, 0, sizeof(Histograms[i]->buckets));
+    Histograms[i]->sum = 0;
+  }
+}
+
+/**
+ * Adds this process's counters into totals, which may be shared with other
+ * processes doing the same: counts are summed and maxima are combined.
+ */
+static void addValue(struct statisticTotals* totals, int i, uint64 value)
+{
+  if (Statistics[i].maximum) {
+    uint64 old = __atomic_load_n(&totals->values[i], __ATOMIC_RELAXED);
+    while (old < value &&
+           !__atomic_compare_exchange_n(&totals->values[i], &old, value,
+                                        false, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED)) {
+    }
+  } else {
+    __atomic_fetch_add(&totals->values[i], value, __ATOMIC_RELAXED);
+  }
+}
+
+void statisticAddTo(struct statisticTotals* totals)
+{
+  for (int i = 0; i < totals->statistics; i++) {
+    addValue(totals, i, valueOf(i));
+  }
+  for (int i = 0; i < totals->failures; i++) {
+    uint64* counts = failureTotals(totals, i);
+    for (int j = 0; j < NFACES; j++) {
+      __atomic_fetch_add(&counts[j], Failures[i]->count[j], __ATOMIC_RELAXED);
+    }
+  }
+  for (int i = 0; i < totals->histograms; i++) {
+    uint64* counts = histogramTotals(totals, i);
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+      __atomic_fetch_add(&counts[b], Histograms[i]->buckets[b],
+                         __ATOMIC_RELAXED);
+    }
+    __atomic_fetch_add(&counts[HISTOGRAM_BUCKETS], Histograms[i]->sum,
+                       __ATOMIC_RELAXED);
+  }
+}
+
+/**
+ * Replaces this process's counters with totals collected by statisticAddTo.
+ */
+void statisticSetFrom(struct statisticTotals* totals)
+{
+  for (int i = 0; i < totals->statistics; i++) {
+    *Statistics[i].countPtr = totals->values[i];
+    clearShards(i);
+  }
+  for (int i = 0; i < totals->failures; i++) {
+    memcpy(Failures[i]->count, failureTotals(totals, i),
+           sizeof(Failures[i]->count));
+  }
+  for (int i = 0; i < totals->histograms; i++) {
+    memcpy(Histograms[i]->buckets, histogramTotals(totals, i),
+           sizeof(Histograms[i]->buckets));
+    Histograms[i]->sum = histogramTotals(totals, i)[HISTOGRAM_BUCKETS];
+  }
+}
+
+/**
+ * Writes every registered counter, one per line, for statisticReadInto.
+ */
+void statisticWrite(FILE* fp)
+{
+  for (int i = 0; i < NumberOfStatistics; i++) {
+    fprintf(fp, "counter %s %llu\n", Statistics[i].shortName, valueOf(i));
+  }
+  for (int i = 0; i < NumberOfFailures; i++) {
+    fprintf(fp, "failure %s", Failures[i]->shortLabel);
+    for (int j = 0; j < NFACES; j++) {
+      fprintf(fp, " %llu", Failures[i]->count[j]);
+    }
+    fprintf(fp, "\n");
+  }
+  for (int i = 0; i < NumberOfHistograms; i++) {
+    fprintf(fp, "histogram %s", Histograms[i]->shortName);
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+      fprintf(fp, " %llu", Histograms[i]->buckets[b]);
+    }
+    fprintf(fp, " %llu\n", Histograms[i]->sum);
+  }
+}
+
+/* Adds count values from fp into counts, or skips them if counts is NULL. */
+static bool readCounts(FILE* fp, uint64* counts, int count)
+{
+  uint64 value;
+  for (int j = 0; j < count; j++) {
+    if (fscanf(fp, "%llu", &value) != 1) {
+      return false;
+    }
+    if (counts != NULL) {
+      counts[j] += value;
+    }
+  }
+  return true;
+}
+
+/**
+ * Adds the counters written by statisticWrite into totals, matching them
+ * by name. Returns false if the file is malformed.
+ */
+bool statisticReadInto(FILE* fp, struct statisticTotals* totals)
+{
+  char kind[16], name[16];
+  uint64 value;
+  while (fscanf(fp, "%15s %15s", kind, name) == 2) {
+    int i;
+    if (strcmp(kind, "counter") == 0) {
+      if (fscanf(fp, "%llu", &value) != 1) {
+        return false;
+      }
+      for (i = 0; i < totals->statistics; i++) {
+        if (strcmp(Statistics[i].shortName, name) == 0) {
+          addValue(totals, i, value);
+          break;
+        }
+      }
+    } else if (strcmp(kind, "failure") == 0) {
+      for (i = 0; i < totals->failures; i++) {
+        if (strcmp(Failures[i]->shortLabel, name) == 0) {
+          break;
+        }
+      }
+      if (!readCounts(fp,
+                      i < totals->failures ? failureTotals(totals, i) : NULL,
+                      NFACES)) {
+        return false;
+      }
+    } else if (strcmp(kind, "histogram") == 0) {
+      for (i = 0; i < totals->histograms; i++) {
+        if (strcmp(Histograms[i]->shortName, name) == 0) {
+          break;
+        }
+      }
+      if (!readCounts(fp,
+                      i < totals->histograms ? histogramTotals(totals, i)
+                                             : NULL,
+                      HISTOGRAM_BUCKETS + 1)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Lower case, with _ for anything but letters and digits. */
+static void metricName(char* buffer, const char* name)
+{
+  int i;
+  for (i = 0; name[i] != '\0' && i < 63; i++) {
+    buffer[i] = isalnum((unsigned char)name[i])
+                    ? (char)tolower((unsigned char)name[i])
+                    : '_';
+  }
+  buffer[i] = '\0';
+}
+
+static void exportJson(FILE* fp, time_t elapsed)
+{
+  const char* separator = "";
+  fprintf(fp,
+          "{\"elapsed\":%ld,\"estimatedNodes\":%.6g,\"progress\":%.6f,"
+          "\"counters\":{",
+          (long)elapsed, engineEstimatedNodes(), engineProgress());
+  for (int i = 0; i < NumberOfStatistics; i++) {
+    fprintf(fp, "%s\"%s\":%llu", separator, Statistics[i].name, valueOf(i));
+    separator = ",";
+  }
+  fprintf(fp, "},\"failures\":{");
+  separator = "";
+  for (int i = 0; i < NumberOfFailures; i++) {
+    fprintf(fp, "%s\"%s\":[", separator, Failures[i]->label);
+    for (int j = 0; j < NFACES; j++) {
+      fprintf(fp, "%s%llu", j ? "," : "", Failures[i]->count[j]);
+    }
+    fprintf(fp, "]");
+    separator = ",";
+  }
+  fprintf(fp, "},\"histograms\":{");
+  separator = "";
+  for (int i = 0; i < NumberOfHistograms; i++) {
+    fprintf(fp, "%s\"%s\":{\"buckets\":[", separator, Histograms[i]->name);
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+      fprintf(fp, "%s%llu", b ? "," : "", Histograms[i]->buckets[b]);
+    }
+    fprintf(fp, "],\"sum\":%llu}", Histograms[i]->sum);
+    separator = ",";
+  }
+  fprintf(fp, "}}\n");
+}
+
+/* Histogram buckets are cumulative, with le the largest value in each. */
+static void exportPrometheus(FILE* fp, time_t elapsed)
+{
+  char name[64];
+  fprintf(fp, "# TYPE venn_elapsed_seconds gauge\nvenn_elapsed_seconds %ld\n",
+          (long)elapsed);
+  fprintf(fp, "# TYPE venn_estimated_nodes gauge\nvenn_estimated_nodes %.6g\n",
+          engineEstimatedNodes());
+  fprintf(fp, "# TYPE venn_progress gauge\nvenn_progress %.6f\n",
+          engineProgress());
+  for (int i = 0; i < NumberOfStatistics; i++) {
+    metricName(name, Statistics[i].name);
+    fprintf(fp, "# TYPE venn_%s %s\nvenn_%s %llu\n", name,
+            Statistics[i].maximum ? "gauge" : "counter", name, valueOf(i));
+  }
+  fprintf(fp, "# TYPE venn_failures counter\n");
+  for (int i = 0; i < NumberOfFailures; i++) {
+    metricName(name, Failures[i]->label);
+    for (int j = 0; j < NFACES; j++) {
+      if (Failures[i]->count[j] != 0) {
+        fprintf(fp, "venn_failures{failure=\"%s\",depth=\"%d\"} %llu\n", name,
+                j, Failures[i]->count[j]);
+      }
+    }
+  }
+  for (int i = 0; i < NumberOfHistograms; i++) {
+    struct statisticHistogram* histogram = Histograms[i];
+    uint64 count = 0;
+    metricName(name, histogram->name);
+    fprintf(fp, "# TYPE venn_%s histogram\n", name);
+    for (int b = 0; b <= findHighestNonZeroBucket(histogram); b++) {
+      count += histogram->buckets[b];
+      fprintf(fp, "venn_%s_bucket{le=\"%llu\"} %llu\n", name,
+              b == 0 ? 0ull : (2ull << (b - 1)) - 1, count);
+    }
+    fprintf(fp, "venn_%s_bucket{le=\"+Inf\"} %llu\n", name, count);
+    fprintf(fp, "venn_%s_sum %llu\nvenn_%s_count %llu\n", name,
+            histogram->sum, name, count);
+  }
+}
+
+/* Written beside path and renamed, so that readers see a whole file. */
+static void exportStatistics(time_t now)
+{
+  char temporary[1024];
+  size_t length;
+  FILE* fp;
+  if (ExportPath == NULL) {
+    return;
+  }
+  snprintf(temporary, sizeof(temporary), "%s.tmp", ExportPath);
+  fp = fopen(temporary, "w");
+  if (fp == NULL) {
+    perror(temporary);
+    exit(EXIT_FAILURE);
+  }
+  length = strlen(ExportPath);
+  if (length >= 5 && strcmp(ExportPath + length - 5, ".json") == 0) {
+    exportJson(fp, now - StartTime);
+  } else {
+    exportPrometheus(fp, now - StartTime);
+  }
+  if (fclose(fp) != 0 || rename(temporary, ExportPath) != 0) {
+    perror(ExportPath);
+    exit(EXIT_FAILURE);
+  }
+}
+
+void statisticExportTo(const char* path)
+{
+  ExportPath = path;
 }
 
 void statisticPrintOneLine(int position, bool force)
@@ -196,7 +698,9 @@ void statisticPrintOneLine(int position, bool force)
 
       printStatisticsCounters(true);
       printFailureCounts(true);
+      printProgress(now);
       fprintf(LogFile, "\n");
+      exportStatistics(now);
 
       updateLoggingState(now);
     }
@@ -226,8 +730,17 @@ void statisticPrintFull(void)
   fprintf(LogFile, "%30s %30s\n", "Counter", "Value(s)");
 
   printStatisticsCounters(false);
+  if (VerboseModeFlag) {
+    fprintf(LogFile, "%30s %30llu\n", "TrailCapacity", trailCapacity());
+  }
   printFailureCounts(false);
+  printHistograms();
+  if (VerboseModeFlag) {
+    enginePrintProfile(LogFile);
+  }
+  enginePrintCounters(LogFile);
 
   fprintf(LogFile, "\n");
+  exportStatistics(now);
   updateLoggingState(now);
 }
@@ -12,8 +12,9 @@
  * Statistics tracking system for monitoring algorithm performance.
  */
 
-/* Maximum number of statistics that can be tracked */
-#define MAX_STATISTICS 10
+/* Buckets of a histogram: bucket b counts the values with b significant
+ * bits, so bucket 0 counts zeroes and bucket 64 the values of 2^63 or more. */
+#define HISTOGRAM_BUCKETS 65
 
 /* Structure for tracking a single statistic */
 struct statistic {
@@ -21,10 +22,37 @@ struct statistic {
   char *shortName;  /* Abbreviated name for compact display */
   uint64 *countPtr; /* Pointer to the counter value */
   bool verboseOnly; /* Only display in verbose mode */
+  bool maximum;     /* A high-water mark rather than a count */
+  struct statisticShard *shards; /* Counted by other threads */
 };
 
 typedef struct statistic Statistic;
 
+/* A counter of one statistic owned by one thread, merged at report time. */
+struct statisticShard {
+  uint64 count;
+  struct statisticShard *next;
+};
+
+/* The distribution of a quantity, such as the trail depth at each choice. */
+struct statisticHistogram {
+  char *name;
+  char *shortName;
+  bool verboseOnly;
+  uint64 buckets[HISTOGRAM_BUCKETS];
+  uint64 sum;
+};
+
+/* Every registered counter, failure and histogram, in registration order,
+ * for folding together the statistics of several processes. Created for
+ * those registered so far; any registered afterwards are not folded. */
+struct statisticTotals {
+  int statistics;
+  int failures;
+  int histograms;
+  uint64 values[];
+};
+
 /* Initialization and configuration */
 extern void initializeStatisticLogging(char *filename, int frequency,
                                        int seconds);
@@ -32,10 +60,46 @@ extern void initializeStatisticLogging(char *filename, int frequency,
 /* Counter registration */
 extern void statisticIncludeInteger(uint64 *counter, char *shortName,
                                     char *name, bool verboseOnly);
+extern void statisticIncludeMaximum(uint64 *counter, char *shortName,
+                                    char *name, bool verboseOnly);
 extern void statisticIncludeFailure(FAILURE failure);
+extern void statisticIncludeHistogram(struct statisticHistogram *histogram,
+                                      char *shortName, char *name,
+                                      bool verboseOnly);
+
+/* A counter for the calling thread, to be added to counter, or for a
+ * maximum combined with it, whenever the statistic is reported. */
+extern uint64 *statisticShard(uint64 *counter);
+/* The registered counter with its shards. */
+extern uint64 statisticValue(uint64 *counter);
+
+static inline void statisticShardAdd(uint64 *shard, uint64 value)
+{
+  __atomic_store_n(shard, __atomic_load_n(shard, __ATOMIC_RELAXED) + value,
+                   __ATOMIC_RELAXED);
+}
+
+static inline void statisticHistogramAdd(struct statisticHistogram *histogram,
+                                         uint64 value)
+{
+  histogram->buckets[value == 0 ? 0 : 64 - __builtin_clzll(value)]++;
+  histogram->sum += value;
+}
+
+/* Combining statistics across processes */
+extern struct statisticTotals *statisticTotalsCreate(void);
+extern void statisticTotalsFree(struct statisticTotals *totals);
+extern void statisticClear(void);
+extern void statisticAddTo(struct statisticTotals *totals);
+extern void statisticSetFrom(struct statisticTotals *totals);
+extern void statisticWrite(FILE *fp);
+extern bool statisticReadInto(FILE *fp, struct statisticTotals *totals);
 
 /* Output and reporting */
 extern void statisticPrintOneLine(int position, bool force);
 extern void statisticPrintFull(void);
+/* Also writes the statistics into path, whenever they are logged, as JSON
+ * if it ends with .json and otherwise in the Prometheus text format. */
+extern void statisticExportTo(const char *path);
 
 #endif  // STATISTICS_H
@@ -0,0 +1,69 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _GNU_SOURCE
+
+#include "stream.h"
+
+#include <sys/types.h>
+
+#include <stdlib.h>
+
+struct stream {
+  void *cookie;
+  StreamWriteFunction write;
+  StreamCloseFunction close;
+};
+
+static int closeStream(void *cookie)
+{
+  struct stream *stream = cookie;
+  int result = stream->close(stream->cookie);
+  free(stream);
+  return result;
+}
+
+#ifdef __APPLE__
+static int writeStream(void *cookie, const char *buffer, int size)
+{
+  struct stream *stream = cookie;
+  return stream->write(stream->cookie, buffer, size);
+}
+
+static FILE *openStream(struct stream *stream)
+{
+  return funopen(stream, NULL, writeStream, NULL, closeStream);
+}
+#else
+static ssize_t writeStream(void *cookie, const char *buffer, size_t size)
+{
+  struct stream *stream = cookie;
+  return stream->write(stream->cookie, buffer, (int)size);
+}
+
+static FILE *openStream(struct stream *stream)
+{
+  cookie_io_functions_t functions = {
+      .read = NULL, .write = writeStream, .seek = NULL, .close = closeStream};
+  return fopencookie(stream, "w", functions);
+}
+#endif
+
+FILE *streamOpen(void *cookie, StreamWriteFunction write,
+                 StreamCloseFunction close)
+{
+  struct stream *stream = malloc(sizeof(*stream));
+  FILE *fp;
+  if (stream == NULL) {
+    perror("malloc");
+    exit(EXIT_FAILURE);
+  }
+  stream->cookie = cookie;
+  stream->write = write;
+  stream->close = close;
+  fp = openStream(stream);
+  if (fp == NULL) {
+    perror("stream");
+    exit(EXIT_FAILURE);
+  }
+  return fp;
+}
@@ -0,0 +1,23 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdio.h>
+
+/**
+ * A FILE for writing whose bytes go to functions of our own, rather than to
+ * a file, so that what graphml.c prints can be compressed or archived behind
+ * GraphmlFileOps.fopen. This is fopencookie on glibc, and funopen on macOS.
+ */
+
+/* Returns the bytes taken, or -1 for an error. */
+typedef int (*StreamWriteFunction)(void *cookie, const char *buffer, int size);
+/* Returns 0, or EOF for an error. */
+typedef int (*StreamCloseFunction)(void *cookie);
+
+/* Opens a stream writing to cookie, exiting on failure. */
+extern FILE *streamOpen(void *cookie, StreamWriteFunction write,
+                        StreamCloseFunction close);
+
+#endif  // STREAM_H
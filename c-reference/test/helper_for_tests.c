@@ -78,6 +78,9 @@ uint_trail* getPartialCyclicOrder(int i, int j, int k)
   return getAlternating(PartialCyclicOrder, i, j, k);
 }
 
+/* For dynamicAlternatingComplete. */
+static struct stack CompletionStack;
+
 void verifyPartialCyclicOrderAxioms(void)
 {
   int i, j, k;
@@ -118,6 +121,10 @@ bool dynamicPCOSet(int i, int j, int k)
 void clearPartialCyclicOrder(void)
 {
   memset(getPartialCyclicOrder(0, 1, 2), 0, sizeof(uint_trail) * PCO_TRIPLES);
+  memset(PartialCyclicOrder->rows, 0,
+         sizeof(uint_trail) * PCO_LINES * PCO_LINES);
+  memset(PartialCyclicOrder->progress, 0,
+         sizeof(*PartialCyclicOrder->progress));
 }
 
 static void setupPartialExample(int a, int b, int c, int d, int e, int f)
@@ -142,7 +149,8 @@ static void testPartialExample(int a, int b, int c, int d, int e, int f)
     }
   }
   TEST_ASSERT_EQUAL_INT(12, count);
-  TEST_ASSERT_TRUE(dynamicAlternatingComplete(PartialCyclicOrder));
+  TEST_ASSERT_TRUE(
+      dynamicAlternatingComplete(&CompletionStack, PartialCyclicOrder));
 }
 
 void testPartialExampleA()
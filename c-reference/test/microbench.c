@@ -0,0 +1,416 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "alternating.h"
+#include "common.h"
+#include "engine.h"
+#include "face.h"
+#include "geometry.h"
+#include "main.h"
+#include "memory.h"
+#include "predicates.h"
+#include "s6.h"
+#include "triangles.h"
+#include "visible_for_testing.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * The microbenchmarks of make microbench: each core kernel called in a loop
+ * on inputs recorded from a search of the solutions with the face degrees
+ * of the bench workloads. The faces are snapshot as the search reaches
+ * several depths of Venn choices, and at the first solutions, with the
+ * corners of their first variation. Each kernel runs on each input for some
+ * warmup repetitions, and then for the timed ones, reporting the mean,
+ * standard deviation and minimum of the nanoseconds per call in each.
+ *
+ * A snapshot is copied back into Faces for the kernels reading faces; this
+ * leaves the other state of the search, which these kernels do not read,
+ * as it was. The alternating closure is not used by the search, so its
+ * input is a fixed pseudo-random cyclic order of the PCO lines instead.
+ */
+
+#define MICROBENCH_FACE_DEGREES "554544"
+#define MAX_SOLUTIONS 4
+#define DEFAULT_REPETITIONS 20
+#define DEFAULT_WARMUPS 3
+/* Each repetition calls the kernel on its input this many times over. */
+#define INNER_LOOPS 200
+/* Triples of the cyclic order set before each closure. */
+#define ALTERNATING_TRIPLES 24
+
+static const int Depths[] = {2, 4, 8, 12, 16};
+#define NUMBER_OF_DEPTHS (int)(sizeof(Depths) / sizeof(Depths[0]))
+
+static struct face DepthSnapshots[NUMBER_OF_DEPTHS][NFACES];
+static bool DepthCaptured[NUMBER_OF_DEPTHS];
+static struct face SolutionSnapshots[MAX_SOLUTIONS][NFACES];
+static EDGE SolutionCorners[MAX_SOLUTIONS][NCOLORS][3];
+static int Solutions = 0;
+static bool CornersCaptured[MAX_SOLUTIONS];
+
+static int Repetitions = DEFAULT_REPETITIONS;
+static int Warmups = DEFAULT_WARMUPS;
+static const char *Filter = NULL;
+
+/* The input of the kernel being measured, and the state of its body. */
+static struct face *Input;
+static int InputIndex;
+static uint64 Operations;
+static volatile uint64 Sink;
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*--------------------------------------
+ * Recording the inputs
+ *--------------------------------------*/
+
+static volatile int AlwaysPoll = 1;
+
+static void captureDepth(STACK stack)
+{
+  if (stack->stackTop->predicate != &VennPredicate ||
+      stack->stackTop->inChoiceMode) {
+    return;
+  }
+  for (int i = 0; i < NUMBER_OF_DEPTHS; i++) {
+    if (!DepthCaptured[i] && stack->stackTop->round == Depths[i]) {
+      memcpy(DepthSnapshots[i], Faces, sizeof(Faces));
+      DepthCaptured[i] = true;
+    }
+  }
+}
+
+static struct predicateResult tryCaptureSolution(int round)
+{
+  (void)round;
+  if (Solutions == MAX_SOLUTIONS) {
+    return PredicateFail;
+  }
+  memcpy(SolutionSnapshots[Solutions++], Faces, sizeof(Faces));
+  return PredicateSuccessNextPredicate;
+}
+
+static struct predicateResult tryCaptureCorners(int round)
+{
+  int solution = Solutions - 1;
+  (void)round;
+  if (!CornersCaptured[solution]) {
+    memcpy(SolutionCorners[solution], SelectedCornersIPC,
+           sizeof(SelectedCornersIPC));
+    CornersCaptured[solution] = true;
+  }
+  return PredicateFail;
+}
+
+static struct predicate CaptureSolutionPredicate = {
+    "CaptureSolution", tryCaptureSolution, NULL};
+static struct predicate CaptureCornersPredicate = {"CaptureCorners",
+                                                   tryCaptureCorners, NULL};
+
+static void recordInputs(void)
+{
+  struct stack stack;
+  for (int i = 0; i < NCOLORS; i++) {
+    CentralFaceDegreesFlag[i] = MICROBENCH_FACE_DEGREES[i] - '0';
+  }
+  enginePollWith(&AlwaysPoll, captureDepth);
+  engine(&stack, (PREDICATE[]){&InitializePredicate, &InnerFacePredicate,
+                               &VennPredicate, &CaptureSolutionPredicate,
+                               &CornersPredicate, &CaptureCornersPredicate,
+                               &FAILPredicate});
+  enginePollWith(NULL, NULL);
+}
+
+/*--------------------------------------
+ * Measuring
+ *--------------------------------------*/
+
+/* Runs the kernel on Input, returning the seconds to time, and adding the
+ * calls made to Operations. */
+typedef double (*Body)(void);
+
+static void measure(const char *kernel, const char *input, Body body)
+{
+  double mean = 0.0, squares = 0.0, least = INFINITY;
+  uint64 operations = 0;
+  if (Filter != NULL && strstr(kernel, Filter) == NULL) {
+    return;
+  }
+  for (int i = 0; i < Warmups; i++) {
+    body();
+  }
+  for (int i = 0; i < Repetitions; i++) {
+    double seconds, nanoseconds;
+    Operations = 0;
+    seconds = body();
+    operations = Operations;
+    nanoseconds = operations == 0 ? 0.0 : seconds * 1e9 / operations;
+    mean += nanoseconds;
+    squares += nanoseconds * nanoseconds;
+    if (nanoseconds < least) {
+      least = nanoseconds;
+    }
+  }
+  mean /= Repetitions;
+  printf("%-26s %-12s %10llu %10.2f %10.2f %10.2f\n", kernel, input,
+         operations, mean, sqrt(fmax(0.0, squares / Repetitions - mean * mean)),
+         least);
+}
+
+static double bodyCycleSetSize(void)
+{
+  double start = now();
+  for (int loop = 0; loop < INNER_LOOPS; loop++) {
+    for (int i = 0; i < NFACES; i++) {
+      Sink += cycleSetSize(Input[i].possibleCycles);
+    }
+  }
+  Operations += INNER_LOOPS * NFACES;
+  return now() - start;
+}
+
+/* Each call of cycleSetNext, including the last, returning NULL. */
+static double bodyCycleSetNext(void)
+{
+  double start = now();
+  for (int loop = 0; loop < INNER_LOOPS; loop++) {
+    for (int i = 0; i < NFACES; i++) {
+      CYCLE cycle = NULL;
+      do {
+        cycle = cycleSetNext(Input[i].possibleCycles, cycle);
+        Operations++;
+      } while (cycle != NULL);
+    }
+  }
+  return now() - start;
+}
+
+/* Restricts each face without a cycle to omit a color, as completing a
+ * curve does, returning the trail from which to rewind. */
+static double restrictOpenFaces(TRAIL *mark)
+{
+  double start;
+  memcpy(Faces, Input, sizeof(Faces));
+  *mark = Trail;
+  start = now();
+  for (int i = 0; i < NFACES; i++) {
+    if (Faces[i].cycle == NULL) {
+      Sink += dynamicRestrictCycles(Faces + i,
+                                    CycleSetOmittingOneColor[i % NCOLORS]);
+      Operations++;
+    }
+  }
+  return now() - start;
+}
+
+static double bodyRestrictCycles(void)
+{
+  double seconds = 0.0;
+  for (int loop = 0; loop < INNER_LOOPS; loop++) {
+    TRAIL mark;
+    seconds += restrictOpenFaces(&mark);
+    trailRewindTo(mark);
+  }
+  return seconds;
+}
+
+/* One call rewinds all the restrictions of the open faces. */
+static double bodyTrailRewind(void)
+{
+  double seconds = 0.0;
+  for (int loop = 0; loop < INNER_LOOPS; loop++) {
+    TRAIL mark;
+    double start;
+    restrictOpenFaces(&mark);
+    start = now();
+    trailRewindTo(mark);
+    seconds += now() - start;
+  }
+  Operations = INNER_LOOPS;
+  return seconds;
+}
+
+static double bodyMaxSignature(void)
+{
+  double start;
+  memcpy(Faces, Input, sizeof(Faces));
+  start = now();
+  for (int loop = 0; loop < INNER_LOOPS / 10; loop++) {
+    struct tempMark mark = tempMark();
+    Sink += s6MaxSignature()->offset;
+    freeTo(mark);
+  }
+  Operations += INNER_LOOPS / 10;
+  return now() - start;
+}
+
+static void countEdge(void *data, EDGE current, int line)
+{
+  (void)current;
+  (void)line;
+  (*(uint64 *)data)++;
+}
+
+/* One call traverses the triangle of one color. */
+static double bodyTriangleTraverse(void)
+{
+  TriangleTraversalCallbacks callbacks = {
+      .processRegularEdge = countEdge,
+      .processSingleCorner = countEdge,
+      .processAdjacentCorners = countEdge,
+      .processAllCorners = countEdge,
+      .processVertex = NULL};
+  uint64 edges = 0;
+  TRAIL mark;
+  double start;
+  memcpy(Faces, Input, sizeof(Faces));
+  mark = Trail;
+  /* Found afresh for the faces copied in, and kept on the trail. */
+  dynamicSolutionGeometry();
+  start = now();
+  for (int loop = 0; loop < INNER_LOOPS; loop++) {
+    for (COLOR color = 0; color < NCOLORS; color++) {
+      triangleTraverse(color, SolutionCorners[InputIndex] + color, &callbacks,
+                       &edges);
+    }
+  }
+  Sink += edges;
+  Operations += INNER_LOOPS * NCOLORS;
+  start = now() - start;
+  trailRewindTo(mark);
+  return start;
+}
+
+static int CyclicOrder[PCO_LINES];
+static int Triples[ALTERNATING_TRIPLES][3];
+
+/* Triples of lines ordered as they are in CyclicOrder. */
+static void chooseTriples(void)
+{
+  srandom(1);
+  for (int i = 0; i < PCO_LINES; i++) {
+    int j = random() % (i + 1);
+    CyclicOrder[i] = CyclicOrder[j];
+    CyclicOrder[j] = i;
+  }
+  for (int t = 0; t < ALTERNATING_TRIPLES; t++) {
+    int a = random() % PCO_LINES, b, c;
+    do {
+      b = random() % PCO_LINES;
+    } while (b == a);
+    do {
+      c = random() % PCO_LINES;
+    } while (c == a || c == b);
+    /* Sorted positions around the cycle, so a, b, c is in cyclic order. */
+    if (a > b) {
+      int swap = a;
+      a = b;
+      b = swap;
+    }
+    if (b > c) {
+      int swap = b;
+      b = c;
+      c = swap;
+    }
+    if (a > b) {
+      int swap = a;
+      a = b;
+      b = swap;
+    }
+    Triples[t][0] = CyclicOrder[a];
+    Triples[t][1] = CyclicOrder[b];
+    Triples[t][2] = CyclicOrder[c];
+  }
+}
+
+/* One call sets the triples and closes over them. */
+static double bodyAlternatingClosure(void)
+{
+  double seconds = 0.0;
+  for (int loop = 0; loop < INNER_LOOPS / 10; loop++) {
+    TRAIL mark = Trail;
+    double start = now();
+    for (int t = 0; t < ALTERNATING_TRIPLES; t++) {
+      dynamicAlternatingSet(PartialCyclicOrder, Triples[t][0], Triples[t][1],
+                            Triples[t][2]);
+    }
+    if (!dynamicAlternatingClosure(PartialCyclicOrder)) {
+      fprintf(stderr, "The cyclic order is inconsistent.\n");
+      exit(EXIT_FAILURE);
+    }
+    seconds += now() - start;
+    trailRewindTo(mark);
+  }
+  Operations += INNER_LOOPS / 10;
+  return seconds;
+}
+
+static void usage(const char *programName)
+{
+  fprintf(stderr, "Usage: %s [-r repetitions] [-w warmups] [-k kernel]\n",
+          programName);
+  exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+  char input[32];
+  int opt;
+  while ((opt = getopt(argc, argv, "r:w:k:")) != -1) {
+    switch (opt) {
+      case 'r':
+        Repetitions = atoi(optarg);
+        break;
+      case 'w':
+        Warmups = atoi(optarg);
+        break;
+      case 'k':
+        Filter = optarg;
+        break;
+      default:
+        usage(argv[0]);
+    }
+  }
+  if (optind != argc || Repetitions < 1 || Warmups < 0) {
+    usage(argv[0]);
+  }
+  recordInputs();
+  printf("%-26s %-12s %10s %10s %10s %10s\n", "kernel", "input", "calls",
+         "ns/call", "stddev", "min");
+  for (int i = 0; i < NUMBER_OF_DEPTHS; i++) {
+    if (!DepthCaptured[i]) {
+      continue;
+    }
+    Input = DepthSnapshots[i];
+    snprintf(input, sizeof(input), "depth %d", Depths[i]);
+    measure("cycleSetSize", input, bodyCycleSetSize);
+    measure("cycleSetNext", input, bodyCycleSetNext);
+    measure("dynamicRestrictCycles", input, bodyRestrictCycles);
+    measure("trailRewindTo", input, bodyTrailRewind);
+  }
+  for (InputIndex = 0; InputIndex < Solutions; InputIndex++) {
+    Input = SolutionSnapshots[InputIndex];
+    snprintf(input, sizeof(input), "solution %d", InputIndex + 1);
+    measure("s6MaxSignature", input, bodyMaxSignature);
+    if (CornersCaptured[InputIndex]) {
+      measure("triangleTraverse", input, bodyTriangleTraverse);
+    }
+  }
+  initializePartialCyclicOrder();
+  chooseTriples();
+  snprintf(input, sizeof(input), "%d triples", ALTERNATING_TRIPLES);
+  measure("dynamicAlternatingClosure", input, bodyAlternatingClosure);
+  return EXIT_SUCCESS;
+}
@@ -13,6 +13,9 @@
 #include <string.h>
 #include <unity.h>
 
+/* For dynamicAlternatingComplete. */
+static struct stack CompletionStack;
+
 void setUp(void)
 {
   initializeTrail();
@@ -64,7 +67,9 @@ static void runTest(AlternatingPredicate chirotope, char *chirotopeString,
     }
   }
 
-  TRAIL startTrail = Trail;
+  /* Closing over what was set only trails its progress, unless it adds to
+   * what was set. */
+  uint_trail startLength = chirotope->progress->length;
   // printf("before\n");
   // debugAlternating(chirotope);
   bool consistent = dynamicAlternatingClosure(chirotope);
@@ -73,9 +78,10 @@ static void runTest(AlternatingPredicate chirotope, char *chirotopeString,
 
   VERIFY_PROPERTY(consistent);
   if (consistent) {
-    bool closed = startTrail == Trail;
+    bool closed = startLength == chirotope->progress->length;
     VERIFY_PROPERTY(closed);
-    bool extensible = dynamicAlternatingComplete(chirotope);
+    bool extensible =
+        dynamicAlternatingComplete(&CompletionStack, chirotope);
     VERIFY_PROPERTY(extensible);
   }
 }
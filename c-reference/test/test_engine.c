@@ -0,0 +1,354 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "engine.h"
+#include "helper_for_tests.h"
+#include "trace.h"
+
+#include <sys/wait.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <unity.h>
+
+/* A toy search of the 27 three digit numbers in base 3. */
+#define DIGITS 3
+#define LEAVES 27
+
+static int Digits[DIGITS];
+static int Leaves[LEAVES];
+static int LeafCount;
+static int SplitAt;
+static volatile int SplitRequest;
+static struct choicePath Stolen;
+static bool StoleWork;
+static double Progress[LEAVES];
+
+void setUp(void)
+{
+  LeafCount = 0;
+  SplitAt = -1;
+  SplitRequest = 0;
+  StoleWork = false;
+}
+
+void tearDown(void)
+{
+  enginePollWith(NULL, NULL);
+}
+
+static struct predicateResult tryDigit(int round)
+{
+  if (round == DIGITS) {
+    return PredicateSuccessNextPredicate;
+  }
+  return predicateChoices(3);
+}
+
+static struct predicateResult retryDigit(int round, int choice)
+{
+  Digits[round] = choice;
+  return PredicateSuccessSamePredicate;
+}
+
+static struct predicateResult tryLeaf(int round)
+{
+  (void)round;
+  Progress[LeafCount] = engineProgress();
+  Leaves[LeafCount++] = Digits[0] * 9 + Digits[1] * 3 + Digits[2];
+  if (LeafCount == SplitAt) {
+    SplitRequest = 1;
+  }
+  return PredicateFail;
+}
+
+static struct predicate DigitPredicate = {"Digit", tryDigit, retryDigit};
+static struct predicate LeafPredicate = {"Leaf", tryLeaf, NULL};
+static PREDICATE Program[] = {&DigitPredicate, &LeafPredicate};
+
+static void splitOnRequest(STACK stack)
+{
+  StoleWork = engineSplit(stack, &DigitPredicate, &Stolen);
+  SplitRequest = 0;
+}
+
+static void assertLeaves(int from, int to)
+{
+  TEST_ASSERT_EQUAL(to - from, LeafCount);
+  for (int i = 0; i < LeafCount; i++) {
+    TEST_ASSERT_EQUAL(from + i, Leaves[i]);
+  }
+}
+
+static void runSplitting(int splitAt)
+{
+  SplitAt = splitAt;
+  enginePollWith(&SplitRequest, splitOnRequest);
+  engine(&TestStack, Program);
+  enginePollWith(NULL, NULL);
+}
+
+static void replayStolen(void)
+{
+  LeafCount = 0;
+  TEST_ASSERT_TRUE(StoleWork);
+  engineReplay(&TestStack, Program, &Stolen);
+}
+
+static void testFullSearch(void)
+{
+  engine(&TestStack, Program);
+  assertLeaves(0, LEAVES);
+}
+
+static void testEstimateAndProgress(void)
+{
+  engine(&TestStack, Program);
+  /* The root, and 3, 9 and 27 nodes below it. */
+  TEST_ASSERT_TRUE(fabs(engineEstimatedNodes() - 40.0) < 1e-9);
+  for (int i = 0; i < LEAVES; i++) {
+    TEST_ASSERT_TRUE(fabs(Progress[i] - i / (double)LEAVES) < 1e-9);
+  }
+  TEST_ASSERT_TRUE(fabs(engineProgress() - 1.0) < 1e-9);
+}
+
+/* As DigitPredicate, but with a middle digit of 2 failing at once. */
+static struct predicateResult retryPrunedDigit(int round, int choice)
+{
+  Digits[round] = choice;
+  return round == 1 && choice == 2 ? PredicateFail
+                                   : PredicateSuccessSamePredicate;
+}
+
+static double ProbeWeight;
+
+static struct predicateResult tryProbeLeaf(int round)
+{
+  (void)round;
+  ProbeWeight = engineWeight();
+  Leaves[LeafCount++] = Digits[0] * 9 + Digits[1] * 3 + Digits[2];
+  return PredicateFail;
+}
+
+static struct predicate PrunedDigitPredicate = {"PrunedDigit", tryDigit,
+                                                retryPrunedDigit};
+static struct predicate ProbeLeafPredicate = {"ProbeLeaf", tryProbeLeaf,
+                                              NULL};
+static PREDICATE ProbeProgram[] = {&PrunedDigitPredicate,
+                                   &ProbeLeafPredicate};
+
+static void testProbe(void)
+{
+  /* The 6 leaves ending in 0, of the 18 that are not pruned. */
+  double sum = 0.0;
+  uint64 random = 7, again = 7;
+  int first;
+  for (int i = 0; i < 3000; i++) {
+    LeafCount = 0;
+    engineProbe(&TestStack, ProbeProgram, &random);
+    TEST_ASSERT_EQUAL(1, LeafCount);
+    TEST_ASSERT_TRUE(Leaves[0] / 3 % 3 != 2);
+    /* The pruned choice is not counted. */
+    TEST_ASSERT_TRUE(fabs(ProbeWeight - 18.0) < 1e-9);
+    sum += Leaves[0] % 3 == 0 ? ProbeWeight : 0.0;
+  }
+  TEST_ASSERT_TRUE(fabs(sum / 3000 - 6.0) < 1.0);
+
+  LeafCount = 0;
+  engineProbe(&TestStack, ProbeProgram, &again);
+  first = Leaves[0];
+  again = 7;
+  engineProbe(&TestStack, ProbeProgram, &again);
+  TEST_ASSERT_EQUAL(first, Leaves[1]);
+
+  /* An ordinary search afterwards explores every choice. */
+  LeafCount = 0;
+  engine(&TestStack, Program);
+  assertLeaves(0, LEAVES);
+}
+
+static void testSplitShallow(void)
+{
+  /* While exploring the first digit 0, the untried 1 and 2 are split. */
+  runSplitting(5);
+  assertLeaves(0, 18);
+  replayStolen();
+  assertLeaves(18, LEAVES);
+}
+
+static void testSplitWithPrefix(void)
+{
+  /* At 2,0,2 only the second digit has untried choices: 1 and 2. */
+  runSplitting(21);
+  assertLeaves(0, 24);
+  TEST_ASSERT_EQUAL(2, Stolen.length);
+  replayStolen();
+  assertLeaves(24, LEAVES);
+}
+
+static void testSplitLastChoice(void)
+{
+  /* At 2,2,1 only the last digit has an untried choice. */
+  runSplitting(26);
+  assertLeaves(0, 26);
+  replayStolen();
+  assertLeaves(26, LEAVES);
+}
+
+static void testNothingToSplit(void)
+{
+  runSplitting(LEAVES);
+  assertLeaves(0, LEAVES);
+  TEST_ASSERT_FALSE(StoleWork);
+}
+
+static struct choicePath Continuation;
+
+/* Waits until between digits, as the leaves have side effects. */
+static void checkpointOnRequest(STACK stack)
+{
+  if (stack->stackTop->predicate == &DigitPredicate) {
+    engineContinuationPath(stack, &Continuation);
+    SplitRequest = 0;
+  }
+}
+
+static void runContinuation(int stopAt)
+{
+  LeafCount = 0;
+  SplitAt = stopAt;
+  enginePollWith(&SplitRequest, checkpointOnRequest);
+  engine(&TestStack, Program);
+  enginePollWith(NULL, NULL);
+  assertLeaves(0, LEAVES);
+  LeafCount = 0;
+  engineReplay(&TestStack, Program, &Continuation);
+  assertLeaves(stopAt, LEAVES);
+}
+
+static void testContinuation(void)
+{
+  /* Stop after 2,0,1, and carry on from 2,0,2. */
+  runContinuation(20);
+  /* Stop after 0,2,2 with no choices left for the last two digits. */
+  runContinuation(9);
+}
+
+static void testProfile(void)
+{
+  struct predicateProfile digit, leaf;
+  engine(&TestStack, Program);
+  digit = *engineProfile(&DigitPredicate);
+  leaf = *engineProfile(&LeafPredicate);
+  engine(&TestStack, Program);
+  /* Digit is called once at the root, and after each of its 39 choices. */
+  TEST_ASSERT_EQUAL(40, engineProfile(&DigitPredicate)->calls - digit.calls);
+  TEST_ASSERT_EQUAL(39,
+                    engineProfile(&DigitPredicate)->retries - digit.retries);
+  TEST_ASSERT_EQUAL(
+      66, engineProfile(&DigitPredicate)->successes - digit.successes);
+  TEST_ASSERT_EQUAL(27, engineProfile(&LeafPredicate)->calls - leaf.calls);
+  TEST_ASSERT_EQUAL(27,
+                    engineProfile(&LeafPredicate)->failures - leaf.failures);
+  TEST_ASSERT_NULL(engineProfile(&SUSPENDPredicate));
+}
+
+static void testTrace(void)
+{
+  int counts[3] = {0, 0, 0};
+  traceStart("/dev/null");
+  engine(&TestStack, Program);
+  for (uint64_t i = 0; i < TraceCount; i++) {
+    counts[TraceRing[i].kind]++;
+  }
+  TEST_ASSERT_EQUAL(40 + 27, counts[TRACE_CALL]);
+  TEST_ASSERT_EQUAL(39, counts[TRACE_RETRY]);
+  /* The search ends failing out of the first digit. */
+  TEST_ASSERT_EQUAL(TRACE_FAIL, TraceRing[TraceCount - 1].kind);
+  TEST_ASSERT_EQUAL(0, TraceRing[TraceCount - 1].depth);
+  TEST_ASSERT_EQUAL_STRING(
+      "Digit", enginePredicateName(TraceRing[TraceCount - 1].predicate));
+}
+
+static struct stack NestedStack;
+static uint_trail Outer;
+static bool NestedOk;
+
+static struct predicateResult tryNested(int round)
+{
+  (void)round;
+  int *temporary = NEW(int *);
+  *temporary = 42;
+  trailSetInt(&Outer, 1);
+  /* The nested engine neither frees temporary, nor rewinds Outer. */
+  engine(&NestedStack, (PREDICATE[]){&FAILPredicate});
+  NestedOk = *temporary == 42 && Outer == 1 && NEW(int *) != temporary;
+  return PredicateFail;
+}
+
+static struct predicate NestedPredicate = {"Nested", tryNested, NULL};
+
+static void testNestedEngine(void)
+{
+  NestedOk = false;
+  Outer = 0;
+  engine(&TestStack, (PREDICATE[]){&NestedPredicate});
+  TEST_ASSERT_TRUE(NestedOk);
+}
+
+static uint_trail Region[3] = {0, 1ull << 40, 0};
+static uint_trail Outside = 7;
+
+static void testTrailEncodings(void)
+{
+  TRAIL start = Trail;
+  trailRegisterDynamic(Region, sizeof(Region));
+  trailSetInt(&Region[0], 5);
+  trailSetInt(&Region[1], 6);
+  TRAIL_SET_POINTER(&Region[2], &Outside);
+  trailSetInt(&Outside, 1ull << 40);
+  trailSetInt(&Region[0], 1ull << 41);
+  trailSetInt(&Region[0], 9);
+  TEST_ASSERT_TRUE(trailRewindTo(start));
+  TEST_ASSERT_EQUAL(0, Region[0]);
+  TEST_ASSERT_TRUE(Region[1] == 1ull << 40);
+  TEST_ASSERT_EQUAL(0, Region[2]);
+  TEST_ASSERT_EQUAL(7, Outside);
+  TEST_ASSERT_FALSE(trailRewindTo(start));
+}
+
+static void testTrailOverflow(void)
+{
+  int status;
+  pid_t pid = fork();
+  if (pid == 0) {
+    freopen("/dev/null", "w", stderr);
+    Trail = TrailEnd;
+    trailSetInt(&Outside, 1);
+    exit(EXIT_SUCCESS);
+  }
+  TEST_ASSERT_TRUE(waitpid(pid, &status, 0) == pid);
+  TEST_ASSERT_TRUE(WIFEXITED(status));
+  TEST_ASSERT_EQUAL(EXIT_FAILURE, WEXITSTATUS(status));
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(testTrailEncodings);
+  RUN_TEST(testTrailOverflow);
+  RUN_TEST(testFullSearch);
+  RUN_TEST(testEstimateAndProgress);
+  RUN_TEST(testProbe);
+  RUN_TEST(testSplitShallow);
+  RUN_TEST(testSplitWithPrefix);
+  RUN_TEST(testSplitLastChoice);
+  RUN_TEST(testNothingToSplit);
+  RUN_TEST(testContinuation);
+  RUN_TEST(testProfile);
+  RUN_TEST(testNestedEngine);
+  RUN_TEST(testTrace);
+  return UNITY_END();
+}
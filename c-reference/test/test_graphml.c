@@ -2,17 +2,23 @@
 
 #define _GNU_SOURCE
 #include "common.h"
+#include "cornerseek.h"
 #include "face.h"
 #include "helper_for_tests.h"
 #include "main.h"
 #include "predicates.h"
 #include "s6.h"
+#include "solutionpath.h"
 #include "statistics.h"
+#include "variantdedup.h"
+#include "visible_for_testing.h"
 
+#include <limits.h>
 #include <regex.h>
 #include <search.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include <unity.h>
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 
@@ -383,6 +389,28 @@ static void backwardVariant14188(void)
 FORWARD_BACKWARD_PREDICATE_STATIC(Variant14188, NULL, forwardVariant14188,
                                   backwardVariant14188)
 
+static int SeekedTotal;
+
+static bool forwardSeekTotal(void)
+{
+  int choices[NCOLORS * 3];
+  /* Every variant, counted but not written. */
+  MaxVariantsPerSolutionFlag = INT_MAX;
+  IgnoreFirstVariantsPerSolution = 0;
+  CountVariationsFlag = true;
+  SeekedTotal = cornerSeek(INT_MAX, choices);
+  TEST_ASSERT_TRUE(SeekedTotal > 0);
+  return true;
+}
+
+static void backwardSeekTotal(void)
+{
+  CountVariationsFlag = false;
+  TEST_ASSERT_EQUAL(SeekedTotal, VariationNumberIPC - 1);
+}
+FORWARD_BACKWARD_PREDICATE_STATIC(SeekTotal, NULL, forwardSeekTotal,
+                                  backwardSeekTotal)
+
 static bool forwardVariant1319(void)
 {
   /* Test output: 555444-64/27/005.xml (variant 1319 = 0x5*0x100+0x27) */
@@ -427,6 +455,139 @@ static void backwardVariant1319(void)
 FORWARD_BACKWARD_PREDICATE_STATIC(Variant1319, NULL, forwardVariant1319,
                                   backwardVariant1319)
 
+static bool forwardUnique(void)
+{
+  struct automorphism automorphisms[S6_MAX_AUTOMORPHISMS];
+  /* Inside out, and not otherwise, is this solution symmetric. */
+  TEST_ASSERT_EQUAL(2, s6Automorphisms(automorphisms));
+  TEST_ASSERT_EQUAL(0, automorphisms[0].offset);
+  TEST_ASSERT_EQUAL(NFACES - 1, automorphisms[1].offset);
+  for (COLORSET colors = 0; colors < NFACES; colors++) {
+    COLORSET image = automorphisms[1].offset;
+    for (COLOR color = 0; color < NCOLORS; color++) {
+      if (COLORSET_HAS_MEMBER(color, colors)) {
+        image ^= 1u << automorphisms[1].permutation[color];
+      }
+    }
+    TEST_ASSERT_EQUAL(Faces[colors].cycle->length,
+                      Faces[image].cycle->length);
+  }
+  MaxVariantsPerSolutionFlag = INT_MAX;
+  IgnoreFirstVariantsPerSolution = 0;
+  UniqueVariantsFlag = true;
+  variantDedupSolution();
+  return true;
+}
+
+static void backwardUnique(void)
+{
+  UniqueVariantsFlag = false;
+  /* That map takes no variant to another. */
+  TEST_ASSERT_EQUAL(0, variantDedupDuplicates());
+  TEST_ASSERT_EQUAL(1728, FopenCount);
+  TEST_ASSERT_EQUAL(1728, VariationNumberIPC - 1);
+}
+FORWARD_BACKWARD_PREDICATE_STATIC(Unique, NULL, forwardUnique, backwardUnique)
+
+/* The faces of the corners, as colors, of a variant that rotating the
+ * colors does not take to itself. */
+static COLORSET asymmetricCorners[NCOLORS][3] = {
+    {01, 01, 01},    {012, 016, 036}, {024, 034, 074},
+    {050, 070, 061}, {060, 061, 063}, {041, 043, 047}};
+
+static COLORSET rotateColors(COLORSET colors, int by)
+{
+  return (colors << by | colors >> (NCOLORS - by)) & (NFACES - 1);
+}
+
+/* The variant with these corners, with each color moved on by. */
+static void rotatedVariant(COLORSET faces[NCOLORS][3], int by,
+                           EDGE (*corners)[3])
+{
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    COLOR image = (color + by) % NCOLORS;
+    for (int i = 0; i < 3; i++) {
+      FACE face = Faces + rotateColors(faces[color][i], by);
+      corners[image][i] = &face->edges[image];
+    }
+  }
+}
+
+/* No solution of six curves has a map keeping the central face, so these
+ * rotations of the colors stand in for one. */
+static void testDedupRotations(void)
+{
+  struct automorphism rotations[NCOLORS];
+  EDGE corners[NCOLORS][3];
+  COLORSET sameCorners[NCOLORS][3];
+  engine(&TestStack, (PREDICATE[]){&InitializePredicate, &SUSPENDPredicate});
+  for (int by = 0; by < NCOLORS; by++) {
+    for (COLOR color = 0; color < NCOLORS; color++) {
+      rotations[by].permutation[color] = (color + by) % NCOLORS;
+      for (int i = 0; i < 3; i++) {
+        sameCorners[color][i] = rotateColors(07, color);
+      }
+    }
+    rotations[by].offset = 0;
+  }
+  variantDedupAutomorphisms(rotations, NCOLORS, 16);
+  rotatedVariant(asymmetricCorners, 0, corners);
+  TEST_ASSERT_FALSE(variantDedupSeen(corners));
+  for (int by = 1; by < NCOLORS; by++) {
+    rotatedVariant(asymmetricCorners, by, corners);
+    TEST_ASSERT_TRUE(variantDedupSeen(corners));
+  }
+  /* Moving one corner gives a variant of its own, even rotated. */
+  asymmetricCorners[0][0] = 03;
+  rotatedVariant(asymmetricCorners, 2, corners);
+  TEST_ASSERT_FALSE(variantDedupSeen(corners));
+  asymmetricCorners[0][0] = 01;
+  /* Each rotation takes this one to itself. */
+  rotatedVariant(sameCorners, 0, corners);
+  TEST_ASSERT_FALSE(variantDedupSeen(corners));
+  rotatedVariant(sameCorners, 3, corners);
+  TEST_ASSERT_TRUE(variantDedupSeen(corners));
+  TEST_ASSERT_EQUAL(6, variantDedupDuplicates());
+  /* A new solution starts afresh. */
+  variantDedupAutomorphisms(rotations, NCOLORS, 16);
+  TEST_ASSERT_EQUAL(0, variantDedupDuplicates());
+  rotatedVariant(asymmetricCorners, 4, corners);
+  TEST_ASSERT_FALSE(variantDedupSeen(corners));
+  variantDedupAutomorphisms(rotations, 1, 16);
+}
+
+static char PathsFolder[] = "/tmp/test_graphml_XXXXXX";
+
+static bool forwardPaths(void)
+{
+  struct choicePath path;
+  char signature[SOLUTION_SIGNATURE_SIZE];
+  TEST_ASSERT_NOT_NULL(mkdtemp(PathsFolder));
+  /* As in a folder from -P, which has no index. */
+  TEST_ASSERT_FALSE(
+      solutionPathRead(PathsFolder, "555444-01", &path, signature));
+  PerFaceDegreeSolutionNumberIPC = 1;
+  solutionPathRecord(PathsFolder);
+  return true;
+}
+
+static void backwardPaths(void)
+{
+  struct choicePath path;
+  char signature[SOLUTION_SIGNATURE_SIZE], filename[64];
+  TEST_ASSERT_TRUE(
+      solutionPathRead(PathsFolder, "555444-01", &path, signature));
+  TEST_ASSERT_EQUAL_STRING(ExpectedSignature, signature);
+  TEST_ASSERT_GREATER_THAN(0, path.length);
+  TEST_ASSERT_FALSE(
+      solutionPathRead(PathsFolder, "555444-02", &path, signature));
+  snprintf(filename, sizeof(filename), "%s/555444" SOLUTION_PATH_SUFFIX,
+           PathsFolder);
+  TEST_ASSERT_EQUAL(0, unlink(filename));
+  TEST_ASSERT_EQUAL(0, rmdir(PathsFolder));
+}
+FORWARD_BACKWARD_PREDICATE_STATIC(Paths, NULL, forwardPaths, backwardPaths)
+
 extern int searchCountVariations(void);
 
 static bool testVariationEstimate()
@@ -459,6 +620,12 @@ static bool gate()
   VariationNumberIPC = 1;
   SolutionCount++;
   TEST_ASSERT_EQUAL_STRING(ClassSignature, s6SignatureToString(classSignature));
+  TEST_ASSERT_EQUAL_STRING(
+      ExpectedSignature, s6SignatureToString(&CurrentSolution.signature));
+  TEST_ASSERT_EQUAL_STRING(
+      ClassSignature, s6SignatureToString(&CurrentSolution.classSignature));
+  TEST_ASSERT_EQUAL_STRING(s6FaceDegreeSignature(),
+                           CurrentSolution.faceDegrees);
   return true;
 }
 
@@ -478,6 +645,7 @@ static void run(void)
 
 #define RUN_645534(program) RUN_SEARCH_TEST(645534, __LINE__, program)
 #define RUN_654444(program) RUN_SEARCH_TEST(654444, __LINE__, program)
+#define RUN_655344(program) RUN_SEARCH_TEST(655344, __LINE__, program)
 #define RUN_KNOWN(program) RUN_SEARCH_TEST(Known, __LINE__, program)
 
 FORWARD_BACKWARD_PREDICATE_STATIC(Gate, gate, NULL, NULL)
@@ -509,6 +677,17 @@ static PREDICATE Variant1319[] = {
     &InitializePredicate, &Variant1319Predicate, &CheckGraphMLPredicate,
     &InnerFacePredicate,  &VennPredicate,        &GatePredicate,
     &CornersPredicate,    &GraphMLPredicate,     &FAILPredicate};
+static PREDICATE SeekTotal[] = {&InitializePredicate, &InnerFacePredicate,
+                                &VennPredicate,       &GatePredicate,
+                                &SeekTotalPredicate,  &CornersPredicate,
+                                &GraphMLPredicate,    &FAILPredicate};
+static PREDICATE Unique[] = {&InitializePredicate, &InnerFacePredicate,
+                             &VennPredicate,       &GatePredicate,
+                             &UniquePredicate,     &CornersPredicate,
+                             &GraphMLPredicate,    &FAILPredicate};
+static PREDICATE Paths[] = {&InitializePredicate, &InnerFacePredicate,
+                            &VennPredicate,       &GatePredicate,
+                            &PathsPredicate,      &FAILPredicate};
 static PREDICATE CornerCount[] = {&InitializePredicate, &InnerFacePredicate,
                                   &VennPredicate, &GatePredicate,
                                   &CornerCountPredicate};
@@ -553,6 +732,19 @@ static void setup654444()
       "BrFuAzFcFbAyFnBmFoBvFuBrEmCzDzCxArDbCdFgDiIgDbDtDpKwIxOq";
 }
 
+static void setup655344()
+{
+  initializeFaceDegree(6, 5, 5, 3, 4, 4);
+  LevelsIPC = 2;
+  // From 655344-01.txt, the first of the solutions with a symmetry
+  ExpectedSignature =
+      "MrNjGaAqJvDkCjAuEoFlCwEiEtDpAhItDqDfAoDyEvDnBiAxJqDkDvCwAeFnFkEoDcEdGj"
+      "AtDjJdAoBcDmExDsDcDnEyApDwEdDcAtGjJdDjBcAoDiIlCyGeAhIpLaPd";
+  ClassSignature =
+      "PdHlAaKhDzCzEzDoBaAcAtElGuEnArDeOaAeEzDoAbAkAaKhBnAnBvAaDfAcJnHhHaIuAq"
+      "CzEeDtIvEvBpAuAsDbCxDyAuMxDfAoIvEvAsApAqCzAwCvBuAiDwBaHqMj";
+}
+
 static void setupKnown()
 {
   initializeFaceDegree(5, 5, 5, 4, 4, 4);
@@ -581,13 +773,18 @@ int main(void)
   UNITY_BEGIN();
   RUN_654444(Basic);
   RUN_654444(Variant14188);
+  RUN_654444(SeekTotal);
   RUN_654444(CheckGraphML);
   RUN_645534(Basic);
   RUN_645534(EstimateCount);
   RUN_645534(ExactCount);
+  RUN_645534(SeekTotal);
   RUN_645534(CheckGraphML);
+  RUN_655344(Unique);
+  RUN_TEST(testDedupRotations);
   RUN_KNOWN(Basic);
   RUN_KNOWN(Variant1319);
+  RUN_KNOWN(Paths);
   RUN_CORNER_COUNT(0, 8);
   RUN_CORNER_COUNT(1, 1);
   RUN_CORNER_COUNT(2, 2);
@@ -1,6 +1,8 @@
 /* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
 
+#include "dynamicface.h"
 #include "face.h"
+#include "nogood.h"
 #include "statistics.h"
 #include "utils.h"
 #include "visible_for_testing.h"
@@ -121,6 +123,25 @@ static void verifyCycleSetTriples(void)
   }
 }
 
+static void testCountNotIn(void)
+{
+  CYCLESET_DECLARE cycleSet, mask;
+  uint64 words;
+  initializeCycleSetUniversal(cycleSet);
+  initializeCycleSetUniversal(mask);
+  TEST_ASSERT_EQUAL(0, cycleSetCountNotIn(cycleSet, mask, &words));
+  TEST_ASSERT_EQUAL(0, words);
+  cycleSetRemove(0, mask);
+  cycleSetRemove(NCYCLES - 1, mask);
+  cycleSetRemove(NCYCLES - 2, mask);
+  TEST_ASSERT_EQUAL(3, cycleSetCountNotIn(cycleSet, mask, &words));
+  TEST_ASSERT_EQUAL(1ull | 1ull << (NCYCLES - 1) / 64 | 1ull << (NCYCLES - 2) / 64,
+                    words);
+  memset(mask, 0, sizeof(mask));
+  TEST_ASSERT_EQUAL(NCYCLES, cycleSetCountNotIn(cycleSet, mask, &words));
+  TEST_ASSERT_EQUAL((1ull << CYCLESET_LENGTH) - 1, words);
+}
+
 static void testCycleset(void)
 {
   initialize();
@@ -141,6 +162,40 @@ static void testSameAndOppositeDirections(void)
   }
 }
 
+static void testByLength(void)
+{
+  uint32_t length, total = 0;
+  CYCLE cycle;
+  initialize();
+  for (length = 0; length <= NCOLORS; length++) {
+    total += cycleSetSize(CycleSetByLength[length]);
+    for (cycle = cycleSetFirst(CycleSetByLength[length]); cycle != NULL;
+         cycle = cycleSetNext(CycleSetByLength[length], cycle)) {
+      TEST_ASSERT_EQUAL(length, cycle->length);
+    }
+  }
+  TEST_ASSERT_EQUAL(NCYCLES, total);
+}
+
+static void testRestrictedPairs(void)
+{
+  uint32_t cycleId, i, j, count;
+  CYCLE cycle;
+  initialize();
+  for (cycleId = 0, cycle = Cycles; cycleId < NCYCLES; cycleId++, cycle++) {
+    count = 0;
+    for (i = 0; i < NCOLORS; i++) {
+      for (j = i + 1; j < NCOLORS; j++) {
+        bool restricted = (cycle->restrictedPairs >> (i * NCOLORS + j)) & 1;
+        TEST_ASSERT_EQUAL(!cycleContainsAthenB(cycle, i, j), restricted);
+        count += !restricted;
+      }
+    }
+    /* The first color is the lowest, so the edge back to it never counts. */
+    TEST_ASSERT_TRUE(count < cycle->length);
+  }
+}
+
 static void testOppositeDirections(void)
 {
   uint32_t cycleId, j, k, oppositeCycleId;
@@ -181,6 +236,62 @@ static void testFaceChoiceCount(void)
   }
 }
 
+/* Links the faces with one color in a ring of count, or a chain if open. */
+static void linkOneColorFaces(uint32_t count, bool open)
+{
+  for (uint32_t i = 0; i < NCOLORS; i++) {
+    Faces[1u << i].next = NULL;
+  }
+  for (uint32_t i = 0; i + 1 < count; i++) {
+    Faces[1u << i].next = Faces + (1u << (i + 1));
+  }
+  if (count > 0 && !open) {
+    Faces[1u << (count - 1)].next = Faces + 1;
+  }
+}
+
+static void testRingOfFaces(void)
+{
+  initialize();
+  linkOneColorFaces(2, false);
+  TEST_ASSERT_NOT_NULL(dynamicFaceCheckRingOfFaces(Faces + 2, 0, true));
+  linkOneColorFaces(3, true);
+  TEST_ASSERT_NULL(dynamicFaceCheckRingOfFaces(Faces + 2, 0, true));
+  linkOneColorFaces(NCOLORS, false);
+  TEST_ASSERT_NULL(dynamicFaceCheckRingOfFaces(Faces + 2, 0, true));
+  linkOneColorFaces(0, true);
+}
+
+static void testNogood(void)
+{
+  FACE faces[] = {Faces + 1, Faces + 2, Faces + 3};
+  CYCLE first;
+  initialize();
+  first = cycleSetFirst(faces[0]->possibleCycles);
+  nogoodClear();
+  faces[0]->cycle = first;
+  faces[1]->cycle = cycleSetFirst(faces[1]->possibleCycles);
+  faces[2]->cycle = cycleSetFirst(faces[2]->possibleCycles);
+
+  NogoodFailureReasons = NOGOOD_UNKNOWN;
+  nogoodLearn(faces, 2);
+  TEST_ASSERT_FALSE(nogoodExcludes(faces[2], faces[2]->cycle));
+
+  /* Rounds 0 and 2 */
+  NogoodFailureReasons = 5;
+  nogoodLearn(faces, 2);
+  TEST_ASSERT_TRUE(nogoodExcludes(faces[2], faces[2]->cycle));
+  faces[1]->cycle = cycleSetNext(faces[1]->possibleCycles, faces[1]->cycle);
+  TEST_ASSERT_TRUE(nogoodExcludes(faces[2], faces[2]->cycle));
+  faces[0]->cycle = cycleSetNext(faces[0]->possibleCycles, first);
+  TEST_ASSERT_FALSE(nogoodExcludes(faces[2], faces[2]->cycle));
+  faces[0]->cycle = first;
+  nogoodClear();
+  TEST_ASSERT_FALSE(nogoodExcludes(faces[2], faces[2]->cycle));
+
+  faces[0]->cycle = faces[1]->cycle = faces[2]->cycle = NULL;
+}
+
 static void testNextCycle(void)
 {
   FACE face = Faces;
@@ -200,11 +311,16 @@ int main(void)
   UNITY_BEGIN();
   RUN_TEST(testInitialize);
   RUN_TEST(testSizeOfCycleSet);
+  RUN_TEST(testCountNotIn);
   RUN_TEST(testLastCycles);
   RUN_TEST(testSameAndOppositeDirections);
+  RUN_TEST(testRestrictedPairs);
+  RUN_TEST(testByLength);
   RUN_TEST(testFaceChoiceCount);
   RUN_TEST(testOppositeDirections);
   RUN_TEST(testNextCycle);
+  RUN_TEST(testRingOfFaces);
+  RUN_TEST(testNogood);
   RUN_TEST(testContains2);
   RUN_TEST(testContains3);
   RUN_TEST(testCycleset);
@@ -3,15 +3,24 @@
 #define _GNU_SOURCE
 
 #include "main.h"
+#include "s6.h"
 
 #include <getopt.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unity.h>
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 extern int realMain0(int argc, char *argv[]);
 static bool DisasterCalled = false;
+static const char *OrderName = "mrv";
+static bool Served = false;
+static int BatchParallel = 0;
+static int EstimatedProbes = 0;
+static const char *Replayed = NULL;
+static bool DedupStarted = false;
 
 void setUp(void)
 {
@@ -56,10 +65,449 @@ static void testMainArguments(void)
   TEST_ASSERT_NOT_EQUAL_INT(0, run(argc5, argv5));
 }
 
+static void testParallelArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-P", "4"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-P", "0"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-f", "foo", "-P", "4", "-m", "3"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+  char *argv4[] = {"program", "-f", "foo", "-P",
+                   "4",       "-m", "3",   "-d", "556443"};
+  int argc4 = sizeof(argv4) / sizeof(argv4[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  TEST_ASSERT_EQUAL_INT(0, run(argc4, argv4));
+  ParallelWorkersFlag = 0;
+}
+
+static void testShardArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-S", "2/3"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-S", "3/3"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-f", "foo", "-S", "0/3:x"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+  char *argv4[] = {"program", "-f", "foo", "-S", "0/3", "-k", "3"};
+  int argc4 = sizeof(argv4) / sizeof(argv4[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_INT(2, ShardIndexFlag);
+  TEST_ASSERT_EQUAL_INT(3, ShardCountFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc4, argv4));
+  ShardIndexFlag = ShardCountFlag = 0;
+}
+
+static void testCheckpointArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-c", "foo.cp"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-R", "foo.cp"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-f", "foo", "-c", "foo.cp", "-P", "4"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+  char *argv4[] = {"program", "-f", "foo", "-R", "foo.cp", "-M"};
+  int argc4 = sizeof(argv4) / sizeof(argv4[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_FALSE(ResumeFlag);
+  TEST_ASSERT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_TRUE(ResumeFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc4, argv4));
+  CheckpointFileFlag = NULL;
+  ResumeFlag = false;
+  ParallelWorkersFlag = 0;
+  MergeShardsFlag = false;
+}
+
+static void testOrderArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-O", "constraining", "-P", "4"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-O", "nosuch"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-f", "foo", "-O", "wdeg", "-S", "0/3"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+  char *argv4[] = {"program", "-f", "foo", "-O", "all", "-m", "1"};
+  int argc4 = sizeof(argv4) / sizeof(argv4[0]);
+  char *argv5[] = {"program", "-f", "foo", "-O", "all", "-c", "foo.cp"};
+  int argc5 = sizeof(argv5) / sizeof(argv5[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  ParallelWorkersFlag = 0;
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  ShardIndexFlag = ShardCountFlag = 0;
+  TEST_ASSERT_EQUAL_INT(0, run(argc4, argv4));
+  TEST_ASSERT_TRUE(BenchmarkOrdersFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc5, argv5));
+  BenchmarkOrdersFlag = false;
+  CheckpointFileFlag = NULL;
+  OrderName = "mrv";
+}
+
+static void testSymmetryDepthArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-y", "0"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-y", "-1"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_INT(0, SymmetryDepthFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  SymmetryDepthFlag = DEFAULT_SYMMETRY_DEPTH;
+}
+
+static void testUniqueClassesArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-u", "-P", "2"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_TRUE(UniqueClassesFlag);
+  UniqueClassesFlag = false;
+  ParallelWorkersFlag = 0;
+}
+
+static void testUniqueVariantsArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-i", "-F", "delta"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-C", "-i"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_TRUE(UniqueVariantsFlag);
+  TEST_ASSERT_TRUE(DedupStarted);
+  DeltaVariationsFlag = false;
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  UniqueVariantsFlag = false;
+  CountVariationsFlag = false;
+  DedupStarted = false;
+}
+
+static void testCountVariationsArguments(void)
+{
+  char *argv1[] = {"program", "-C", "-d", "554544"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_TRUE(CountVariationsFlag);
+  TEST_ASSERT_NULL(TargetFolderFlag);
+  CountVariationsFlag = false;
+}
+
+static void testVariantWritersArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-W", "4", "-S", "0/3"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-W", "4", "-P", "2"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-f", "foo", "-W", "0"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_INT(4, VariantWritersFlag);
+  ShardIndexFlag = ShardCountFlag = 0;
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  VariantWritersFlag = 0;
+  ParallelWorkersFlag = 0;
+}
+
+static void testVariationFormatArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-F", "bin"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-F", "xml"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-C", "-F", "bin"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+  char *argv4[] = {"program", "-f", "foo", "-F", "archive"};
+  int argc4 = sizeof(argv4) / sizeof(argv4[0]);
+  char *argv5[] = {"program", "-f", "foo", "-F", "delta"};
+  int argc5 = sizeof(argv5) / sizeof(argv5[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_TRUE(BinaryVariationsFlag);
+  TEST_ASSERT_FALSE(ArchiveVariationsFlag);
+  BinaryVariationsFlag = false;
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  CountVariationsFlag = BinaryVariationsFlag = false;
+  TEST_ASSERT_EQUAL_INT(0, run(argc4, argv4));
+  TEST_ASSERT_TRUE(ArchiveVariationsFlag);
+  TEST_ASSERT_FALSE(BinaryVariationsFlag);
+  ArchiveVariationsFlag = false;
+  TEST_ASSERT_EQUAL_INT(0, run(argc5, argv5));
+  TEST_ASSERT_TRUE(DeltaVariationsFlag);
+  TEST_ASSERT_FALSE(ArchiveVariationsFlag);
+  DeltaVariationsFlag = false;
+}
+
+static void testWriterQueueArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-Q", "64"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-Q", "64", "-W", "2"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_INT(64, WriterQueueFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  WriterQueueFlag = VariantWritersFlag = 0;
+}
+
+static void testJsonSinkArguments(void)
+{
+  char *argv1[] = {"program", "-J", "-", "-d", "554544"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-J", "-", "-f", "foo"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-J", "-", "-F", "delta"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+  char *argv4[] = {"program", "-J", "-", "-C"};
+  int argc4 = sizeof(argv4) / sizeof(argv4[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_STRING("-", JsonSinkFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc4, argv4));
+  JsonSinkFlag = NULL;
+  TargetFolderFlag = NULL;
+  DeltaVariationsFlag = CountVariationsFlag = false;
+}
+
+static void testHardwareCountersArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-H"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-H", "-P", "2"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_TRUE(HardwareCountersFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  HardwareCountersFlag = false;
+  ParallelWorkersFlag = 0;
+}
+
+static void testStatisticsExportArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-E", "stats.prom"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-E", "stats.json", "-P", "2"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_STRING("stats.prom", StatisticsExportFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  StatisticsExportFlag = NULL;
+  ParallelWorkersFlag = 0;
+}
+
+static void testFailureAttributionArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-A", "failures.csv"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-A", "failures.csv", "-P", "2"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_STRING("failures.csv", FailureAttributionFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  FailureAttributionFlag = NULL;
+  ParallelWorkersFlag = 0;
+}
+
+static void testSamplingProfileArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-G", "search.folded"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-G", "search.folded", "-P", "2"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_STRING("search.folded", SamplingProfileFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  SamplingProfileFlag = NULL;
+  ParallelWorkersFlag = 0;
+}
+
+static void testMemoImageArguments(void)
+{
+  char *argv[] = {"program", "-f", "foo", "-I", "venn.memo", "-P", "2"};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc, argv));
+  TEST_ASSERT_EQUAL_STRING("venn.memo", MemoImageFlag);
+  MemoImageFlag = NULL;
+  ParallelWorkersFlag = 0;
+}
+
+static void testServeArguments(void)
+{
+  char *argv1[] = {"program", "-s", "-", "-I", "venn.memo"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-s", "-", "-f", "foo"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_STRING("-", ServeFlag);
+  TEST_ASSERT_TRUE(Served);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  Served = false;
+  ServeFlag = NULL;
+  MemoImageFlag = NULL;
+  TargetFolderFlag = NULL;
+}
+
+static void testBatchArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-b", "jobs.txt", "-P", "4"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-b", "jobs.txt", "-n", "1"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-f", "foo", "-b", "jobs.txt", "-d", "554544"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_STRING("jobs.txt", BatchFileFlag);
+  TEST_ASSERT_EQUAL_INT(4, BatchParallel);
+  ParallelWorkersFlag = 0;
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  MaxVariantsPerSolutionFlag = INT_MAX;
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  memset(CentralFaceDegreesFlag, 0, sizeof(CentralFaceDegreesFlag));
+  PerFaceDegreeMaxSolutionsFlag = INT_MAX;
+  PerFaceDegreeSkipSolutionsFlag = 0;
+  BatchFileFlag = NULL;
+}
+
+static void testEstimateArguments(void)
+{
+  char *argv1[] = {"program", "-e", "100:7", "-d", "664443"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-e", "0"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-e", "10:x"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+  char *argv4[] = {"program", "-e", "10", "-f", "foo"};
+  int argc4 = sizeof(argv4) / sizeof(argv4[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_INT(100, EstimateProbesFlag);
+  TEST_ASSERT_TRUE(EstimateSeedFlag == 7);
+  TEST_ASSERT_EQUAL_INT(100, EstimatedProbes);
+  memset(CentralFaceDegreesFlag, 0, sizeof(CentralFaceDegreesFlag));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc4, argv4));
+  EstimateProbesFlag = 0;
+  EstimateSeedFlag = 1;
+  EstimatedProbes = 0;
+}
+
+static void testReplayArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-r", "554544-06", "-n", "3"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-r", "554544"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-f", "foo", "-r", "554544-06", "-k", "5"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_STRING("554544-06", ReplaySolutionFlag);
+  TEST_ASSERT_EQUAL_STRING("554544-06", Replayed);
+  MaxVariantsPerSolutionFlag = INT_MAX;
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  GlobalSkipSolutionsFlag = 0;
+  ReplaySolutionFlag = NULL;
+  Replayed = NULL;
+}
+
+static void testSolutionPathsArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-x"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-x", "-P", "2"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-f", "foo", "-x", "-S", "0/2"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+  char *argv4[] = {"program", "-f", "foo", "-x", "-b", "jobs"};
+  int argc4 = sizeof(argv4) / sizeof(argv4[0]);
+  char *argv5[] = {"program", "-f", "foo", "-x", "-r", "554544-06"};
+  int argc5 = sizeof(argv5) / sizeof(argv5[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_TRUE(SolutionPathsFlag);
+  /* These find solutions out of serial order, and so write no index. */
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc4, argv4));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc5, argv5));
+  SolutionPathsFlag = false;
+  ParallelWorkersFlag = 0;
+  ShardIndexFlag = ShardCountFlag = 0;
+  BatchFileFlag = NULL;
+  ReplaySolutionFlag = NULL;
+}
+
+static void testCompressionArguments(void)
+{
+  char *argv1[] = {"program", "-f", "foo", "-z", "6"};
+  int argc1 = sizeof(argv1) / sizeof(argv1[0]);
+  char *argv2[] = {"program", "-f", "foo", "-z", "10"};
+  int argc2 = sizeof(argv2) / sizeof(argv2[0]);
+  char *argv3[] = {"program", "-f", "foo", "-z", "6", "-F", "bin"};
+  int argc3 = sizeof(argv3) / sizeof(argv3[0]);
+
+  TEST_ASSERT_EQUAL_INT(0, run(argc1, argv1));
+  TEST_ASSERT_EQUAL_INT(6, CompressionLevelFlag);
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc2, argv2));
+  TEST_ASSERT_NOT_EQUAL_INT(0, run(argc3, argv3));
+  CompressionLevelFlag = 0;
+  BinaryVariationsFlag = false;
+}
+
 int main(void)
 {
   UNITY_BEGIN();
   RUN_TEST(testMainArguments);
+  RUN_TEST(testParallelArguments);
+  RUN_TEST(testShardArguments);
+  RUN_TEST(testCheckpointArguments);
+  RUN_TEST(testOrderArguments);
+  RUN_TEST(testSymmetryDepthArguments);
+  RUN_TEST(testUniqueClassesArguments);
+  RUN_TEST(testUniqueVariantsArguments);
+  RUN_TEST(testCountVariationsArguments);
+  RUN_TEST(testVariantWritersArguments);
+  RUN_TEST(testVariationFormatArguments);
+  RUN_TEST(testCompressionArguments);
+  RUN_TEST(testWriterQueueArguments);
+  RUN_TEST(testJsonSinkArguments);
+  RUN_TEST(testHardwareCountersArguments);
+  RUN_TEST(testStatisticsExportArguments);
+  RUN_TEST(testFailureAttributionArguments);
+  RUN_TEST(testSamplingProfileArguments);
+  RUN_TEST(testMemoImageArguments);
+  RUN_TEST(testServeArguments);
+  RUN_TEST(testBatchArguments);
+  RUN_TEST(testEstimateArguments);
+  RUN_TEST(testReplayArguments);
+  RUN_TEST(testSolutionPathsArguments);
   return UNITY_END();
 }
 
@@ -95,12 +543,21 @@ void searchSolutionWrite(const char *buffer)
 }
 
 struct predicate *NonDeterministicProgram[] = {/* stub for testing. */};
+struct stack;
+struct choicePath;
 #pragma GCC diagnostic ignored "-Wvisibility"
 void engine(struct stack *stack, struct predicate *predicates[])
 {
   /* stub for testing. */
 }
 
+bool engineReplay(struct stack *stack, struct predicate *predicates[],
+                  const struct choicePath *path)
+{
+  /* stub for testing. */
+  return true;
+}
+
 char *getBuffer()
 {
   return NULL;
@@ -110,3 +567,135 @@ void disaster(const char *message)
 {
   DisasterCalled = true;
 }
+void parallelSearch(int workers)
+{ /* stub for testing. */
+}
+void shardTag(char *tag, size_t size)
+{ /* stub for testing. */
+}
+void shardSaveStatistics(const char *folder)
+{ /* stub for testing. */
+}
+void shardMerge(const char *folder)
+{ /* stub for testing. */
+}
+void solutionIndexOpen(const char *folder, const char *tag, int keep)
+{ /* stub for testing. */
+}
+void solutionIndexClose(void)
+{ /* stub for testing. */
+}
+void solutionIndexRenumber(const char *folder)
+{ /* stub for testing. */
+}
+void classIndexOpen(const char *folder)
+{ /* stub for testing. */
+}
+void variantDedupStart(void)
+{
+  DedupStarted = true;
+}
+void classIndexPending(const char *folder, const char *tag)
+{ /* stub for testing. */
+}
+void classIndexClose(void)
+{ /* stub for testing. */
+}
+void classIndexFold(const char *folder)
+{ /* stub for testing. */
+}
+void variantPoolStart(int writers)
+{ /* stub for testing. */
+}
+void variantPoolFinish(void)
+{ /* stub for testing. */
+}
+void compressionStart(int level)
+{ /* stub for testing. */
+}
+void compressionPrintSummary(FILE *fp)
+{ /* stub for testing. */
+}
+void variantArchiveStart(void)
+{ /* stub for testing. */
+}
+void asyncWriterStart(int depth)
+{ /* stub for testing. */
+}
+void jsonSinkOpen(const char *path)
+{ /* stub for testing. */
+}
+void jsonSinkClose(void)
+{ /* stub for testing. */
+}
+bool perfCountersStart(void)
+{ /* stub for testing. */
+  return false;
+}
+void statisticExportTo(const char *path)
+{ /* stub for testing. */
+}
+void failureAttributionStart(const char *path)
+{ /* stub for testing. */
+}
+void failureAttributionWrite(void)
+{ /* stub for testing. */
+}
+void samplerStart(const char *path)
+{ /* stub for testing. */
+}
+void samplerWrite(void)
+{ /* stub for testing. */
+}
+void asyncWriterFinish(void)
+{ /* stub for testing. */
+}
+void checkpointStart(struct stack *stack, const char *filename, bool resume)
+{ /* stub for testing. */
+}
+const struct choicePath *checkpointPath(void)
+{
+  return NULL;
+}
+int checkpointSolutionIndexCount(void)
+{
+  return 0;
+}
+void checkpointFinish(void)
+{ /* stub for testing. */
+}
+void traceStart(const char *filename)
+{ /* stub for testing. */
+}
+bool orderSelect(const char *name)
+{
+  if (strcmp(name, "mrv") != 0 && strcmp(name, "constraining") != 0 &&
+      strcmp(name, "wdeg") != 0) {
+    return false;
+  }
+  OrderName = name;
+  return true;
+}
+bool orderIsRepeatable(void)
+{
+  return strcmp(OrderName, "wdeg") != 0;
+}
+void orderBenchmark(void (*search)(void))
+{ /* stub for testing. */
+}
+void serve(const char *address)
+{
+  Served = true;
+}
+void batchSearch(const char *path, int parallel)
+{
+  BatchParallel = parallel;
+}
+void estimateSearch(int probes, uint64 seed, int workers)
+{
+  EstimatedProbes = probes;
+}
+void solutionPathReplay(const char *folder, const char *name)
+{
+  Replayed = name;
+}
@@ -0,0 +1,82 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "face.h"
+#include "main.h"
+#include "memoimage.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <unity.h>
+
+static char ImagePath[] = "/tmp/test_memoimage_XXXXXX";
+static struct face SavedFaces[NFACES];
+static struct facialCycle SavedCycles[NCYCLES];
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/* Must run first: saves the image of the first initialization. */
+static void testSaveOnFirstInitialize(void)
+{
+  int fd = mkstemp(ImagePath);
+  TEST_ASSERT_TRUE(fd >= 0);
+  close(fd);
+  unlink(ImagePath);
+  MemoImageFlag = ImagePath;
+  initialize();
+  MemoImageFlag = NULL;
+  TEST_ASSERT_EQUAL(0, access(ImagePath, R_OK));
+  memcpy(SavedFaces, Faces, sizeof(Faces));
+  memcpy(SavedCycles, Cycles, sizeof(Cycles));
+}
+
+static void testLoadRestoresState(void)
+{
+  memset(Faces, 0, sizeof(Faces));
+  memset(Cycles, 0, sizeof(Cycles));
+  TEST_ASSERT_TRUE(memoImageLoad(ImagePath));
+  TEST_ASSERT_EQUAL_INT(0, memcmp(SavedFaces, Faces, sizeof(Faces)));
+  TEST_ASSERT_EQUAL_INT(0, memcmp(SavedCycles, Cycles, sizeof(Cycles)));
+  TEST_ASSERT_TRUE(Faces[0].adjacentFaces[0] == Faces + 1);
+  TEST_ASSERT_TRUE(Faces[0].edges[0].reversed == &Faces[1].edges[0]);
+}
+
+static void testMissingImage(void)
+{
+  TEST_ASSERT_FALSE(memoImageLoad("/tmp/test_memoimage_missing"));
+}
+
+static void testOtherBuildLeavesStateAlone(void)
+{
+  FILE* fp = fopen(ImagePath, "r+");
+  TEST_ASSERT_NOT_NULL(fp);
+  /* The NCOLORS of the header. */
+  fseek(fp, 16, SEEK_SET);
+  fputc(NCOLORS + 1, fp);
+  fclose(fp);
+  Faces[1].cycleSetSize = 0;
+  TEST_ASSERT_FALSE(memoImageLoad(ImagePath));
+  TEST_ASSERT_EQUAL(0, Faces[1].cycleSetSize);
+  Faces[1].cycleSetSize = SavedFaces[1].cycleSetSize;
+  unlink(ImagePath);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(testSaveOnFirstInitialize);
+  RUN_TEST(testLoadRestoresState);
+  RUN_TEST(testMissingImage);
+  RUN_TEST(testOtherBuildLeavesStateAlone);
+  return UNITY_END();
+}
@@ -0,0 +1,33 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "memotables.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/* Must run first: nothing else may have initialized the MEMO data. */
+static void testGeneratedTablesMatchComputed(void)
+{
+  struct memoTables *computed = calloc(1, sizeof(*computed));
+  TEST_ASSERT_NOT_NULL(computed);
+  TEST_ASSERT_NOT_NULL(memoTables());
+  memoTablesCompute(computed);
+  TEST_ASSERT_EQUAL_INT(0, memcmp(&MemoTables, computed, sizeof(*computed)));
+  free(computed);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(testGeneratedTablesMatchComputed);
+  return UNITY_END();
+}
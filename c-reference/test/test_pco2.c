@@ -53,6 +53,23 @@ static void testClosure(void)
   TEST_ASSERT_FALSE(dynamicAlternatingClosure(PartialCyclicOrder));
 }
 
+static void testIncrementalClosure(void)
+{
+  TEST_ASSERT_EQUAL(true, dynamicPCOSet(0, 1, 2));
+  TEST_ASSERT_EQUAL(true, dynamicAlternatingClosure(PartialCyclicOrder));
+  TEST_ASSERT_EQUAL(true, dynamicPCOSet(0, 2, 3));
+  TEST_ASSERT_EQUAL(true, dynamicAlternatingClosure(PartialCyclicOrder));
+  TEST_ASSERT_TRUE(*getPartialCyclicOrder(0, 1, 3));
+  TEST_ASSERT_TRUE(*getPartialCyclicOrder(1, 2, 3));
+  /* The new entry is the second premise, with earlier ones as the first. */
+  TEST_ASSERT_EQUAL(true, dynamicPCOSet(0, 3, 4));
+  TEST_ASSERT_EQUAL(true, dynamicAlternatingClosure(PartialCyclicOrder));
+  TEST_ASSERT_TRUE(*getPartialCyclicOrder(0, 1, 4));
+  TEST_ASSERT_TRUE(*getPartialCyclicOrder(0, 2, 4));
+  TEST_ASSERT_FALSE(*getPartialCyclicOrder(0, 1, 5));
+  verifyPartialCyclicOrderAxioms();
+}
+
 int main(void)
 {
   UNITY_BEGIN();
@@ -61,5 +78,6 @@ int main(void)
   RUN_TEST(testPartialExampleB);
   RUN_TEST(testPartialExampleC);
   RUN_TEST(testClosure);
+  RUN_TEST(testIncrementalClosure);
   return UNITY_END();
 }
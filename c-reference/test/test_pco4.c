@@ -7,6 +7,9 @@
 #include <stdlib.h>
 #include <unity.h>
 
+/* For dynamicAlternatingComplete. */
+static struct stack CompletionStack;
+
 void setUp(void)
 {
   initializePartialCyclicOrder();
@@ -140,8 +143,9 @@ static void testV4(int a, int b, int c, int d, int e, int f, int g, int h,
 
   TEST_ASSERT_EQUAL(true, dynamicAlternatingClosure(PartialCyclicOrder));
   int counter = EngineCounter;
-  TEST_ASSERT_TRUE_MESSAGE(dynamicAlternatingComplete(PartialCyclicOrder),
-                           "extendable");
+  TEST_ASSERT_TRUE_MESSAGE(
+      dynamicAlternatingComplete(&CompletionStack, PartialCyclicOrder),
+      "extendable");
   printf("Engine counter = %d\n", EngineCounter - counter);
 }
 
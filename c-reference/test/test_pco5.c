@@ -4,6 +4,9 @@
 #include <stdio.h>
 #include <unity.h>
 
+/* For dynamicAlternatingComplete. */
+static struct stack CompletionStack;
+
 void setUp(void)
 {
   initializePartialCyclicOrder();
@@ -41,7 +44,8 @@ static void testMegiddo(int a, int b, int c, int d, int e, int f, int g, int h,
   TEST_ASSERT_EQUAL(true, dynamicPCOSet(b, h, m));
   TEST_ASSERT_EQUAL(true, dynamicAlternatingClosure(PartialCyclicOrder));
   int counter = EngineCounter;
-  bool result = dynamicAlternatingComplete(PartialCyclicOrder);
+  bool result =
+      dynamicAlternatingComplete(&CompletionStack, PartialCyclicOrder);
   printf("Engine counter = %d\n", EngineCounter - counter);
   TEST_ASSERT_FALSE_MESSAGE(result, "not extendable");
 }
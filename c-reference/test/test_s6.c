@@ -7,6 +7,7 @@
 #include "s6.h"
 #include "statistics.h"
 #include "utils.h"
+#include "visible_for_testing.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -39,6 +40,67 @@ static void testCanonical6()
   TEST_ASSERT_EQUAL(EQUIVOCAL, s6SymmetryType6(intArray(5, 5, 5, 4, 4, 4)));
 }
 
+static void testPrefixCanonical6()
+{
+  TEST_ASSERT_TRUE(s6PrefixNonCanonical6(intArray(5, 5, 4, 4, 4, 5), 6));
+  TEST_ASSERT_FALSE(s6PrefixNonCanonical6(intArray(6, 5, 5, 4, 4, 3), 6));
+  TEST_ASSERT_FALSE(s6PrefixNonCanonical6(intArray(5, 5, 5, 4, 4, 4), 6));
+  /* Only the first two are known: rotating the 6 to the front is larger. */
+  TEST_ASSERT_TRUE(s6PrefixNonCanonical6(intArray(5, 6, 3, 3, 3, 3), 2));
+  TEST_ASSERT_FALSE(s6PrefixNonCanonical6(intArray(6, 5, 6, 6, 6, 6), 2));
+  /* 5 5 4 5 4 4 is canonical, 5 4 5 5 4 4 is not. */
+  TEST_ASSERT_FALSE(s6PrefixNonCanonical6(intArray(5, 4, 5, 6, 6, 6), 3));
+  TEST_ASSERT_TRUE(s6PrefixNonCanonical6(intArray(5, 4, 5, 5, 6, 6), 4));
+}
+
+static CYCLE cycleOfLength(uint32_t length)
+{
+  for (CYCLE_ID i = 0; i < NCYCLES; i++) {
+    if (Cycles[i].length == length) {
+      return Cycles + i;
+    }
+  }
+  return NULL;
+}
+
+/* Sets the cycles of the first count faces around the central face. */
+static void setFaceDegrees(int count, const FACE_DEGREE* degrees)
+{
+  for (int i = 0; i < NCOLORS; i++) {
+    Faces[(NFACES - 1) & ~(1u << i)].cycle =
+        i < count ? cycleOfLength(degrees[i]) : NULL;
+  }
+}
+
+static void testPartialCanonical6()
+{
+  initialize();
+  setFaceDegrees(NCOLORS, intArray(5, 5, 4, 4, 4, 5));
+  TEST_ASSERT_TRUE(s6PartialFacesNonCanonical());
+  setFaceDegrees(NCOLORS, intArray(6, 5, 5, 4, 4, 3));
+  TEST_ASSERT_FALSE(s6PartialFacesNonCanonical());
+  /* Whatever the others, rotating the 6 to the front is larger. */
+  setFaceDegrees(2, intArray(5, 6));
+  TEST_ASSERT_TRUE(s6PartialFacesNonCanonical());
+  setFaceDegrees(2, intArray(6, 5));
+  TEST_ASSERT_FALSE(s6PartialFacesNonCanonical());
+  setFaceDegrees(0, NULL);
+}
+
+static void testPermuteCycleId()
+{
+  int rotate[NCOLORS] = {1, 2, 3, 4, 5, 0};
+  int unrotate[NCOLORS] = {5, 0, 1, 2, 3, 4};
+  for (CYCLE_ID i = 0; i < NCYCLES; i++) {
+    CYCLE_ID rotated = s6PermuteCycleId(i, &rotate);
+    TEST_ASSERT_EQUAL(Cycles[i].length, Cycles[rotated].length);
+    TEST_ASSERT_EQUAL(i, s6PermuteCycleId(rotated, &unrotate));
+    if (Cycles[i].length == NCOLORS) {
+      TEST_ASSERT_EQUAL(NCYCLES - 1, s6PermuteCycleId(i, s6Automorphism(i)));
+    }
+  }
+}
+
 static struct predicate countSolutionsPredicate = {"Count", countSolutions,
                                                    NULL};
 static struct predicate* testProgram[] = {
@@ -55,6 +117,9 @@ int main(void)
 {
   UNITY_BEGIN();
   RUN_TEST(testCanonical6);
+  RUN_TEST(testPrefixCanonical6);
+  RUN_TEST(testPartialCanonical6);
+  RUN_TEST(testPermuteCycleId);
   RUN_TEST(testCallback);
   return UNITY_END();
 }
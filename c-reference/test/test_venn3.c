@@ -98,18 +98,18 @@ static void checkBVertexOfAEdge(FACE face, EDGE edge, bool primary,
 {
   TEST_ASSERT_EQUAL(primary, IS_CLOCKWISE_EDGE(edge));
   TEST_ASSERT_EQUAL(face->colors, edge->colors);
-  TEST_ASSERT_NULL(edge->to);
+  TEST_ASSERT_NULL(edgeTo(edge));
   TEST_ASSERT_EQUAL(A, edge->color);
-  TEST_ASSERT_NULL(edge->possiblyTo[A].vertex);
-  TEST_ASSERT_NULL(edge->possiblyTo[A].next);
+  TEST_ASSERT_NULL(curveLinkVertex(&edge->possiblyTo[A]));
+  TEST_ASSERT_NULL(curveLinkNext(&edge->possiblyTo[A]));
   TEST_ASSERT_EQUAL(primaryAtBVertex ? A : B,
-                    edge->possiblyTo[B].vertex->primary);
+                    curveLinkVertex(&edge->possiblyTo[B])->primary);
   TEST_ASSERT_EQUAL(primaryAtBVertex ? B : A,
-                    edge->possiblyTo[B].vertex->secondary);
+                    curveLinkVertex(&edge->possiblyTo[B])->secondary);
   TEST_ASSERT_NOT_EQUAL(edge->possiblyTo[B].vertex, edge->possiblyTo[C].vertex);
-  TEST_ASSERT_EQUAL(A, edge->possiblyTo[B].next->color);
-  TEST_ASSERT_EQUAL(nextBcolors, edge->possiblyTo[B].next->colors);
-  sanityVertex(edge->possiblyTo[B].vertex);
+  TEST_ASSERT_EQUAL(A, curveLinkNext(&edge->possiblyTo[B])->color);
+  TEST_ASSERT_EQUAL(nextBcolors, curveLinkNext(&edge->possiblyTo[B])->colors);
+  sanityVertex(curveLinkVertex(&edge->possiblyTo[B]));
 }
 
 static void testOuterAEdge()
@@ -9,6 +9,7 @@
 #include "utils.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unity.h>
 
@@ -86,6 +87,79 @@ static void testFullSearch(void)
   TEST_ASSERT_EQUAL(233, SolutionCount);
 }
 
+static struct stack SplitStack;
+static volatile int SplitRequest;
+static struct choicePath Stolen;
+static bool StoleWork;
+static int LastChoices[NFACES], LastLength;
+static bool InOrder;
+
+static bool choicesBefore(int* a, int aLength, int* b, int bLength)
+{
+  for (int i = 0; i < aLength && i < bLength; i++) {
+    if (a[i] != b[i]) {
+      return a[i] < b[i];
+    }
+  }
+  return aLength < bLength;
+}
+
+static struct predicateResult countSolutionsInOrder(int round)
+{
+  int choices[NFACES];
+  int length = vennChoicePath(choices);
+  (void)round;
+  if (SolutionCount > 0 &&
+      !choicesBefore(LastChoices, LastLength, choices, length)) {
+    InOrder = false;
+  }
+  memcpy(LastChoices, choices, sizeof(choices));
+  LastLength = length;
+  if (++SolutionCount == 10) {
+    SplitRequest = 1;
+  }
+  return PredicateFail;
+}
+
+static struct predicateResult trySetup555444(int round)
+{
+  (void)round;
+  dynamicFaceSetupCentral(intArray(5, 5, 5, 4, 4, 4));
+  return PredicateSuccessNextPredicate;
+}
+
+static void splitVenn(STACK stack)
+{
+  if (stack == &SplitStack) {
+    StoleWork = engineSplit(stack, &VennPredicate, &Stolen);
+    SplitRequest = 0;
+  }
+}
+
+static PREDICATE SplitProgram[] = {
+    &(struct predicate){"Setup", trySetup555444, NULL}, &VennPredicate,
+    &(struct predicate){"Found", countSolutionsInOrder, NULL}};
+
+static void testSplitSearch(void)
+{
+  int victimSolutions;
+  SolutionCount = 0;
+  InOrder = true;
+  enginePollWith(&SplitRequest, splitVenn);
+  engine(&SplitStack, SplitProgram);
+  engineClear(&SplitStack);
+  enginePollWith(NULL, NULL);
+  TEST_ASSERT_TRUE(StoleWork);
+  victimSolutions = SolutionCount;
+  TEST_ASSERT_LESS_THAN(80, victimSolutions);
+
+  /* The stolen subtree follows the rest in the serial order. */
+  engineReplay(&SplitStack, SplitProgram, &Stolen);
+  engineClear(&SplitStack);
+  TEST_ASSERT_EQUAL(80, SolutionCount);
+  TEST_ASSERT_TRUE(InOrder);
+}
+
 int main(void)
 {
   UNITY_BEGIN();
@@ -93,5 +167,6 @@ int main(void)
   RUN_TEST(testSearchForBestSolution);
   RUN_TEST(testSearchForTwoSolutions);
   RUN_TEST(testFullSearch);
+  RUN_TEST(testSplitSearch);
   return UNITY_END();
 }
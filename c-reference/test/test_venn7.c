@@ -0,0 +1,77 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "face.h"
+#include "helper_for_tests.h"
+#include "predicates.h"
+#include "statistics.h"
+
+#include <unity.h>
+
+void setUp(void)
+{
+  initializeStatisticLogging(NULL, 4, 1);
+  engine(&TestStack, (PREDICATE[]){&InitializePredicate, &SUSPENDPredicate});
+}
+
+void tearDown(void)
+{
+  engineClear(&TestStack);
+}
+
+static void testSizes(void)
+{
+  TEST_ASSERT_EQUAL(2344, NCYCLES);
+  TEST_ASSERT_EQUAL(37, CYCLESET_LENGTH);
+  TEST_ASSERT_EQUAL(128, NFACES);
+  TEST_ASSERT_EQUAL(2, FACESET_LENGTH);
+}
+
+static void testByLength(void)
+{
+  /* 7 choose k colors, in (k-1)! orders. */
+  uint32_t expected[] = {0, 0, 0, 70, 210, 504, 840, 720};
+  for (uint32_t length = 0; length <= NCOLORS; length++) {
+    TEST_ASSERT_EQUAL(expected[length],
+                      cycleSetSize(CycleSetByLength[length]));
+  }
+}
+
+static void testFaceChoiceCount(void)
+{
+  uint32_t expected[] = {720, 1950, 1290, 948, 948, 1290, 1950, 720};
+  for (uint32_t faceColors = 1; faceColors < NFACES - 1; faceColors++) {
+    TEST_ASSERT_EQUAL(expected[__builtin_popcount(faceColors)],
+                      Faces[faceColors].cycleSetSize);
+  }
+}
+
+static void testCentralFaceDegrees(void)
+{
+  dynamicFaceSetupCentral(intArray(5, 5, 5, 5, 5, 5, 5));
+  TEST_ASSERT_EQUAL(1, Faces[NFACES - 1].cycleSetSize);
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    TEST_ASSERT_EQUAL(12, Faces[(NFACES - 1) & ~(1u << color)].cycleSetSize);
+  }
+}
+
+static void testChoice(void)
+{
+  dynamicFaceSetupCentral(intArray(5, 5, 5, 5, 5, 5, 5));
+  dynamicFaceAddSpecific("bcdefg", "agfeb");
+  /* Some of the faces inside five curves near it are restricted. */
+  TEST_ASSERT_EQUAL(16, faceFromColors("bcdeg")->cycleSetSize);
+  TEST_ASSERT_EQUAL(16, faceFromColors("bcdfg")->cycleSetSize);
+  TEST_ASSERT_EQUAL(65, faceFromColors("bcdef")->cycleSetSize);
+  TEST_ASSERT_EQUAL(65, faceFromColors("cdefg")->cycleSetSize);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(testSizes);
+  RUN_TEST(testByLength);
+  RUN_TEST(testFaceChoiceCount);
+  RUN_TEST(testCentralFaceDegrees);
+  RUN_TEST(testChoice);
+  return UNITY_END();
+}
@@ -0,0 +1,159 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 700
+
+#include "main.h"
+#include "verify.h"
+
+#include <sys/wait.h>
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <unity.h>
+
+/* Of the small searches that vennverify is tried on. */
+static char Folder[] = "/tmp/test_verify_XXXXXX";
+
+void setUp(void)
+{
+  TEST_ASSERT_NOT_NULL(mkdtemp(Folder));
+}
+
+static int removeEntry(const char *path, const struct stat *st, int type,
+                       struct FTW *ftw)
+{
+  (void)st;
+  (void)type;
+  (void)ftw;
+  return remove(path);
+}
+
+void tearDown(void)
+{
+  TEST_ASSERT_EQUAL(0, nftw(Folder, removeEntry, 16, FTW_DEPTH | FTW_PHYS));
+  strcpy(Folder + strlen(Folder) - 6, "XXXXXX");
+}
+
+/* Runs the main in a child of its own, as each of them has global state,
+ * returning its exit status. */
+static int run(int (*main)(int argc, char *argv[]), char *argv[])
+{
+  int argc = 0, status;
+  pid_t pid;
+  while (argv[argc] != NULL) {
+    argc++;
+  }
+  fflush(NULL);
+  pid = fork();
+  if (pid == 0) {
+    freopen("/dev/null", "w", stdout);
+    freopen("/dev/null", "w", stderr);
+    optind = 1;
+    exit(main(argc, argv));
+  }
+  TEST_ASSERT_TRUE(waitpid(pid, &status, 0) == pid);
+  TEST_ASSERT_TRUE(WIFEXITED(status));
+  return WEXITSTATUS(status);
+}
+
+/* Twenty variations of each of two solutions of 555444, in the format, with
+ * the .paths index if paths is -x. */
+static void search(char *format, char *paths)
+{
+  char *argv[] = {"venn", "-f", Folder, "-d", "555444", "-m", "2",
+                  "-n",   "20", "-F",   format, paths, NULL};
+  TEST_ASSERT_EQUAL(EXIT_SUCCESS, run(realMain0, argv));
+}
+
+static int verify(void)
+{
+  char *argv[] = {"vennverify", "-P", "2", Folder, NULL};
+  return run(verifyMain, argv);
+}
+
+static FILE *openInFolder(const char *file)
+{
+  char filename[128];
+  FILE *fp;
+  snprintf(filename, sizeof(filename), "%s/%s", Folder, file);
+  fp = fopen(filename, "r+");
+  TEST_ASSERT_NOT_NULL(fp);
+  return fp;
+}
+
+/* The offset in the file of the end of the first line starting text. */
+static long offsetAfter(const char *file, const char *text)
+{
+  char line[512];
+  FILE *fp = openInFolder(file);
+  long offset = -1;
+  while (offset < 0 && fgets(line, sizeof(line), fp) != NULL) {
+    if (strncmp(line, text, strlen(text)) == 0) {
+      offset = ftell(fp) - 2;
+    }
+  }
+  fclose(fp);
+  TEST_ASSERT_GREATER_OR_EQUAL_INT(0, offset);
+  return offset;
+}
+
+/* Overwrites a byte of the file in the folder. */
+static void corrupt(const char *file, long offset)
+{
+  FILE *fp = openInFolder(file);
+  int c;
+  TEST_ASSERT_NOT_NULL(fp);
+  TEST_ASSERT_EQUAL(0, fseek(fp, offset, SEEK_SET));
+  c = fgetc(fp);
+  TEST_ASSERT_NOT_EQUAL(EOF, c);
+  TEST_ASSERT_EQUAL(0, fseek(fp, offset, SEEK_SET));
+  fputc(c ^ 1, fp);
+  TEST_ASSERT_EQUAL(0, fclose(fp));
+}
+
+static void testDeltaWithPaths(void)
+{
+  search("delta", "-x");
+  TEST_ASSERT_EQUAL(EXIT_SUCCESS, verify());
+  corrupt("555444-02.txt",
+          offsetAfter("555444-02.txt", "Solution signature "));
+  TEST_ASSERT_EQUAL(EXIT_FAILURE, verify());
+}
+
+static void testGraphmlWithoutPaths(void)
+{
+  search("graphml", NULL);
+  TEST_ASSERT_EQUAL(EXIT_SUCCESS, verify());
+  corrupt("555444-01/007.xml", 300);
+  TEST_ASSERT_EQUAL(EXIT_FAILURE, verify());
+}
+
+static void testBinaryWithoutPaths(void)
+{
+  search("bin", NULL);
+  TEST_ASSERT_EQUAL(EXIT_SUCCESS, verify());
+  corrupt("555444-02/variations.bin", 300);
+  TEST_ASSERT_EQUAL(EXIT_FAILURE, verify());
+}
+
+static void testArchiveWithPaths(void)
+{
+  search("archive", "-x");
+  TEST_ASSERT_EQUAL(EXIT_SUCCESS, verify());
+  corrupt("555444-01/variations.arc", 300);
+  TEST_ASSERT_EQUAL(EXIT_FAILURE, verify());
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(testDeltaWithPaths);
+  RUN_TEST(testGraphmlWithoutPaths);
+  RUN_TEST(testBinaryWithoutPaths);
+  RUN_TEST(testArchiveWithPaths);
+  return UNITY_END();
+}
@@ -0,0 +1,92 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "trace.h"
+
+#include "engine.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+struct traceEvent *TraceRing = NULL;
+uint64_t TraceCount = 0;
+static const char *TraceFile = NULL;
+
+/* write, until done or failing. */
+static void writeFully(int fd, const void *data, size_t size)
+{
+  const char *next = data;
+  while (size > 0) {
+    ssize_t written = write(fd, next, size);
+    if (written <= 0) {
+      return;
+    }
+    next += written;
+    size -= (size_t)written;
+  }
+}
+
+void traceWrite(void)
+{
+  uint32_t predicates = 0;
+  uint64_t capacity = TRACE_EVENTS, count = TraceCount;
+  int fd;
+  if (TraceRing == NULL) {
+    return;
+  }
+  fd = open(TraceFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return;
+  }
+  while (enginePredicateName(predicates) != NULL) {
+    predicates++;
+  }
+  writeFully(fd, TRACE_MAGIC, strlen(TRACE_MAGIC));
+  writeFully(fd, &predicates, sizeof(predicates));
+  for (uint32_t i = 0; i < predicates; i++) {
+    const char *name = enginePredicateName(i);
+    writeFully(fd, name, strlen(name) + 1);
+  }
+  writeFully(fd, &capacity, sizeof(capacity));
+  writeFully(fd, &count, sizeof(count));
+  writeFully(fd, TraceRing, sizeof(struct traceEvent) * TRACE_EVENTS);
+  close(fd);
+}
+
+static void onSignal(int number)
+{
+  traceWrite();
+  if (number != SIGUSR1) {
+    signal(number, SIG_DFL);
+    raise(number);
+  }
+}
+
+static void writeAtExit(void)
+{
+  traceWrite();
+}
+
+void traceStart(const char *filename)
+{
+  static const int signals[] = {SIGUSR1, SIGINT, SIGTERM, SIGABRT};
+  struct sigaction action;
+  TraceRing = calloc(TRACE_EVENTS, sizeof(struct traceEvent));
+  if (TraceRing == NULL) {
+    perror("trace");
+    exit(EXIT_FAILURE);
+  }
+  TraceFile = filename;
+  TraceCount = 0;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = onSignal;
+  action.sa_flags = SA_RESTART;
+  for (size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); i++) {
+    sigaction(signals[i], &action, NULL);
+  }
+  atexit(writeAtExit);
+}
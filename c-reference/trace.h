@@ -0,0 +1,61 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+/**
+ * A binary trace of the engine, cheap enough to leave on in long runs. The
+ * last TRACE_EVENTS calls, retries and failures are kept in a ring, which is
+ * written to a file when the run ends, when it is killed or aborts, and
+ * whenever it gets SIGUSR1. The tracedump program prints such a file in the
+ * same text as -t. Compiling with -DNO_TRACE removes all tracing from the
+ * engine, including -t.
+ */
+
+/* Must be a power of two */
+#define TRACE_EVENTS (1u << 22)
+#define TRACE_MAGIC "VTR1"
+
+enum traceKind { TRACE_CALL, TRACE_RETRY, TRACE_FAIL };
+#define TRACE_KIND_NAMES {"call", "retry", "fail"}
+
+struct traceEvent {
+  int32_t counter;   /* Engine counter of the stack entry */
+  uint16_t depth;    /* Depth of the stack entry */
+  uint8_t predicate; /* Index into the names in the file */
+  uint8_t kind;      /* enum traceKind */
+  int32_t round;
+  int32_t choice; /* Current choice, or -1 */
+};
+
+/*
+ * The file is: TRACE_MAGIC; a uint32_t count of predicates, and then their
+ * names, each terminated by a NUL; the uint64_t capacity of the ring, and the
+ * uint64_t number of events recorded; and then the ring itself, in which the
+ * next event would go at the count modulo the capacity.
+ */
+
+extern struct traceEvent *TraceRing; /* NULL when not tracing */
+extern uint64_t TraceCount;
+
+static inline void traceRecord(int counter, int depth, int predicate,
+                               enum traceKind kind, int round, int choice)
+{
+  struct traceEvent *event = TraceRing + (TraceCount++ & (TRACE_EVENTS - 1));
+  event->counter = counter;
+  event->depth = (uint16_t)depth;
+  event->predicate = (uint8_t)predicate;
+  event->kind = (uint8_t)kind;
+  event->round = round;
+  event->choice = choice;
+}
+
+/* Starts recording, to be written to filename */
+extern void traceStart(const char *filename);
+
+/* Writes the ring to the file; safe to call from a signal handler */
+extern void traceWrite(void);
+
+#endif  // TRACE_H
@@ -0,0 +1,94 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Prints a trace file written by venn -T, oldest event first, in the same
+ * text as venn -t.
+ */
+
+#define MAX_TRACE_PREDICATES 256
+#define MAX_NAME 256
+
+static void malformed(const char *filename)
+{
+  fprintf(stderr, "%s: malformed trace\n", filename);
+  exit(EXIT_FAILURE);
+}
+
+static char *readName(FILE *fp, const char *filename)
+{
+  char buffer[MAX_NAME];
+  int c, length = 0;
+  while ((c = getc(fp)) != 0) {
+    if (c == EOF || length == MAX_NAME - 1) {
+      malformed(filename);
+    }
+    buffer[length++] = (char)c;
+  }
+  buffer[length] = 0;
+  return strdup(buffer);
+}
+
+int main(int argc, char *argv[])
+{
+  static const char *const messages[] = TRACE_KIND_NAMES;
+  char *names[MAX_TRACE_PREDICATES];
+  char magic[sizeof(TRACE_MAGIC) - 1];
+  uint32_t predicates;
+  uint64_t capacity, count, first;
+  struct traceEvent *ring;
+  FILE *fp;
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s traceFile\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  fp = fopen(argv[1], "rb");
+  if (fp == NULL) {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+  if (fread(magic, sizeof(magic), 1, fp) != 1 ||
+      memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 ||
+      fread(&predicates, sizeof(predicates), 1, fp) != 1 ||
+      predicates > MAX_TRACE_PREDICATES) {
+    malformed(argv[1]);
+  }
+  for (uint32_t i = 0; i < predicates; i++) {
+    names[i] = readName(fp, argv[1]);
+  }
+  if (fread(&capacity, sizeof(capacity), 1, fp) != 1 ||
+      fread(&count, sizeof(count), 1, fp) != 1 || capacity == 0 ||
+      (capacity & (capacity - 1)) != 0) {
+    malformed(argv[1]);
+  }
+  ring = malloc(capacity * sizeof(struct traceEvent));
+  if (ring == NULL ||
+      fread(ring, sizeof(struct traceEvent), capacity, fp) != capacity) {
+    malformed(argv[1]);
+  }
+  /* Once the ring has wrapped, the oldest event is the next to go. */
+  first = count > capacity ? count - capacity : 0;
+  for (uint64_t i = first; i < count; i++) {
+    struct traceEvent *event = ring + (i & (capacity - 1));
+    if (event->predicate >= predicates || event->kind > TRACE_FAIL) {
+      malformed(argv[1]);
+    }
+    printf("%d:%d:", event->counter, event->depth);
+    if (event->choice >= 0) {
+      printf("%s(%d,%d) %s\n", messages[event->kind], event->round,
+             event->choice, names[event->predicate]);
+    } else {
+      printf("%s(%d) %s\n", messages[event->kind], event->round,
+             names[event->predicate]);
+    }
+  }
+  fclose(fp);
+  return EXIT_SUCCESS;
+}
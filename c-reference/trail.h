@@ -17,6 +17,14 @@ typedef struct trail *TRAIL; /* Opaque pointer to trail structure */
 /* Trail initialization */
 extern void initializeTrail(void); /* Initialize the trail system */
 extern void trailFreeze(void);     /* Freeze trail to prevent backtracking */
+extern uint64 trailCapacity(void); /* Reserved size, in the units of MaxTrail */
+
+/* Declare memory holding DYNAMIC fields, so that the trail can record its
+   changes compactly. Regions must be registered while the trail is empty;
+   changes elsewhere are still undone, using larger trail entries. Build with
+   -DTRAIL_CHECK, e.g. make ARCH_CFLAGS=-DTRAIL_CHECK, to assert that every
+   change is inside a registered region. */
+extern void trailRegisterDynamic(void *start, uint64 size);
 
 /* Value setting operations */
 extern void trailSetInt(
@@ -3,16 +3,11 @@
 #include "triangles.h"
 
 #include "edge.h"
+#include "geometry.h"
 #include "trail.h"
 #include "utils.h"
 #include "vertex.h"
 
-typedef struct {
-  uint64 linesCrossed;
-  uint64 initialLinesCrossed;
-  bool linesAreCrossed;
-} LineCrossingData;
-
 static int edgeIsCorner(EDGE edge, EDGE (*corners)[3])
 {
   int count = 0;
@@ -24,72 +19,77 @@ static int edgeIsCorner(EDGE edge, EDGE (*corners)[3])
   return count;
 }
 
-static void dynamicCheckRegularEdge(void *data, EDGE current, int line)
+/**
+ * Walks the triangle of color directly, rather than with triangleTraverse,
+ * since this is run for every choice of corners for a color. Each vertex of
+ * the path is labelled with the line of the triangle through it, the first
+ * time it is met; a line of another color that is met twice between two
+ * corners crosses this line twice, so the triangle cannot be drawn.
+ */
+bool dynamicTriangleLinesNotCrossed(COLOR color, EDGE (*corners)[3])
 {
-  LineCrossingData *lcd = (LineCrossingData *)data;
-  VERTEX vertex = current->to->vertex;
-
-  if (vertex->lineId == 0) {
-    trailSetInt(&vertex->lineId, 1 + current->color * 3 + line);
-  } else {
-    uint64 crossedLineAsBit = 1l << vertex->lineId;
-    if (lcd->linesCrossed & crossedLineAsBit) {
-      lcd->linesAreCrossed = true;
+  uint64 linesCrossed = 0;
+  uint64 initialLinesCrossed = 0;
+  int line = 0;
+  for (EDGE const *path = dynamicSolutionGeometry()->paths[color];
+       *path != NULL; path++) {
+    EDGE current = *path;
+    int cornerCount = edgeIsCorner(current->reversed, corners);
+    VERTEX vertex;
+    if (cornerCount > 0) {
+      if (line == 0) {
+        initialLinesCrossed = linesCrossed;
+      }
+      linesCrossed = 0;
+      if (cornerCount == 3) {
+        continue;
+      }
+      line = (line + cornerCount) % 3;
+    }
+    vertex = edgeVertex(current);
+    if (vertex->lineId == 0) {
+      trailSetInt(&vertex->lineId, 1 + current->color * 3 + line);
     } else {
-      lcd->linesCrossed |= crossedLineAsBit;
+      uint64 crossedLineAsBit = 1ull << vertex->lineId;
+      if (linesCrossed & crossedLineAsBit) {
+        return false;
+      }
+      linesCrossed |= crossedLineAsBit;
     }
   }
+  assert(line == 0);
+  return (linesCrossed & initialLinesCrossed) == 0;
 }
 
-static void dynamicCheckSingleCorner(void *data, EDGE current, int line)
-{
-  LineCrossingData *lcd = (LineCrossingData *)data;
-  if (line == 0) {
-    lcd->initialLinesCrossed = lcd->linesCrossed;
-  }
-  line = (line + 1) % 3;
-  lcd->linesCrossed = 0;
-  dynamicCheckRegularEdge(data, current, line);
-}
-
-static void dynamicCheckAdjacentCorners(void *data, EDGE current, int line)
-{
-  LineCrossingData *lcd = (LineCrossingData *)data;
-  if (line == 0) {
-    lcd->initialLinesCrossed = lcd->linesCrossed;
-  }
-  line = (line + 2) % 3;
-  lcd->linesCrossed = 0;
-  dynamicCheckRegularEdge(data, current, line);
-}
-
-static void checkAllCorners(void *data, EDGE current, int line)
-{
-  (void)current;
-  LineCrossingData *lcd = (LineCrossingData *)data;
-  if (line == 0) {
-    lcd->initialLinesCrossed = lcd->linesCrossed;
-  }
-  lcd->linesCrossed = 0;
-}
-
-bool dynamicTriangleLinesNotCrossed(COLOR color, EDGE (*corners)[3])
+/**
+ * Between two boundaries the path is all on one line of the triangle, so,
+ * as in dynamicTriangleLinesNotCrossed, the lines of earlier colors met there
+ * must all differ. Vertices are not labelled, leaving that to the full check.
+ */
+bool dynamicTriangleLinesNotCrossedBetween(COLOR color, uint64 boundaries)
 {
-  LineCrossingData lcd = {0, 0, false};
-  TriangleTraversalCallbacks dynamicCallbacks = {
-      .processRegularEdge = dynamicCheckRegularEdge,
-      .processSingleCorner = dynamicCheckSingleCorner,
-      .processAdjacentCorners = dynamicCheckAdjacentCorners,
-      .processAllCorners = checkAllCorners,
-      .processVertex = NULL};
-
-  triangleTraverse(color, corners, &dynamicCallbacks, &lcd);
-
-  if (lcd.linesCrossed & lcd.initialLinesCrossed) {
-    return false;
+  const struct solutionGeometry *geometry = dynamicSolutionGeometry();
+  EDGE const *path = geometry->paths[color];
+  int length = geometry->pathLengths[color];
+  uint64 linesCrossed = 0;
+  int start;
+  assert(boundaries != 0);
+  start = __builtin_ctzll(boundaries);
+  for (int ix = start; ix < start + length; ix++) {
+    int position = ix % length;
+    uint_trail lineId = edgeVertex(path[position])->lineId;
+    if (boundaries & (1ull << position)) {
+      linesCrossed = 0;
+    }
+    if (lineId != 0) {
+      uint64 crossedLineAsBit = 1ull << lineId;
+      if (linesCrossed & crossedLineAsBit) {
+        return false;
+      }
+      linesCrossed |= crossedLineAsBit;
+    }
   }
-
-  return !lcd.linesAreCrossed;
+  return true;
 }
 
 /**
@@ -105,14 +105,10 @@ bool dynamicTriangleLinesNotCrossed(COLOR color, EDGE (*corners)[3])
 void triangleTraverse(COLOR color, EDGE (*corners)[3],
                       TriangleTraversalCallbacks *callbacks, void *data)
 {
-  EDGE edge;
-  EDGE path[NFACES];
+  EDGE const *path = dynamicSolutionGeometry()->paths[color];
   EDGE current;
   int ix;
 
-  edge = vertexGetCentralEdge(color);
-  edgePathLength(edge, edgeFollowBackwards(edge), path);
-
   int line = 0;
   for (ix = 0; path[ix] != NULL; ix++) {
     current = path[ix];
@@ -144,7 +140,7 @@ void triangleTraverse(COLOR color, EDGE (*corners)[3],
     }
 
     if (callbacks->processVertex) {
-      callbacks->processVertex(data, current->to->vertex, color);
+      callbacks->processVertex(data, edgeVertex(current), color);
     }
   }
 
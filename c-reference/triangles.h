@@ -51,4 +51,15 @@ void triangleTraverse(COLOR color, EDGE (*corners)[3],
  */
 bool dynamicTriangleLinesNotCrossed(COLOR color, EDGE (*corners)[3]);
 
+/**
+ * Check if lines must cross within a triangle, whose corners are not all
+ * chosen.
+ *
+ * @param color Color of the triangle to check
+ * @param boundaries Bits, as in the solution geometry, of every edge that
+ * is, or could still be, a corner
+ * @return false if some line must cross another twice, true otherwise
+ */
+bool dynamicTriangleLinesNotCrossedBetween(COLOR color, uint64 boundaries);
+
 #endif /* TRIANGLES_H */
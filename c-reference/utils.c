@@ -6,15 +6,91 @@
 
 #include <stdlib.h>
 #include <unistd.h>
-#define USAGE_ONE_LINE                                                   \
-  "Usage: %s -f outputFolder [-d centralFaceDegrees] [-m maxSolutions] " \
-  "[-n maxVariantsPerSolution] [-k skipFirstSolutions] [-j "             \
-  "skipFirstVariantsPerSolution] [-v]\n"
+#define USAGE_ONE_LINE                                                    \
+  "Usage: %s -f outputFolder [-d centralFaceDegrees] [-m maxSolutions] "  \
+  "[-n maxVariantsPerSolution] [-k skipFirstSolutions] [-j "              \
+  "skipFirstVariantsPerSolution] [-P workers] [-S shard/shards[:depth]] " \
+  "[-M] [-c checkpointFile | -R checkpointFile] [-T traceFile] "          \
+  "[-O order] [-y symmetryDepth] [-u] [-i] [-W writers] [-F format] "  \
+  "[-z level] [-Q depth] [-H] [-E statisticsFile] "                      \
+  "[-A attributionFile] [-G samplesFile] [-I imageFile] [-b jobsFile] "    \
+  "[-x] [-r solution] [-v] | "                                           \
+  "-C [-d ...] [-m ...] ... | -J path [-d ...] [-m ...] ... | "          \
+  "-s address [-I imageFile] [-v] | -e probes[:seed] [-d ...] [-P ...] " \
+  "...\n"
 
 #define USAGE_WITH_D_EXPLANATION                                              \
   "When -d is specified, -m and -k apply to solutions with that face degree " \
   "pattern.\n"                                                                \
   "Otherwise, they apply globally across all face degree patterns.\n"         \
+  "Use -P to search with that many worker processes; with -P, -m and -k "     \
+  "need -d.\n"                                                                \
+  "Use -S to search one shard of several, without -m or -k; -M then merges\n" \
+  "the shard folders, once copied into one, into the serial results.\n"       \
+  "Use -c to checkpoint to a file every minute, and -R with the same other\n" \
+  "options to resume from it; neither can be used with -P or -M.\n"           \
+  "Use -T to keep a trace of the latest engine steps, written to the file\n"  \
+  "at the end, or on SIGUSR1, for reading with tracedump; not with -P.\n"    \
+  "Use -O to choose the search order: mrv, the default, takes the face\n"    \
+  "with fewest cycles; constraining also tries the cycles restricting most\n" \
+  "faces first; wdeg breaks ties, and orders cycles, by recent failures,\n"  \
+  "and not with -P, -S, -c or -R. -O all runs each, reporting the guesses.\n" \
+  "Use -y to check for symmetry after each of that many Venn choices,\n"    \
+  "rather than only for complete diagrams; 0 turns this off.\n"            \
+  "Use -u to save no solution of a class already saved in the folder, by\n"  \
+  "this or an earlier run, as listed in its .classes index.\n"             \
+  "Use -i to write no variant of a solution isomorphic to one already\n"   \
+  "written for it, counting those skipped; not with -C, -W or -e.\n"      \
+  "Use -C, instead of -f, to count the variations of each solution, with\n" \
+  "the corners that can be drawn, writing no files.\n"                    \
+  "Use -W to write the variants of each solution in up to that many\n"    \
+  "writer processes, while the search goes on; not with -P, -c, -R or -T.\n" \
+  "Use -F bin to write the variants of each solution to one compact file,\n" \
+  "variations.bin in its folder, from which variantgraphml writes the\n"   \
+  "GraphML files; -F archive writes the GraphML files of each solution\n"  \
+  "into one, variations.arc, indexed for variantextract; -F graphml, the\n" \
+  "default, writes each GraphML file on its own; -F delta writes only the\n" \
+  "paths of each solution, and the corners of each variation, to\n"       \
+  "variations.dlt, from which variantgraphml writes the GraphML too.\n"   \
+  "Use -z to write each GraphML file through gzip, at that level from 1 to\n" \
+  "9, as .xml.gz, reporting the compression ratio and throughput.\n"       \
+  "Use -Q to write the GraphML files in a thread of their own, queuing up\n" \
+  "to that many; only with -F graphml, and not with -W.\n"                \
+  "Use -J, instead of -f, to stream each solution, and each variation, as\n" \
+  "a line of JSON to that path, such as a named pipe, or, for -, stdout,\n" \
+  "with the other output going to stderr; no files are written.\n"      \
+  "Use -H to count the cycles, instructions, cache misses and branch\n"  \
+  "misses of each predicate, where the hardware counters can be opened;\n" \
+  "not with -P.\n"                                                      \
+  "Use -E to write the statistics to that file whenever they are logged,\n" \
+  "as JSON if it ends with .json, and otherwise as Prometheus text; not\n" \
+  "with -P.\n"                                                          \
+  "Use -A to count, for each face and cycle, the choices tried, those that\n" \
+  "failed, and the failures found at it, written to that file as CSV at\n" \
+  "the end; not with -P.\n"                                             \
+  "Use -G to sample the position of the search about every millisecond of\n" \
+  "CPU time, written to that file at the end as folded stacks, for\n"    \
+  "flamegraph.pl; not with -P.\n"                                        \
+  "Use -I to load the initialized state from that file, saving it there\n" \
+  "first if there is none, or it is from another build.\n"              \
+  "Use -b to run each line of that file, of degrees, or - for all, and\n" \
+  "then -k, -m, -j and -n, or - for no maximum, as a job of its own,\n"   \
+  "with the statistics of each, and then of all; -P runs that many jobs\n" \
+  "at once. Not with -d, -m, -k, -n, -j, -S, -M, -c, -R, -u or -W, or\n"  \
+  "those not with -P.\n"                                               \
+  "Use -e, instead of -f, to estimate the numbers of solutions and of\n"  \
+  "variations from that many random probes down the search, with the\n"  \
+  "seed, by default 1; -P runs the probes in that many processes.\n"    \
+  "Use -x to index, in a .paths file for each sequence of degrees in the\n" \
+  "folder, the choices to each solution found; not with -P, -S, -M, -b\n" \
+  "or -r.\n"                                                           \
+  "Use -r to save again the solution so named, such as 554544-06, and\n"   \
+  "its variants, with no search, from the choices to it in the .paths\n" \
+  "index that -x wrote in the folder; not with -d, -m, -k, -P, -S, -M,\n" \
+  "-c, -R, -u, -b or -W.\n"                                             \
+  "Use -s to initialize once, and then run each line of arguments read\n"  \
+  "from the Unix socket at that path, or, for -, stdin, as a job of its\n" \
+  "own, with its output, and then a line with its status, written back.\n" \
   "Use -v to enable verbose output mode.\n"
 
 /**
@@ -0,0 +1,110 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "variantarchive.h"
+
+#include "common.h"
+#include "stream.h"
+#include "utils.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static FILE *Archive = NULL;
+static char Filename[1024];
+static size_t FolderLength;
+static uint64_t Offset;
+static struct variantArchiveEntry *Index = NULL;
+static uint64_t Entries;
+static uint64_t Capacity = 0;
+/* Graphml.c writes one variation at a time. */
+static bool EntryOpen = false;
+
+static void writeFailed(void)
+{
+  perror(Filename);
+  exit(EXIT_FAILURE);
+}
+
+/* The variations are in the archive, not in folders of their own. */
+static void noFolder(const char *folder)
+{
+  (void)folder;
+}
+
+void variantArchiveStart(void)
+{
+  GraphmlFileOps.fopen = variantArchiveFopen;
+  GraphmlFileOps.initializeFolder = noFolder;
+}
+
+void variantArchiveOpen(const char *folder)
+{
+  assert(Archive == NULL);
+  initializeFolder(folder);
+  FolderLength = strlen(folder);
+  snprintf(Filename, sizeof(Filename), "%s/variations.arc", folder);
+  Archive = fopen(Filename, "wb");
+  if (Archive == NULL ||
+      fwrite(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC) - 1, 1, Archive) != 1) {
+    writeFailed();
+  }
+  Offset = sizeof(ARCHIVE_MAGIC) - 1;
+  Entries = 0;
+}
+
+static int archiveWrite(void *cookie, const char *buffer, int size)
+{
+  (void)cookie;
+  if (fwrite(buffer, 1, size, Archive) != (size_t)size) {
+    return -1;
+  }
+  Index[Entries].length += size;
+  Offset += size;
+  return size;
+}
+
+static int archiveClose(void *cookie)
+{
+  (void)cookie;
+  EntryOpen = false;
+  Entries++;
+  return 0;
+}
+
+FILE *variantArchiveFopen(const char *filename, const char *mode)
+{
+  struct variantArchiveEntry *entry;
+  assert(Archive != NULL && !EntryOpen);
+  assert(strncmp(filename, Filename, FolderLength) == 0);
+  assert(strlen(filename + FolderLength + 1) < sizeof(entry->name));
+  (void)mode;
+  if (Entries == Capacity) {
+    Capacity = Capacity == 0 ? 4096 : Capacity * 2;
+    Index = realloc(Index, Capacity * sizeof(*Index));
+    if (Index == NULL) {
+      perror("realloc");
+      exit(EXIT_FAILURE);
+    }
+  }
+  entry = Index + Entries;
+  memset(entry, 0, sizeof(*entry));
+  entry->offset = Offset;
+  strcpy(entry->name, filename + FolderLength + 1);
+  EntryOpen = true;
+  return streamOpen(NULL, archiveWrite, archiveClose);
+}
+
+void variantArchiveClose(void)
+{
+  struct variantArchiveTrailer trailer;
+  assert(Archive != NULL && !EntryOpen);
+  trailer.index = Offset;
+  trailer.entries = Entries;
+  memcpy(trailer.magic, ARCHIVE_MAGIC, sizeof(trailer.magic));
+  if (fwrite(Index, sizeof(*Index), Entries, Archive) != Entries ||
+      fwrite(&trailer, sizeof(trailer), 1, Archive) != 1 ||
+      fclose(Archive) != 0) {
+    writeFailed();
+  }
+  Archive = NULL;
+}
@@ -0,0 +1,48 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef VARIANTARCHIVE_H
+#define VARIANTARCHIVE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Writing all the GraphML files of a solution into one file (-F archive),
+ * variations.arc in the folder of the solution, rather than a file for each
+ * in folders for each 256. GraphmlFileOps is pointed here: each variation is
+ * appended as it is written, and an index at the end gives the name that
+ * each would have had, relative to the folder, with its offset and length.
+ * variantextract lists the variations in an archive and prints them.
+ *
+ * The file is the magic, the GraphML files one after another, the index, and
+ * last, a trailer ending with the magic again.
+ */
+
+/* The digit is the version of the format. */
+#define ARCHIVE_MAGIC "VENNARC1"
+
+struct variantArchiveEntry {
+  uint64_t offset;
+  uint64_t length;
+  char name[24]; /* e.g. 01/abc.xml, NUL-terminated */
+};
+
+struct variantArchiveTrailer {
+  uint64_t index; /* The offset of the first entry of the index */
+  uint64_t entries;
+  char magic[sizeof(ARCHIVE_MAGIC) - 1];
+};
+
+/* Points GraphmlFileOps at the archive. */
+extern void variantArchiveStart(void);
+
+/* Starts the archive of the solution in folder. */
+extern void variantArchiveOpen(const char *folder);
+
+/* Opens a variation, filename in the folder, to append to the archive. */
+extern FILE *variantArchiveFopen(const char *filename, const char *mode);
+
+/* Writes the index. */
+extern void variantArchiveClose(void);
+
+#endif  // VARIANTARCHIVE_H
@@ -0,0 +1,187 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "variantdedup.h"
+
+#include "s6.h"
+#include "statistics.h"
+#include "visible_for_testing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FNV-1a */
+#define FNV_OFFSET 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+/* A variant as the curve segment of each corner, sorted within each color. */
+typedef uint16_t VARIANT_KEY[NCOLORS][3];
+
+static struct automorphism Automorphisms[S6_MAX_AUTOMORPHISMS];
+static int AutomorphismCount = 1;
+
+/* The variants seen for the current solution: each of the Slots holds the
+ * hash of one, 0 for none, and where its key is in Keys. The tables are
+ * allocated for the first symmetric solution, and grow for a larger one. */
+static uint64 *Hashes = NULL;
+static uint32_t *KeyIndexes = NULL;
+static VARIANT_KEY *Keys = NULL;
+static uint32_t Slots = 0;
+static int HashCount = 0;
+static int Duplicates = 0;
+static uint64 DuplicateCounter = 0;
+
+void variantDedupStart(void)
+{
+  statisticIncludeInteger(&DuplicateCounter, "D", "duplicate variants",
+                          false);
+}
+
+void variantDedupSolution(void)
+{
+  variantDedupAutomorphisms(Automorphisms, s6Automorphisms(Automorphisms),
+                            searchCountVariations());
+}
+
+/* Room for the keys of the variations, the slots no more than three quarters
+ * full, up to VARIANT_DEDUP_SLOTS. */
+static void reserveSlots(int variations)
+{
+  uint32_t slots = 64;
+  while (slots < VARIANT_DEDUP_SLOTS && slots / 4 * 3 < (uint32_t)variations) {
+    slots *= 2;
+  }
+  if (slots <= Slots) {
+    if (HashCount > 0) {
+      memset(Hashes, 0, Slots * sizeof(*Hashes));
+    }
+    return;
+  }
+  free(Hashes);
+  free(KeyIndexes);
+  free(Keys);
+  Slots = slots;
+  Hashes = calloc(Slots, sizeof(*Hashes));
+  KeyIndexes = malloc(Slots * sizeof(*KeyIndexes));
+  Keys = malloc(Slots / 4 * 3 * sizeof(*Keys));
+  if (Hashes == NULL || KeyIndexes == NULL || Keys == NULL) {
+    perror("malloc");
+    exit(EXIT_FAILURE);
+  }
+}
+
+void variantDedupAutomorphisms(const struct automorphism *automorphisms,
+                               int count, int variations)
+{
+  AutomorphismCount = 0;
+  for (int i = 0; i < count; i++) {
+    /* A map taking the central face elsewhere takes the corners of the
+     * triangles to where none can be, and so to no variant. */
+    if (automorphisms[i].offset == 0) {
+      Automorphisms[AutomorphismCount++] = automorphisms[i];
+    }
+  }
+  if (AutomorphismCount > 1) {
+    reserveSlots(variations);
+  }
+  HashCount = 0;
+  Duplicates = 0;
+}
+
+/* The segment of color along the face with colors, named from the side
+ * inside the curve, as the corners of the other side are its images. */
+static uint16_t segment(COLORSET colors, COLOR color)
+{
+  return (colors | 1u << color) << 3 | (color + 1);
+}
+
+static COLORSET automorphismFace(const struct automorphism *automorphism,
+                                 COLORSET colors)
+{
+  COLORSET result = 0;
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    if (COLORSET_HAS_MEMBER(color, colors)) {
+      result |= 1u << automorphism->permutation[color];
+    }
+  }
+  return result ^ automorphism->offset;
+}
+
+static void sortCorners(uint16_t corners[3])
+{
+  for (int i = 1; i < 3; i++) {
+    for (int j = i; j > 0 && corners[j - 1] > corners[j]; j--) {
+      uint16_t swap = corners[j];
+      corners[j] = corners[j - 1];
+      corners[j - 1] = swap;
+    }
+  }
+}
+
+static void imageKey(const struct automorphism *automorphism,
+                     EDGE (*corners)[3], VARIANT_KEY key)
+{
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    COLOR image = automorphism->permutation[color];
+    for (int i = 0; i < 3; i++) {
+      key[image][i] =
+          segment(automorphismFace(automorphism, corners[color][i]->colors),
+                  image);
+    }
+  }
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    sortCorners(key[color]);
+  }
+}
+
+/* The least image of the variant, and its hash. */
+static uint64 canonicalKey(EDGE (*corners)[3], VARIANT_KEY best)
+{
+  VARIANT_KEY key;
+  const unsigned char *bytes = (const unsigned char *)best;
+  uint64 hash = FNV_OFFSET;
+  imageKey(&Automorphisms[0], corners, best);
+  for (int i = 1; i < AutomorphismCount; i++) {
+    imageKey(&Automorphisms[i], corners, key);
+    if (memcmp(key, best, sizeof(key)) < 0) {
+      memcpy(best, key, sizeof(key));
+    }
+  }
+  for (size_t i = 0; i < sizeof(VARIANT_KEY); i++) {
+    hash ^= bytes[i];
+    hash *= FNV_PRIME;
+  }
+  return hash == 0 ? 1 : hash;
+}
+
+bool variantDedupSeen(EDGE (*corners)[3])
+{
+  VARIANT_KEY key;
+  uint64 hash;
+  uint32_t slot;
+  if (AutomorphismCount == 1) {
+    return false;
+  }
+  hash = canonicalKey(corners, key);
+  for (slot = hash & (Slots - 1); Hashes[slot] != 0;
+       slot = (slot + 1) & (Slots - 1)) {
+    if (Hashes[slot] == hash &&
+        memcmp(Keys[KeyIndexes[slot]], key, sizeof(key)) == 0) {
+      Duplicates++;
+      DuplicateCounter++;
+      return true;
+    }
+  }
+  if (HashCount < (int)(Slots / 4 * 3)) {
+    Hashes[slot] = hash;
+    KeyIndexes[slot] = HashCount;
+    memcpy(Keys[HashCount], key, sizeof(key));
+    HashCount++;
+  }
+  return false;
+}
+
+int variantDedupDuplicates(void)
+{
+  return Duplicates;
+}
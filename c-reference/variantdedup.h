@@ -0,0 +1,40 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef VARIANTDEDUP_H
+#define VARIANTDEDUP_H
+
+#include "edge.h"
+
+/**
+ * Skipping, with -i, the variants of a solution that are isomorphic to one
+ * already written for it. A symmetric solution has maps onto itself, found
+ * by s6Automorphisms, and each that keeps the central face takes a choice
+ * of corners to another drawing of the same diagram. A variant is named by
+ * the curve segments of its corners, and so by the least, in memcmp order,
+ * of its images under the maps; that key is kept, under its hash, in a set
+ * sized to the variations of the solution, of up to VARIANT_DEDUP_SLOTS, and
+ * a variant is a duplicate only if its key is already there. Should the set
+ * become three quarters full, as it does not for any solution of six curves,
+ * the later variants are only checked against those in it. A solution with
+ * no symmetry is not checked at all, and no set is allocated for it.
+ */
+
+/* The most slots of the set, a power of two. */
+#define VARIANT_DEDUP_SLOTS (1 << 20)
+
+/* Counts the duplicates in the statistics. */
+extern void variantDedupStart(void);
+
+/* Finds the maps of the current solution, and forgets earlier variants. */
+extern void variantDedupSolution(void);
+
+/**
+ * Whether a variant isomorphic to the one with these corners has already
+ * been seen for the current solution; if not, it is now.
+ */
+extern bool variantDedupSeen(EDGE (*corners)[3]);
+
+/* The variants of the current solution skipped as duplicates. */
+extern int variantDedupDuplicates(void);
+
+#endif  // VARIANTDEDUP_H
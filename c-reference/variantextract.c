@@ -0,0 +1,97 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "variantarchive.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Lists the variations in a variations.arc written by venn -F archive, or,
+ * given their names, such as 01/abc.xml, prints them, with the same text as
+ * the GraphML files venn writes without -F archive.
+ */
+
+static const char *Filename;
+
+static void malformed(void)
+{
+  fprintf(stderr, "%s: malformed archive\n", Filename);
+  exit(EXIT_FAILURE);
+}
+
+static void printEntry(FILE *fp, struct variantArchiveEntry *entry)
+{
+  char buffer[65536];
+  uint64_t remaining = entry->length;
+  if (fseek(fp, (long)entry->offset, SEEK_SET) != 0) {
+    malformed();
+  }
+  while (remaining > 0) {
+    size_t size = remaining < sizeof(buffer) ? remaining : sizeof(buffer);
+    if (fread(buffer, 1, size, fp) != size) {
+      malformed();
+    }
+    fwrite(buffer, 1, size, stdout);
+    remaining -= size;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  struct variantArchiveTrailer trailer;
+  struct variantArchiveEntry *index;
+  char magic[sizeof(ARCHIVE_MAGIC) - 1];
+  FILE *fp;
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s folder/variations.arc [name ...]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  Filename = argv[1];
+  fp = fopen(Filename, "rb");
+  if (fp == NULL) {
+    perror(Filename);
+    return EXIT_FAILURE;
+  }
+  if (fread(magic, sizeof(magic), 1, fp) != 1 ||
+      memcmp(magic, ARCHIVE_MAGIC, sizeof(magic)) != 0 ||
+      fseek(fp, -(long)sizeof(trailer), SEEK_END) != 0 ||
+      fread(&trailer, sizeof(trailer), 1, fp) != 1 ||
+      memcmp(trailer.magic, ARCHIVE_MAGIC, sizeof(magic)) != 0 ||
+      trailer.entries > (1u << 24)) {
+    malformed();
+  }
+  index = malloc(trailer.entries * sizeof(*index) + 1);
+  if (index == NULL || fseek(fp, (long)trailer.index, SEEK_SET) != 0 ||
+      fread(index, sizeof(*index), trailer.entries, fp) != trailer.entries) {
+    malformed();
+  }
+  for (uint64_t i = 0; i < trailer.entries; i++) {
+    if (index[i].name[sizeof(index[i].name) - 1] != '\0' ||
+        index[i].offset + index[i].length > trailer.index) {
+      malformed();
+    }
+  }
+  if (argc == 2) {
+    for (uint64_t i = 0; i < trailer.entries; i++) {
+      printf("%s %llu\n", index[i].name,
+             (unsigned long long)index[i].length);
+    }
+  }
+  for (int arg = 2; arg < argc; arg++) {
+    uint64_t i;
+    for (i = 0; i < trailer.entries; i++) {
+      if (strcmp(index[i].name, argv[arg]) == 0) {
+        printEntry(fp, index + i);
+        break;
+      }
+    }
+    if (i == trailer.entries) {
+      fprintf(stderr, "%s: no %s\n", Filename, argv[arg]);
+      return EXIT_FAILURE;
+    }
+  }
+  fclose(fp);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "variantfile.h"
+
+#include "common.h"
+#include "geometry.h"
+#include "mappedfile.h"
+#include "vertex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Enough for the nodes and edges of a variation of six curves. */
+#define MAX_VARIANT_ELEMENTS 1024
+#define MAX_VARIANT_VERTICES VARIANT_CORNER_ENDPOINT(0)
+
+static struct mappedFile File;
+static bool FileOpen = false;
+static char Filename[1024];
+static struct variantFileHeader Header;
+/* The vertices in the order they first appear in the first record. */
+static VERTEX Vertices[MAX_VARIANT_VERTICES];
+static uint32_t VariationNumber;
+static struct variantElement Record[MAX_VARIANT_ELEMENTS];
+static uint32_t RecordLength;
+static uint32_t Records;
+static struct variantIndexEntry *Index = NULL;
+static uint32_t IndexCapacity = 0;
+
+static void openFile(const char *folder, const char *name)
+{
+  assert(!FileOpen);
+  snprintf(Filename, sizeof(Filename), "%s/%s", folder, name);
+  mappedOpen(&File, Filename);
+  FileOpen = true;
+  Header.vertices = 0;
+  Records = 0;
+}
+
+/* Starts a record, at the end of the file, adding it to the index. */
+static void writeVariationNumber(uint32_t variationNumber)
+{
+  if (Records == IndexCapacity) {
+    IndexCapacity = IndexCapacity == 0 ? 4096 : IndexCapacity * 2;
+    Index = realloc(Index, IndexCapacity * sizeof(*Index));
+    if (Index == NULL) {
+      perror("realloc");
+      exit(EXIT_FAILURE);
+    }
+  }
+  assert(File.length <= UINT32_MAX);
+  Index[Records].variationNumber = variationNumber;
+  Index[Records].offset = File.length;
+  Records++;
+  mappedWrite(&File, &variationNumber, sizeof(variationNumber));
+}
+
+static void closeFile(const char *magic)
+{
+  struct variantTrailer trailer;
+  trailer.index = File.length;
+  trailer.records = Records;
+  memcpy(trailer.magic, magic, sizeof(trailer.magic));
+  mappedWrite(&File, Index, Records * sizeof(*Index));
+  mappedWrite(&File, &trailer, sizeof(trailer));
+  mappedClose(&File);
+  FileOpen = false;
+}
+
+void variantFileOpen(const char *folder, int levels)
+{
+  openFile(folder, "variations.bin");
+  memset(&Header, 0, sizeof(Header));
+  memcpy(Header.magic, VARIANT_MAGIC, sizeof(Header.magic));
+  Header.colors = NCOLORS;
+  Header.levels = levels;
+}
+
+void variantFileBegin(int variationNumber)
+{
+  assert(FileOpen);
+  VariationNumber = variationNumber;
+  RecordLength = 0;
+}
+
+static struct variantElement *addElement(enum variantElementKind kind,
+                                         int color)
+{
+  struct variantElement *element;
+  assert(RecordLength < MAX_VARIANT_ELEMENTS);
+  element = Record + RecordLength++;
+  element->kind = kind;
+  element->color = color;
+  element->line = element->from = element->to = 0;
+  return element;
+}
+
+/* The vertices are the same in every variation, so all are in the table
+ * after the first. */
+static int vertexIndex(VERTEX vertex)
+{
+  uint32_t i;
+  for (i = 0; i < Header.vertices; i++) {
+    if (Vertices[i] == vertex) {
+      return i;
+    }
+  }
+  assert(Records == 0);
+  assert(Header.vertices < MAX_VARIANT_VERTICES);
+  Vertices[Header.vertices++] = vertex;
+  return i;
+}
+
+static int endpoint(struct variantEndpoint end)
+{
+  if (end.vertex == NULL) {
+    assert(end.corner >= 0 && end.corner < 3);
+    return VARIANT_CORNER_ENDPOINT(end.corner);
+  }
+  return vertexIndex(end.vertex);
+}
+
+void variantFileVertex(VERTEX vertex)
+{
+  addElement(VARIANT_VERTEX, vertex->primary)->from = vertexIndex(vertex);
+}
+
+void variantFileCorner(EDGE edge, int color, int counter)
+{
+  struct variantElement *element = addElement(VARIANT_CORNER, color);
+  element->line = counter;
+  element->from = edge->colors | (1u << color);
+}
+
+void variantFileEdge(int color, int line, struct variantEndpoint source,
+                     struct variantEndpoint target)
+{
+  struct variantElement *element = addElement(VARIANT_EDGE, color);
+  element->line = line;
+  element->from = endpoint(source);
+  element->to = endpoint(target);
+}
+
+static void writeVertexTable(void)
+{
+  struct variantVertex table[MAX_VARIANT_VERTICES];
+  for (uint32_t i = 0; i < Header.vertices; i++) {
+    VERTEX vertex = Vertices[i];
+    table[i].colors = vertex->incomingEdges[0]->colors |
+                      (1u << vertex->primary) | (1u << vertex->secondary);
+    table[i].primary = vertex->primary;
+    table[i].secondary = vertex->secondary;
+  }
+  mappedWrite(&File, table, Header.vertices * sizeof(table[0]));
+}
+
+static void writeHeader(void)
+{
+  mappedWrite(&File, &Header, sizeof(Header));
+  writeVertexTable();
+}
+
+void variantFileEnd(void)
+{
+  if (Records == 0) {
+    Header.elements = RecordLength;
+    writeHeader();
+  }
+  assert(RecordLength == Header.elements);
+  writeVariationNumber(VariationNumber);
+  mappedWrite(&File, Record, RecordLength * sizeof(Record[0]));
+}
+
+void variantFileClose(void)
+{
+  assert(FileOpen);
+  if (Records == 0) {
+    writeHeader();
+  }
+  closeFile(VARIANT_MAGIC);
+}
+
+void variantDeltaOpen(const char *folder, int levels)
+{
+  const struct solutionGeometry *geometry = dynamicSolutionGeometry();
+  struct variantDeltaHeader header;
+  struct variantDeltaStep steps[NFACES];
+  openFile(folder, "variations.dlt");
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, DELTA_MAGIC, sizeof(header.magic));
+  header.colors = NCOLORS;
+  header.levels = levels;
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    header.pathLengths[color] = geometry->pathLengths[color];
+    for (int ix = 0; ix < geometry->pathLengths[color]; ix++) {
+      vertexIndex(edgeVertex(geometry->paths[color][ix]));
+    }
+  }
+  header.vertices = Header.vertices;
+  mappedWrite(&File, &header, sizeof(header));
+  writeVertexTable();
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    int length = geometry->pathLengths[color];
+    for (int ix = 0; ix < length; ix++) {
+      EDGE edge = geometry->paths[color][ix];
+      steps[ix].source = vertexIndex(edgeVertex(edge->reversed));
+      steps[ix].target = vertexIndex(edgeVertex(edge));
+      steps[ix].flags =
+          (IS_CLOCKWISE_EDGE(edge) ? DELTA_CLOCKWISE : 0) |
+          (edgeVertex(edge)->primary == color ? DELTA_PRIMARY : 0);
+      steps[ix].cornerColors = edge->reversed->colors | (1u << color);
+    }
+    mappedWrite(&File, steps, length * sizeof(steps[0]));
+  }
+}
+
+void variantDeltaWrite(int variationNumber, EDGE (*corners)[3])
+{
+  const struct solutionGeometry *geometry = dynamicSolutionGeometry();
+  uint8_t steps[NCOLORS][3];
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    for (int i = 0; i < 3; i++) {
+      int ix = 0;
+      while (geometry->paths[color][ix]->reversed != corners[color][i]) {
+        ix++;
+        assert(ix < geometry->pathLengths[color]);
+      }
+      steps[color][i] = ix;
+    }
+  }
+  writeVariationNumber(variationNumber);
+  mappedWrite(&File, steps, sizeof(steps));
+}
+
+void variantDeltaClose(void)
+{
+  closeFile(DELTA_MAGIC);
+}
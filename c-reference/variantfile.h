@@ -0,0 +1,143 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef VARIANTFILE_H
+#define VARIANTFILE_H
+
+#include <stdint.h>
+
+/**
+ * A compact binary alternative to GraphML for the variations of a solution
+ * (-F bin). Rather than a GraphML file for each, the variations are written
+ * to one file, variations.bin, in the folder of the solution, from which
+ * variantgraphml writes the GraphML files that venn would have written.
+ *
+ * The file is a header, a table of the vertices of the solution, and then a
+ * record for each variation: its number, and the nodes and edges of its
+ * GraphML, in the same order, as elements of a fixed size. Each record of a
+ * file has the same number of elements. The file ends with an index of the
+ * records, and a trailer locating it, so that a reader can map the file and
+ * go straight to any variation. The folder of the file, from CurrentPrefixIPC,
+ * gives the face degrees and the number of the solution.
+ *
+ * The files are written through mappedfile.h, not stdio.
+ */
+
+/* The digit is the version of the format. */
+#define VARIANT_MAGIC "VENNVAR2"
+
+struct variantFileHeader {
+  char magic[sizeof(VARIANT_MAGIC) - 1];
+  uint32_t colors;   /* NCOLORS */
+  uint32_t levels;   /* Of folders for the GraphML files, as LevelsIPC */
+  uint32_t vertices; /* In the table */
+  uint32_t elements; /* In each record */
+};
+
+struct variantVertex {
+  uint8_t colors; /* The face colors in the id of the vertex */
+  uint8_t primary;
+  uint8_t secondary;
+};
+
+enum variantElementKind {
+  VARIANT_EDGE,   /* color, line, from and to, each a vertex or a corner */
+  VARIANT_VERTEX, /* from is the index of the vertex in the table */
+  VARIANT_CORNER, /* line is the counter of the corner, from its colors */
+};
+
+/* The endpoint of an edge for its corner with the given counter; lower
+ * endpoints are indexes in the vertex table. */
+#define VARIANT_CORNER_ENDPOINT(counter) (0xF0 + (counter))
+
+struct variantElement {
+  uint8_t kind; /* enum variantElementKind */
+  uint8_t color;
+  uint8_t line;
+  uint8_t from;
+  uint8_t to;
+};
+
+/* Each record is the variation number, a uint32_t, then its elements. */
+
+/* For each record, in order. */
+struct variantIndexEntry {
+  uint32_t variationNumber;
+  uint32_t offset; /* Of the record in the file */
+};
+
+/* The last bytes of the file, after the index. */
+struct variantTrailer {
+  uint64_t index; /* The offset of the index */
+  uint64_t records;
+  char magic[sizeof(VARIANT_MAGIC) - 1]; /* Of the file, again */
+};
+
+struct Vertex;
+struct edge;
+
+/* The end of an edge: a vertex, or, if vertex is NULL, the corner with
+ * that counter of the color of the edge. */
+struct variantEndpoint {
+  struct Vertex *vertex;
+  int corner;
+};
+
+/* Starts writing variations to the file in folder. */
+extern void variantFileOpen(const char *folder, int levels);
+
+/* Starts the record of the given variation. */
+extern void variantFileBegin(int variationNumber);
+
+extern void variantFileVertex(struct Vertex *vertex);
+extern void variantFileCorner(struct edge *edge, int color, int counter);
+extern void variantFileEdge(int color, int line, struct variantEndpoint source,
+                            struct variantEndpoint target);
+
+/* Writes the record. */
+extern void variantFileEnd(void);
+
+extern void variantFileClose(void);
+
+/**
+ * The delta format (-F delta), variations.dlt, is smaller again: the header
+ * and vertex table, then, once, the path of each color as geometry.c finds
+ * it, and for each variation only which steps of those paths are its
+ * corners. variantgraphml walks the paths as triangles.c does, to write the
+ * same GraphML. It ends with an index and trailer as variations.bin does.
+ */
+
+#define DELTA_MAGIC "VENNDLT2"
+#define MAX_DELTA_COLORS 8
+
+struct variantDeltaHeader {
+  char magic[sizeof(DELTA_MAGIC) - 1];
+  uint32_t colors;
+  uint32_t levels;
+  uint32_t vertices;
+  uint32_t pathLengths[MAX_DELTA_COLORS];
+};
+
+/* The vertex table follows, then the steps of each path in turn. */
+
+/* An edge of a path, from the vertex source to the vertex target. */
+struct variantDeltaStep {
+  uint8_t source;
+  uint8_t target;
+  uint8_t flags;
+  uint8_t cornerColors; /* Of a corner on the step */
+};
+
+#define DELTA_CLOCKWISE 1 /* The edge, rather than its reverse, is clockwise */
+#define DELTA_PRIMARY 2   /* The target is a vertex of the color */
+
+/* Each record is the variation number, a uint32_t, then for each color the
+ * steps of its three corners, a uint8_t each, in the order chosen. */
+
+/* Starts writing the variations of the current solution to folder. */
+extern void variantDeltaOpen(const char *folder, int levels);
+
+extern void variantDeltaWrite(int variationNumber, struct edge *(*corners)[3]);
+
+extern void variantDeltaClose(void);
+
+#endif  // VARIANTFILE_H
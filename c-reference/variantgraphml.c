@@ -0,0 +1,490 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "variantfile.h"
+
+#include <sys/stat.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Writes the GraphML files for the variations in a variations.bin or
+ * variations.dlt, written by venn -F bin or -F delta, in its folder, with the
+ * same names and text as venn -F graphml. Given variation numbers, it prints
+ * just those instead, finding them in the index at the end of the file.
+ */
+
+#define MAX_PATH 1024
+#define MAX_ELEMENTS 1024
+
+static const char *Filename;
+static struct variantFileHeader Header;
+static struct variantVertex *Vertices;
+static char Folder[MAX_PATH];
+static int WantedCount;
+static char **Wanted;
+static struct variantDeltaStep *Steps[MAX_DELTA_COLORS];
+static uint32_t PathLengths[MAX_DELTA_COLORS];
+static struct variantIndexEntry *Index;
+static uint64_t Records;
+static uint64_t NextRecord = 0;
+
+static void malformed(void)
+{
+  fprintf(stderr, "%s: malformed variations\n", Filename);
+  exit(EXIT_FAILURE);
+}
+
+static void makeFolder(const char *folder)
+{
+  if (mkdir(folder, 0700) != 0 && errno != EEXIST) {
+    perror(folder);
+    exit(EXIT_FAILURE);
+  }
+}
+
+static const char *colorSetString(unsigned colors)
+{
+  static char buffer[16];
+  char *p = buffer;
+  for (uint32_t i = 0; i < Header.colors; i++) {
+    if (colors & (1u << i)) {
+      *p++ = 'a' + i;
+    }
+  }
+  *p = '\0';
+  return buffer;
+}
+
+/* As in graphml.c, vertices are p_<colors>_<primary>_<secondary> and
+ * corners are <color>_<counter>. */
+static void printEndpoint(FILE *fp, int color, int end)
+{
+  if (end >= VARIANT_CORNER_ENDPOINT(0)) {
+    fprintf(fp, "%c_%d", 'a' + color, end - VARIANT_CORNER_ENDPOINT(0));
+  } else {
+    struct variantVertex *vertex = Vertices + end;
+    fprintf(fp, "p_%s_%c_%c", colorSetString(vertex->colors),
+            'a' + vertex->primary, 'a' + vertex->secondary);
+  }
+}
+
+static void printNode(FILE *fp, int colors, int primary, int secondary)
+{
+  fprintf(fp, "\">\n");
+  fprintf(fp, "      <data key=\"colors\">%s</data>\n", colorSetString(colors));
+  fprintf(fp, "      <data key=\"primary\">%c</data>\n", 'a' + primary);
+  fprintf(fp, "      <data key=\"secondary\">%c</data>\n", 'a' + secondary);
+  fprintf(fp, "    </node>\n");
+}
+
+static void printElement(FILE *fp, struct variantElement *element)
+{
+  struct variantVertex *vertex;
+  switch (element->kind) {
+    case VARIANT_EDGE:
+      fprintf(fp, "    <edge source=\"");
+      printEndpoint(fp, element->color, element->from);
+      fprintf(fp, "\" target=\"");
+      printEndpoint(fp, element->color, element->to);
+      fprintf(fp, "\">\n");
+      fprintf(fp, "      <data key=\"color\">%c</data>\n", 'a' + element->color);
+      fprintf(fp, "      <data key=\"line\">%c%d</data>\n",
+              'a' + element->color, element->line);
+      fprintf(fp, "    </edge>\n");
+      break;
+    case VARIANT_VERTEX:
+      vertex = Vertices + element->from;
+      fprintf(fp, "    <node id=\"");
+      printEndpoint(fp, element->color, element->from);
+      printNode(fp, vertex->colors, vertex->primary, vertex->secondary);
+      break;
+    case VARIANT_CORNER:
+      fprintf(fp, "    <node id=\"");
+      printEndpoint(fp, element->color,
+                    VARIANT_CORNER_ENDPOINT(element->line));
+      printNode(fp, element->from, element->color, element->color);
+      break;
+  }
+}
+
+/* The same text as graphmlBegin in graphml.c. */
+static void printBegin(FILE *fp)
+{
+  static const char *ns = "http://graphml.graphdrawing.org/xmlns";
+  fprintf(fp, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+  fprintf(fp, "<graphml xmlns=\"%s\"\n", ns);
+  fprintf(fp,
+          "         xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n");
+  fprintf(fp, "         xsi:schemaLocation=\"%s %s\">\n", ns,
+          "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd");
+  fprintf(fp,
+          "  <key id=\"colors\" for=\"node\" attr.name=\"colors\" "
+          "attr.type=\"string\"/>\n");
+  fprintf(fp,
+          "  <key id=\"primary\" for=\"node\" attr.name=\"primary\" "
+          "attr.type=\"string\"/>\n");
+  fprintf(fp,
+          "  <key id=\"secondary\" for=\"node\" attr.name=\"secondary\" "
+          "attr.type=\"string\"/>\n");
+  fprintf(fp,
+          "  <key id=\"color\" for=\"edge\" attr.name=\"color\" "
+          "attr.type=\"string\"/>\n");
+  fprintf(fp,
+          "  <key id=\"line\" for=\"edge\" attr.name=\"line\" "
+          "attr.type=\"string\"/>\n");
+  fprintf(fp, "  <graph id=\"venn_diagram\" edgedefault=\"undirected\">\n");
+}
+
+/* As subFilename in graphml.c, making the folders as need be. */
+static void variationFilename(char *buffer, const char *folder,
+                              uint32_t variationNumber)
+{
+  char *p = buffer + sprintf(buffer, "%s", folder);
+  for (uint32_t levels = Header.levels; levels > 1; levels--) {
+    p += sprintf(p, "/%2.2x", variationNumber % 256);
+    makeFolder(buffer);
+    variationNumber /= 256;
+  }
+  sprintf(p, "/%3.3x.xml", variationNumber);
+}
+
+static void checkElement(struct variantElement *element)
+{
+  int vertices = VARIANT_CORNER_ENDPOINT(0);
+  if (element->color >= Header.colors) {
+    malformed();
+  }
+  switch (element->kind) {
+    case VARIANT_EDGE:
+      if ((element->from < vertices && element->from >= Header.vertices) ||
+          (element->to < vertices && element->to >= Header.vertices) ||
+          element->from > VARIANT_CORNER_ENDPOINT(2) ||
+          element->to > VARIANT_CORNER_ENDPOINT(2)) {
+        malformed();
+      }
+      break;
+    case VARIANT_VERTEX:
+      if (element->from >= Header.vertices) {
+        malformed();
+      }
+      break;
+    case VARIANT_CORNER:
+      if (element->line > 2) {
+        malformed();
+      }
+      break;
+    default:
+      malformed();
+  }
+}
+
+static bool wanted(uint32_t variationNumber)
+{
+  if (WantedCount == 0) {
+    return true;
+  }
+  for (int i = 0; i < WantedCount; i++) {
+    if (strtoul(Wanted[i], NULL, 10) == variationNumber) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* To its file, or, if some variations were asked for, to stdout. */
+static void writeVariation(uint32_t variationNumber,
+                           struct variantElement *record, uint32_t elements)
+{
+  char path[MAX_PATH];
+  FILE *out = stdout;
+  if (!wanted(variationNumber)) {
+    return;
+  }
+  if (WantedCount == 0) {
+    variationFilename(path, Folder, variationNumber);
+    out = fopen(path, "w");
+    if (out == NULL) {
+      perror(path);
+      exit(EXIT_FAILURE);
+    }
+  }
+  printBegin(out);
+  for (uint32_t i = 0; i < elements; i++) {
+    checkElement(record + i);
+    printElement(out, record + i);
+  }
+  fprintf(out, "  </graph>\n");
+  fprintf(out, "</graphml>\n");
+  if (out != stdout && fclose(out) != 0) {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Reads the index, leaving fp where it was. */
+static void readIndex(FILE *fp)
+{
+  struct variantTrailer trailer;
+  long position = ftell(fp);
+  if (fseek(fp, -(long)sizeof(trailer), SEEK_END) != 0 ||
+      fread(&trailer, sizeof(trailer), 1, fp) != 1 ||
+      memcmp(trailer.magic, Header.magic, sizeof(trailer.magic)) != 0 ||
+      trailer.records > (1u << 24)) {
+    malformed();
+  }
+  Records = trailer.records;
+  Index = malloc(Records * sizeof(*Index) + 1);
+  if (Index == NULL || fseek(fp, (long)trailer.index, SEEK_SET) != 0 ||
+      fread(Index, sizeof(*Index), Records, fp) != Records) {
+    malformed();
+  }
+  for (uint64_t i = 0; i < Records; i++) {
+    if (Index[i].offset < (uint64_t)position ||
+        Index[i].offset >= trailer.index) {
+      malformed();
+    }
+  }
+  if (fseek(fp, position, SEEK_SET) != 0) {
+    malformed();
+  }
+}
+
+/* Moves fp to the next wanted record, after its variation number. */
+static bool nextRecord(FILE *fp, uint32_t *variationNumber)
+{
+  while (NextRecord < Records && !wanted(Index[NextRecord].variationNumber)) {
+    NextRecord++;
+  }
+  if (NextRecord == Records) {
+    return false;
+  }
+  if (fseek(fp, (long)Index[NextRecord].offset, SEEK_SET) != 0 ||
+      fread(variationNumber, sizeof(*variationNumber), 1, fp) != 1 ||
+      *variationNumber != Index[NextRecord].variationNumber) {
+    malformed();
+  }
+  NextRecord++;
+  return true;
+}
+
+static void readVertices(FILE *fp)
+{
+  if (Header.colors > MAX_DELTA_COLORS ||
+      Header.vertices > VARIANT_CORNER_ENDPOINT(0) || Header.levels > 4) {
+    malformed();
+  }
+  Vertices = malloc(Header.vertices * sizeof(struct variantVertex) + 1);
+  if (Vertices == NULL ||
+      fread(Vertices, sizeof(struct variantVertex), Header.vertices, fp) !=
+          Header.vertices) {
+    malformed();
+  }
+}
+
+static void readVariantFile(FILE *fp)
+{
+  struct variantElement *record;
+  uint32_t variationNumber;
+  if (fread((char *)&Header + sizeof(Header.magic),
+            sizeof(Header) - sizeof(Header.magic), 1, fp) != 1) {
+    malformed();
+  }
+  readVertices(fp);
+  readIndex(fp);
+  record = malloc(Header.elements * sizeof(struct variantElement) + 1);
+  if (record == NULL) {
+    malformed();
+  }
+  while (nextRecord(fp, &variationNumber)) {
+    if (fread(record, sizeof(struct variantElement), Header.elements, fp) !=
+        Header.elements) {
+      malformed();
+    }
+    writeVariation(variationNumber, record, Header.elements);
+  }
+}
+
+static struct variantElement *addElement(struct variantElement *record,
+                                         uint32_t *length, int kind,
+                                         int color, int line, int from, int to)
+{
+  struct variantElement *element = record + (*length)++;
+  if (*length > MAX_ELEMENTS) {
+    malformed();
+  }
+  element->kind = kind;
+  element->color = color;
+  element->line = line;
+  element->from = from;
+  element->to = to;
+  return element;
+}
+
+#define EDGE(line, from, to) \
+  addElement(record, &length, VARIANT_EDGE, color, line, from, to)
+#define CORNER(counter) VARIANT_CORNER_ENDPOINT(counter)
+
+/**
+ * The nodes and edges of the triangles with the given corners, in the order
+ * that saveTriangle in graphml.c writes them, following triangleTraverse.
+ */
+static uint32_t materialize(uint8_t (*corners)[3],
+                            struct variantElement *record)
+{
+  uint32_t length = 0;
+  for (uint32_t color = 0; color < Header.colors; color++) {
+    int cornerIds[3] = {-1, -1, -1};
+    int cornerIx = 0, line = 0;
+    for (uint32_t ix = 0; ix < PathLengths[color]; ix++) {
+      struct variantDeltaStep *step = Steps[color] + ix;
+      int count = (corners[color][0] == ix) + (corners[color][1] == ix) +
+                  (corners[color][2] == ix);
+      if (cornerIx + count > 3) {
+        malformed();
+      }
+      switch (count) {
+        case 0:
+          if (step->flags & DELTA_CLOCKWISE) {
+            EDGE(line, step->source, step->target);
+          } else {
+            EDGE(line, step->target, step->source);
+          }
+          break;
+        case 1:
+          cornerIds[cornerIx] = line == 0 ? 2 : line == 1 ? 0 : 1;
+          EDGE(line, step->source, CORNER(cornerIds[cornerIx]));
+          EDGE((line + 1) % 3, CORNER(cornerIds[cornerIx]), step->target);
+          cornerIx++;
+          line = (line + 1) % 3;
+          break;
+        case 2:
+          if (line > 1) {
+            malformed();
+          }
+          cornerIds[cornerIx + 1] = line;
+          cornerIds[cornerIx] = line == 0 ? 2 : 0;
+          EDGE(line, step->source, CORNER(cornerIds[cornerIx]));
+          EDGE(3 - cornerIds[cornerIx] - cornerIds[cornerIx + 1],
+               CORNER(cornerIds[cornerIx]), CORNER(cornerIds[cornerIx + 1]));
+          EDGE((line + 2) % 3, CORNER(cornerIds[cornerIx + 1]), step->target);
+          cornerIx += 2;
+          line = (line + 2) % 3;
+          break;
+        case 3:
+          cornerIds[0] = 0;
+          cornerIds[1] = 1;
+          cornerIds[2] = 2;
+          cornerIx = 3;
+          EDGE(1, step->source, CORNER(0));
+          EDGE(2, CORNER(0), CORNER(1));
+          EDGE(0, CORNER(1), CORNER(2));
+          EDGE(1, CORNER(2), step->target);
+          break;
+      }
+      if (step->flags & DELTA_PRIMARY) {
+        addElement(record, &length, VARIANT_VERTEX,
+                   Vertices[step->target].primary, 0, step->target, 0);
+      }
+    }
+    if (cornerIx != 3 || line != 0) {
+      malformed();
+    }
+    for (int i = 0; i < 3; i++) {
+      addElement(record, &length, VARIANT_CORNER, color, cornerIds[i],
+                 Steps[color][corners[color][i]].cornerColors, 0);
+    }
+  }
+  return length;
+}
+
+static void readDeltaFile(FILE *fp)
+{
+  struct variantDeltaHeader header;
+  struct variantElement record[MAX_ELEMENTS];
+  uint8_t corners[MAX_DELTA_COLORS][3];
+  uint32_t variationNumber;
+  if (fread((char *)&header + sizeof(header.magic),
+            sizeof(header) - sizeof(header.magic), 1, fp) != 1) {
+    malformed();
+  }
+  Header.colors = header.colors;
+  Header.levels = header.levels;
+  Header.vertices = header.vertices;
+  readVertices(fp);
+  for (uint32_t color = 0; color < Header.colors; color++) {
+    PathLengths[color] = header.pathLengths[color];
+    Steps[color] = malloc(PathLengths[color] * sizeof(**Steps) + 1);
+    if (Steps[color] == NULL ||
+        fread(Steps[color], sizeof(**Steps), PathLengths[color], fp) !=
+            PathLengths[color]) {
+      malformed();
+    }
+    for (uint32_t ix = 0; ix < PathLengths[color]; ix++) {
+      if (Steps[color][ix].source >= Header.vertices ||
+          Steps[color][ix].target >= Header.vertices) {
+        malformed();
+      }
+    }
+  }
+  readIndex(fp);
+  while (nextRecord(fp, &variationNumber)) {
+    if (fread(corners, 3, Header.colors, fp) != Header.colors) {
+      malformed();
+    }
+    for (uint32_t color = 0; color < Header.colors; color++) {
+      for (int i = 0; i < 3; i++) {
+        if (corners[color][i] >= PathLengths[color]) {
+          malformed();
+        }
+      }
+    }
+    writeVariation(variationNumber, record, materialize(corners, record));
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  char *slash;
+  FILE *fp;
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s folder/variations.bin [variationNumber ...]\n",
+            argv[0]);
+    return EXIT_FAILURE;
+  }
+  Filename = argv[1];
+  WantedCount = argc - 2;
+  Wanted = argv + 2;
+  if (strlen(Filename) >= MAX_PATH - 32) {
+    malformed();
+  }
+  strcpy(Folder, Filename);
+  slash = strrchr(Folder, '/');
+  if (slash == NULL) {
+    strcpy(Folder, ".");
+  } else {
+    *slash = '\0';
+  }
+  fp = fopen(Filename, "rb");
+  if (fp == NULL) {
+    perror(Filename);
+    return EXIT_FAILURE;
+  }
+  if (fread(Header.magic, sizeof(Header.magic), 1, fp) != 1) {
+    malformed();
+  }
+  if (memcmp(Header.magic, VARIANT_MAGIC, sizeof(Header.magic)) == 0) {
+    readVariantFile(fp);
+  } else if (memcmp(Header.magic, DELTA_MAGIC, sizeof(Header.magic)) == 0) {
+    readDeltaFile(fp);
+  } else {
+    malformed();
+  }
+  fclose(fp);
+  return EXIT_SUCCESS;
+}
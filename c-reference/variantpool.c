@@ -0,0 +1,123 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+
+#include "variantpool.h"
+
+#include "common.h"
+#include "statistics.h"
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * The writers are forked, as the -P workers are, since the faces, edges and
+ * trail of the search are global. Each writer clears its statistics, so that
+ * it counts only its own share, and adds them to totals shared with the
+ * search, which folds them into its own once every writer has finished.
+ */
+
+struct poolState {
+  int variations;
+};
+
+static struct poolState* Pool = NULL;
+/* Created with the first writer, once the search has registered them all. */
+static struct statisticTotals* Totals = NULL;
+static int MaxWriters;
+static int RunningWriters = 0;
+static bool IsWriter = false;
+
+void variantPoolStart(int writers)
+{
+  assert(writers > 0 && writers <= MAX_VARIANT_WRITERS);
+  Pool = mmap(NULL, sizeof(*Pool), PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (Pool == MAP_FAILED) {
+    perror("mmap");
+    exit(EXIT_FAILURE);
+  }
+  MaxWriters = writers;
+}
+
+bool variantPoolIsOpen(void)
+{
+  return Pool != NULL;
+}
+
+bool variantPoolIsWriter(void)
+{
+  return IsWriter;
+}
+
+static void waitForWriter(void)
+{
+  int status;
+  if (wait(&status) < 0) {
+    perror("wait");
+    exit(EXIT_FAILURE);
+  }
+  RunningWriters--;
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+    fprintf(stderr, "A writer process failed; the output is incomplete.\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+bool variantPoolDispatch(void)
+{
+  pid_t pid;
+  assert(Pool != NULL && !IsWriter);
+  while (RunningWriters >= MaxWriters) {
+    waitForWriter();
+  }
+  if (Totals == NULL) {
+    Totals = statisticTotalsCreate();
+  }
+  /* Both processes would write out anything still buffered. */
+  fflush(NULL);
+  pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    exit(EXIT_FAILURE);
+  }
+  if (pid == 0) {
+    IsWriter = true;
+    statisticClear();
+    return true;
+  }
+  RunningWriters++;
+  return false;
+}
+
+void variantPoolWriterExit(int variations)
+{
+  assert(IsWriter);
+  __atomic_fetch_add(&Pool->variations, variations, __ATOMIC_RELAXED);
+  statisticAddTo(Totals);
+  fflush(stdout);
+  _exit(EXIT_SUCCESS);
+}
+
+void variantPoolFinish(void)
+{
+  if (Pool == NULL) {
+    return;
+  }
+  while (RunningWriters > 0) {
+    waitForWriter();
+  }
+  VariationCountIPC += Pool->variations;
+  if (Totals != NULL) {
+    statisticAddTo(Totals);
+    statisticSetFrom(Totals);
+    statisticTotalsFree(Totals);
+    Totals = NULL;
+  }
+  munmap(Pool, sizeof(*Pool));
+  Pool = NULL;
+}
@@ -0,0 +1,45 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef VARIANTPOOL_H
+#define VARIANTPOOL_H
+
+#include "core.h"
+
+/**
+ * Writing the variants of each solution in a pool of writer processes (-W).
+ * Once Save has written the text file of a solution, the search forks a
+ * writer, which inherits the finished faces and edges, runs Corners and
+ * GraphML for that solution alone, and exits when they are done; the search
+ * itself moves straight on to the next solution. A writer numbers and names
+ * the variants just as the serial search does, so the output is the same.
+ */
+
+/* The most writer processes. */
+#define MAX_VARIANT_WRITERS 256
+
+/* Allows up to writers writer processes at once. */
+extern void variantPoolStart(int writers);
+
+/* Whether variantPoolStart has been called. */
+extern bool variantPoolIsOpen(void);
+
+/**
+ * Forks a writer for the current solution, first waiting until there are
+ * fewer than the maximum. Returns true in the writer, which goes on to write
+ * the variants, and false in the search.
+ */
+extern bool variantPoolDispatch(void);
+
+/* Whether this process is a writer. */
+extern bool variantPoolIsWriter(void);
+
+/* Ends a writer, having written the given number of variants. */
+extern void variantPoolWriterExit(int variations);
+
+/**
+ * Waits for every writer, adding their statistics and variation counts to
+ * those of this process.
+ */
+extern void variantPoolFinish(void);
+
+#endif  // VARIANTPOOL_H
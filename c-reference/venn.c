@@ -1,11 +1,15 @@
 /* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
 
+#include "attribution.h"
 #include "common.h"
 #include "face.h"
 #include "failure.h"
 #include "main.h"
+#include "nogood.h"
+#include "order.h"
 #include "predicates.h"
 #include "s6.h"
+#include "shard.h"
 #include "statistics.h"
 #include "utils.h"
 #include "visible_for_testing.h"
@@ -14,6 +18,9 @@ uint64 CycleGuessCounterIPC = 0;
 uint64 GlobalSolutionsFoundIPC = 0;
 
 static FACE facesInOrderOfChoice[NFACES];
+static int choicesInOrder[NFACES];
+/* When the strategy orders the cycles, those for the face chosen each round */
+static CYCLE cyclesInOrder[NFACES][NCYCLES];
 
 static void dynamicSetFaceCycleSetToSingleton(FACE face, uint64 cycleId)
 {
@@ -27,21 +34,6 @@ static void dynamicSetFaceCycleSetToSingleton(FACE face, uint64 cycleId)
   trailMaybeSetInt(&face->cycleSetSize, 1);
 }
 
-static FAILURE dynamicCheckFacePoints(FACE face, CYCLE cycle, int depth)
-{
-  uint32_t i;
-  FAILURE failure;
-
-  for (i = 0; i < cycle->length - 1; i++) {
-    CHECK_FAILURE(dynamicFaceIncludeVertex(face, cycle->curves[i],
-                                           cycle->curves[i + 1], depth));
-  }
-  CHECK_FAILURE(dynamicFaceIncludeVertex(face, cycle->curves[i],
-                                         cycle->curves[0], depth));
-
-  return NULL;
-}
-
 static FAILURE dynamicCheckEdgeCurvesAndCorners(FACE face, CYCLE cycle,
                                                 int depth)
 {
@@ -74,13 +66,11 @@ static FAILURE dynamicPropagateRestrictionsToNonAdjacentFaces(FACE face,
                                                               CYCLE cycle,
                                                               int depth)
 {
-  uint32_t i;
+  COLORSET missing = ~cycle->colors & ((1u << NCOLORS) - 1);
   FAILURE failure;
 
-  for (i = 0; i < NCOLORS; i++) {
-    if (COLORSET_HAS_MEMBER(i, cycle->colors)) {
-      continue;
-    }
+  for (; missing != 0; missing &= missing - 1) {
+    uint32_t i = __builtin_ctz(missing);
     CHECK_FAILURE(dynamicFaceRestrictAndPropagateCycles(
         face->adjacentFaces[i], CycleSetOmittingOneColor[i], depth));
   }
@@ -92,34 +82,38 @@ static FAILURE dynamicPropagateRestrictionsToNonVertexAdjacentFaces(FACE face,
                                                                     CYCLE cycle,
                                                                     int depth)
 {
-  uint32_t i, j;
+  uint64 pairs;
   FAILURE failure;
 
-  for (i = 0; i < NCOLORS; i++) {
-    for (j = i + 1; j < NCOLORS; j++) {
-      if (COLORSET_HAS_MEMBER(i, cycle->colors) &&
-          COLORSET_HAS_MEMBER(j, cycle->colors)) {
-        if (cycleContainsAthenB(face->cycle, i, j)) {
-          continue;
-        }
-      }
-      CHECK_FAILURE(dynamicFaceRestrictAndPropagateCycles(
-          face->adjacentFaces[i]->adjacentFaces[j],
-          CycleSetOmittingColorPair[i][j], depth));
-    }
+  /* In increasing order, as i < j, this is the order of the pairs (i, j). */
+  for (pairs = cycle->restrictedPairs; pairs != 0; pairs &= pairs - 1) {
+    uint32_t bit = __builtin_ctzll(pairs);
+    uint32_t i = bit / NCOLORS, j = bit % NCOLORS;
+    CHECK_FAILURE(dynamicFaceRestrictAndPropagateCycles(
+        face->adjacentFaces[i]->adjacentFaces[j],
+        CycleSetOmittingColorPair[i][j], depth));
   }
   return NULL;
 }
 
-static CYCLE chooseCycle(FACE face, CYCLE cycle)
+/**
+ * The cycle for the given choice. Usually the previous choice's cycle is
+ * still in face->cycle and we just step on, but when a choice path is being
+ * replayed, we may start at any choice.
+ */
+static CYCLE chooseCycle(FACE face, CYCLE previous, int choice)
 {
-  return cycleSetNext(face->possibleCycles, cycle);
+  if (choice == 0 || previous == NULL) {
+    return cycleSetNth(face->possibleCycles, choice);
+  }
+  return cycleSetNext(face->possibleCycles, previous);
 }
 
 static struct predicateResult dynamicTryFace(int round)
 {
   if (round == 0) {
     PerFaceDegreeSolutionNumberIPC = 0;
+    nogoodClear();
 #if NCOLORS > 4
     dynamicFaceSetupCentral(CentralFaceDegreesFlag);
 #endif
@@ -127,11 +121,17 @@ static struct predicateResult dynamicTryFace(int round)
   if ((int64_t)GlobalSolutionsFoundIPC >= GlobalMaxSolutionsFlag) {
     return PredicateFail;
   }
-  facesInOrderOfChoice[round] = searchChooseNextFace();
+  facesInOrderOfChoice[round] = OrderStrategy->chooseFace();
   if (facesInOrderOfChoice[round] == NULL) {
+    if (ShardCountFlag > 0 && round < ShardDepthFlag &&
+        !shardOwnsChoicePath(round, choicesInOrder)) {
+      return PredicateFail;
+    }
     if (dynamicFaceFinalCorrectnessChecks() == NULL) {
+      s6RecordSolution();
       GlobalSolutionsFoundIPC++;
       PerFaceDegreeSolutionNumberIPC++;
+      orderSolutionFound();
       return PredicateSuccessNextPredicate;
     } else {
       return PredicateFail;
@@ -139,19 +139,48 @@ static struct predicateResult dynamicTryFace(int round)
   }
   // Add to trail so value is cleared when backtracking.
   TRAIL_SET_POINTER(&facesInOrderOfChoice[round]->cycle, NULL);
+  dynamicFaceHasCycle(facesInOrderOfChoice[round]);
+  if (OrderStrategy->orderCycles != NULL) {
+    OrderStrategy->orderCycles(facesInOrderOfChoice[round],
+                               cyclesInOrder[round]);
+  }
+  statisticHistogramAdd(&CycleChoiceHistogram,
+                        facesInOrderOfChoice[round]->cycleSetSize);
   return predicateChoices(facesInOrderOfChoice[round]->cycleSetSize);
 }
 
 static struct predicateResult dynamicRetryFace(int round, int choice)
 {
-  (void)choice;
   FACE face = facesInOrderOfChoice[round];
+  /* A probe may try every choice before retrying one of them again. */
+  CYCLE previous = choicesInOrder[round] == choice - 1 ? face->cycle : NULL;
+  choicesInOrder[round] = choice;
   // Not on trail, otherwise it would get unset before the next retry.
-  face->cycle = chooseCycle(face, face->cycle);
+  face->cycle = OrderStrategy->orderCycles != NULL
+                    ? cyclesInOrder[round][choice]
+                    : chooseCycle(face, previous, choice);
   assert(face->cycle != NULL);
+  if (ShardCountFlag > 0 && round == ShardDepthFlag - 1 &&
+      !shardOwnsChoicePath(round + 1, choicesInOrder)) {
+    return PredicateFail;
+  }
+  if (nogoodExcludes(face, face->cycle)) {
+    return PredicateFail;
+  }
+  trailSetInt(&face->reasons, NOGOOD_REASON(round));
   if (dynamicFaceBacktrackableChoice(face) == NULL) {
+#if NCOLORS == 6
+    /* Not a failure to learn from: the reasons do not cover it. */
+    if (round < SymmetryDepthFlag && s6PartialFacesNonCanonical()) {
+      return PredicateFail;
+    }
+#endif
     return PredicateSuccessSamePredicate;
   }
+  nogoodLearn(facesInOrderOfChoice, round);
+  if (OrderStrategy->failed != NULL) {
+    OrderStrategy->failed(face, face->cycle);
+  }
   return PredicateFail;
 }
 
@@ -163,7 +192,7 @@ FAILURE dynamicFaceChoice(FACE face, int depth)
 
   assert(depth <= NFACES);
 
-  CHECK_FAILURE(dynamicCheckFacePoints(face, cycle, depth));
+  CHECK_FAILURE(dynamicFaceIncludeVertices(face, cycle, depth));
   CHECK_FAILURE(dynamicCheckEdgeCurvesAndCorners(face, cycle, depth));
   CHECK_FAILURE(dynamicPropagateFaceChoices(face, cycle, depth));
   CHECK_FAILURE(
@@ -173,13 +202,14 @@ FAILURE dynamicFaceChoice(FACE face, int depth)
     TRAIL_SET_POINTER(&face->next, face);
     TRAIL_SET_POINTER(&face->previous, face);
   } else {
-    TRAIL_SET_POINTER(&face->next, face->nextByCycleId[cycleId]);
-    TRAIL_SET_POINTER(&face->previous, face->previousByCycleId[cycleId]);
-  }
-
-  if (face->colors != 0 && face->colors != (NFACES - 1)) {
+    struct faceNeighbours* neighbours =
+        &FaceNeighboursByCycleId[face->colors][cycleId];
+    TRAIL_SET_POINTER(&face->next, Faces + neighbours->next);
+    TRAIL_SET_POINTER(&face->previous, Faces + neighbours->previous);
     assert(face->next != Faces);
     assert(face->previous != Faces);
+    /* The last face of a ring to be chosen closes it. */
+    CHECK_FAILURE(dynamicFaceCheckRingOfFaces(face, depth, true));
   }
 
   CHECK_FAILURE(
@@ -188,20 +218,21 @@ FAILURE dynamicFaceChoice(FACE face, int depth)
   return NULL;
 }
 
-FAILURE dynamicFaceBacktrackableChoice(FACE face)
+static FAILURE backtrackableChoice(FACE face)
 {
   FAILURE failure;
   COLOR completedColor;
   uint64 cycleId;
   CycleGuessCounterIPC++;
   ColorCompletedState = 0;
+  NogoodFailureReasons = NOGOOD_UNKNOWN;
   assert(face->cycle != NULL);
   cycleId = face->cycle - Cycles;
   assert(cycleId < NCYCLES);
   assert(cycleSetMember(cycleId, face->possibleCycles));
   dynamicSetFaceCycleSetToSingleton(face, cycleId);
 
-  failure = dynamicFaceChoice(face, 0);
+  failure = dynamicFacePropagateChoiceAndForced(face);
   if (failure != NULL) {
     return failure;
   }
@@ -217,18 +248,29 @@ FAILURE dynamicFaceBacktrackableChoice(FACE face)
   return NULL;
 }
 
-FACE searchChooseNextFace(void)
+FAILURE dynamicFaceBacktrackableChoice(FACE face)
 {
-  FACE face = NULL;
-  int64_t min = NCYCLES + 1;
-  int i;
-  for (i = 0; i < NFACES; i++) {
-    if ((int64_t)Faces[i].cycleSetSize < min && Faces[i].cycle == NULL) {
-      min = (int64_t)Faces[i].cycleSetSize;
-      face = Faces + i;
-    }
+  FAILURE failure;
+  FailureFace = NULL;
+  failure = backtrackableChoice(face);
+  if (FailureAttributionEnabled) {
+    failureAttributionRecord(face, failure);
+  }
+  return failure;
+}
+
+/**
+ * The choices made for the faces of the current solution, in order. Serial
+ * search finds solutions in the lexicographic order of these.
+ */
+int vennChoicePath(int choices[NFACES])
+{
+  int round;
+  for (round = 0; round < NFACES && facesInOrderOfChoice[round] != NULL;
+       round++) {
+    choices[round] = choicesInOrder[round];
   }
-  return face;
+  return round;
 }
 
 struct predicate VennPredicate = {"Venn", dynamicTryFace, dynamicRetryFace};
@@ -0,0 +1,12 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#include "verify.h"
+
+/**
+ * Program entry point that delegates to verify.c, which the unity tests
+ * link without this main.
+ */
+int main(int argc, char *argv[])
+{
+  return verifyMain(argc, argv);
+}
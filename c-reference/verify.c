@@ -0,0 +1,1069 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 700
+
+#include "verify.h"
+
+#include "common.h"
+#include "dynamicface.h"
+#include "engine.h"
+#include "geometry.h"
+#include "main.h"
+#include "order.h"
+#include "predicates.h"
+#include "s6.h"
+#include "solutionpath.h"
+#include "statistics.h"
+#include "stream.h"
+#include "triangles.h"
+#include "variantarchive.h"
+#include "variantdedup.h"
+#include "variantfile.h"
+#include "vertex.h"
+#include "visible_for_testing.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define VERIFY_CHUNK 4096
+#define MAX_PATH 1024
+
+enum verifyFormat {
+  FORMAT_GRAPHML, /* A file for each variation, perhaps with -z */
+  FORMAT_ARCHIVE, /* variations.arc, from -F archive */
+  FORMAT_BINARY,  /* variations.bin, from -F bin */
+  FORMAT_DELTA,   /* variations.dlt, from -F delta */
+};
+
+struct verifySolution {
+  char name[NCOLORS + 8]; /* As 554544-06 */
+  char signature[SOLUTION_SIGNATURE_SIZE];
+  char classSignature[SOLUTION_SIGNATURE_SIZE];
+  /* Of its .paths entry, or, if it has none, its own. */
+  char pathSignature[SOLUTION_SIGNATURE_SIZE];
+  int variations; /* The number of the last one, from the .txt */
+  bool unique;    /* Saved with -i, skipping isomorphic duplicates */
+  enum verifyFormat format;
+  uint64 records; /* The variations saved, in its files */
+};
+
+struct verifyJob {
+  int solution;
+  uint64 first, end; /* The records of variations.dlt */
+};
+
+/* Shared with the workers. */
+struct verifyShared {
+  int nextSearch, nextJob;
+  uint64 solutions, variations, problems;
+};
+
+/* A variations.dlt, variations.bin or variations.arc, mapped. */
+struct variationsFile {
+  const unsigned char *data;
+  size_t size;
+  const void *index;
+  uint64 records;
+};
+
+static const char *Folder;
+static struct verifySolution *Solutions;
+static int SolutionCount = 0;
+/* The path to each solution, shared, so that the workers can find those
+ * with none in an index; an empty path is one not found yet. */
+static struct choicePath *Paths;
+/* The first solution of each sequence of degrees that must be searched. */
+static int *Searches;
+static int SearchCount = 0;
+static struct verifyJob *Jobs;
+static int JobCount = 0;
+static struct verifyShared *Shared;
+static uint64 Problems = 0;
+
+/* The work of this worker: the degrees searched, or the job being run. */
+static int SearchFirst;
+static const struct verifyJob *Job;
+static const struct verifySolution *Solution;
+static bool Reached;
+static uint64 Checked;
+/* Whether a variation has been found saved; with -j, those before are not. */
+static bool FoundSaved;
+static struct stack Stack;
+static struct variationsFile Saved;
+static size_t RecordsStart;
+
+/* The variation being compared with its GraphML file. */
+static struct {
+  unsigned char *expected;
+  size_t capacity, length, offset;
+  bool saved, differs;
+} Compare;
+/* With -F archive, the index entry after the last one found. */
+static uint64 NextEntry;
+/* With -F bin, the folder for the variations.bin written again. */
+static char Scratch[64];
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void problem(const char *format, const char *detail)
+{
+  fprintf(stderr, "%s: ", Solution->name);
+  fprintf(stderr, format, detail);
+  fprintf(stderr, "\n");
+  Problems++;
+}
+
+static void variationProblem(const char *format, uint32_t variationNumber)
+{
+  char detail[32];
+  snprintf(detail, sizeof(detail), "%u", variationNumber);
+  problem(format, detail);
+}
+
+static void solutionFilename(char *filename, const char *name,
+                             const char *file)
+{
+  snprintf(filename, MAX_PATH, "%s/%s/%s", Folder, name, file);
+}
+
+static const void *mapped(const struct variationsFile *file, size_t offset,
+                          size_t size)
+{
+  return offset + size <= file->size ? file->data + offset : NULL;
+}
+
+static void unmapVariations(struct variationsFile *file)
+{
+  if (file->data != NULL) {
+    munmap((void *)file->data, file->size);
+    file->data = NULL;
+  }
+}
+
+/* Maps the file, checking its magic, at both ends, and its index, found from
+ * its trailer, for records of recordSize; false if it cannot be. */
+static bool mapVariations(struct variationsFile *file, const char *filename,
+                          const char *magic, size_t recordSize)
+{
+  const struct variantTrailer *trailer;
+  const struct variantArchiveTrailer *archive;
+  size_t magicSize = strlen(magic), trailerSize;
+  uint64 index;
+  struct stat st;
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  trailerSize = strcmp(magic, ARCHIVE_MAGIC) == 0 ? sizeof(*archive)
+                                                  : sizeof(*trailer);
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)trailerSize) {
+    close(fd);
+    return false;
+  }
+  file->size = st.st_size;
+  file->data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (file->data == MAP_FAILED) {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+  if (trailerSize == sizeof(*archive)) {
+    archive = mapped(file, file->size - trailerSize, trailerSize);
+    index = archive->index;
+    file->records = archive->entries;
+  } else {
+    trailer = mapped(file, file->size - trailerSize, trailerSize);
+    index = trailer->index;
+    file->records = trailer->records;
+  }
+  if (memcmp(file->data, magic, magicSize) != 0 ||
+      memcmp(file->data + file->size - magicSize, magic, magicSize) != 0 ||
+      file->records > file->size ||
+      (file->index = mapped(file, index, file->records * recordSize)) ==
+          NULL) {
+    unmapVariations(file);
+    return false;
+  }
+  return true;
+}
+
+/* Whether the paths of variations.dlt are those of the solution found. */
+static bool deltaMatchesGeometry(void)
+{
+  const struct solutionGeometry *geometry = dynamicSolutionGeometry();
+  const struct variantDeltaHeader *header = mapped(&Saved, 0, sizeof(*header));
+  size_t offset = sizeof(*header);
+  if (header->colors != NCOLORS) {
+    return false;
+  }
+  offset += header->vertices * sizeof(struct variantVertex);
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    int length = geometry->pathLengths[color];
+    const struct variantDeltaStep *steps =
+        mapped(&Saved, offset, length * sizeof(*steps));
+    if ((int)header->pathLengths[color] != length || steps == NULL) {
+      return false;
+    }
+    for (int ix = 0; ix < length; ix++) {
+      EDGE edge = geometry->paths[color][ix];
+      int flags =
+          (IS_CLOCKWISE_EDGE(edge) ? DELTA_CLOCKWISE : 0) |
+          (edgeVertex(edge)->primary == color ? DELTA_PRIMARY : 0);
+      if (steps[ix].flags != flags ||
+          steps[ix].cornerColors != (edge->reversed->colors | (1u << color))) {
+        return false;
+      }
+    }
+    offset += length * sizeof(struct variantDeltaStep);
+  }
+  RecordsStart = offset;
+  return true;
+}
+
+/* Between Venn and the variations: the checks of the solution itself. */
+static struct predicateResult tryVerifySolution(int round)
+{
+  (void)round;
+  if (strcmp(s6SignatureToString(&CurrentSolution.signature),
+             Solution->pathSignature) != 0) {
+    return PredicateFail;
+  }
+  Reached = true;
+  if (Job->first > 0) {
+    /* Checked with the first of its variations. */
+    return PredicateSuccessNextPredicate;
+  }
+  if (strcmp(Solution->pathSignature, Solution->signature) != 0) {
+    problem("the signature is not that of its .paths entry, %s",
+            Solution->pathSignature);
+  }
+  if (dynamicFaceFinalCorrectnessChecks() != NULL) {
+    problem("the faces fail the final checks%s", "");
+  }
+  if (strcmp(s6SignatureToString(&CurrentSolution.classSignature),
+             Solution->classSignature) != 0) {
+    problem("the class signature is %s",
+            s6SignatureToString(&CurrentSolution.classSignature));
+  }
+  if (strncmp(s6FaceDegreeSignature(), Solution->name, NCOLORS) != 0) {
+    problem("the face degrees are %s", s6FaceDegreeSignature());
+  }
+  __atomic_fetch_add(&Shared->solutions, 1, __ATOMIC_RELAXED);
+  return PredicateSuccessNextPredicate;
+}
+
+static struct predicateResult tryVerifyDelta(int round)
+{
+  (void)round;
+  if (Job->end == Job->first) {
+    return PredicateFail;
+  }
+  if (!deltaMatchesGeometry()) {
+    if (Job->first == 0) {
+      problem("variations.dlt has other paths%s", "");
+    }
+    return PredicateFail;
+  }
+  return predicateChoices(Job->end - Job->first);
+}
+
+/* The problem with the variation, or NULL, setting its corners. */
+static const char *deltaProblem(uint64 record)
+{
+  const struct solutionGeometry *geometry = dynamicSolutionGeometry();
+  const struct variantIndexEntry *entry =
+      (const struct variantIndexEntry *)Saved.index + record;
+  const uint32_t *number = mapped(&Saved, entry->offset, sizeof(*number));
+  const uint8_t *steps =
+      mapped(&Saved, entry->offset + sizeof(*number), NCOLORS * 3);
+  if (entry->offset < RecordsStart || number == NULL || steps == NULL ||
+      *number != entry->variationNumber) {
+    return "bad index entry";
+  }
+  if ((record > 0 && entry[-1].variationNumber >= *number) ||
+      (int)*number > Solution->variations) {
+    return "is out of order";
+  }
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    for (int i = 0; i < 3; i++) {
+      int step = steps[3 * color + i];
+      EDGE corner;
+      int j;
+      if (step >= geometry->pathLengths[color]) {
+        return "has a corner off its path";
+      }
+      corner = geometry->paths[color][step]->reversed;
+      for (j = 0; j < geometry->possibleCornerCounts[color][i]; j++) {
+        if (geometry->possibleCorners[color][i][j] == corner) {
+          break;
+        }
+      }
+      if (j == geometry->possibleCornerCounts[color][i]) {
+        return "has a corner where none can be";
+      }
+      TRAIL_SET_POINTER(&SelectedCornersIPC[color][i], corner);
+    }
+  }
+  for (COLOR color = 0; color < NCOLORS; color++) {
+    if (!dynamicTriangleLinesNotCrossed(color, SelectedCornersIPC + color)) {
+      return "has lines that cross";
+    }
+  }
+  return NULL;
+}
+
+static struct predicateResult retryVerifyDelta(int round, int choice)
+{
+  uint64 record = Job->first + choice;
+  const char *message = deltaProblem(record);
+  (void)round;
+  if (message != NULL) {
+    char detail[64];
+    snprintf(detail, sizeof(detail), "%u %s",
+             ((const struct variantIndexEntry *)Saved.index)[record]
+                 .variationNumber,
+             message);
+    problem("variation %s", detail);
+  }
+  Checked++;
+  return PredicateFail;
+}
+
+/* Reads all of the file, through zlib, so that it may be gzipped or not. */
+static bool readExpected(const char *filename)
+{
+  gzFile gz = gzopen(filename, "rb");
+  int n;
+  if (gz == NULL) {
+    return false;
+  }
+  Compare.length = 0;
+  do {
+    if (Compare.capacity - Compare.length < 65536) {
+      Compare.capacity = Compare.capacity == 0 ? 1 << 20 : 2 * Compare.capacity;
+      Compare.expected = realloc(Compare.expected, Compare.capacity);
+      if (Compare.expected == NULL) {
+        perror("realloc");
+        exit(EXIT_FAILURE);
+      }
+    }
+    n = gzread(gz, Compare.expected + Compare.length,
+               Compare.capacity - Compare.length);
+    Compare.length += n > 0 ? n : 0;
+  } while (n > 0);
+  gzclose(gz);
+  return n == 0;
+}
+
+/* The GraphML of variations.arc with this name, relative to the folder. */
+static bool findArchived(const char *name)
+{
+  const struct variantArchiveEntry *entries = Saved.index;
+  for (uint64 i = 0; i < Saved.records; i++) {
+    const struct variantArchiveEntry *entry =
+        entries + (NextEntry + i) % Saved.records;
+    if (strncmp(entry->name, name, sizeof(entry->name)) == 0) {
+      const void *data = mapped(&Saved, entry->offset, entry->length);
+      if (data == NULL) {
+        return false;
+      }
+      NextEntry = (NextEntry + i + 1) % Saved.records;
+      Compare.length = 0;
+      if (entry->length > Compare.capacity) {
+        Compare.capacity = entry->length;
+        Compare.expected = realloc(Compare.expected, Compare.capacity);
+        if (Compare.expected == NULL) {
+          perror("realloc");
+          exit(EXIT_FAILURE);
+        }
+      }
+      memcpy(Compare.expected, data, entry->length);
+      Compare.length = entry->length;
+      return true;
+    }
+  }
+  return false;
+}
+
+static int compareWrite(void *cookie, const char *buffer, int size)
+{
+  (void)cookie;
+  if (Compare.saved) {
+    Compare.differs |=
+        Compare.offset + size > Compare.length ||
+        memcmp(Compare.expected + Compare.offset, buffer, size) != 0;
+    Compare.offset += size;
+  }
+  return size;
+}
+
+static int compareClose(void *cookie)
+{
+  (void)cookie;
+  if (!Compare.saved) {
+    if (FoundSaved) {
+      variationProblem("variation %s is missing", VariationNumberIPC - 1);
+    }
+  } else {
+    FoundSaved = true;
+    if (Compare.differs || Compare.offset != Compare.length) {
+      variationProblem("variation %s differs from its GraphML",
+                       VariationNumberIPC - 1);
+    }
+    Checked++;
+  }
+  return 0;
+}
+
+/* As GraphmlFileOps.fopen: compares the GraphML written for a variation with
+ * that saved for it, if it was. */
+static FILE *compareFopen(const char *filename, const char *mode)
+{
+  char gzipped[MAX_PATH];
+  (void)mode;
+  Compare.offset = 0;
+  Compare.differs = false;
+  if (Solution->format == FORMAT_ARCHIVE) {
+    Compare.saved = findArchived(filename + strlen(CurrentPrefixIPC) + 1);
+  } else {
+    snprintf(gzipped, sizeof(gzipped), "%s.gz", filename);
+    Compare.saved = (access(filename, R_OK) == 0 && readExpected(filename)) ||
+                    (access(gzipped, R_OK) == 0 && readExpected(gzipped));
+  }
+  return streamOpen(&Compare, compareWrite, compareClose);
+}
+
+static void noFolder(const char *folder)
+{
+  (void)folder;
+}
+
+/* Whether vertex a of the saved file is vertex b of the one written again. */
+static bool sameVertex(const struct variationsFile *written, int a, int b)
+{
+  const struct variantVertex *savedVertex = mapped(
+      &Saved, sizeof(struct variantFileHeader) + a * sizeof(*savedVertex),
+      sizeof(*savedVertex));
+  const struct variantVertex *writtenVertex = mapped(
+      written, sizeof(struct variantFileHeader) + b * sizeof(*writtenVertex),
+      sizeof(*writtenVertex));
+  return savedVertex != NULL && writtenVertex != NULL &&
+         memcmp(savedVertex, writtenVertex, sizeof(*savedVertex)) == 0;
+}
+
+static bool sameEndpoint(const struct variationsFile *written, int a, int b)
+{
+  if (a >= VARIANT_CORNER_ENDPOINT(0) || b >= VARIANT_CORNER_ENDPOINT(0)) {
+    return a == b;
+  }
+  return sameVertex(written, a, b);
+}
+
+/* Whether the saved record is the one written again. The vertex tables may
+ * be in another order, as each is in that of its first record. */
+static bool sameRecord(const struct variationsFile *written,
+                       const struct variantElement *saved,
+                       const struct variantElement *again, uint32_t elements)
+{
+  for (uint32_t i = 0; i < elements; i++) {
+    if (saved[i].kind != again[i].kind || saved[i].color != again[i].color ||
+        saved[i].line != again[i].line) {
+      return false;
+    }
+    switch (saved[i].kind) {
+      case VARIANT_EDGE:
+        if (!sameEndpoint(written, saved[i].to, again[i].to)) {
+          return false;
+        }
+        /* fall through */
+      case VARIANT_VERTEX:
+        if (!sameEndpoint(written, saved[i].from, again[i].from)) {
+          return false;
+        }
+        break;
+      default:
+        if (saved[i].from != again[i].from || saved[i].to != again[i].to) {
+          return false;
+        }
+    }
+  }
+  return true;
+}
+
+/* Compares each record of the saved variations.bin with that of the same
+ * variation in the one written again, each of which, after the first saved,
+ * must be saved. */
+static void compareBinary(void)
+{
+  char filename[MAX_PATH];
+  struct variationsFile written = {0};
+  const struct variantFileHeader *savedHeader, *writtenHeader;
+  const struct variantIndexEntry *savedIndex = Saved.index, *writtenIndex;
+  size_t recordSize;
+  uint64 next = 0, record = 0;
+  snprintf(filename, sizeof(filename), "%s/variations.bin", Scratch);
+  savedHeader = mapped(&Saved, 0, sizeof(*savedHeader));
+  if (Saved.records == 0) {
+    unlink(filename);
+    return;
+  }
+  if (!mapVariations(&written, filename, VARIANT_MAGIC,
+                     sizeof(*writtenIndex))) {
+    problem("has variations in variations.bin not found again%s", "");
+    unlink(filename);
+    return;
+  }
+  writtenHeader = mapped(&written, 0, sizeof(*writtenHeader));
+  writtenIndex = written.index;
+  recordSize = sizeof(uint32_t) +
+               savedHeader->elements * sizeof(struct variantElement);
+  if (savedHeader->elements != writtenHeader->elements ||
+      savedHeader->levels != writtenHeader->levels ||
+      savedHeader->colors != NCOLORS) {
+    problem("variations.bin has another header%s", "");
+  } else {
+    for (; record < Saved.records; record++) {
+      uint32_t number = savedIndex[record].variationNumber;
+      const uint32_t *saved =
+          mapped(&Saved, savedIndex[record].offset, recordSize);
+      const uint32_t *again;
+      for (; next < written.records &&
+             writtenIndex[next].variationNumber < number;
+           next++) {
+        /* Those before the first saved are skipped with -j. */
+        if (record > 0) {
+          variationProblem("variation %s is missing",
+                           writtenIndex[next].variationNumber);
+        }
+      }
+      if (next == written.records ||
+          writtenIndex[next].variationNumber != number) {
+        variationProblem("variation %s is not found again", number);
+        continue;
+      }
+      again = mapped(&written, writtenIndex[next].offset, recordSize);
+      if (saved == NULL || again == NULL || *saved != number ||
+          !sameRecord(&written, (const struct variantElement *)(saved + 1),
+                      (const struct variantElement *)(again + 1),
+                      savedHeader->elements)) {
+        variationProblem("variation %s differs from its record", number);
+      }
+      Checked++;
+      next++;
+    }
+    for (; next < written.records; next++) {
+      variationProblem("variation %s is missing",
+                       writtenIndex[next].variationNumber);
+    }
+  }
+  unmapVariations(&written);
+  unlink(filename);
+}
+
+/* Before the corners, so that the variations, numbered as the search did,
+ * are written again, checked against those saved, rather than saved. */
+static bool forwardVerifyOutput(void)
+{
+  snprintf(CurrentPrefixIPC, sizeof(CurrentPrefixIPC), "%s/%s", Folder,
+           Solution->name);
+  LevelsIPC = numberOfLevels(searchCountVariations());
+  VariationNumberIPC = 1;
+  MaxVariantsPerSolutionFlag = Solution->variations;
+  UniqueVariantsFlag = Solution->unique;
+  if (UniqueVariantsFlag) {
+    variantDedupSolution();
+  }
+  NextEntry = 0;
+  FoundSaved = false;
+  if (Solution->format == FORMAT_BINARY) {
+    if (Scratch[0] == '\0') {
+      snprintf(Scratch, sizeof(Scratch), "/tmp/vennverify-XXXXXX");
+      if (mkdtemp(Scratch) == NULL) {
+        perror(Scratch);
+        exit(EXIT_FAILURE);
+      }
+    }
+    variantFileOpen(Scratch, LevelsIPC);
+  }
+  return true;
+}
+
+static void backwardVerifyOutput(void)
+{
+  char detail[32];
+  if (Solution->format == FORMAT_BINARY) {
+    variantFileClose();
+    compareBinary();
+  }
+  if (Checked < Solution->records) {
+    snprintf(detail, sizeof(detail), "%llu",
+             (unsigned long long)(Solution->records - Checked));
+    problem("has %s saved variations not found again", detail);
+  }
+}
+
+static struct predicate VerifySolutionPredicate = {"VerifySolution",
+                                                   tryVerifySolution, NULL};
+static struct predicate VerifyDeltaPredicate = {"VerifyDelta", tryVerifyDelta,
+                                                retryVerifyDelta};
+FORWARD_BACKWARD_PREDICATE_STATIC(VerifyOutput, NULL, forwardVerifyOutput,
+                                  backwardVerifyOutput)
+
+/* As NonDeterministicProgram, to replay its paths. */
+static PREDICATE DeltaProgram[] = {
+    &InitializePredicate,  &InnerFacePredicate,      &LogPredicate,
+    &VennPredicate,        &VerifySolutionPredicate, &VerifyDeltaPredicate,
+    &FAILPredicate};
+static PREDICATE OutputProgram[] = {
+    &InitializePredicate,     &InnerFacePredicate,    &LogPredicate,
+    &VennPredicate,           &VerifySolutionPredicate,
+    &VerifyOutputPredicate,   &CornersPredicate,      &GraphMLPredicate,
+    &FAILPredicate};
+
+/* In place of VerifySolution, in a search of the degrees of solutions with no
+ * path in an index: records the path to each found. */
+static struct predicateResult tryFindSolution(int round)
+{
+  const char *signature = s6SignatureToString(&CurrentSolution.signature);
+  (void)round;
+  for (int i = SearchFirst; i < SolutionCount &&
+                            strncmp(Solutions[i].name,
+                                    Solutions[SearchFirst].name, NCOLORS) == 0;
+       i++) {
+    if (Paths[i].length == 0 &&
+        strcmp(Solutions[i].signature, signature) == 0) {
+      engineContinuationPath(&Stack, Paths + i);
+      /* Only the choices to it, not the rest of the search after it. */
+      for (int j = 0; j < Paths[i].length; j++) {
+        if (Paths[i].steps[j].first >= 0) {
+          Paths[i].steps[j].end = Paths[i].steps[j].first + 1;
+        }
+      }
+    }
+  }
+  return PredicateFail;
+}
+
+static struct predicate FindSolutionPredicate = {"FindSolution",
+                                                 tryFindSolution, NULL};
+
+static PREDICATE FindProgram[] = {
+    &InitializePredicate, &InnerFacePredicate,    &LogPredicate,
+    &VennPredicate,       &FindSolutionPredicate, &FAILPredicate};
+
+static void setDegrees(const char *name)
+{
+  for (int i = 0; i < NCOLORS; i++) {
+    CentralFaceDegreesFlag[i] = name[i] - '0';
+  }
+}
+
+static void runSearches(void)
+{
+  /* InnerFace reports each sequence of degrees that it finishes. */
+  if (freopen("/dev/null", "w", stdout) == NULL) {
+    perror("/dev/null");
+    exit(EXIT_FAILURE);
+  }
+  for (;;) {
+    int i = __atomic_fetch_add(&Shared->nextSearch, 1, __ATOMIC_RELAXED);
+    if (i >= SearchCount) {
+      return;
+    }
+    SearchFirst = Searches[i];
+    setDegrees(Solutions[SearchFirst].name);
+    engine(&Stack, FindProgram);
+  }
+}
+
+static void runJob(const struct verifyJob *job)
+{
+  uint64 before = Problems;
+  char filename[MAX_PATH];
+  Job = job;
+  Solution = Solutions + job->solution;
+  setDegrees(Solution->name);
+  if (Solution->format == FORMAT_DELTA) {
+    solutionFilename(filename, Solution->name, "variations.dlt");
+    if (job->end > job->first &&
+        !mapVariations(&Saved, filename, DELTA_MAGIC,
+                       sizeof(struct variantIndexEntry))) {
+      problem("variations.dlt cannot be read%s", "");
+      return;
+    }
+  } else if (Solution->format != FORMAT_GRAPHML) {
+    bool archive = Solution->format == FORMAT_ARCHIVE;
+    solutionFilename(filename, Solution->name,
+                     archive ? "variations.arc" : "variations.bin");
+    if (!mapVariations(&Saved, filename,
+                       archive ? ARCHIVE_MAGIC : VARIANT_MAGIC,
+                       archive ? sizeof(struct variantArchiveEntry)
+                               : sizeof(struct variantIndexEntry))) {
+      problem("%s cannot be read", filename);
+      return;
+    }
+  }
+  Reached = false;
+  Checked = 0;
+  engineReplay(&Stack,
+               Solution->format == FORMAT_DELTA ? DeltaProgram : OutputProgram,
+               Paths + job->solution);
+  unmapVariations(&Saved);
+  if (!Reached) {
+    problem("the path does not lead to the solution; verify with the -O "
+            "and -y of the search that found it%s",
+            "");
+    Problems += job->end - job->first;
+  }
+  __atomic_fetch_add(&Shared->variations, Checked, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&Shared->problems, Problems - before, __ATOMIC_RELAXED);
+}
+
+static void runJobs(void)
+{
+  /* The search's own writers are replaced by comparisons. */
+  GraphmlFileOps.fopen = compareFopen;
+  GraphmlFileOps.initializeFolder = noFolder;
+  IgnoreFirstVariantsPerSolution = 0;
+  CountVariationsFlag = false;
+  ArchiveVariationsFlag = DeltaVariationsFlag = false;
+  JsonSinkFlag = NULL;
+  for (;;) {
+    int i = __atomic_fetch_add(&Shared->nextJob, 1, __ATOMIC_RELAXED);
+    if (i >= JobCount) {
+      break;
+    }
+    Solution = Solutions + Jobs[i].solution;
+    BinaryVariationsFlag = Solution->format == FORMAT_BINARY;
+    runJob(Jobs + i);
+  }
+  if (Scratch[0] != '\0') {
+    rmdir(Scratch);
+  }
+}
+
+/* The signatures and the number of variations of the solution, from its
+ * .txt, with false if they are not there. */
+static bool readSolution(struct verifySolution *solution)
+{
+  char filename[MAX_PATH], line[512];
+  bool hasSignature = false, hasClass = false, hasVariations = false;
+  FILE *fp;
+  snprintf(filename, sizeof(filename), "%s/%s.txt", Folder, solution->name);
+  fp = fopen(filename, "r");
+  if (fp == NULL) {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    hasSignature |=
+        sscanf(line, "Solution signature %255s", solution->signature) == 1;
+    hasClass |=
+        sscanf(line, "Class signature %255s", solution->classSignature) == 1;
+    hasVariations |=
+        sscanf(line, "Number of variations: %d/", &solution->variations) == 1;
+    solution->unique |= strncmp(line, "Isomorphic duplicates skipped:",
+                                strlen("Isomorphic duplicates skipped:")) == 0;
+  }
+  fclose(fp);
+  return hasSignature && hasClass && hasVariations;
+}
+
+/* Whether the file is the .txt of a solution, as 554544-06.txt. */
+static bool isSolutionName(const char *filename)
+{
+  size_t length = strlen(filename);
+  if (length < NCOLORS + 6 || length >= NCOLORS + 8 + 4 ||
+      strcmp(filename + length - 4, ".txt") != 0 ||
+      filename[NCOLORS] != '-') {
+    return false;
+  }
+  for (size_t i = 0; i < length - 4; i++) {
+    if (i != NCOLORS && (filename[i] < '0' || filename[i] > '9')) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static int compareSolutions(const void *a, const void *b)
+{
+  return strcmp(((const struct verifySolution *)a)->name,
+                ((const struct verifySolution *)b)->name);
+}
+
+static void findSolutions(void)
+{
+  DIR *dir = opendir(Folder);
+  struct dirent *entry;
+  int capacity = 0;
+  if (dir == NULL) {
+    perror(Folder);
+    exit(EXIT_FAILURE);
+  }
+  while ((entry = readdir(dir)) != NULL) {
+    if (!isSolutionName(entry->d_name)) {
+      continue;
+    }
+    if (SolutionCount == capacity) {
+      capacity = capacity == 0 ? 256 : 2 * capacity;
+      Solutions = realloc(Solutions, capacity * sizeof(*Solutions));
+      if (Solutions == NULL) {
+        perror("realloc");
+        exit(EXIT_FAILURE);
+      }
+    }
+    memset(Solutions + SolutionCount, 0, sizeof(*Solutions));
+    snprintf(Solutions[SolutionCount].name, sizeof(Solutions->name),
+             "%.*s", (int)strlen(entry->d_name) - 4, entry->d_name);
+    SolutionCount++;
+  }
+  closedir(dir);
+  qsort(Solutions, SolutionCount, sizeof(*Solutions), compareSolutions);
+}
+
+static uint64 GraphmlFiles;
+
+static int countGraphml(const char *path, const struct stat *st, int type,
+                        struct FTW *ftw)
+{
+  size_t length = strlen(path);
+  (void)st;
+  (void)ftw;
+  if (type == FTW_F &&
+      ((length > 4 && strcmp(path + length - 4, ".xml") == 0) ||
+       (length > 7 && strcmp(path + length - 7, ".xml.gz") == 0))) {
+    GraphmlFiles++;
+  }
+  return 0;
+}
+
+/* How the variations of the solution were saved, and how many; false if
+ * their file cannot be read. */
+static bool findVariations(struct verifySolution *solution)
+{
+  static const struct {
+    const char *file, *magic;
+    size_t entrySize;
+    enum verifyFormat format;
+  } formats[] = {
+      {"variations.dlt", DELTA_MAGIC, sizeof(struct variantIndexEntry),
+       FORMAT_DELTA},
+      {"variations.bin", VARIANT_MAGIC, sizeof(struct variantIndexEntry),
+       FORMAT_BINARY},
+      {"variations.arc", ARCHIVE_MAGIC, sizeof(struct variantArchiveEntry),
+       FORMAT_ARCHIVE}};
+  char filename[MAX_PATH];
+  for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+    struct variationsFile file = {0};
+    solutionFilename(filename, solution->name, formats[i].file);
+    if (access(filename, F_OK) != 0) {
+      continue;
+    }
+    if (!mapVariations(&file, filename, formats[i].magic,
+                       formats[i].entrySize)) {
+      problem("%s cannot be read", filename);
+      return false;
+    }
+    solution->format = formats[i].format;
+    solution->records = file.records;
+    unmapVariations(&file);
+    return true;
+  }
+  snprintf(filename, sizeof(filename), "%s/%s", Folder, solution->name);
+  GraphmlFiles = 0;
+  nftw(filename, countGraphml, 16, FTW_PHYS);
+  solution->format = FORMAT_GRAPHML;
+  solution->records = GraphmlFiles;
+  return true;
+}
+
+/* Reads each solution, with the path to it from the index of its degrees,
+ * or, if it is not there, notes that they must be searched. */
+static void readSolutions(void)
+{
+  Paths = mmap(NULL, (SolutionCount + 1) * sizeof(*Paths),
+               PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  Searches = malloc((SolutionCount + 1) * sizeof(*Searches));
+  if (Paths == MAP_FAILED || Searches == NULL) {
+    perror("mmap");
+    exit(EXIT_FAILURE);
+  }
+  for (int i = 0; i < SolutionCount; i++) {
+    Solution = Solutions + i;
+    if (!readSolution(Solutions + i)) {
+      problem("the .txt is incomplete%s", "");
+    } else if (findVariations(Solutions + i)) {
+      if (solutionPathRead(Folder, Solution->name, Paths + i,
+                           Solutions[i].pathSignature)) {
+        continue;
+      }
+      strcpy(Solutions[i].pathSignature, Solutions[i].signature);
+      if (SearchCount == 0 ||
+          strncmp(Solutions[Searches[SearchCount - 1]].name, Solution->name,
+                  NCOLORS) != 0) {
+        Searches[SearchCount++] = i;
+      }
+      continue;
+    }
+    Solutions[i].name[0] = '\0';
+  }
+}
+
+/* A job for each solution that can be replayed, with each VERIFY_CHUNK of
+ * the records of a variations.dlt a job of its own. */
+static void queueJobs(void)
+{
+  uint64 chunks = 0;
+  for (int i = 0; i < SolutionCount; i++) {
+    Solution = Solutions + i;
+    if (Solution->name[0] != '\0' && Paths[i].length == 0) {
+      problem("is not among the solutions of its degrees; verify with the "
+              "-O and -y of the search that found it%s",
+              "");
+      Solutions[i].name[0] = '\0';
+    }
+    chunks += Solution->records / VERIFY_CHUNK + 1;
+  }
+  Jobs = malloc(chunks * sizeof(*Jobs) + 1);
+  if (Jobs == NULL) {
+    perror("malloc");
+    exit(EXIT_FAILURE);
+  }
+  for (int i = 0; i < SolutionCount; i++) {
+    uint64 first = 0, chunk = Solutions[i].format == FORMAT_DELTA
+                                  ? VERIFY_CHUNK
+                                  : Solutions[i].records + 1;
+    if (Solutions[i].name[0] == '\0') {
+      continue;
+    }
+    do {
+      struct verifyJob *job = Jobs + JobCount++;
+      job->solution = i;
+      job->first = first;
+      first += chunk;
+      job->end = first < Solutions[i].records ? first : Solutions[i].records;
+    } while (first < Solutions[i].records);
+  }
+}
+
+/* Forks the workers, each running work, and waits for them, returning how
+ * many failed. */
+static int runWorkers(int workers, void (*work)(void))
+{
+  int failed = 0;
+  fflush(NULL);
+  for (int i = 0; i < workers; i++) {
+    pid_t pid = fork();
+    if (pid < 0) {
+      perror("fork");
+      exit(EXIT_FAILURE);
+    }
+    if (pid == 0) {
+      work();
+      fflush(NULL);
+      _exit(EXIT_SUCCESS);
+    }
+  }
+  for (int i = 0; i < workers; i++) {
+    int status;
+    if (wait(&status) < 0) {
+      perror("wait");
+      exit(EXIT_FAILURE);
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+      failed++;
+    }
+  }
+  return failed;
+}
+
+static void usage(const char *program)
+{
+  fprintf(stderr, "Usage: %s [-P workers] [-O order] [-y symmetryDepth] "
+                  "folder\n",
+          program);
+  exit(EXIT_FAILURE);
+}
+
+int verifyMain(int argc, char *argv[])
+{
+  int workers = sysconf(_SC_NPROCESSORS_ONLN);
+  double start, seconds;
+  int opt, failed = 0;
+  while ((opt = getopt(argc, argv, "P:O:y:")) != -1) {
+    switch (opt) {
+      case 'P':
+        workers = atoi(optarg);
+        break;
+      case 'O':
+        if (!orderSelect(optarg) || !orderIsRepeatable()) {
+          usage(argv[0]);
+        }
+        break;
+      case 'y':
+        SymmetryDepthFlag = atoi(optarg);
+        break;
+      default:
+        usage(argv[0]);
+    }
+  }
+  if (optind != argc - 1 || workers < 1) {
+    usage(argv[0]);
+  }
+  Folder = argv[optind];
+  start = now();
+  Shared = mmap(NULL, sizeof(*Shared), PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (Shared == MAP_FAILED) {
+    perror("mmap");
+    exit(EXIT_FAILURE);
+  }
+  findSolutions();
+  readSolutions();
+  /* The progress lines of Log would be those of each worker. */
+  initializeStatisticLogging("/dev/null", 200, 10);
+  /* Initialize does not undo, so each worker starts from the frozen point. */
+  engine(&Stack, (PREDICATE[]){&InitializePredicate, &FAILPredicate});
+  if (SearchCount > 0) {
+    failed += runWorkers(workers < SearchCount ? workers : SearchCount,
+                         runSearches);
+  }
+  queueJobs();
+  Shared->problems = Problems;
+  failed += runWorkers(workers, runJobs);
+  seconds = now() - start;
+  printf("Verified %llu of %d solutions, and %llu variations, in %.3fs: "
+         "%.0f variations/s with %d worker%s\n",
+         (unsigned long long)Shared->solutions, SolutionCount,
+         (unsigned long long)Shared->variations, seconds,
+         Shared->variations / seconds, workers, workers == 1 ? "" : "s");
+  if (failed > 0) {
+    fprintf(stderr, "%d worker%s failed; the verification is incomplete.\n",
+            failed, failed == 1 ? "" : "s");
+    return EXIT_FAILURE;
+  }
+  if (Shared->problems > 0) {
+    printf("%llu problem%s\n", (unsigned long long)Shared->problems,
+           Shared->problems == 1 ? "" : "s");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+/* Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details. */
+
+#ifndef VERIFY_H
+#define VERIFY_H
+
+/**
+ * Verifies the results that venn -f saved in a folder, with the checks of the
+ * search itself. Each solution, from its .txt, is found again from the
+ * choices to it in the .paths index of its degrees, as venn -r does, or, if
+ * there is none, as venn -d does, by searching its degrees. Its signature,
+ * its class signature and its face degrees must then be those saved, and
+ * dynamicFaceFinalCorrectnessChecks must pass.
+ *
+ * Each variation in a variations.dlt, from -F delta, must have each corner
+ * among the possibilities for it, and triangles whose lines, as
+ * dynamicTriangleLinesNotCrossed finds, do not cross. The variations of the
+ * other formats, GraphML, with -z or not, variations.arc and variations.bin,
+ * are written again, numbered as the search numbered them, and each must be
+ * as saved. Every variation saved must be found again.
+ *
+ * The work is a queue of jobs, each a solution and, for variations.dlt, up
+ * to VERIFY_CHUNK of its variations, so that the largest solutions are
+ * shared out too. The workers, forked once initialized, take the next job
+ * from the queue until it is empty. The throughput is reported in
+ * variations per second.
+ */
+
+/* The main of vennverify; see usage. */
+extern int verifyMain(int argc, char *argv[]);
+
+#endif  // VERIFY_H
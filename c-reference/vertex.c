@@ -2,10 +2,11 @@
 
 #include "vertex.h"
 
+#include "memoimage.h"
 #include "trail.h"
 #include "utils.h"
 
-static struct Vertex VertexAllUVertices[NPOINTS];
+struct Vertex VertexAllUVertices[NPOINTS];
 static int NextUVertexId = 0;
 static MEMO struct Vertex* AllUPointPointers[NFACES][NCOLORS][NCOLORS];
 
@@ -84,11 +85,11 @@ static void initializeEdgeLink(EDGE edge1, EDGE edge2, EDGE edge3)
   COLOR other = edge3->color;
 
   assert(edge1->color == edge2->color);
-  assert(edge1->possiblyTo[other].next == NULL);
-  assert(edge2->possiblyTo[other].next == NULL);
+  assert(edge1->possiblyTo[other].next == 0);
+  assert(edge2->possiblyTo[other].next == 0);
   assert(edge1->possiblyTo[other].vertex == edge2->possiblyTo[other].vertex);
-  edge1->possiblyTo[other].next = edge2->reversed;
-  edge2->possiblyTo[other].next = edge1->reversed;
+  edge1->possiblyTo[other].next = EDGE_NUMBER(edge2->reversed);
+  edge2->possiblyTo[other].next = EDGE_NUMBER(edge1->reversed);
 }
 
 /**
@@ -104,19 +105,19 @@ static FAILURE findCornersByTraversal(EDGE start, int depth,
   COLORSET notMyColor = ~(1u << start->color), passed = 0,
            outside = ~start->colors;
   int counter = 0;
-  assert(start->reversed->to == NULL ||
+  assert(start->reversed->to == 0 ||
          (start->colors & notMyColor) == ((NFACES - 1) & notMyColor));
   do {
-    CURVELINK p = current->to;
-    if (detectCornerAndUpdateCrossingSets(p->vertex->colors & notMyColor,
-                                          &outside, &passed)) {
+    CURVELINK p = edgeTo(current);
+    if (detectCornerAndUpdateCrossingSets(
+            curveLinkVertex(p)->colors & notMyColor, &outside, &passed)) {
       if (counter >= MAX_CORNERS) {
         return failureTooManyCorners(depth);
       }
       cornersReturn[counter++] = current;
     }
-    current = p->next;
-  } while (current->to != NULL && current != start);
+    current = curveLinkNext(p);
+  } while (current->to != 0 && current != start);
   while (counter < MAX_CORNERS) {
     cornersReturn[counter++] = NULL;
   }
@@ -163,6 +164,12 @@ char* vertexToColorSetString(VERTEX up)
   return colorSetToBareString(colors);
 }
 
+int vertexNumber(VERTEX up)
+{
+  assert(up >= VertexAllUVertices && up < VertexAllUVertices + NPOINTS);
+  return up - VertexAllUVertices;
+}
+
 char* vertexToString(VERTEX up)
 {
   char* buffer = getBuffer();
@@ -183,7 +190,7 @@ FAILURE vertexCornerCheck(EDGE start, int depth)
   return NULL;
 #else
   EDGE ignore[MAX_CORNERS * 100];
-  if (start->reversed->to != NULL) {
+  if (start->reversed->to != 0) {
     start = vertexGetCentralEdge(start->color);
   }
   return findCornersByTraversal(start, depth, ignore);
@@ -230,7 +237,8 @@ void vertexAlignCorners(COLOR a, EDGE result[3][2])
 void initializePoints(void)
 {
   uint32_t i, j, k;
-  if (VertexAllUVertices[0].incomingEdges[0]->possiblyTo[1].next == NULL) {
+  trailRegisterDynamic(VertexAllUVertices, sizeof(VertexAllUVertices));
+  if (VertexAllUVertices[0].incomingEdges[0]->possiblyTo[1].next == 0) {
     for (i = 0; i < NPOINTS; i++) {
       VERTEX p = VertexAllUVertices + i;
       initializeEdgeLink(p->incomingEdges[0], p->incomingEdges[1],
@@ -246,14 +254,33 @@ void initializePoints(void)
           if (k == j) {
             continue;
           }
-          assert(f->edges[j].possiblyTo[k].vertex != NULL);
-          assert(f->edges[j].possiblyTo[k].next != NULL);
-          assert(f->edges[j].possiblyTo[k].next->color == j);
-          assert(
-              f->edges[j].possiblyTo[k].next->reversed->possiblyTo[k].vertex ==
-              f->edges[j].possiblyTo[k].vertex);
+          assert(f->edges[j].possiblyTo[k].vertex != 0);
+          assert(f->edges[j].possiblyTo[k].next != 0);
+          assert(curveLinkNext(&f->edges[j].possiblyTo[k])->color == j);
+          assert(curveLinkNext(&f->edges[j].possiblyTo[k])
+                     ->reversed->possiblyTo[k]
+                     .vertex == f->edges[j].possiblyTo[k].vertex);
         }
       }
     }
   }
 }
+
+void verticesIncludeInImage(void)
+{
+  memoImageInclude(VertexAllUVertices, sizeof(VertexAllUVertices));
+  memoImageInclude(&NextUVertexId, sizeof(NextUVertexId));
+  memoImageInclude(AllUPointPointers, sizeof(AllUPointPointers));
+  for (uint32_t i = 0; i < NPOINTS; i++) {
+    for (uint32_t j = 0; j < 4; j++) {
+      memoImageIncludePointer(VertexAllUVertices[i].incomingEdges + j);
+    }
+  }
+  for (uint32_t i = 0; i < NFACES; i++) {
+    for (uint32_t j = 0; j < NCOLORS; j++) {
+      for (uint32_t k = 0; k < NCOLORS; k++) {
+        memoImageIncludePointer(&AllUPointPointers[i][j][k]);
+      }
+    }
+  }
+}
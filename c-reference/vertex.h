@@ -89,20 +89,72 @@ struct face {
   /* Set of possible cycles for this face */
   DYNAMIC CYCLESET_DECLARE possibleCycles;
 
+  /* Bit r is set if the Venn choice in round r restricted possibleCycles,
+   * see nogood.h */
+  DYNAMIC uint_trail reasons;
+
   /* Array of adjacent faces, indexed by color */
   MEMO struct face* adjacentFaces[NCOLORS];
 
   /* Edges that form the boundary of this face */
   MEMO struct edge edges[NCOLORS];
-
-  /* Precomputed lookup tables for previous and next faces by cycle ID. */
-  MEMO FACE previousByCycleId[NCYCLES];
-  MEMO FACE nextByCycleId[NCYCLES];
 };
 
 /* Global array of all faces in the diagram */
 extern MEMO struct face Faces[NFACES];
 
+/* The previous and next faces with the same number of colors, for a face with
+ * a given cycle, as their colors; 0, the outer face, for a cycle the face
+ * cannot have. */
+struct faceNeighbours {
+  MEMO uint8_t previous;
+  MEMO uint8_t next;
+};
+
+/* Precomputed, indexed by face colors and by cycle ID. This is kept apart from
+ * struct face, so that the faces, which propagation keeps visiting, are small
+ * and close together; and it is kept small, since it is NFACES * NCYCLES, 300
+ * thousand for NCOLORS=7. */
+extern MEMO struct faceNeighbours FaceNeighboursByCycleId[NFACES][NCYCLES];
+
+/* All the vertices, in the order they were created; see vertexNumber. */
+extern MEMO struct Vertex VertexAllUVertices[NPOINTS];
+
+/*--------------------------------------
+ * Edges and Curve Links by Number
+ *--------------------------------------*/
+
+/* The curve link the edge runs to, or NULL; see struct edge. */
+static inline CURVELINK edgeTo(EDGE edge)
+{
+  return edge->to == 0 ? NULL : edge->possiblyTo + edge->to - 1;
+}
+
+/* The edge with the given EDGE_NUMBER, or NULL for 0. */
+static inline EDGE edgeFromNumber(uint32_t number)
+{
+  return number == 0 ? NULL : Faces[number >> 3].edges + (number & 7) - 1;
+}
+
+/* The edge after a curve link, or NULL if it has none. */
+static inline EDGE curveLinkNext(CURVELINK link)
+{
+  return edgeFromNumber(link->next);
+}
+
+/* The vertex of a curve link, or NULL if it has none. */
+static inline VERTEX curveLinkVertex(CURVELINK link)
+{
+  return link->vertex == 0 ? NULL : VertexAllUVertices + link->vertex - 1;
+}
+
+/* The vertex an edge runs to, or NULL if it has none. */
+static inline VERTEX edgeVertex(EDGE edge)
+{
+  return edge->to == 0 ? NULL
+                       : curveLinkVertex(edge->possiblyTo + edge->to - 1);
+}
+
 /*--------------------------------------
  * Vertex Initialization and Management
  *--------------------------------------*/
@@ -140,6 +192,13 @@ extern char* vertexToString(VERTEX up);
  */
 extern char* vertexToColorSetString(VERTEX up);
 
+/**
+ * The place of a vertex among all NPOINTS of them, for tables of vertices.
+ * @param up The vertex
+ * @return From 0 to NPOINTS - 1
+ */
+extern int vertexNumber(VERTEX up);
+
 /**
  * Perform validation checks on a vertex at a corner.
  * @param start The starting edge for the check
@@ -16,6 +16,7 @@
 /* Search algorithm internals */
 extern FACE searchChooseNextFace(void);         /* Face selection algorithm */
 extern int searchCountVariations(void);         /* Count available variations */
+extern bool dynamicRestrictCycles(FACE face, CYCLESET cycleSet); /* Narrow possible cycles */
 
 /* S6 signature functions */
 extern PERMUTATION s6Automorphism(CYCLE_ID cycleId); /* Get automorphism for cycle */
@@ -26,9 +27,14 @@ extern char *s6SignatureToLongString(SIGNATURE signature); /* Convert to detaile
 
 /* Trail system */
 extern TRAIL Trail; /* Global trail for backtracking */
+extern TRAIL TrailEnd; /* Followed by the guard page */
 extern bool trailRewindTo(TRAIL backtrackPoint); /* Rewind trail to point */
 extern uint_trail * getAlternating(AlternatingPredicate ap, int a, int b, int c);
 extern void debugAlternating(AlternatingPredicate chirotope);
 extern int EngineCounter;
+/* Variant deduplication with these maps, for that many variations, as
+   variantDedupSolution does for the current solution; see variantdedup.h. */
+extern void variantDedupAutomorphisms(const struct automorphism *automorphisms,
+                                      int count, int variations);
 
 #endif  /* VISIBLE_FOR_TESTING_H */
\ No newline at end of file
@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+# Copyright (C) 2025 Jeremy J. Carroll. See LICENSE for details.
+"""Runs the same searches with the C reference and the Rust port, reporting
+wall time, search counters, peak trail and peak RSS as JSON.
+
+    scripts/benchmark.py [--repeat N] [--only c|rust] [--output report.json]
+                         [workload ...]
+
+Each workload is timed as the best of --repeat runs; the counters and RSS come
+from that run. The RSS is sampled, so it may be null for the shortest runs. Counters that an implementation does not report are null, as
+are the entries for an implementation without that workload.
+
+The C program searches six colors only: for four and five colors this times
+the C unit-test searches, test_venn4 and test_venn5, against the Rust search
+tests for the same number of colors. The C program also computes corners and
+writes its output, with -n 1 for one variant per solution, while the Rust
+tests only count solutions.
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+C_DIR = os.path.join(ROOT, "c-reference")
+
+# name: (colors, C command, Rust (features, test target, test name))
+# In the C command, OUT is replaced by a fresh output folder.
+WORKLOADS = {
+    "full": (6, ["bin/venn", "-f", "OUT", "-n", "1", "-v"],
+             (None, "venn6_test", "test_all")),
+    "554544": (6, ["bin/venn", "-f", "OUT", "-d", "554544", "-n", "1", "-v"],
+               (None, "venn6_test", "test_554544")),
+    "corners": (6, ["bin/venn", "-f", "OUT", "-d", "554544", "-m", "1", "-v"],
+                None),
+    "venn5": (5, ["bin/test_venn5"],
+              ("ncolors_5", "venn_integration_test",
+               "test_venn_search_ncolors_5")),
+    "venn4": (4, ["bin/test_venn4"],
+              ("ncolors_4", "venn_integration_test",
+               "test_venn_search_ncolors_4")),
+}
+
+# The statistics printed by the C program with -v
+C_COUNTERS = {"guesses": "guesses", "forced": "forced",
+              "MaxTrail": "max_trail", "solutions": "solutions"}
+
+
+def peak_rss(pid, name):
+    """The peak RSS in KB of the running process pid, once it runs name."""
+    try:
+        with open("/proc/%d/status" % pid) as file:
+            status = dict(line.split(":", 1) for line in file)
+    except (OSError, ValueError):
+        return None
+    # Before the exec, the peak would be that of this script.
+    if status.get("Name", "").strip() != name[:15] or "VmHWM" not in status:
+        return None
+    return int(status["VmHWM"].split()[0])
+
+
+def run(command, cwd):
+    """Runs command, returning its wall time, output and peak RSS in KB.
+
+    The peak RSS is sampled while it runs, since the rusage of a child
+    includes the memory of this script before the exec."""
+    name = os.path.basename(command[0])
+    rss = None
+    with tempfile.TemporaryFile(mode="w+") as output:
+        start = time.perf_counter()
+        process = subprocess.Popen(command, cwd=cwd, stdout=output,
+                                   stderr=subprocess.STDOUT, text=True)
+        while process.poll() is None:
+            rss = peak_rss(process.pid, name) or rss
+            time.sleep(0.005)
+        wall = time.perf_counter() - start
+        output.seek(0)
+        text = output.read()
+    if process.returncode != 0:
+        sys.exit("%s failed:\n%s" % (" ".join(command), text[-2000:]))
+    return wall, text, rss
+
+
+def best_of(repeat, command, cwd, parse):
+    best = None
+    for _ in range(repeat):
+        folder = tempfile.mkdtemp(prefix="venn-benchmark-")
+        try:
+            wall, output, rss = run(
+                [folder if word == "OUT" else word for word in command], cwd)
+        finally:
+            shutil.rmtree(folder)
+        if best is None or wall < best["wall_seconds"]:
+            best = dict(parse(output), wall_seconds=round(wall, 3),
+                        max_rss_kb=rss)
+    return best
+
+
+def parse_c(output):
+    result = dict.fromkeys(C_COUNTERS.values())
+    for name, key in C_COUNTERS.items():
+        match = re.search(r"^\s*%s\s+(\d+)\s*$" % name, output, re.MULTILINE)
+        if match:
+            result[key] = int(match.group(1))
+    return result
+
+
+def parse_rust(output):
+    return dict.fromkeys(C_COUNTERS.values())
+
+
+def build_c(workloads):
+    targets = sorted({WORKLOADS[name][1][0] for name in workloads})
+    subprocess.run(["make"] + targets, cwd=C_DIR, check=True,
+                   stdout=subprocess.DEVNULL)
+
+
+def build_rust(features):
+    """Builds the release test binaries, returning them by test target."""
+    command = ["cargo", "test", "--release", "--no-run",
+               "--message-format=json"]
+    if features:
+        command += ["--features", features]
+    build = subprocess.run(command, cwd=ROOT, stdout=subprocess.PIPE,
+                           text=True)
+    if build.returncode != 0:
+        sys.exit("%s failed" % " ".join(command))
+    output = build.stdout
+    binaries = {}
+    for line in output.splitlines():
+        message = json.loads(line)
+        if message.get("reason") == "compiler-artifact" and \
+                message.get("executable") and message["profile"]["test"]:
+            binaries[message["target"]["name"]] = message["executable"]
+    return binaries
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("workloads", nargs="*",
+                        help="of %s; default: all" % ", ".join(WORKLOADS))
+    parser.add_argument("--repeat", type=int, default=1)
+    parser.add_argument("--only", choices=["c", "rust"])
+    parser.add_argument("--output", help="default: standard output")
+    args = parser.parse_args()
+    workloads = args.workloads or list(WORKLOADS)
+    for name in workloads:
+        if name not in WORKLOADS:
+            parser.error("unknown workload: %s" % name)
+
+    results = []
+    if args.only != "rust":
+        build_c(workloads)
+        for name in workloads:
+            colors, command, _ = WORKLOADS[name]
+            results.append(dict(implementation="c", workload=name,
+                                colors=colors,
+                                **best_of(args.repeat, command, C_DIR,
+                                          parse_c)))
+    if args.only != "c":
+        binaries = {}
+        for name in workloads:
+            colors, _, rust = WORKLOADS[name]
+            if rust is None:
+                continue
+            features, target, test = rust
+            if features not in binaries:
+                binaries[features] = build_rust(features)
+            command = [binaries[features][target], test, "--exact"]
+            results.append(dict(implementation="rust", workload=name,
+                                colors=colors,
+                                **best_of(args.repeat, command, ROOT,
+                                          parse_rust)))
+
+    report = json.dumps({
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "host": platform.node(),
+        "machine": platform.machine(),
+        "repeat": args.repeat,
+        "results": results,
+    }, indent=2)
+    if args.output:
+        with open(args.output, "w") as file:
+            file.write(report + "\n")
+    else:
+        print(report)
+
+
+if __name__ == "__main__":
+    main()
@@ -101,6 +101,12 @@ fn test_655443() {
     run_test([6, 5, 5, 4, 4, 3], true, 6, 0);
 }
 
+#[test]
+fn test_554544() {
+    // From RESULTS.md: 554544 has 36 solutions (all canonical)
+    run_test([5, 5, 4, 5, 4, 4], true, 36, 0);
+}
+
 #[test]
 fn test_all() {
     let mut ctx = SearchContext::new();